@@ -1098,6 +1098,35 @@ CP_C_API cp_plugin_info_t * cp_load_plugin_descriptor(cp_context_t *ctx, const c
  */
 CP_C_API cp_plugin_info_t * cp_load_plugin_descriptor_from_memory(cp_context_t *context, const char *buffer, unsigned int buffer_len, cp_status_t *error) CP_GCC_NONNULL(1, 2);
 
+/**
+ * Writes the specified plug-in information in a compact binary form which
+ * can be loaded again using ::cp_load_plugin_descriptor_from_serialized
+ * without parsing the plug-in descriptor. The format is only meant to be
+ * read by the same build of the library on the same machine.
+ * Nothing is written beyond the given size, so the required size can be
+ * queried by passing a NULL buffer.
+ *
+ * @param plugin the plug-in information to be written
+ * @param buffer the buffer to write to, or NULL
+ * @param buffer_len the size of the buffer
+ * @return the number of bytes required
+ */
+CP_C_API unsigned int cp_serialize_plugin_descriptor(const cp_plugin_info_t *plugin, char *buffer, unsigned int buffer_len) CP_GCC_NONNULL(1);
+
+/**
+ * Loads plug-in information written by ::cp_serialize_plugin_descriptor.
+ * Otherwise the same as ::cp_load_plugin_descriptor, the returned
+ * information can be installed to the context and must be released by
+ * calling ::cp_release_plugin_info.
+ *
+ * @param ctx the plug-in context
+ * @param buffer the buffer containing the serialized plug-in information
+ * @param buffer_len the length of the buffer
+ * @param status a pointer to the location where status code is to be stored, or NULL
+ * @return pointer to the information structure or NULL if error occurs
+ */
+CP_C_API cp_plugin_info_t * cp_load_plugin_descriptor_from_serialized(cp_context_t *ctx, const char *buffer, unsigned int buffer_len, cp_status_t *status) CP_GCC_NONNULL(1, 2);
+
 /**
  * Installs the plug-in described by the specified plug-in information
  * structure to the specified plug-in context. The plug-in information
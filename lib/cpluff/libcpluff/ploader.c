@@ -1363,3 +1363,345 @@ CP_C_API cp_plugin_info_t * cp_load_plugin_descriptor_from_memory(cp_context_t *
 
 	return plugin;
 }
+
+
+/* ------------------------------------------------------------------------
+ * Serialized plug-in descriptors
+ * ----------------------------------------------------------------------*/
+
+/// Writer state for serializing plug-in information
+typedef struct serial_writer_t {
+	char *buffer;
+	unsigned int size;
+	unsigned int pos;
+} serial_writer_t;
+
+/// Reader state for loading serialized plug-in information
+typedef struct serial_reader_t {
+	const char *buffer;
+	unsigned int size;
+	unsigned int pos;
+	int error;
+} serial_reader_t;
+
+static void serial_write(serial_writer_t *w, const void *data, unsigned int len) {
+	if (w->buffer != NULL && w->pos + len <= w->size) {
+		memcpy(w->buffer + w->pos, data, len);
+	}
+	w->pos += len;
+}
+
+static void serial_write_uint(serial_writer_t *w, unsigned int value) {
+	serial_write(w, &value, sizeof(value));
+}
+
+/// Strings are stored as their length plus one, zero stands for NULL
+static void serial_write_str(serial_writer_t *w, const char *str) {
+	if (str == NULL) {
+		serial_write_uint(w, 0);
+	} else {
+		unsigned int len = strlen(str);
+		serial_write_uint(w, len + 1);
+		serial_write(w, str, len);
+	}
+}
+
+static void serial_write_cfg_element(serial_writer_t *w, const cp_cfg_element_t *ce) {
+	unsigned int i;
+
+	serial_write_str(w, ce->name);
+	serial_write_uint(w, ce->num_atts);
+	for (i = 0; i < ce->num_atts * 2; i++) {
+		serial_write_str(w, ce->atts[i]);
+	}
+	serial_write_str(w, ce->value);
+	serial_write_uint(w, ce->num_children);
+	for (i = 0; i < ce->num_children; i++) {
+		serial_write_cfg_element(w, ce->children + i);
+	}
+}
+
+CP_C_API unsigned int cp_serialize_plugin_descriptor(const cp_plugin_info_t *plugin, char *buffer, unsigned int buffer_len) {
+	serial_writer_t w;
+	unsigned int i;
+
+	w.buffer = buffer;
+	w.size = buffer_len;
+	w.pos = 0;
+
+	serial_write_str(&w, plugin->identifier);
+	serial_write_str(&w, plugin->name);
+	serial_write_str(&w, plugin->version);
+	serial_write_str(&w, plugin->provider_name);
+	serial_write_str(&w, plugin->plugin_path);
+	serial_write_str(&w, plugin->abi_bw_compatibility);
+	serial_write_str(&w, plugin->api_bw_compatibility);
+	serial_write_str(&w, plugin->req_cpluff_version);
+	serial_write_str(&w, plugin->runtime_lib_name);
+	serial_write_str(&w, plugin->runtime_funcs_symbol);
+
+	serial_write_uint(&w, plugin->num_imports);
+	for (i = 0; i < plugin->num_imports; i++) {
+		serial_write_str(&w, plugin->imports[i].plugin_id);
+		serial_write_str(&w, plugin->imports[i].version);
+		serial_write_uint(&w, plugin->imports[i].optional);
+	}
+
+	serial_write_uint(&w, plugin->num_ext_points);
+	for (i = 0; i < plugin->num_ext_points; i++) {
+		serial_write_str(&w, plugin->ext_points[i].local_id);
+		serial_write_str(&w, plugin->ext_points[i].identifier);
+		serial_write_str(&w, plugin->ext_points[i].name);
+		serial_write_str(&w, plugin->ext_points[i].schema_path);
+	}
+
+	serial_write_uint(&w, plugin->num_extensions);
+	for (i = 0; i < plugin->num_extensions; i++) {
+		serial_write_str(&w, plugin->extensions[i].ext_point_id);
+		serial_write_str(&w, plugin->extensions[i].local_id);
+		serial_write_str(&w, plugin->extensions[i].identifier);
+		serial_write_str(&w, plugin->extensions[i].name);
+		serial_write_uint(&w, plugin->extensions[i].configuration != NULL);
+		if (plugin->extensions[i].configuration != NULL) {
+			serial_write_cfg_element(&w, plugin->extensions[i].configuration);
+		}
+	}
+
+	return w.pos;
+}
+
+static unsigned int serial_read_uint(serial_reader_t *r) {
+	unsigned int value = 0;
+
+	if (r->error || r->size - r->pos < sizeof(value)) {
+		r->error = 1;
+		return 0;
+	}
+	memcpy(&value, r->buffer + r->pos, sizeof(value));
+	r->pos += sizeof(value);
+	return value;
+}
+
+/// Reads a count of items which take at least min_size bytes each
+static unsigned int serial_read_count(serial_reader_t *r, unsigned int min_size) {
+	unsigned int count = serial_read_uint(r);
+
+	if (!r->error && count > (r->size - r->pos) / min_size) {
+		r->error = 1;
+		return 0;
+	}
+	return count;
+}
+
+static char *serial_read_str(serial_reader_t *r) {
+	unsigned int len = serial_read_uint(r);
+	char *str;
+
+	if (r->error || len == 0) {
+		return NULL;
+	}
+	len--;
+	if (r->size - r->pos < len || (str = malloc(len + 1)) == NULL) {
+		r->error = 1;
+		return NULL;
+	}
+	memcpy(str, r->buffer + r->pos, len);
+	str[len] = '\0';
+	r->pos += len;
+	return str;
+}
+
+/// Attributes share one allocation like the parser creates them
+static char **serial_read_atts(serial_reader_t *r, unsigned int num) {
+	unsigned int start = r->pos;
+	unsigned int i;
+	size_t size = 0;
+	char **atts;
+	char *data;
+
+	if (num == 0) {
+		return NULL;
+	}
+	for (i = 0; i < num && !r->error; i++) {
+		unsigned int len = serial_read_uint(r);
+		if (len > 0 && r->size - r->pos >= len - 1) {
+			r->pos += len - 1;
+			size += len;
+		} else {
+			r->error = 1;
+		}
+	}
+	if (r->error) {
+		return NULL;
+	}
+	if ((atts = malloc(num * sizeof(char *))) == NULL || (data = malloc(size)) == NULL) {
+		free(atts);
+		r->error = 1;
+		return NULL;
+	}
+	r->pos = start;
+	for (i = 0; i < num; i++) {
+		unsigned int len = serial_read_uint(r) - 1;
+		memcpy(data, r->buffer + r->pos, len);
+		data[len] = '\0';
+		atts[i] = data;
+		data += len + 1;
+		r->pos += len;
+	}
+	return atts;
+}
+
+static void serial_read_cfg_element(serial_reader_t *r, cp_cfg_element_t *ce, cp_cfg_element_t *parent, unsigned int index) {
+	unsigned int i;
+
+	ce->parent = parent;
+	ce->index = index;
+	ce->name = serial_read_str(r);
+	ce->num_atts = serial_read_count(r, 2 * sizeof(unsigned int));
+	ce->atts = serial_read_atts(r, ce->num_atts * 2);
+	if (r->error) {
+		ce->num_atts = 0;
+		return;
+	}
+	ce->value = serial_read_str(r);
+	i = serial_read_count(r, 3 * sizeof(unsigned int));
+	if (i > 0 && !r->error) {
+		if ((ce->children = calloc(i, sizeof(cp_cfg_element_t))) == NULL) {
+			r->error = 1;
+			return;
+		}
+		ce->num_children = i;
+	}
+	for (i = 0; i < ce->num_children && !r->error; i++) {
+		serial_read_cfg_element(r, ce->children + i, ce, i);
+	}
+}
+
+CP_C_API cp_plugin_info_t * cp_load_plugin_descriptor_from_serialized(cp_context_t *context, const char *buffer, unsigned int buffer_len, cp_status_t *error) {
+	cp_status_t status = CP_OK;
+	cp_plugin_info_t *plugin = NULL;
+	serial_reader_t r;
+	unsigned int i;
+
+	CHECK_NOT_NULL(context);
+	CHECK_NOT_NULL(buffer);
+	cpi_lock_context(context);
+	cpi_check_invocation(context, CPI_CF_ANY, __func__);
+	do {
+		r.buffer = buffer;
+		r.size = buffer_len;
+		r.pos = 0;
+		r.error = 0;
+
+		// Arrays are allocated in full before their items are read, so
+		// that cpi_free_plugin can release a partially loaded plug-in
+		if ((plugin = calloc(1, sizeof(cp_plugin_info_t))) == NULL) {
+			status = CP_ERR_RESOURCE;
+			break;
+		}
+		plugin->identifier = serial_read_str(&r);
+		plugin->name = serial_read_str(&r);
+		plugin->version = serial_read_str(&r);
+		plugin->provider_name = serial_read_str(&r);
+		plugin->plugin_path = serial_read_str(&r);
+		plugin->abi_bw_compatibility = serial_read_str(&r);
+		plugin->api_bw_compatibility = serial_read_str(&r);
+		plugin->req_cpluff_version = serial_read_str(&r);
+		plugin->runtime_lib_name = serial_read_str(&r);
+		plugin->runtime_funcs_symbol = serial_read_str(&r);
+
+		i = serial_read_count(&r, 3 * sizeof(unsigned int));
+		if (i > 0 && !r.error) {
+			if ((plugin->imports = calloc(i, sizeof(cp_plugin_import_t))) == NULL) {
+				status = CP_ERR_RESOURCE;
+				break;
+			}
+			plugin->num_imports = i;
+		}
+		for (i = 0; i < plugin->num_imports && !r.error; i++) {
+			plugin->imports[i].plugin_id = serial_read_str(&r);
+			plugin->imports[i].version = serial_read_str(&r);
+			plugin->imports[i].optional = serial_read_uint(&r);
+		}
+
+		i = serial_read_count(&r, 4 * sizeof(unsigned int));
+		if (i > 0 && !r.error) {
+			if ((plugin->ext_points = calloc(i, sizeof(cp_ext_point_t))) == NULL) {
+				status = CP_ERR_RESOURCE;
+				break;
+			}
+			plugin->num_ext_points = i;
+		}
+		for (i = 0; i < plugin->num_ext_points && !r.error; i++) {
+			plugin->ext_points[i].plugin = plugin;
+			plugin->ext_points[i].local_id = serial_read_str(&r);
+			plugin->ext_points[i].identifier = serial_read_str(&r);
+			plugin->ext_points[i].name = serial_read_str(&r);
+			plugin->ext_points[i].schema_path = serial_read_str(&r);
+		}
+
+		i = serial_read_count(&r, 5 * sizeof(unsigned int));
+		if (i > 0 && !r.error) {
+			if ((plugin->extensions = calloc(i, sizeof(cp_extension_t))) == NULL) {
+				status = CP_ERR_RESOURCE;
+				break;
+			}
+			plugin->num_extensions = i;
+		}
+		for (i = 0; i < plugin->num_extensions && !r.error; i++) {
+			cp_extension_t *extension = plugin->extensions + i;
+
+			extension->plugin = plugin;
+			extension->ext_point_id = serial_read_str(&r);
+			extension->local_id = serial_read_str(&r);
+			extension->identifier = serial_read_str(&r);
+			extension->name = serial_read_str(&r);
+			if (serial_read_uint(&r) && !r.error) {
+				if ((extension->configuration = calloc(1, sizeof(cp_cfg_element_t))) == NULL) {
+					status = CP_ERR_RESOURCE;
+					break;
+				}
+				serial_read_cfg_element(&r, extension->configuration, NULL, 0);
+			}
+		}
+		if (status != CP_OK) {
+			break;
+		}
+
+		if (r.error || r.pos != r.size || plugin->identifier == NULL) {
+			status = CP_ERR_MALFORMED;
+			break;
+		}
+
+		// Increase plug-in usage count
+		if ((status = cpi_register_info(context, plugin, (void (*)(cp_context_t *, void *)) dealloc_plugin_info)) != CP_OK) {
+			break;
+		}
+
+	} while (0);
+
+	// Report possible errors
+	if (status != CP_OK) {
+		switch (status) {
+			case CP_ERR_MALFORMED:
+				cpi_error(context, N_("Serialized plug-in descriptor is invalid."));
+				break;
+			case CP_ERR_RESOURCE:
+				cpi_error(context, N_("Insufficient system resources to load a serialized plug-in descriptor."));
+				break;
+			default:
+				cpi_error(context, N_("Failed to load a serialized plug-in descriptor."));
+				break;
+		}
+		if (plugin != NULL) {
+			cpi_free_plugin(plugin);
+			plugin = NULL;
+		}
+	}
+	cpi_unlock_context(context);
+
+	if (error != NULL) {
+		*error = status;
+	}
+	return plugin;
+}
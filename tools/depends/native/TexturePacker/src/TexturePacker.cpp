@@ -49,6 +49,10 @@
 using namespace std;
 
 #define FLAGS_USE_LZO     1
+#define FLAGS_PAGE_ALIGN  2
+
+// frames of page aligned bundles can be used straight from a memory mapped file
+#define PAGE_ALIGNMENT    4096
 
 #define DIR_SEPARATOR "/"
 
@@ -219,6 +223,8 @@ void Usage()
   puts("  -input <dir>     Input directory. Default: current dir");
   puts("  -output <dir>    Output directory/filename. Default: Textures.xbt");
   puts("  -dupecheck       Enable duplicate file detection. Reduces output file size. Default: off");
+  puts("  -pagealign       Store frames uncompressed at page boundaries, so they can be used");
+  puts("                   straight from the memory mapped file. Increases output file size. Default: off");
 }
 
 static bool checkDupe(struct MD5Context* ctx,
@@ -250,7 +256,7 @@ static bool checkDupe(struct MD5Context* ctx,
 
 int createBundle(const std::string& InputDir, const std::string& OutputFile, double maxMSE, unsigned int flags, bool dupecheck)
 {
-  CXBTFWriter writer(OutputFile);
+  CXBTFWriter writer(OutputFile, (flags & FLAGS_PAGE_ALIGN) ? PAGE_ALIGNMENT : 0);
   if (!writer.Create())
   {
     fprintf(stderr, "Error creating file\n");
@@ -381,6 +387,11 @@ int main(int argc, char* argv[])
     {
       dupecheck = true;
     }
+    else if (!strcmp(args[i], "-pagealign"))
+    {
+      flags |= FLAGS_PAGE_ALIGN;
+      flags &= ~FLAGS_USE_LZO;
+    }
     else if (!platform_stricmp(args[i], "-output") || !platform_stricmp(args[i], "-o"))
     {
       OutputFilename = args[++i];
@@ -37,8 +37,9 @@
 #define WRITE_U32(i, file) { uint32_t _n = Endian_SwapLE32(i); fwrite(&_n, 4, 1, file); }
 #define WRITE_U64(i, file) { uint64_t _n = i; _n = Endian_SwapLE64(i); fwrite(&_n, 8, 1, file); }
 
-CXBTFWriter::CXBTFWriter(const std::string& outputFile)
+CXBTFWriter::CXBTFWriter(const std::string& outputFile, uint64_t alignment)
   : m_outputFile(outputFile),
+    m_alignment(alignment),
     m_file(nullptr),
     m_data(nullptr),
     m_size(0)
@@ -82,9 +83,20 @@ void CXBTFWriter::Cleanup()
   }
 }
 
+uint64_t CXBTFWriter::Align(uint64_t offset) const
+{
+  if (m_alignment <= 1)
+    return offset;
+
+  return (offset + m_alignment - 1) / m_alignment * m_alignment;
+}
+
 bool CXBTFWriter::AppendContent(unsigned char const* data, size_t length)
 {
-  unsigned char *new_data = (unsigned char *)realloc(m_data, m_size + length);
+  // pad the previous frame, the content starts at an aligned offset behind the (padded) header
+  size_t padding = static_cast<size_t>(Align(m_size) - m_size);
+
+  unsigned char *new_data = (unsigned char *)realloc(m_data, m_size + padding + length);
 
   if (new_data == nullptr)
   { // OOM - cleanup and fail
@@ -94,6 +106,9 @@ bool CXBTFWriter::AppendContent(unsigned char const* data, size_t length)
 
   m_data = new_data;
 
+  memset(m_data + m_size, 0, padding);
+  m_size += padding;
+
   memcpy(m_data + m_size, data, length);
   m_size += length;
 
@@ -106,7 +121,7 @@ bool CXBTFWriter::UpdateHeader(const std::vector<unsigned int>& dupes)
     return false;
 
   uint64_t headerSize = GetHeaderSize();
-  uint64_t offset = headerSize;
+  uint64_t offset = Align(headerSize);
 
   WRITE_STR(XBTF_MAGIC.c_str(), 4, m_file);
   WRITE_STR(XBTF_VERSION.c_str(), 1, m_file);
@@ -138,6 +153,7 @@ bool CXBTFWriter::UpdateHeader(const std::vector<unsigned int>& dupes)
         frame.SetOffset(files[dupes[i]].GetFrames()[j].GetOffset());
       else
       {
+        offset = Align(offset);
         frame.SetOffset(offset);
         offset += frame.GetPackedSize();
       }
@@ -160,5 +176,9 @@ bool CXBTFWriter::UpdateHeader(const std::vector<unsigned int>& dupes)
     return false;
   }
 
+  // readers only look at the header, so the padding up to the first frame can simply be zeros
+  for (uint64_t padding = Align(headerSize) - headerSize; padding > 0; padding--)
+    fputc(0, m_file);
+
   return true;
 }
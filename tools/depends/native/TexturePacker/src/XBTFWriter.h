@@ -30,7 +30,10 @@
 class CXBTFWriter : public CXBTFBase
 {
 public:
-  CXBTFWriter(const std::string& outputFile);
+  /*!
+   \param alignment if not 0, the header and every frame are padded so frames start at a multiple of it
+   */
+  CXBTFWriter(const std::string& outputFile, uint64_t alignment = 0);
   ~CXBTFWriter() override;
 
   bool Create();
@@ -40,8 +43,10 @@ public:
 
 private:
   void Cleanup();
+  uint64_t Align(uint64_t offset) const;
 
   std::string m_outputFile;
+  uint64_t m_alignment;
   FILE* m_file;
   unsigned char *m_data;
   size_t         m_size;
@@ -0,0 +1,242 @@
+#!/usr/bin/env python3
+#
+#      Copyright (C) 2017 Team Kodi
+#      http://kodi.tv
+#
+#  This Program is free software; you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation; either version 2, or (at your option)
+#  any later version.
+#
+#  This Program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with Kodi; see the file COPYING.  If not, see
+#  <http://www.gnu.org/licenses/>.
+#
+
+"""Load test for the JSON-RPC TCP server (port 9090 by default).
+
+Opens many raw TCP and/or WebSocket clients at once, lets every client send
+requests one after another and reports the request latency percentiles.
+Announcements received in between are counted but otherwise ignored.
+
+  loadtest.py --clients 300 --requests 20
+  loadtest.py --mode websocket --method VideoLibrary.GetMovies \\
+              --params '{"limits": {"end": 50}}'
+"""
+
+import argparse
+import asyncio
+import base64
+import json
+import os
+import struct
+import sys
+import time
+
+
+class Stats(object):
+  def __init__(self):
+    self.latencies = []
+    self.errors = 0
+    self.failed_clients = 0
+    self.announcements = 0
+
+
+class JsonStream(object):
+  """Splits a byte stream into JSON values."""
+
+  def __init__(self):
+    self.buffer = ''
+    self.decoder = json.JSONDecoder()
+
+  def feed(self, data):
+    self.buffer += data.decode('utf-8', 'replace')
+    values = []
+    while True:
+      text = self.buffer.lstrip()
+      if not text:
+        self.buffer = ''
+        break
+      try:
+        value, end = self.decoder.raw_decode(text)
+      except ValueError:
+        self.buffer = text
+        break
+      values.append(value)
+      self.buffer = text[end:]
+    return values
+
+
+class TcpConnection(object):
+  def __init__(self, reader, writer):
+    self.reader = reader
+    self.writer = writer
+    self.stream = JsonStream()
+
+  async def send(self, text):
+    self.writer.write(text.encode('utf-8'))
+    await self.writer.drain()
+
+  async def receive(self):
+    while True:
+      data = await self.reader.read(65536)
+      if not data:
+        raise ConnectionError('connection closed')
+      values = self.stream.feed(data)
+      if values:
+        return values
+
+  def close(self):
+    self.writer.close()
+
+
+class WebSocketConnection(TcpConnection):
+  async def handshake(self, host, port):
+    key = base64.b64encode(os.urandom(16)).decode('ascii')
+    request = ('GET /jsonrpc HTTP/1.1\r\n'
+               'Host: %s:%d\r\n'
+               'Upgrade: websocket\r\n'
+               'Connection: Upgrade\r\n'
+               'Sec-WebSocket-Key: %s\r\n'
+               'Sec-WebSocket-Version: 13\r\n\r\n') % (host, port, key)
+    self.writer.write(request.encode('ascii'))
+    await self.writer.drain()
+    response = await self.reader.readuntil(b'\r\n\r\n')
+    if b' 101 ' not in response.split(b'\r\n', 1)[0]:
+      raise ConnectionError('websocket handshake failed')
+
+  async def send(self, text):
+    payload = text.encode('utf-8')
+    mask = os.urandom(4)
+    header = bytearray([0x81])
+    if len(payload) < 126:
+      header.append(0x80 | len(payload))
+    elif len(payload) < 65536:
+      header.append(0x80 | 126)
+      header += struct.pack('!H', len(payload))
+    else:
+      header.append(0x80 | 127)
+      header += struct.pack('!Q', len(payload))
+    masked = bytes(b ^ mask[i % 4] for i, b in enumerate(payload))
+    self.writer.write(bytes(header) + mask + masked)
+    await self.writer.drain()
+
+  async def receive(self):
+    message = b''
+    while True:
+      first, second = await self.reader.readexactly(2)
+      length = second & 0x7f
+      if length == 126:
+        length = struct.unpack('!H', await self.reader.readexactly(2))[0]
+      elif length == 127:
+        length = struct.unpack('!Q', await self.reader.readexactly(8))[0]
+      if second & 0x80:
+        await self.reader.readexactly(4)
+      payload = await self.reader.readexactly(length)
+      opcode = first & 0x0f
+      if opcode == 0x8:
+        raise ConnectionError('websocket closed')
+      if opcode in (0x9, 0xa):
+        continue
+      message += payload
+      if first & 0x80:
+        return self.stream.feed(message)
+
+
+async def connect(args, websocket):
+  reader, writer = await asyncio.open_connection(args.host, args.port, limit=1 << 24)
+  if websocket:
+    connection = WebSocketConnection(reader, writer)
+    await connection.handshake(args.host, args.port)
+  else:
+    connection = TcpConnection(reader, writer)
+  return connection
+
+
+async def run_client(index, args, params, stats, start):
+  websocket = args.mode == 'websocket' or (args.mode == 'mixed' and index % 2)
+  try:
+    connection = await asyncio.wait_for(connect(args, websocket), args.timeout)
+  except (OSError, ConnectionError, asyncio.TimeoutError, asyncio.IncompleteReadError):
+    stats.failed_clients += 1
+    return
+
+  await start.wait()
+  try:
+    for request_id in range(args.requests):
+      request = {'jsonrpc': '2.0', 'method': args.method, 'id': request_id}
+      if params is not None:
+        request['params'] = params
+      sent = time.monotonic()
+      await connection.send(json.dumps(request))
+      answered = False
+      while not answered:
+        values = await asyncio.wait_for(connection.receive(), args.timeout)
+        for value in values:
+          if isinstance(value, dict) and value.get('id') == request_id:
+            stats.latencies.append(time.monotonic() - sent)
+            if 'error' in value:
+              stats.errors += 1
+            answered = True
+          else:
+            stats.announcements += 1
+  except (OSError, ConnectionError, asyncio.TimeoutError, asyncio.IncompleteReadError):
+    stats.failed_clients += 1
+  finally:
+    connection.close()
+
+
+def percentile(values, fraction):
+  if not values:
+    return 0.0
+  return values[min(len(values) - 1, int(len(values) * fraction))]
+
+
+async def run(args):
+  params = json.loads(args.params) if args.params else None
+  stats = Stats()
+  start = asyncio.Event()
+  clients = [asyncio.ensure_future(run_client(i, args, params, stats, start))
+             for i in range(args.clients)]
+
+  # let every client connect before the clock starts
+  await asyncio.sleep(args.warmup)
+  began = time.monotonic()
+  start.set()
+  await asyncio.gather(*clients)
+  elapsed = time.monotonic() - began
+
+  latencies = sorted(stats.latencies)
+  print('clients:        %d (%d failed)' % (args.clients, stats.failed_clients))
+  print('requests:       %d (%d errors) in %.2f s, %.1f req/s'
+        % (len(latencies), stats.errors, elapsed, len(latencies) / elapsed if elapsed else 0))
+  print('announcements:  %d' % stats.announcements)
+  for name, fraction in (('p50', 0.50), ('p90', 0.90), ('p99', 0.99), ('max', 1.0)):
+    print('latency %s:    %8.2f ms' % (name, percentile(latencies, fraction) * 1000))
+  return 0 if latencies and stats.failed_clients == 0 else 1
+
+
+def main():
+  parser = argparse.ArgumentParser(description='Load test for the JSON-RPC TCP server')
+  parser.add_argument('--host', default='127.0.0.1')
+  parser.add_argument('--port', type=int, default=9090)
+  parser.add_argument('--clients', type=int, default=200, help='number of concurrent clients')
+  parser.add_argument('--requests', type=int, default=50, help='requests sent by each client')
+  parser.add_argument('--mode', choices=('tcp', 'websocket', 'mixed'), default='mixed')
+  parser.add_argument('--method', default='JSONRPC.Ping')
+  parser.add_argument('--params', help='JSON encoded parameters of the method')
+  parser.add_argument('--timeout', type=float, default=30.0, help='seconds to wait for a response')
+  parser.add_argument('--warmup', type=float, default=1.0, help='seconds to wait for all clients to connect')
+  args = parser.parse_args()
+
+  loop = asyncio.get_event_loop()
+  return loop.run_until_complete(run(args))
+
+
+if __name__ == '__main__':
+  sys.exit(main())
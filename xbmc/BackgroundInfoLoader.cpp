@@ -24,13 +24,24 @@
 #include "utils/log.h"
 #include "URL.h"
 
-CBackgroundInfoLoader::CBackgroundInfoLoader() : m_thread (NULL)
+#include <algorithm>
+#include <limits>
+
+CBackgroundInfoLoader::CBackgroundInfoLoader(unsigned int workers /* = 1 */)
+  : m_startEvent(true),
+    m_workers(std::max(workers, 1U))
 {
   m_bStop = true;
   m_pObserver=NULL;
   m_pProgressCallback=NULL;
   m_pVecItems = NULL;
   m_bIsLoading = false;
+  m_starting = 0;
+  m_running = 0;
+  m_visibleFirst = 0;
+  m_visibleLast = 0;
+  for (unsigned int stage = 0; stage < STAGE_DONE; stage++)
+    m_cursorUp[stage] = m_cursorDown[stage] = 0;
 }
 
 CBackgroundInfoLoader::~CBackgroundInfoLoader()
@@ -40,61 +51,164 @@ CBackgroundInfoLoader::~CBackgroundInfoLoader()
 
 void CBackgroundInfoLoader::Run()
 {
+  bool first;
+  {
+    CSingleLock lock(m_lock);
+    first = m_starting++ == 0;
+  }
+
   try
   {
-    if (!m_vecItems.empty())
+    // the first worker prepares the loader, the others wait for it
+    if (first)
     {
-      OnLoaderStart();
+      if (!m_vecItems.empty())
+        OnLoaderStart();
+      m_startEvent.Set();
+    }
+    else
+      m_startEvent.Wait();
 
-      // Stage 1: All "fast" stuff we have already cached
-      for (std::vector<CFileItemPtr>::const_iterator iter = m_vecItems.begin(); iter != m_vecItems.end(); ++iter)
-      {
-        CFileItemPtr pItem = *iter;
+    while (true)
+    {
+      // Ask the callback if we should abort
+      if ((m_pProgressCallback && m_pProgressCallback->Abort()) || m_bStop)
+        break;
 
-        // Ask the callback if we should abort
-        if ((m_pProgressCallback && m_pProgressCallback->Abort()) || m_bStop)
+      size_t index;
+      bool lookup;
+      CFileItemPtr pItem;
+      {
+        CSingleLock lock(m_lock);
+        if (!GetNextItem(index, lookup))
           break;
-
-        try
-        {
-          if (LoadItemCached(pItem.get()) && m_pObserver)
-            m_pObserver->OnItemLoaded(pItem.get());
-        }
-        catch (...)
-        {
-          CLog::Log(LOGERROR, "CBackgroundInfoLoader::LoadItemCached - Unhandled exception for item %s", CURL::GetRedacted(pItem->GetPath()).c_str());
-        }
+        pItem = m_vecItems[index];
       }
 
-      // Stage 2: All "slow" stuff that we need to lookup
-      for (std::vector<CFileItemPtr>::const_iterator iter = m_vecItems.begin(); iter != m_vecItems.end(); ++iter)
+      try
       {
-        CFileItemPtr pItem = *iter;
-
-        // Ask the callback if we should abort
-        if ((m_pProgressCallback && m_pProgressCallback->Abort()) || m_bStop)
-          break;
-
-        try
+        bool loaded;
+        if (lookup)
+          loaded = LoadItemLookup(pItem.get());
+        else
         {
-          if (LoadItemLookup(pItem.get()) && m_pObserver)
-            m_pObserver->OnItemLoaded(pItem.get());
+          CSingleLock lock(m_cachedSection);
+          loaded = LoadItemCached(pItem.get());
         }
-        catch (...)
+
+        if (loaded && m_pObserver)
         {
-          CLog::Log(LOGERROR, "CBackgroundInfoLoader::LoadItemLookup - Unhandled exception for item %s", CURL::GetRedacted(pItem->GetPath()).c_str());
+          CSingleLock lock(m_observerSection);
+          m_pObserver->OnItemLoaded(pItem.get());
         }
       }
+      catch (...)
+      {
+        CLog::Log(LOGERROR, "CBackgroundInfoLoader::%s - Unhandled exception for item %s", lookup ? "LoadItemLookup" : "LoadItemCached", CURL::GetRedacted(pItem->GetPath()).c_str());
+      }
+
+      CSingleLock lock(m_lock);
+      m_busy[index] = false;
     }
+  }
+  catch (...)
+  {
+    m_startEvent.Set();
+    CLog::Log(LOGERROR, "%s - Unhandled exception", __FUNCTION__);
+  }
+
+  // the last worker to leave cleans up
+  {
+    CSingleLock lock(m_lock);
+    if (--m_running > 0)
+      return;
+  }
 
+  try
+  {
     OnLoaderFinish();
-    m_bIsLoading = false;
   }
   catch (...)
   {
-    m_bIsLoading = false;
     CLog::Log(LOGERROR, "%s - Unhandled exception", __FUNCTION__);
   }
+  m_bIsLoading = false;
+}
+
+bool CBackgroundInfoLoader::GetNextItem(size_t& index, bool& lookup)
+{
+  // within a page of the visible items all cached details are loaded before
+  // the first lookup, further away the cached details of all items go first
+  const size_t page = m_visibleLast - m_visibleFirst + 1;
+  const size_t unlimited = std::numeric_limits<size_t>::max();
+
+  size_t cached, cachedDistance;
+  bool hasCached = FindNearest(STAGE_CACHED, unlimited, cached, cachedDistance);
+  size_t distance;
+  if (hasCached && cachedDistance <= page)
+    lookup = false;
+  else if (FindNearest(STAGE_LOOKUP, page, index, distance))
+    lookup = true;
+  else if (hasCached)
+    lookup = false;
+  else if (FindNearest(STAGE_LOOKUP, unlimited, index, distance))
+    lookup = true;
+  else
+    return false;
+
+  if (!lookup)
+    index = cached;
+  m_stage[index]++;
+  m_busy[index] = true;
+  return true;
+}
+
+bool CBackgroundInfoLoader::FindNearest(unsigned int stage, size_t maxDistance, size_t& index, size_t& distance)
+{
+  const size_t count = m_stage.size();
+
+  // skip what has been started already
+  size_t& up = m_cursorUp[stage];
+  while (up < count && m_stage[up] > stage)
+    up++;
+  size_t& down = m_cursorDown[stage];
+  while (down > 0 && m_stage[down - 1] > stage)
+    down--;
+
+  // items busy with or waiting for an earlier stage are passed over
+  bool found = false;
+  for (size_t i = up; i < count && GetDistance(i) <= maxDistance; i++)
+  {
+    if (m_stage[i] == stage && !m_busy[i])
+    {
+      index = i;
+      distance = GetDistance(i);
+      found = true;
+      break;
+    }
+  }
+  for (size_t i = down; i > 0 && GetDistance(i - 1) <= maxDistance; i--)
+  {
+    if (found && GetDistance(i - 1) >= distance)
+      break;
+    if (m_stage[i - 1] == stage && !m_busy[i - 1])
+    {
+      index = i - 1;
+      distance = GetDistance(i - 1);
+      found = true;
+      break;
+    }
+  }
+  return found;
+}
+
+size_t CBackgroundInfoLoader::GetDistance(size_t index) const
+{
+  if (index < m_visibleFirst)
+    return m_visibleFirst - index;
+  if (index > m_visibleLast)
+    return index - m_visibleLast;
+  return 0;
 }
 
 void CBackgroundInfoLoader::Load(CFileItemList& items)
@@ -107,15 +221,57 @@ void CBackgroundInfoLoader::Load(CFileItemList& items)
   CSingleLock lock(m_lock);
 
   for (int nItem=0; nItem < items.Size(); nItem++)
+  {
     m_vecItems.push_back(items[nItem]);
+    m_itemIndex[items[nItem].get()] = nItem;
+  }
+  m_stage.assign(m_vecItems.size(), STAGE_CACHED);
+  m_busy.assign(m_vecItems.size(), false);
+  m_visibleFirst = m_visibleLast = 0;
+  for (unsigned int stage = 0; stage < STAGE_DONE; stage++)
+    m_cursorUp[stage] = m_cursorDown[stage] = 0;
 
   m_pVecItems = &items;
   m_bStop = false;
   m_bIsLoading = true;
+  m_starting = 0;
+  m_running = m_workers;
+  m_startEvent.Reset();
 
-  m_thread = new CThread(this, "BackgroundLoader");
-  m_thread->Create();
-  m_thread->SetPriority(THREAD_PRIORITY_BELOW_NORMAL);
+  for (unsigned int i = 0; i < m_workers; i++)
+  {
+    CThread* thread = new CThread(this, "BackgroundLoader");
+    thread->Create();
+    thread->SetPriority(THREAD_PRIORITY_BELOW_NORMAL);
+    m_threads.push_back(thread);
+  }
+}
+
+void CBackgroundInfoLoader::SetVisibleItems(const std::vector<CGUIListItemPtr>& items)
+{
+  CSingleLock lock(m_lock);
+  if (m_itemIndex.empty())
+    return;
+
+  size_t first = std::numeric_limits<size_t>::max();
+  size_t last = 0;
+  for (std::vector<CGUIListItemPtr>::const_iterator it = items.begin(); it != items.end(); ++it)
+  {
+    std::unordered_map<const CGUIListItem*, size_t>::const_iterator index = m_itemIndex.find(it->get());
+    if (index != m_itemIndex.end())
+    {
+      first = std::min(first, index->second);
+      last = std::max(last, index->second);
+    }
+  }
+
+  if (first > last || (first == m_visibleFirst && last == m_visibleLast))
+    return;
+
+  m_visibleFirst = first;
+  m_visibleLast = last;
+  for (unsigned int stage = 0; stage < STAGE_DONE; stage++)
+    m_cursorUp[stage] = m_cursorDown[stage] = first;
 }
 
 void CBackgroundInfoLoader::StopAsync()
@@ -128,13 +284,18 @@ void CBackgroundInfoLoader::StopThread()
 {
   StopAsync();
 
-  if (m_thread)
+  for (std::vector<CThread*>::iterator it = m_threads.begin(); it != m_threads.end(); ++it)
   {
-    m_thread->StopThread();
-    delete m_thread;
-    m_thread = NULL;
+    (*it)->StopThread();
+    delete *it;
   }
+  m_threads.clear();
+
+  CSingleLock lock(m_lock);
   m_vecItems.clear();
+  m_itemIndex.clear();
+  m_stage.clear();
+  m_busy.clear();
   m_pVecItems = NULL;
   m_bIsLoading = false;
 }
@@ -153,4 +314,3 @@ void CBackgroundInfoLoader::SetProgressCallback(IProgressCallback* pCallback)
 {
   m_pProgressCallback = pCallback;
 }
-
@@ -23,12 +23,15 @@
 #include "threads/Thread.h"
 #include "IProgressCallback.h"
 #include "threads/CriticalSection.h"
+#include "threads/Event.h"
 
 #include <vector>
 #include <memory>
+#include <unordered_map>
 
 class CFileItem; typedef std::shared_ptr<CFileItem> CFileItemPtr;
 class CFileItemList;
+class CGUIListItem; typedef std::shared_ptr<CGUIListItem> CGUIListItemPtr;
 
 class IBackgroundLoaderObserver
 {
@@ -37,10 +40,25 @@ public:
   virtual void OnItemLoaded(CFileItem* pItem) = 0;
 };
 
+/*!
+ \brief Loads the details of a list of items on threads of its own.
+
+ Items run through LoadItemCached first and LoadItemLookup afterwards. The
+ items on screen (see SetVisibleItems) go first, then everything within a page
+ of them gets its cached details and lookups, then the rest of the list in
+ order of distance.
+
+ LoadItemCached calls never overlap, they hold m_cachedSection. With more than
+ one worker, LoadItemLookup calls for different items run at the same time and
+ have to guard whatever they share with each other or with LoadItemCached.
+ */
 class CBackgroundInfoLoader : public IRunnable
 {
 public:
-  CBackgroundInfoLoader();
+  /*!
+   \param workers number of threads loading items at the same time
+   */
+  explicit CBackgroundInfoLoader(unsigned int workers = 1);
   ~CBackgroundInfoLoader() override;
 
   void Load(CFileItemList& items);
@@ -52,6 +70,13 @@ public:
   virtual bool LoadItemCached(CFileItem* pItem) { return false; };
   virtual bool LoadItemLookup(CFileItem* pItem) { return false; };
 
+  /*! \brief Tell the loader which items are on screen.
+   Items not part of the loaded list are ignored. Work not yet started is
+   reordered around the new items, calls with the same items change nothing.
+   \param items the visible items, in any order
+   */
+  void SetVisibleItems(const std::vector<CGUIListItemPtr>& items);
+
   void StopThread(); // will actually stop the loader thread.
   void StopAsync();  // will ask loader to stop as soon as possible, but not block
 
@@ -62,12 +87,40 @@ protected:
   CFileItemList *m_pVecItems;
   std::vector<CFileItemPtr> m_vecItems; // FileItemList would delete the items and we only want to keep a reference.
   CCriticalSection m_lock;
+  CCriticalSection m_cachedSection;
 
   volatile bool m_bIsLoading;
   volatile bool m_bStop;
-  CThread *m_thread;
+  std::vector<CThread*> m_threads;
 
   IBackgroundLoaderObserver* m_pObserver;
   IProgressCallback* m_pProgressCallback;
-};
 
+private:
+  enum LoadStage
+  {
+    STAGE_CACHED = 0,
+    STAGE_LOOKUP,
+    STAGE_DONE
+  };
+
+  bool GetNextItem(size_t& index, bool& lookup);
+  bool FindNearest(unsigned int stage, size_t maxDistance, size_t& index, size_t& distance);
+  size_t GetDistance(size_t index) const;
+
+  const unsigned int m_workers;
+  unsigned int m_starting;
+  unsigned int m_running;
+  CEvent m_startEvent;
+  CCriticalSection m_observerSection;
+
+  // all below under m_lock
+  std::unordered_map<const CGUIListItem*, size_t> m_itemIndex;
+  std::vector<unsigned char> m_stage; // the next stage to start per item
+  std::vector<bool> m_busy;
+  size_t m_visibleFirst;
+  size_t m_visibleLast;
+  // per stage, everything between the cursors has been started
+  size_t m_cursorUp[STAGE_DONE];
+  size_t m_cursorDown[STAGE_DONE];
+};
@@ -28,6 +28,7 @@
 #include "favourites/FavouritesService.h"
 #include "games/controllers/ControllerManager.h"
 #include "games/GameServices.h"
+#include "guilib/TextureManager.h"
 #include "peripherals/Peripherals.h"
 #include "PlayListPlayer.h"
 #include "profiles/ProfilesManager.h"
@@ -149,6 +150,7 @@ bool CServiceManager::InitStageThree()
 {
   m_contextMenuManager->Init();
   m_PVRManager->Init();
+  m_addonMgr->Events().Subscribe(&g_TextureManager, &CGUITextureManager::OnAddonEvent);
 
   init_level = 3;
   return true;
@@ -156,6 +158,7 @@ bool CServiceManager::InitStageThree()
 
 void CServiceManager::DeinitStageThree()
 {
+  m_addonMgr->Events().Unsubscribe(&g_TextureManager);
   m_PVRManager->Deinit();
   m_contextMenuManager->Deinit();
 
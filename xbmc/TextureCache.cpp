@@ -23,6 +23,7 @@
 #include "filesystem/File.h"
 #include "profiles/ProfilesManager.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 #include "utils/Crc32.h"
 #include "settings/AdvancedSettings.h"
 #include "utils/log.h"
@@ -177,6 +178,125 @@ bool CTextureCache::CacheImage(const std::string &image, CTextureDetails &detail
   return !path.empty();
 }
 
+std::string CTextureCache::CacheResizedImage(const std::string &image, const std::string &hash)
+{
+  static const size_t resized_images_to_keep = 8;
+  static const unsigned int resized_image_wait_ms = 10000;
+
+  if (image.empty() || hash.empty())
+    return "";
+
+  CTextureDetails details;
+  std::string path = GetCachedImage(image, details, true);
+  if (!path.empty() && GetCachedTextureHash(image) == hash)
+  {
+    // the image hasn't changed, it doesn't need to be checked again for a while
+    if (!details.hash.empty())
+      SetCachedTextureValid(image, true);
+    return path;
+  }
+
+  {
+    // don't hang on a resize that never finishes, the caller resizes directly instead
+    XbmcThreads::EndTime timeout(resized_image_wait_ms);
+    CSingleLock lock(m_processingSection);
+    while (m_processinglist.find(image) != m_processinglist.end())
+    {
+      if (timeout.IsTimePast())
+        return "";
+      m_resizedCondition.wait(lock, timeout.MillisLeft());
+    }
+
+    // resized by the request we waited for
+    path = GetCachedImage(image, details, true);
+    if (!path.empty() && GetCachedTextureHash(image) == hash)
+      return path;
+
+    m_processinglist.insert(image);
+  }
+
+  // replace the resize of an earlier version of the image
+  if (!path.empty())
+    ClearCachedImage(image);
+
+  unsigned int width, height;
+  CPictureScalingAlgorithm::Algorithm scalingAlgorithm;
+  std::string additionalInfo;
+  std::string original = CTextureCacheJob::DecodeImageURL(image, width, height, scalingAlgorithm, additionalInfo);
+
+  uint8_t *buffer = NULL;
+  size_t size = 0;
+  bool success = CTextureCacheJob::ResizeTexture(image, buffer, size, width, height);
+  if (success)
+  {
+    // the image is encoded in the format of the original
+    details.file = GetCacheFile(image) + URIUtils::GetExtension(original);
+    details.hash = hash;
+    details.width = width;
+    details.height = height;
+    // checked against the original at the same interval as other cached images
+    details.updateable = true;
+    path = GetCachedPath(details.file);
+
+    CFile file;
+    success = file.OpenForWrite(path, true) && file.Write(buffer, size) == static_cast<ssize_t>(size);
+    file.Close();
+    if (success)
+    {
+      AddCachedTexture(image, details);
+      ClearResizedImages(image, resized_images_to_keep);
+    }
+    else
+    {
+      CLog::Log(LOGERROR, "%s - unable to write %s", __FUNCTION__, path.c_str());
+      CFile::Delete(path);
+    }
+  }
+  delete[] buffer;
+
+  {
+    CSingleLock lock(m_processingSection);
+    m_processinglist.erase(image);
+    m_resizedCondition.notifyAll();
+  }
+
+  return success ? path : "";
+}
+
+std::string CTextureCache::GetResizedImage(const std::string &image, std::string &hash, bool &needsCheck)
+{
+  CTextureDetails details;
+  std::string path = GetCachedImage(image, details, true);
+  if (path.empty())
+    return "";
+
+  hash = GetCachedTextureHash(image);
+  needsCheck = !details.hash.empty() || hash.empty();
+  return path;
+}
+
+void CTextureCache::ClearResizedImages(const std::string &image, size_t keep)
+{
+  size_t options = image.find('?');
+  if (options == std::string::npos)
+    return;
+
+  std::vector<std::pair<int, std::string>> textures;
+  if (!GetCachedTextures(image.substr(0, options + 1), textures))
+    return;
+
+  // only resized versions carry a width or height, other options belong to the GUI's thumbs
+  size_t resized = 0;
+  for (const auto &texture : textures)
+  {
+    CURL url(texture.second);
+    if (!url.HasOption("width") && !url.HasOption("height"))
+      continue;
+    if (++resized > keep)
+      ClearCachedImage(texture.first);
+  }
+}
+
 void CTextureCache::ClearCachedImage(const std::string &url, bool deleteSource /*= false */)
 {
   //! @todo This can be removed when the texture cache covers everything.
@@ -213,6 +333,18 @@ bool CTextureCache::GetCachedTexture(const std::string &url, CTextureDetails &de
   return m_database.GetCachedTexture(url, details);
 }
 
+std::string CTextureCache::GetCachedTextureHash(const std::string &url)
+{
+  CSingleLock lock(m_databaseSection);
+  return m_database.GetCachedTextureHash(url);
+}
+
+bool CTextureCache::GetCachedTextures(const std::string &prefix, std::vector<std::pair<int, std::string>> &textures)
+{
+  CSingleLock lock(m_databaseSection);
+  return m_database.GetCachedTextures(prefix, textures);
+}
+
 bool CTextureCache::AddCachedTexture(const std::string &url, const CTextureDetails &details)
 {
   CSingleLock lock(m_databaseSection);
@@ -278,6 +410,7 @@ void CTextureCache::OnCachingComplete(bool success, CTextureCacheJob *job)
     std::set<std::string>::iterator i = m_processinglist.find(job->m_url);
     if (i != m_processinglist.end())
       m_processinglist.erase(i);
+    m_resizedCondition.notifyAll();
   }
 
   m_completeEvent.Set();
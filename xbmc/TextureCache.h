@@ -22,9 +22,11 @@
 
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 #include "utils/JobManager.h"
 #include "TextureDatabase.h"
+#include "threads/Condition.h"
 #include "threads/Event.h"
 
 class CURL;
@@ -100,6 +102,27 @@ public:
    */
   bool CacheImage(const std::string &image, CTextureDetails &details);
 
+  /*! \brief Resize an image, reusing an earlier resize of the same version of the image.
+   Unlike CacheImage() the image is resized to exactly the requested size and not limited to
+   the sizes used by the GUI. Concurrent calls for the same image wait for a single resize.
+   A resize of an earlier version of the image is replaced and only the most recently used
+   resized versions of each image are kept.
+   \param image url of the image including the width, height and scaling_algorithm options
+   \param hash hash of the original image as given by CTextureCacheJob::GetImageHash
+   \return full path of the resized image, empty if it couldn't be resized or the hash is empty
+   \sa CTextureCacheJob::ResizeTexture
+   */
+  std::string CacheResizedImage(const std::string &image, const std::string &hash);
+
+  /*! \brief Look up an earlier resize of an image without accessing the original image.
+   \param image url of the image including the width, height and scaling_algorithm options
+   \param hash [out] hash of the original image the resize was made from
+   \param needsCheck [out] whether the original image is due to be checked for changes
+   \return full path of the resized image, empty if it hasn't been resized
+   \sa CacheResizedImage
+   */
+  std::string GetResizedImage(const std::string &image, std::string &hash, bool &needsCheck);
+
   /*! \brief Check whether an image is in the cache
    Note: If the image url won't normally be cached (eg a skin image) this function will return false.
    \param image url of the image
@@ -194,6 +217,29 @@ private:
   bool ClearCachedTexture(const std::string &url, std::string &cacheFile);
   bool ClearCachedTexture(int textureID, std::string &cacheFile);
 
+  /*! \brief Get the hash stored with an image in the database
+   Thread-safe wrapper of CTextureDatabase::GetCachedTextureHash
+   \param image url of the original image
+   \return the stored hash, empty if the image isn't cached
+   */
+  std::string GetCachedTextureHash(const std::string &url);
+
+  /*! \brief Get the images in the database whose url starts with the given prefix
+   Thread-safe wrapper of CTextureDatabase::GetCachedTextures
+   \param prefix start of the urls of the original images
+   \param textures [out] id and url of each image, most recently used first
+   \return true if successful, false otherwise.
+   */
+  bool GetCachedTextures(const std::string &prefix, std::vector<std::pair<int, std::string>> &textures);
+
+  /*! \brief Remove the least recently used resized versions of an image
+   Keeps the given number of resized versions of the image that the given resized image belongs to.
+   \param image url of a resized image including the width, height and scaling_algorithm options
+   \param keep number of resized versions to keep
+   \sa CacheResizedImage
+   */
+  void ClearResizedImages(const std::string &image, size_t keep);
+
   /*! \brief Increment the use count of a texture
    Stores locally before calling CTextureDatabase::IncrementUseCount via a CUseCountJob
    \sa CUseCountJob, CTextureDatabase::IncrementUseCount
@@ -224,6 +270,7 @@ private:
   std::set<std::string> m_processinglist; ///< currently processing list to avoid 2 jobs being processed at once
   CCriticalSection     m_processingSection;
   CEvent               m_completeEvent; ///< Set whenever a job has finished
+  XbmcThreads::ConditionVariable m_resizedCondition; ///< Notified whenever a resize or caching job has finished
   std::vector<CTextureDetails> m_useCounts; ///< Use count tracking
   CCriticalSection             m_useCountSection;
 };
@@ -89,12 +89,16 @@ bool CTextureCacheJob::CacheTexture(CBaseTexture **out_texture)
   else if (m_details.hash == m_oldHash)
     return true;
 
+  // decode no larger than what ends up in the cache
+  uint32_t decodeWidth = width, decodeHeight = height;
+  CPicture::GetMaxCacheSize(decodeWidth, decodeHeight);
+
   CBaseTexture *texture = nullptr;
   if (additional_info == "music")
   { // special case for embedded music images
     MUSIC_INFO::EmbeddedArt art;
     if (CMusicThumbLoader::GetEmbeddedThumb(image, art))
-      texture = CBaseTexture::LoadFromFileInMemory(&art.data[0], art.size, art.mime, width, height);
+      texture = CBaseTexture::LoadFromFileInMemory(&art.data[0], art.size, art.mime, decodeWidth, decodeHeight);
   }
   else
   {
@@ -127,7 +131,7 @@ bool CTextureCacheJob::CacheTexture(CBaseTexture **out_texture)
       }
 #endif
       texture = new CTexture();
-      if (!(texture->LoadFromFileInternal(image, buf, width, height, true, file.GetMimeType())))
+      if (!(texture->LoadFromFileInternal(image, buf, decodeWidth, decodeHeight, true, file.GetMimeType())))
       {
         delete texture;
         texture = nullptr;
@@ -168,16 +172,22 @@ bool CTextureCacheJob::CacheTexture(CBaseTexture **out_texture)
 }
 
 bool CTextureCacheJob::ResizeTexture(const std::string &url, uint8_t* &result, size_t &result_size)
+{
+  unsigned int width, height;
+  return ResizeTexture(url, result, result_size, width, height);
+}
+
+bool CTextureCacheJob::ResizeTexture(const std::string &url, uint8_t* &result, size_t &result_size, unsigned int &width, unsigned int &height)
 {
   result = NULL;
   result_size = 0;
+  width = height = 0;
 
   if (url.empty())
     return false;
 
   // unwrap the URL as required
   std::string additional_info;
-  unsigned int width, height;
   CPictureScalingAlgorithm::Algorithm scalingAlgorithm;
   std::string image = DecodeImageURL(url, width, height, scalingAlgorithm, additional_info);
   if (image.empty())
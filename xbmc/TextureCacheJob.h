@@ -80,11 +80,12 @@ public:
   bool CacheTexture(CBaseTexture **texture = NULL);
 
   static bool ResizeTexture(const std::string &url, uint8_t* &result, size_t &result_size);
+  /*! \brief Resize the image at the given url, returning the size it was actually resized to
+   \param width [out] width of the resized image
+   \param height [out] height of the resized image
+   */
+  static bool ResizeTexture(const std::string &url, uint8_t* &result, size_t &result_size, unsigned int &width, unsigned int &height);
 
-  std::string m_url;
-  std::string m_oldHash;
-  CTextureDetails m_details;
-private:
   /*! \brief retrieve a hash for the given image
    Combines the size, ctime and mtime of the image file into a "unique" hash
    \param url location of the image
@@ -92,15 +93,6 @@ private:
    */
   static std::string GetImageHash(const std::string &url);
 
-  /*! \brief Check whether a given URL represents an image that can be updated
-   We currently don't check http:// and https:// URLs for updates, under the assumption that
-   a image URL is much more likely to be static and the actual image at the URL is unlikely
-   to change, so no point checking all the time.
-   \param url the url to check
-   \return true if the image given by the URL should be checked for updates, false otherwise
-   */
-  bool UpdateableURL(const std::string &url) const;
-
   /*! \brief Decode an image URL to the underlying image, width, height and orientation
    \param url wrapped URL of the image
    \param width width derived from URL
@@ -111,6 +103,19 @@ private:
    */
   static std::string DecodeImageURL(const std::string &url, unsigned int &width, unsigned int &height, CPictureScalingAlgorithm::Algorithm& scalingAlgorithm, std::string &additional_info);
 
+  std::string m_url;
+  std::string m_oldHash;
+  CTextureDetails m_details;
+private:
+  /*! \brief Check whether a given URL represents an image that can be updated
+   We currently don't check http:// and https:// URLs for updates, under the assumption that
+   a image URL is much more likely to be static and the actual image at the URL is unlikely
+   to change, so no point checking all the time.
+   \param url the url to check
+   \return true if the image given by the URL should be checked for updates, false otherwise
+   */
+  bool UpdateableURL(const std::string &url) const;
+
   /*! \brief Load an image at a given target size and orientation.
 
    Doesn't necessarily load the image at the desired size - the loader *may* decide to load it slightly larger
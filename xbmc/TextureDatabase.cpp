@@ -278,6 +278,38 @@ bool CTextureDatabase::GetCachedTexture(const std::string &url, CTextureDetails
   return false;
 }
 
+std::string CTextureDatabase::GetCachedTextureHash(const std::string &url)
+{
+  return GetSingleValue(PrepareSQL("SELECT imagehash FROM texture WHERE url='%s'", url.c_str()));
+}
+
+bool CTextureDatabase::GetCachedTextures(const std::string &prefix, std::vector<std::pair<int, std::string>> &textures)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    // urls may contain '%' and '_' so compare the prefix instead of using LIKE
+    std::string sql = PrepareSQL("SELECT id, url FROM texture JOIN sizes ON (texture.id=sizes.idtexture AND sizes.size=1) WHERE substr(url,1,%u)='%s' ORDER BY lastusetime DESC, id DESC", static_cast<unsigned int>(prefix.size()), prefix.c_str());
+    if (!m_pDS->query(sql))
+      return false;
+
+    while (!m_pDS->eof())
+    {
+      textures.emplace_back(m_pDS->fv(0).get_asInt(), m_pDS->fv(1).get_asString());
+      m_pDS->next();
+    }
+    m_pDS->close();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s, failed on prefix '%s'", __FUNCTION__, prefix.c_str());
+  }
+  return false;
+}
+
 bool CTextureDatabase::GetTextures(CVariant &items, const Filter &filter)
 {
   try
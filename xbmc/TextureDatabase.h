@@ -22,6 +22,7 @@
 
 #include <string>
 #include <vector>
+#include <utility>
 
 #include "dbwrappers/Database.h"
 #include "TextureCacheJob.h"
@@ -81,6 +82,19 @@ public:
   bool ClearCachedTexture(int textureID, std::string &cacheFile);
   bool IncrementUseCount(const CTextureDetails &details);
 
+  /*! \brief Get the hash stored with a cached texture
+   Unlike GetCachedTexture the hash is returned regardless of when it was last checked.
+   \param url texture path
+   \return the stored hash, empty if the texture isn't cached
+   */
+  std::string GetCachedTextureHash(const std::string &originalURL);
+
+  /*! \brief Get the cached textures whose path starts with the given prefix
+   \param prefix start of the texture paths
+   \param textures [out] id and path of each texture, most recently used first
+   */
+  bool GetCachedTextures(const std::string &prefix, std::vector<std::pair<int, std::string>> &textures);
+
   /*! \brief Invalidate a previously cached texture
    Invalidates the texture hash, and sets the texture update time to the current time so that
    next texture load it will be re-cached.
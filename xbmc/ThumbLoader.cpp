@@ -22,11 +22,12 @@
 #include "filesystem/File.h"
 #include "FileItem.h"
 #include "TextureCache.h"
+#include "threads/SingleLock.h"
 
 using namespace XFILE;
 
-CThumbLoader::CThumbLoader() :
-  CBackgroundInfoLoader()
+CThumbLoader::CThumbLoader(unsigned int workers /* = 1 */) :
+  CBackgroundInfoLoader(workers)
 {
   m_textureDatabase = new CTextureDatabase();
 }
@@ -48,6 +49,7 @@ void CThumbLoader::OnLoaderFinish()
 
 std::string CThumbLoader::GetCachedImage(const CFileItem &item, const std::string &type)
 {
+  CSingleLock lock(m_textureSection);
   if (!item.GetPath().empty() && m_textureDatabase->Open())
   {
     std::string image = m_textureDatabase->GetTextureForPath(item.GetPath(), type);
@@ -59,6 +61,7 @@ std::string CThumbLoader::GetCachedImage(const CFileItem &item, const std::strin
 
 void CThumbLoader::SetCachedImage(const CFileItem &item, const std::string &type, const std::string &image)
 {
+  CSingleLock lock(m_textureSection);
   if (!item.GetPath().empty() && m_textureDatabase->Open())
   {
     m_textureDatabase->SetTextureForPath(item.GetPath(), type, image);
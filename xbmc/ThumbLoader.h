@@ -24,10 +24,13 @@
 
 class CTextureDatabase;
 
+// threads the video and music thumb loaders look up items with
+#define THUMB_LOADER_WORKERS 4
+
 class CThumbLoader : public CBackgroundInfoLoader
 {
 public:
-  CThumbLoader();
+  explicit CThumbLoader(unsigned int workers = 1);
   ~CThumbLoader() override;
 
   void OnLoaderStart() override;
@@ -55,6 +58,7 @@ public:
 
 protected:
   CTextureDatabase *m_textureDatabase;
+  CCriticalSection m_textureSection;
 };
 
 class CProgramThumbLoader : public CThumbLoader
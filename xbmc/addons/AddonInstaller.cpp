@@ -619,13 +619,7 @@ bool CAddonInstallJob::DoWork()
 
   ADDON::OnPostInstall(m_addon, m_isUpdate, IsModal());
 
-  {
-    CAddonDatabase database;
-    database.Open();
-    database.SetOrigin(m_addon->ID(), m_repo ? m_repo->ID() : "");
-    if (m_isUpdate)
-      database.SetLastUpdated(m_addon->ID(), CDateTime::GetCurrentDateTime());
-  }
+  CAddonMgr::GetInstance().SetInstallOrigin(m_addon->ID(), m_repo ? m_repo->ID() : "", m_isUpdate);
 
   bool notify = (CServiceBroker::GetSettings().GetBool(CSettings::SETTING_ADDONS_NOTIFICATIONS)
         || !m_isAutoUpdate) && !IsModal();
@@ -247,7 +247,8 @@ static bool LoadManifest(std::set<std::string>& system, std::set<std::string>& o
 
 CAddonMgr::CAddonMgr()
   : m_cp_context(nullptr),
-  m_cpluff(nullptr)
+  m_cpluff(nullptr),
+  m_manifests("special://temp/addonmanifests.idx")
 { }
 
 CAddonMgr::~CAddonMgr()
@@ -287,7 +288,7 @@ void CAddonMgr::UnregisterAddonMgrCallback(TYPE type)
 bool CAddonMgr::Init()
 {
   CSingleLock lock(m_critSection);
-  m_cpluff = std::unique_ptr<DllLibCPluff>(new DllLibCPluff);
+  m_cpluff = std::make_shared<DllLibCPluff>();
   m_cpluff->Load();
 
   if (!m_cpluff->IsLoaded())
@@ -309,25 +310,22 @@ bool CAddonMgr::Init()
   //! @todo could separate addons into different contexts would allow partial unloading of addon framework
   m_cp_context = m_cpluff->create_context(&status);
   assert(m_cp_context);
-  status = m_cpluff->register_pcollection(m_cp_context, CSpecialProtocol::TranslatePath("special://home/addons").c_str());
-  if (status != CP_OK)
+  std::shared_ptr<DllLibCPluff> cpluff = m_cpluff;
+  m_context.reset(m_cp_context, [cpluff](cp_context_t* context){ cpluff->destroy_context(context); });
+  m_addonDirectories.clear();
+  for (const char* path : { "special://home/addons", "special://xbmc/addons", "special://xbmcbin/addons" })
   {
-    CLog::Log(LOGERROR, "ADDONS: Fatal Error, cp_register_pcollection() returned status: %i", status);
-    return false;
-  }
-
-  status = m_cpluff->register_pcollection(m_cp_context, CSpecialProtocol::TranslatePath("special://xbmc/addons").c_str());
-  if (status != CP_OK)
-  {
-    CLog::Log(LOGERROR, "ADDONS: Fatal Error, cp_register_pcollection() returned status: %i", status);
-    return false;
-  }
+    std::string directory = CSpecialProtocol::TranslatePath(path);
+    if (std::find(m_addonDirectories.begin(), m_addonDirectories.end(), directory) != m_addonDirectories.end())
+      continue;
 
-  status = m_cpluff->register_pcollection(m_cp_context, CSpecialProtocol::TranslatePath("special://xbmcbin/addons").c_str());
-  if (status != CP_OK)
-  {
-    CLog::Log(LOGERROR, "ADDONS: Fatal Error, cp_register_pcollection() returned status: %i", status);
-    return false;
+    status = m_cpluff->register_pcollection(m_cp_context, directory.c_str());
+    if (status != CP_OK)
+    {
+      CLog::Log(LOGERROR, "ADDONS: Fatal Error, cp_register_pcollection() returned status: %i", status);
+      return false;
+    }
+    m_addonDirectories.push_back(std::move(directory));
   }
 
   status = m_cpluff->register_logger(m_cp_context, cp_logger,
@@ -373,11 +371,13 @@ bool CAddonMgr::Init()
 
 void CAddonMgr::DeInit()
 {
-  if (m_cpluff)
-  {
-    m_cpluff->destroy_context(m_cp_context);
-    m_cpluff.reset();
-  }
+  // the context is destroyed once the last registry a reader may still hold is gone
+  std::atomic_store(&m_registry, RegistryPtr());
+  if (m_context)
+    m_cpluff->unregister_logger(m_cp_context, cp_logger);
+  m_context.reset();
+  m_cp_context = nullptr;
+  m_cpluff.reset();
   m_database.Close();
 }
 
@@ -592,81 +592,170 @@ bool CAddonMgr::GetInstalledBinaryAddon(const std::string& addonId, BINARY_ADDON
   return ret;
 }
 
-bool CAddonMgr::GetAddonsInternal(const TYPE &type, VECADDONS &addons, bool enabledOnly)
+CAddonMgr::RegistryPtr CAddonMgr::GetRegistry() const
 {
-  CSingleLock lock(m_critSection);
-  if (!m_cp_context)
-    return false;
+  return std::atomic_load(&m_registry);
+}
 
-  std::vector<CAddonBuilder> builders;
-  m_database.GetInstalled(builders);
+void CAddonMgr::PublishRegistry()
+{
+  auto registry = std::make_shared<Registry>();
+  RegistryPtr previous = GetRegistry();
+  registry->version = previous ? previous->version + 1 : 1;
 
-  for (auto& builder : builders)
+  if (m_cpluff && m_cp_context)
   {
     cp_status_t status;
-    cp_plugin_info_t* cp_addon = m_cpluff->get_plugin_info(m_cp_context, builder.GetId().c_str(), &status);
-    if (status == CP_OK && cp_addon)
+    int n = 0;
+    cp_plugin_info_t** plugins = m_cpluff->get_plugins_info(m_cp_context, &status, &n);
+    std::map<std::string, const cp_plugin_info_t*> found;
+    if (status == CP_OK && plugins)
     {
-      if (enabledOnly && IsAddonDisabled(cp_addon->identifier))
-      {
-        m_cpluff->release_info(m_cp_context, cp_addon);
-        continue;
-      }
+      std::shared_ptr<DllLibCPluff> cpluff = m_cpluff;
+      std::shared_ptr<cp_context_t> context = m_context;
+      registry->plugins.reset(plugins, [cpluff, context](cp_plugin_info_t** plugins){ cpluff->release_info(context.get(), plugins); });
+      for (int i = 0; i < n; ++i)
+        found.insert(std::make_pair(plugins[i]->identifier, plugins[i]));
+    }
 
-      //FIXME: hack for skipping special dependency addons (xbmc.python etc.).
-      //Will break if any extension point is added to them
-      cp_extension_t *props = GetFirstExtPoint(cp_addon, type);
-      if (props == nullptr)
+    auto add = [&registry](const CAddonBuilder& metadata, const cp_plugin_info_t* plugin, bool listed)
+    {
+      RegistryEntry entry;
+      entry.listed = listed;
+      entry.hasExtPoint = GetFirstExtPoint(plugin, ADDON_UNKNOWN) != nullptr;
+
+      CAddonBuilder builder(metadata);
+      if (Factory(plugin, ADDON_UNKNOWN, builder))
+        entry.builders.emplace(ADDON_UNKNOWN, std::move(builder));
+      for (unsigned int i = 0; i < plugin->num_extensions; ++i)
       {
-        m_cpluff->release_info(m_cp_context, cp_addon);
-        continue;
+        TYPE type = CAddonInfo::TranslateType(plugin->extensions[i].ext_point_id);
+        if (type == ADDON_UNKNOWN || entry.builders.find(type) != entry.builders.end())
+          continue;
+        CAddonBuilder builder(metadata);
+        if (Factory(plugin, type, builder))
+          entry.builders.emplace(type, std::move(builder));
       }
 
-      AddonPtr addon;
-      if (Factory(cp_addon, type, builder))
-        addon = builder.Build();
-      m_cpluff->release_info(m_cp_context, cp_addon);
-
-      if (addon)
+      size_t index = registry->addons.size();
+      registry->byId[plugin->identifier] = index;
+      if (listed && entry.hasExtPoint)
       {
-        // if the addon has a running instance, grab that
-        AddonPtr runningAddon = addon->GetRunningInstance();
-        if (runningAddon)
-          addon = runningAddon;
-        addons.emplace_back(std::move(addon));
+        for (const auto& builder : entry.builders)
+        {
+          if (builder.first != ADDON_UNKNOWN)
+            registry->byType[builder.first].push_back(index);
+        }
       }
+      registry->addons.emplace_back(plugin->identifier, std::move(entry));
+    };
+
+    // the installed table decides the order add-ons are listed in
+    std::vector<CAddonBuilder> installed;
+    m_database.GetInstalled(installed);
+    for (const auto& metadata : installed)
+    {
+      auto it = found.find(metadata.GetId());
+      if (it == found.end())
+        continue;
+      add(metadata, it->second, true);
+      found.erase(it);
     }
+    for (const auto& it : found)
+      add(CAddonBuilder(), it.second, false);
+
+    m_database.GetDisabled(registry->disabled);
+    m_database.GetBlacklisted(registry->blacklisted);
   }
-  return addons.size() > 0;
+
+  CLog::Log(LOGDEBUG, "CAddonMgr: published registry %u with %u add-ons", registry->version, static_cast<unsigned int>(registry->addons.size()));
+  std::atomic_store(&m_registry, RegistryPtr(std::move(registry)));
 }
 
-bool CAddonMgr::GetAddon(const std::string &str, AddonPtr &addon, const TYPE &type/*=ADDON_UNKNOWN*/, bool enabledOnly /*= true*/)
+void CAddonMgr::UpdateRegistry(const std::function<void(Registry&)>& update)
 {
-  CSingleLock lock(m_critSection);
+  RegistryPtr current = GetRegistry();
+  if (!current)
+    return;
 
-  cp_status_t status;
-  cp_plugin_info_t *cpaddon = m_cpluff->get_plugin_info(m_cp_context, str.c_str(), &status);
-  if (status == CP_OK && cpaddon)
+  auto registry = std::make_shared<Registry>(*current);
+  registry->version++;
+  update(*registry);
+  std::atomic_store(&m_registry, RegistryPtr(std::move(registry)));
+}
+
+AddonPtr CAddonMgr::BuildAddon(const RegistryEntry& entry, TYPE type)
+{
+  auto it = entry.builders.find(type);
+  if (it == entry.builders.end())
+    return nullptr;
+
+  CAddonBuilder builder(it->second);
+  AddonPtr addon = builder.Build();
+  if (addon)
+  {
+    // if the addon has a running instance, grab that
+    AddonPtr runningAddon = addon->GetRunningInstance();
+    if (runningAddon)
+      addon = runningAddon;
+  }
+  return addon;
+}
+
+bool CAddonMgr::GetAddonsInternal(const TYPE &type, VECADDONS &addons, bool enabledOnly)
+{
+  RegistryPtr registry = GetRegistry();
+  if (!registry)
+    return false;
+
+  auto build = [&](size_t index)
   {
-    addon = Factory(cpaddon, type);
-    m_cpluff->release_info(m_cp_context, cpaddon);
+    const auto& installed = registry->addons[index];
+    if (enabledOnly && registry->disabled.find(installed.first) != registry->disabled.end())
+      return;
 
+    AddonPtr addon = BuildAddon(installed.second, type);
     if (addon)
-    {
-      if (enabledOnly && IsAddonDisabled(addon->ID()))
-        return false;
+      addons.emplace_back(std::move(addon));
+  };
 
-      // if the addon has a running instance, grab that
-      AddonPtr runningAddon = addon->GetRunningInstance();
-      if (runningAddon)
-        addon = runningAddon;
+  if (type == ADDON_UNKNOWN)
+  {
+    //FIXME: hack for skipping special dependency addons (xbmc.python etc.).
+    //Will break if any extension point is added to them
+    for (size_t i = 0; i < registry->addons.size(); ++i)
+    {
+      if (registry->addons[i].second.listed && registry->addons[i].second.hasExtPoint)
+        build(i);
+    }
+  }
+  else
+  {
+    auto it = registry->byType.find(type);
+    if (it != registry->byType.end())
+    {
+      for (size_t index : it->second)
+        build(index);
     }
-    return NULL != addon.get();
   }
-  if (cpaddon)
-    m_cpluff->release_info(m_cp_context, cpaddon);
+  return addons.size() > 0;
+}
 
-  return false;
+bool CAddonMgr::GetAddon(const std::string &str, AddonPtr &addon, const TYPE &type/*=ADDON_UNKNOWN*/, bool enabledOnly /*= true*/)
+{
+  RegistryPtr registry = GetRegistry();
+  if (!registry)
+    return false;
+
+  auto it = registry->byId.find(str);
+  if (it == registry->byId.end())
+    return false;
+
+  if (enabledOnly && registry->disabled.find(str) != registry->disabled.end())
+    return false;
+
+  addon = BuildAddon(registry->addons[it->second].second, type);
+  return NULL != addon.get();
 }
 
 bool CAddonMgr::FindAddons()
@@ -676,7 +765,11 @@ bool CAddonMgr::FindAddons()
   if (m_cpluff && m_cp_context)
   {
     result = true;
-    m_cpluff->scan_plugins(m_cp_context, CP_SP_UPGRADE);
+    // only parse the descriptors that changed since they were last seen
+    auto start = XbmcThreads::SystemClockMillis();
+    if (!m_manifests.Scan(*m_cpluff, m_cp_context, m_addonDirectories))
+      m_cpluff->scan_plugins(m_cp_context, CP_SP_UPGRADE);
+    CLog::Log(LOGDEBUG, "CAddonMgr::FindAddons scan took %i ms", XbmcThreads::SystemClockMillis() - start);
 
     //Sync with db
     {
@@ -690,14 +783,7 @@ bool CAddonMgr::FindAddons()
       m_database.SyncInstalled(installed, m_systemAddons, m_optionalAddons);
     }
 
-    // Reload caches
-    std::set<std::string> tmp;
-    m_database.GetDisabled(tmp);
-    m_disabled = std::move(tmp);
-
-    tmp.clear();
-    m_database.GetBlacklisted(tmp);
-    m_updateBlacklist = std::move(tmp);
+    PublishRegistry();
 
     m_events.Publish(AddonEvents::InstalledChanged());
   }
@@ -712,6 +798,7 @@ bool CAddonMgr::UnloadAddon(const AddonPtr& addon)
   {
     if (m_cpluff->uninstall_plugin(m_cp_context, addon->ID().c_str()) == CP_OK)
     {
+      PublishRegistry();
       m_events.Publish(AddonEvents::InstalledChanged());
       m_events.Publish(AddonEvents::UnInstalled(addon->ID()));
       return true;
@@ -759,8 +846,11 @@ bool CAddonMgr::ReloadAddon(AddonPtr& addon)
 void CAddonMgr::OnPostUnInstall(const std::string& id)
 {
   CSingleLock lock(m_critSection);
-  m_disabled.erase(id);
-  m_updateBlacklist.erase(id);
+  UpdateRegistry([&id](Registry& registry)
+  {
+    registry.disabled.erase(id);
+    registry.blacklisted.erase(id);
+  });
 }
 
 bool CAddonMgr::RemoveFromUpdateBlacklist(const std::string& id)
@@ -768,7 +858,10 @@ bool CAddonMgr::RemoveFromUpdateBlacklist(const std::string& id)
   CSingleLock lock(m_critSection);
   if (!IsBlacklisted(id))
     return true;
-  return m_database.RemoveAddonFromBlacklist(id) && m_updateBlacklist.erase(id) > 0;
+  if (!m_database.RemoveAddonFromBlacklist(id))
+    return false;
+  UpdateRegistry([&id](Registry& registry) { registry.blacklisted.erase(id); });
+  return true;
 }
 
 bool CAddonMgr::AddToUpdateBlacklist(const std::string& id)
@@ -776,13 +869,16 @@ bool CAddonMgr::AddToUpdateBlacklist(const std::string& id)
   CSingleLock lock(m_critSection);
   if (IsBlacklisted(id))
     return true;
-  return m_database.BlacklistAddon(id) && m_updateBlacklist.insert(id).second;
+  if (!m_database.BlacklistAddon(id))
+    return false;
+  UpdateRegistry([&id](Registry& registry) { registry.blacklisted.insert(id); });
+  return true;
 }
 
 bool CAddonMgr::IsBlacklisted(const std::string& id) const
 {
-  CSingleLock lock(m_critSection);
-  return m_updateBlacklist.find(id) != m_updateBlacklist.end();
+  RegistryPtr registry = GetRegistry();
+  return registry && registry->blacklisted.find(id) != registry->blacklisted.end();
 }
 
 void CAddonMgr::UpdateLastUsed(const std::string& id)
@@ -791,12 +887,47 @@ void CAddonMgr::UpdateLastUsed(const std::string& id)
   CJobManager::GetInstance().Submit([this, id, time](){
     {
       CSingleLock lock(m_critSection);
-      m_database.SetLastUsed(id, time);
+      if (m_database.SetLastUsed(id, time))
+      {
+        UpdateRegistry([&id, &time](Registry& registry)
+        {
+          auto it = registry.byId.find(id);
+          if (it != registry.byId.end())
+          {
+            for (auto& builder : registry.addons[it->second].second.builders)
+              builder.second.SetLastUsed(time);
+          }
+        });
+      }
     }
     m_events.Publish(AddonEvents::MetadataChanged(id));
   });
 }
 
+void CAddonMgr::SetInstallOrigin(const std::string& id, const std::string& origin, bool updated)
+{
+  CDateTime time = CDateTime::GetCurrentDateTime();
+  {
+    CSingleLock lock(m_critSection);
+    bool setOrigin = m_database.SetOrigin(id, origin);
+    bool setUpdated = updated && m_database.SetLastUpdated(id, time);
+    UpdateRegistry([&](Registry& registry)
+    {
+      auto it = registry.byId.find(id);
+      if (it == registry.byId.end())
+        return;
+      for (auto& builder : registry.addons[it->second].second.builders)
+      {
+        if (setOrigin)
+          builder.second.SetOrigin(origin);
+        if (setUpdated)
+          builder.second.SetLastUpdated(time);
+      }
+    });
+  }
+  m_events.Publish(AddonEvents::MetadataChanged(id));
+}
+
 static void ResolveDependencies(const std::string& addonId, std::vector<std::string>& needed, std::vector<std::string>& missing)
 {
   if (std::find(needed.begin(), needed.end(), addonId) != needed.end())
@@ -819,12 +950,11 @@ bool CAddonMgr::DisableAddon(const std::string& id)
   CSingleLock lock(m_critSection);
   if (!CanAddonBeDisabled(id))
     return false;
-  if (m_disabled.find(id) != m_disabled.end())
+  if (IsAddonDisabled(id))
     return true; //already disabled
   if (!m_database.DisableAddon(id))
     return false;
-  if (!m_disabled.insert(id).second)
-    return false;
+  UpdateRegistry([&id](Registry& registry) { registry.disabled.insert(id); });
 
   //success
   AddonPtr addon;
@@ -842,7 +972,7 @@ bool CAddonMgr::EnableSingle(const std::string& id)
 {
   CSingleLock lock(m_critSection);
 
-  if (m_disabled.find(id) == m_disabled.end())
+  if (!IsAddonDisabled(id))
     return true; //already enabled
 
   AddonPtr addon;
@@ -858,7 +988,7 @@ bool CAddonMgr::EnableSingle(const std::string& id)
 
   if (!m_database.DisableAddon(id, false))
     return false;
-  m_disabled.erase(id);
+  UpdateRegistry([&id](Registry& registry) { registry.disabled.erase(id); });
   ADDON::OnEnabled(addon);
 
   CEventLog::GetInstance().Add(EventPtr(new CAddonManagementEvent(addon, 24064)));
@@ -886,8 +1016,8 @@ bool CAddonMgr::EnableAddon(const std::string& id)
 
 bool CAddonMgr::IsAddonDisabled(const std::string& ID)
 {
-  CSingleLock lock(m_critSection);
-  return m_disabled.find(ID) != m_disabled.end();
+  RegistryPtr registry = GetRegistry();
+  return registry && registry->disabled.find(ID) != registry->disabled.end();
 }
 
 bool CAddonMgr::CanAddonBeDisabled(const std::string& ID)
@@ -21,16 +21,23 @@
 
 #include "Addon.h"
 #include "AddonDatabase.h"
+#include "AddonManifestIndex.h"
 #include "Repository.h"
 #include "threads/CriticalSection.h"
 #include "utils/EventStream.h"
 
+#include <functional>
+#include <memory>
+#include <unordered_map>
+
 class DllLibCPluff;
 extern "C"
 {
 #include "lib/cpluff/libcpluff/cpluff.h"
 }
 
+class TestAddonRegistryHelper;
+
 namespace ADDON
 {
   typedef std::map<TYPE, VECADDONS> MAPADDONS;
@@ -71,6 +78,8 @@ namespace ADDON
   */
   class CAddonMgr
   {
+    friend class ::TestAddonRegistryHelper;
+
   public:
     static CAddonMgr &GetInstance();
     bool ReInit() { DeInit(); return Init(); }
@@ -228,6 +237,13 @@ namespace ADDON
 
     void UpdateLastUsed(const std::string& id);
 
+    /*! \brief Records the repository an add-on was installed from and, for updates, when.
+     \param id id of the addon
+     \param origin id of the repository, empty if installed from a zip
+     \param updated whether this was an update of an installed add-on
+     */
+    void SetInstallOrigin(const std::string& id, const std::string& origin, bool updated);
+
     /* libcpluff */
     std::string GetExtValue(cp_cfg_element_t *base, const char *path) const;
 
@@ -294,7 +310,10 @@ namespace ADDON
   private:
     /* libcpluff */
     cp_context_t *m_cp_context;
-    std::unique_ptr<DllLibCPluff> m_cpluff;
+    std::shared_ptr<DllLibCPluff> m_cpluff;
+    std::shared_ptr<cp_context_t> m_context; // owns m_cp_context, registries hold on to it for their descriptors
+    std::vector<std::string> m_addonDirectories;
+    CAddonManifestIndex m_manifests;
     VECADDONS    m_updateableAddons;
 
     /*! \brief Check whether this addon is supported on the current platform
@@ -303,11 +322,50 @@ namespace ADDON
      */
     static bool PlatformSupportsAddon(const cp_plugin_info_t *info);
 
+    /*! \brief An installed add-on, ready to be built as any of the types it provides.
+     */
+    struct RegistryEntry
+    {
+      bool listed = false; // in the installed table, others are only found by id
+      bool hasExtPoint = false;
+      std::map<TYPE, CAddonBuilder> builders; // ADDON_UNKNOWN builds the first extension point
+    };
+
+    /*! \brief The installed add-ons and their state at one point in time.
+     A registry is never changed once published. Add-ons being found, enabled or
+     disabled publish a new one, so readers neither lock nor touch the database.
+     Instances are still built per call as callers modify the add-ons they get.
+     */
+    struct Registry
+    {
+      unsigned int version = 0;
+      std::shared_ptr<cp_plugin_info_t*> plugins; // the descriptors the builders point into
+      std::vector<std::pair<std::string, RegistryEntry>> addons; // in database order
+      std::unordered_map<std::string, size_t> byId;
+      std::map<TYPE, std::vector<size_t>> byType;
+      std::set<std::string> disabled;
+      std::set<std::string> blacklisted;
+    };
+    typedef std::shared_ptr<const Registry> RegistryPtr;
+
+    RegistryPtr GetRegistry() const;
+
+    /*! \brief Rebuild the registry from cpluff and the database and publish it.
+     Must be called with m_critSection held.
+     */
+    void PublishRegistry();
+
+    /*! \brief Publish a copy of the current registry changed by the given function.
+     Must be called with m_critSection held.
+     */
+    void UpdateRegistry(const std::function<void(Registry&)>& update);
+
+    static AddonPtr BuildAddon(const RegistryEntry& entry, TYPE type);
+
     bool GetAddonsInternal(const TYPE &type, VECADDONS &addons, bool enabledOnly);
     bool EnableSingle(const std::string& id);
 
-    std::set<std::string> m_disabled;
-    std::set<std::string> m_updateBlacklist;
+    RegistryPtr m_registry; // only accessed through std::atomic_load and std::atomic_store
     static std::map<TYPE, IAddonMgrCallback*> m_managers;
     CCriticalSection m_critSection;
     CAddonDatabase m_database;
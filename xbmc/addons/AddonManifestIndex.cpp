@@ -0,0 +1,300 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "AddonManifestIndex.h"
+#include "AddonVersion.h"
+#include "FileItem.h"
+#include "addons/DllLibCPluff.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "utils/log.h"
+#include "utils/URIUtils.h"
+
+#include <cstring>
+
+#define INDEX_MAGIC   "KAMI"
+#define INDEX_VERSION 1
+
+namespace ADDON
+{
+
+namespace
+{
+
+void Write(std::string& out, const void* data, size_t size)
+{
+  out.append(static_cast<const char*>(data), size);
+}
+
+template<typename T>
+void Write(std::string& out, T value)
+{
+  Write(out, &value, sizeof(value));
+}
+
+void Write(std::string& out, const std::string& value)
+{
+  Write(out, static_cast<uint32_t>(value.size()));
+  out.append(value);
+}
+
+bool Read(const char*& pos, const char* end, void* data, size_t size)
+{
+  if (static_cast<size_t>(end - pos) < size)
+    return false;
+  memcpy(data, pos, size);
+  pos += size;
+  return true;
+}
+
+template<typename T>
+bool Read(const char*& pos, const char* end, T& value)
+{
+  return Read(pos, end, &value, sizeof(value));
+}
+
+bool Read(const char*& pos, const char* end, std::string& value)
+{
+  uint32_t size;
+  if (!Read(pos, end, size) || static_cast<size_t>(end - pos) < size)
+    return false;
+  value.assign(pos, size);
+  pos += size;
+  return true;
+}
+
+// compares versions like the scan of cpluff, a missing version being the oldest
+bool IsNewer(const cp_plugin_info_t* plugin, const cp_plugin_info_t* than)
+{
+  if (than->version == nullptr)
+    return plugin->version != nullptr;
+  return plugin->version != nullptr && AddonVersion(plugin->version) > AddonVersion(than->version);
+}
+
+}
+
+CAddonManifestIndex::CAddonManifestIndex(std::string file)
+  : m_file(std::move(file))
+{
+}
+
+bool CAddonManifestIndex::Scan(DllLibCPluff& cpluff, cp_context_t* context, const std::vector<std::string>& directories)
+{
+  if (!m_loaded)
+  {
+    m_loaded = true;
+    if (!Load())
+      m_entries.clear();
+  }
+
+  m_reused = 0;
+  m_parsed = 0;
+  bool changed = false;
+  for (auto& entry : m_entries)
+    entry.second.seen = false;
+
+  // the most recent version of every add-on found
+  std::map<std::string, cp_plugin_info_t*> available;
+  bool result = true;
+  for (const auto& directory : directories)
+  {
+    if (!XFILE::CDirectory::Exists(directory, false))
+      continue;
+
+    CFileItemList items;
+    if (!XFILE::CDirectory::GetDirectory(directory, items, "/", XFILE::DIR_FLAG_NO_FILE_DIRS | XFILE::DIR_FLAG_BYPASS_CACHE))
+    {
+      CLog::Log(LOGERROR, "CAddonManifestIndex: could not read %s", directory.c_str());
+      result = false;
+      break;
+    }
+
+    for (const auto& item : items)
+    {
+      std::string path = item->GetPath();
+      URIUtils::RemoveSlashAtEnd(path);
+      if (!item->m_bIsFolder || URIUtils::GetFileName(path)[0] == '.')
+        continue;
+
+      cp_plugin_info_t* plugin = LoadDescriptor(cpluff, context, path, changed);
+      if (!plugin)
+        continue;
+
+      auto it = available.find(plugin->identifier);
+      if (it == available.end())
+        available.insert(std::make_pair(plugin->identifier, plugin));
+      else if (IsNewer(plugin, it->second))
+      {
+        cpluff.release_info(context, it->second);
+        it->second = plugin;
+      }
+      else
+        cpluff.release_info(context, plugin);
+    }
+  }
+
+  if (result)
+  {
+    std::map<std::string, cp_plugin_info_t*> installed;
+    cp_status_t status;
+    int count = 0;
+    cp_plugin_info_t** plugins = cpluff.get_plugins_info(context, &status, &count);
+    for (int i = 0; i < count; ++i)
+      installed.insert(std::make_pair(plugins[i]->identifier, plugins[i]));
+
+    for (const auto& it : available)
+    {
+      auto current = installed.find(it.first);
+      if (current != installed.end())
+      {
+        if (!IsNewer(it.second, current->second))
+          continue;
+        cpluff.uninstall_plugin(context, it.first.c_str());
+      }
+      if (cpluff.install_plugin(context, it.second) != CP_OK)
+        CLog::Log(LOGERROR, "CAddonManifestIndex: could not install %s", it.first.c_str());
+    }
+    if (plugins)
+      cpluff.release_info(context, plugins);
+
+    for (auto it = m_entries.begin(); it != m_entries.end();)
+    {
+      if (it->second.seen)
+        ++it;
+      else
+      {
+        it = m_entries.erase(it);
+        changed = true;
+      }
+    }
+  }
+
+  for (const auto& it : available)
+    cpluff.release_info(context, it.second);
+
+  if (changed && !Save())
+    CLog::Log(LOGWARNING, "CAddonManifestIndex: could not write %s", m_file.c_str());
+
+  CLog::Log(LOGDEBUG, "CAddonManifestIndex: %u add-on descriptors from the index, %u parsed", m_reused, m_parsed);
+  return result;
+}
+
+cp_plugin_info_t* CAddonManifestIndex::LoadDescriptor(DllLibCPluff& cpluff, cp_context_t* context, const std::string& path, bool& changed)
+{
+  struct __stat64 st;
+  if (XFILE::CFile::Stat(URIUtils::AddFileToFolder(path, "addon.xml"), &st) != 0)
+    return nullptr;
+
+  cp_status_t status;
+  auto it = m_entries.find(path);
+  if (it != m_entries.end() &&
+      it->second.mtime == static_cast<int64_t>(st.st_mtime) &&
+      it->second.ctime == static_cast<int64_t>(st.st_ctime) &&
+      it->second.size == static_cast<int64_t>(st.st_size))
+  {
+    const std::string& descriptor = it->second.descriptor;
+    cp_plugin_info_t* plugin = cpluff.load_plugin_descriptor_from_serialized(context, descriptor.c_str(), descriptor.size(), &status);
+    if (plugin)
+    {
+      it->second.seen = true;
+      m_reused++;
+      return plugin;
+    }
+  }
+
+  // unknown, changed or unreadable, entries not seen are dropped after the scan
+  cp_plugin_info_t* plugin = cpluff.load_plugin_descriptor(context, path.c_str(), &status);
+  if (!plugin)
+    return nullptr;
+  m_parsed++;
+
+  Entry& entry = m_entries[path];
+  entry.mtime = st.st_mtime;
+  entry.ctime = st.st_ctime;
+  entry.size = st.st_size;
+  entry.descriptor.assign(cpluff.serialize_plugin_descriptor(plugin, nullptr, 0), '\0');
+  cpluff.serialize_plugin_descriptor(plugin, &entry.descriptor[0], entry.descriptor.size());
+  entry.seen = true;
+  changed = true;
+  return plugin;
+}
+
+bool CAddonManifestIndex::Load()
+{
+  XFILE::CFile file;
+  XFILE::auto_buffer buffer;
+  if (!XFILE::CFile::Exists(m_file) || file.LoadFile(m_file, buffer) <= 0)
+    return false;
+
+  const char* pos = buffer.get();
+  const char* end = pos + buffer.size();
+  char magic[4];
+  uint32_t version;
+  uint32_t count;
+  if (!Read(pos, end, magic, sizeof(magic)) || memcmp(magic, INDEX_MAGIC, sizeof(magic)) != 0 ||
+      !Read(pos, end, version) || version != INDEX_VERSION ||
+      !Read(pos, end, count))
+  {
+    CLog::Log(LOGDEBUG, "CAddonManifestIndex: ignoring %s written by another version", m_file.c_str());
+    return false;
+  }
+
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    std::string path;
+    Entry entry;
+    if (!Read(pos, end, path) || !Read(pos, end, entry.mtime) || !Read(pos, end, entry.ctime) ||
+        !Read(pos, end, entry.size) || !Read(pos, end, entry.descriptor))
+    {
+      CLog::Log(LOGERROR, "CAddonManifestIndex: %s is damaged, parsing all add-on descriptors", m_file.c_str());
+      return false;
+    }
+    entry.seen = false;
+    m_entries.insert(std::make_pair(std::move(path), std::move(entry)));
+  }
+  return true;
+}
+
+bool CAddonManifestIndex::Save() const
+{
+  std::string data;
+  Write(data, INDEX_MAGIC, 4);
+  Write(data, static_cast<uint32_t>(INDEX_VERSION));
+  Write(data, static_cast<uint32_t>(m_entries.size()));
+  for (const auto& it : m_entries)
+  {
+    Write(data, it.first);
+    Write(data, it.second.mtime);
+    Write(data, it.second.ctime);
+    Write(data, it.second.size);
+    Write(data, it.second.descriptor);
+  }
+
+  XFILE::CFile file;
+  if (!file.OpenForWrite(m_file, true))
+    return false;
+  bool result = file.Write(data.c_str(), data.size()) == static_cast<ssize_t>(data.size());
+  file.Close();
+  if (!result)
+    XFILE::CFile::Delete(m_file);
+  return result;
+}
+
+}
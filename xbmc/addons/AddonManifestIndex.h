@@ -0,0 +1,86 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <map>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+class DllLibCPluff;
+extern "C"
+{
+#include "lib/cpluff/libcpluff/cpluff.h"
+}
+
+namespace ADDON
+{
+/*!
+ \brief Parsed add-on descriptors, kept on disk so unchanged addon.xml files
+ are not parsed again on the next start.
+
+ Descriptors are keyed on the add-on folder and are only used while the size
+ and times of its addon.xml are unchanged. Anything missing from the index,
+ including the whole index, is parsed like cpluff's own scan would.
+ */
+class CAddonManifestIndex
+{
+public:
+  /*!
+   \param file where the index is kept, loaded on the first scan
+   */
+  explicit CAddonManifestIndex(std::string file);
+
+  /*! \brief Install the add-ons found in the given folders into the context.
+   Behaves like cp_scan_plugins with CP_SP_UPGRADE: the most recent version of
+   an add-on is installed and an installed add-on is only replaced by a more
+   recent version.
+   \return false if a folder could not be read, the caller should fall back to cp_scan_plugins
+   */
+  bool Scan(DllLibCPluff& cpluff, cp_context_t* context, const std::vector<std::string>& directories);
+
+  /*! \brief Number of descriptors taken from the index in the last scan */
+  unsigned int GetReused() const { return m_reused; }
+
+  /*! \brief Number of descriptors parsed in the last scan */
+  unsigned int GetParsed() const { return m_parsed; }
+
+private:
+  struct Entry
+  {
+    int64_t mtime;
+    int64_t ctime;
+    int64_t size;
+    std::string descriptor; // as written by cp_serialize_plugin_descriptor
+    bool seen;
+  };
+
+  cp_plugin_info_t* LoadDescriptor(DllLibCPluff& cpluff, cp_context_t* context, const std::string& path, bool& changed);
+  bool Load();
+  bool Save() const;
+
+  std::string m_file;
+  bool m_loaded = false;
+  std::map<std::string, Entry> m_entries;
+  unsigned int m_reused = 0;
+  unsigned int m_parsed = 0;
+};
+}
@@ -0,0 +1,176 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "addons/AddonManager.h"
+#include "threads/SingleLock.h"
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define UPDATE_COUNT 2000U
+#define READER_COUNT 4
+
+using namespace ADDON;
+
+class TestAddonRegistryHelper
+{
+public:
+  typedef CAddonMgr::Registry Registry;
+  typedef CAddonMgr::RegistryPtr RegistryPtr;
+
+  explicit TestAddonRegistryHelper(CAddonMgr& manager) : m_manager(manager) {}
+
+  void Publish()
+  {
+    CSingleLock lock(m_manager.m_critSection);
+    m_manager.PublishRegistry();
+  }
+
+  // adds addon.<n> as the only disabled and blacklisted add-on, n counting the add-ons added
+  void AddAddon()
+  {
+    CSingleLock lock(m_manager.m_critSection);
+    m_manager.UpdateRegistry([](Registry& registry)
+    {
+      std::string id = "addon." + std::to_string(registry.addons.size() + 1);
+      registry.byId[id] = registry.addons.size();
+      registry.addons.emplace_back(id, CAddonMgr::RegistryEntry());
+      registry.disabled = { id };
+      registry.blacklisted = { id };
+    });
+  }
+
+  RegistryPtr Get() const { return m_manager.GetRegistry(); }
+
+private:
+  CAddonMgr& m_manager;
+};
+
+namespace
+{
+// everything in a registry describes the same state, the one its version was published with
+bool IsConsistent(const TestAddonRegistryHelper::Registry& registry)
+{
+  size_t count = registry.version - 1;
+  if (registry.addons.size() != count || registry.byId.size() != count)
+    return false;
+
+  for (size_t i = 0; i < count; i++)
+  {
+    auto it = registry.byId.find(registry.addons[i].first);
+    if (it == registry.byId.end() || it->second != i)
+      return false;
+  }
+
+  if (count == 0)
+    return registry.disabled.empty() && registry.blacklisted.empty();
+
+  std::string last = "addon." + std::to_string(count);
+  return registry.addons.back().first == last &&
+         registry.disabled == std::set<std::string>({ last }) &&
+         registry.blacklisted == registry.disabled;
+}
+}
+
+TEST(TestAddonManager, RegistrySnapshot)
+{
+  CAddonMgr manager;
+  TestAddonRegistryHelper helper(manager);
+  EXPECT_EQ(nullptr, helper.Get());
+
+  helper.Publish();
+  TestAddonRegistryHelper::RegistryPtr first = helper.Get();
+  ASSERT_NE(nullptr, first);
+  EXPECT_EQ(1U, first->version);
+  EXPECT_TRUE(IsConsistent(*first));
+  EXPECT_FALSE(manager.IsBlacklisted("addon.1"));
+
+  helper.AddAddon();
+  TestAddonRegistryHelper::RegistryPtr second = helper.Get();
+  ASSERT_NE(first, second);
+  EXPECT_EQ(2U, second->version);
+  EXPECT_TRUE(IsConsistent(*second));
+  EXPECT_TRUE(manager.IsBlacklisted("addon.1"));
+
+  // a registry already taken isn't touched by publishing another
+  EXPECT_EQ(1U, first->version);
+  EXPECT_TRUE(first->addons.empty());
+  EXPECT_TRUE(first->blacklisted.empty());
+
+  // nor by dropping the current one
+  manager.DeInit();
+  EXPECT_EQ(nullptr, helper.Get());
+  EXPECT_TRUE(IsConsistent(*second));
+}
+
+TEST(TestAddonManager, RegistrySnapshotConcurrentPublish)
+{
+  CAddonMgr manager;
+  TestAddonRegistryHelper helper(manager);
+  helper.Publish();
+
+  std::atomic<bool> done(false);
+  std::atomic<unsigned int> inconsistent(0);
+  std::atomic<unsigned int> backwards(0);
+  std::atomic<unsigned int> changed(0);
+
+  std::vector<std::thread> readers;
+  for (int i = 0; i < READER_COUNT; i++)
+  {
+    readers.emplace_back([&]()
+    {
+      unsigned int lastVersion = 0;
+      while (!done)
+      {
+        TestAddonRegistryHelper::RegistryPtr registry = helper.Get();
+        if (!IsConsistent(*registry))
+          inconsistent++;
+        if (registry->version < lastVersion)
+          backwards++;
+        lastVersion = registry->version;
+
+        // still the same after the writer had a chance to publish again
+        size_t count = registry->addons.size();
+        std::this_thread::yield();
+        if (registry->addons.size() != count || !IsConsistent(*registry))
+          changed++;
+      }
+    });
+  }
+
+  for (unsigned int i = 0; i < UPDATE_COUNT; i++)
+    helper.AddAddon();
+  done = true;
+  for (auto& reader : readers)
+    reader.join();
+
+  EXPECT_EQ(0U, inconsistent);
+  EXPECT_EQ(0U, backwards);
+  EXPECT_EQ(0U, changed);
+
+  TestAddonRegistryHelper::RegistryPtr last = helper.Get();
+  EXPECT_EQ(UPDATE_COUNT + 1, last->version);
+  EXPECT_TRUE(IsConsistent(*last));
+}
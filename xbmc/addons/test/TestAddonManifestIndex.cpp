@@ -0,0 +1,210 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "addons/AddonManifestIndex.h"
+#include "addons/DllLibCPluff.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "threads/SystemClock.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <map>
+
+#define ADDON_COUNT 300U
+
+using namespace ADDON;
+
+class TestAddonManifestIndex : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_root = CSpecialProtocol::TranslatePath("special://temp/manifestindex");
+    XFILE::CDirectory::RemoveRecursive(m_root);
+    XFILE::CDirectory::Create(m_root);
+    m_directories.push_back(URIUtils::AddFileToFolder(m_root, "addons"));
+    XFILE::CDirectory::Create(m_directories[0]);
+    m_index = URIUtils::AddFileToFolder(m_root, "manifests.idx");
+
+    for (unsigned int i = 0; i < ADDON_COUNT; i++)
+      WriteAddon(i, "1.0.0");
+
+    ASSERT_TRUE(m_cpluff.Load());
+    ASSERT_EQ(CP_OK, m_cpluff.init());
+  }
+
+  void TearDown() override
+  {
+    for (auto context : m_contexts)
+      m_cpluff.destroy_context(context);
+    XFILE::CDirectory::RemoveRecursive(m_root);
+  }
+
+  void WriteAddon(unsigned int i, const std::string& version)
+  {
+    std::string directory = URIUtils::AddFileToFolder(m_directories[0], StringUtils::Format("plugin.test.%u", i));
+    XFILE::CDirectory::Create(directory);
+
+    std::string xml = StringUtils::Format(
+      "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+      "<addon id=\"plugin.test.%u\" version=\"%s\" name=\"Test %u\" provider-name=\"Team Kodi\">\n"
+      "  <requires>\n"
+      "    <import addon=\"xbmc.python\" version=\"2.25.0\"/>\n"
+      "    <import addon=\"script.module.test\" version=\"1.0.0\" optional=\"true\"/>\n"
+      "  </requires>\n"
+      "  <extension point=\"xbmc.python.pluginsource\" library=\"default.py\">\n"
+      "    <provides>video audio</provides>\n"
+      "  </extension>\n"
+      "  <extension point=\"xbmc.addon.metadata\">\n", i, version.c_str(), i);
+    for (const char* lang : { "en_GB", "de_DE", "fr_FR", "es_ES", "nl_NL", "it_IT" })
+    {
+      xml += StringUtils::Format("    <summary lang=\"%s\">Watch the videos of test %u</summary>\n", lang, i);
+      xml += StringUtils::Format("    <description lang=\"%s\">Browse and play the videos and podcasts of test %u, "
+                                 "sorted by date, with the most recent first. Version %s.</description>\n", lang, i, version.c_str());
+    }
+    xml += "    <platform>all</platform>\n"
+           "    <license>GPL-2.0</license>\n"
+           "    <assets>\n"
+           "      <icon>icon.png</icon>\n"
+           "      <fanart>fanart.jpg</fanart>\n"
+           "    </assets>\n"
+           "  </extension>\n"
+           "</addon>\n";
+
+    XFILE::CFile file;
+    ASSERT_TRUE(file.OpenForWrite(URIUtils::AddFileToFolder(directory, "addon.xml"), true));
+    ASSERT_EQ(static_cast<ssize_t>(xml.size()), file.Write(xml.c_str(), xml.size()));
+    file.Close();
+  }
+
+  cp_context_t* CreateContext()
+  {
+    cp_status_t status;
+    cp_context_t* context = m_cpluff.create_context(&status);
+    m_contexts.push_back(context);
+    return context;
+  }
+
+  // the serialized descriptors of all installed add-ons
+  std::map<std::string, std::string> GetInstalled(cp_context_t* context)
+  {
+    std::map<std::string, std::string> installed;
+    cp_status_t status;
+    int count = 0;
+    cp_plugin_info_t** plugins = m_cpluff.get_plugins_info(context, &status, &count);
+    for (int i = 0; i < count; i++)
+    {
+      std::string descriptor(m_cpluff.serialize_plugin_descriptor(plugins[i], nullptr, 0), '\0');
+      m_cpluff.serialize_plugin_descriptor(plugins[i], &descriptor[0], descriptor.size());
+      installed[plugins[i]->identifier] = descriptor;
+    }
+    if (plugins)
+      m_cpluff.release_info(context, plugins);
+    return installed;
+  }
+
+  std::string GetVersion(cp_context_t* context, const std::string& id)
+  {
+    cp_status_t status;
+    cp_plugin_info_t* plugin = m_cpluff.get_plugin_info(context, id.c_str(), &status);
+    if (!plugin)
+      return "";
+    std::string version = plugin->version;
+    m_cpluff.release_info(context, plugin);
+    return version;
+  }
+
+  DllLibCPluff m_cpluff;
+  std::vector<cp_context_t*> m_contexts;
+  std::string m_root;
+  std::vector<std::string> m_directories;
+  std::string m_index;
+};
+
+TEST_F(TestAddonManifestIndex, ColdAndWarmScan)
+{
+  cp_context_t* cold = CreateContext();
+  CAddonManifestIndex coldIndex(m_index);
+  unsigned int start = XbmcThreads::SystemClockMillis();
+  ASSERT_TRUE(coldIndex.Scan(m_cpluff, cold, m_directories));
+  unsigned int coldTime = XbmcThreads::SystemClockMillis() - start;
+  EXPECT_EQ(ADDON_COUNT, coldIndex.GetParsed());
+  EXPECT_EQ(0U, coldIndex.GetReused());
+  EXPECT_TRUE(XFILE::CFile::Exists(m_index));
+
+  // a new start, with nothing but the index on disk
+  cp_context_t* warm = CreateContext();
+  CAddonManifestIndex warmIndex(m_index);
+  start = XbmcThreads::SystemClockMillis();
+  ASSERT_TRUE(warmIndex.Scan(m_cpluff, warm, m_directories));
+  unsigned int warmTime = XbmcThreads::SystemClockMillis() - start;
+  EXPECT_EQ(0U, warmIndex.GetParsed());
+  EXPECT_EQ(ADDON_COUNT, warmIndex.GetReused());
+
+  std::map<std::string, std::string> parsed = GetInstalled(cold);
+  EXPECT_EQ(ADDON_COUNT, parsed.size());
+  EXPECT_TRUE(parsed == GetInstalled(warm));
+
+  RecordProperty("cold_ms", coldTime);
+  RecordProperty("warm_ms", warmTime);
+}
+
+TEST_F(TestAddonManifestIndex, ChangedManifests)
+{
+  cp_context_t* context = CreateContext();
+  CAddonManifestIndex index(m_index);
+  ASSERT_TRUE(index.Scan(m_cpluff, context, m_directories));
+  EXPECT_EQ("1.0.0", GetVersion(context, "plugin.test.3"));
+
+  // an update is parsed and replaces the installed version
+  WriteAddon(3, "1.10.0");
+  ASSERT_TRUE(index.Scan(m_cpluff, context, m_directories));
+  EXPECT_EQ(1U, index.GetParsed());
+  EXPECT_EQ(ADDON_COUNT - 1, index.GetReused());
+  EXPECT_EQ("1.10.0", GetVersion(context, "plugin.test.3"));
+
+  // removed add-ons are dropped from the index
+  XFILE::CDirectory::RemoveRecursive(URIUtils::AddFileToFolder(m_directories[0], "plugin.test.5"));
+  cp_context_t* restarted = CreateContext();
+  CAddonManifestIndex reloaded(m_index);
+  ASSERT_TRUE(reloaded.Scan(m_cpluff, restarted, m_directories));
+  EXPECT_EQ(0U, reloaded.GetParsed());
+  EXPECT_EQ(ADDON_COUNT - 1, reloaded.GetReused());
+  EXPECT_EQ("1.10.0", GetVersion(restarted, "plugin.test.3"));
+  EXPECT_EQ("", GetVersion(restarted, "plugin.test.5"));
+}
+
+TEST_F(TestAddonManifestIndex, DamagedIndex)
+{
+  XFILE::CFile file;
+  ASSERT_TRUE(file.OpenForWrite(m_index, true));
+  file.Write("KAMI\x01\0\0\0\xff\xff", 10);
+  file.Close();
+
+  cp_context_t* context = CreateContext();
+  CAddonManifestIndex index(m_index);
+  ASSERT_TRUE(index.Scan(m_cpluff, context, m_directories));
+  EXPECT_EQ(ADDON_COUNT, index.GetParsed());
+  EXPECT_EQ(ADDON_COUNT, GetInstalled(context).size());
+}
@@ -298,3 +298,73 @@ bool CDataCacheCore::CDataCacheCore::GetVideoRender()
 
   return m_stateInfo.m_renderVideoLayer;
 }
+
+// demux packet pool
+void CDataCacheCore::SetDemuxPacketPool(unsigned int packetsInUse, uint64_t payloads, uint64_t payloadsReused, uint64_t pooledBytes)
+{
+  CSingleLock lock(m_demuxPoolSection);
+
+  m_demuxPoolInfo.m_packetsInUse = packetsInUse;
+  m_demuxPoolInfo.m_payloads = payloads;
+  m_demuxPoolInfo.m_payloadsReused = payloadsReused;
+  m_demuxPoolInfo.m_pooledBytes = pooledBytes;
+}
+
+unsigned int CDataCacheCore::GetDemuxPacketsInUse()
+{
+  CSingleLock lock(m_demuxPoolSection);
+
+  return m_demuxPoolInfo.m_packetsInUse;
+}
+
+uint64_t CDataCacheCore::GetDemuxPayloads()
+{
+  CSingleLock lock(m_demuxPoolSection);
+
+  return m_demuxPoolInfo.m_payloads;
+}
+
+uint64_t CDataCacheCore::GetDemuxPayloadsReused()
+{
+  CSingleLock lock(m_demuxPoolSection);
+
+  return m_demuxPoolInfo.m_payloadsReused;
+}
+
+uint64_t CDataCacheCore::GetDemuxPooledBytes()
+{
+  CSingleLock lock(m_demuxPoolSection);
+
+  return m_demuxPoolInfo.m_pooledBytes;
+}
+
+// demuxer read ahead
+void CDataCacheCore::SetDemuxReadAhead(uint64_t bytes, double time, int level)
+{
+  CSingleLock lock(m_readAheadSection);
+
+  m_readAheadInfo.m_bytes = bytes;
+  m_readAheadInfo.m_time = time;
+  m_readAheadInfo.m_level = level;
+}
+
+uint64_t CDataCacheCore::GetDemuxReadAheadBytes()
+{
+  CSingleLock lock(m_readAheadSection);
+
+  return m_readAheadInfo.m_bytes;
+}
+
+double CDataCacheCore::GetDemuxReadAheadTime()
+{
+  CSingleLock lock(m_readAheadSection);
+
+  return m_readAheadInfo.m_time;
+}
+
+int CDataCacheCore::GetDemuxReadAheadLevel()
+{
+  CSingleLock lock(m_readAheadSection);
+
+  return m_readAheadInfo.m_level;
+}
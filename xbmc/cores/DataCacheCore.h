@@ -21,6 +21,7 @@
 */
 
 #include <atomic>
+#include <cstdint>
 #include <string>
 #include "threads/CriticalSection.h"
 
@@ -75,6 +76,19 @@ public:
   void SetVideoRender(bool video);
   bool GetVideoRender();
 
+  // demux packet pool
+  void SetDemuxPacketPool(unsigned int packetsInUse, uint64_t payloads, uint64_t payloadsReused, uint64_t pooledBytes);
+  unsigned int GetDemuxPacketsInUse();
+  uint64_t GetDemuxPayloads();
+  uint64_t GetDemuxPayloadsReused();
+  uint64_t GetDemuxPooledBytes();
+
+  // demuxer read ahead
+  void SetDemuxReadAhead(uint64_t bytes, double time, int level);
+  uint64_t GetDemuxReadAheadBytes();
+  double GetDemuxReadAheadTime();
+  int GetDemuxReadAheadLevel();
+
 protected:
   std::atomic_bool m_hasAVInfoChanges;
 
@@ -116,4 +130,21 @@ protected:
     float m_tempo;
     float m_speed;
   } m_stateInfo;
+
+  CCriticalSection m_demuxPoolSection;
+  struct SDemuxPoolInfo
+  {
+    unsigned int m_packetsInUse = 0;
+    uint64_t m_payloads = 0;
+    uint64_t m_payloadsReused = 0;
+    uint64_t m_pooledBytes = 0;
+  } m_demuxPoolInfo;
+
+  CCriticalSection m_readAheadSection;
+  struct SReadAheadInfo
+  {
+    uint64_t m_bytes = 0;
+    double m_time = 0.0;
+    int m_level = 0;
+  } m_readAheadInfo;
 };
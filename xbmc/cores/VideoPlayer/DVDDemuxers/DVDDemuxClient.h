@@ -20,6 +20,7 @@
  */
 
 #include "DVDDemux.h"
+#include "DVDDemuxUtils.h"
 #include <map>
 #include <vector>
 
@@ -65,6 +66,6 @@ protected:
   std::map<int, std::shared_ptr<CDemuxStream>> m_streams;
   int m_displayTime;
   double m_dtsAtDisplayTime;
-  std::unique_ptr<DemuxPacket> m_packet;
+  std::unique_ptr<DemuxPacket, DemuxPacketDeleter> m_packet;
 };
 
@@ -597,6 +597,10 @@ void CDVDDemuxFFmpeg::Dispose()
 
   DisposeStreams();
 
+  for (auto stream : m_disposedStreams)
+    delete stream;
+  m_disposedStreams.clear();
+
   m_pInput = NULL;
 }
 
@@ -996,9 +1000,8 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
 
         if (m_pkt.pkt.data)
         {
-          pPacket->pData = m_pkt.pkt.data;
           // so we can free AVPacket when DemuxPacket is freed
-          pPacket->pkt = new AVPacket(m_pkt.pkt);
+          CDVDDemuxUtils::AttachAVPacket(pPacket, m_pkt.pkt);
         }
 
 
@@ -1372,11 +1375,25 @@ void CDVDDemuxFFmpeg::DisposeStreams()
 {
   std::map<int, CDemuxStream*>::iterator it;
   for(it = m_streams.begin(); it != m_streams.end(); ++it)
-    delete it->second;
+    DisposeStream(it->second);
   m_streams.clear();
   m_parsers.clear();
 }
 
+void CDVDDemuxFFmpeg::DisposeStream(CDemuxStream* stream)
+{
+  if (m_keepDisposedStreams)
+    m_disposedStreams.push_back(stream);
+  else
+    delete stream;
+}
+
+void CDVDDemuxFFmpeg::TakeDisposedStreams(std::vector<CDemuxStream*>& streams)
+{
+  streams.insert(streams.end(), m_disposedStreams.begin(), m_disposedStreams.end());
+  m_disposedStreams.clear();
+}
+
 CDemuxStream* CDVDDemuxFFmpeg::AddStream(int streamIdx)
 {
   AVStream* pStream = m_pFormatContext->streams[streamIdx];
@@ -1708,7 +1725,7 @@ void CDVDDemuxFFmpeg::AddStream(int streamIdx, CDemuxStream* stream)
   }
   else
   {
-    delete res.first->second;
+    DisposeStream(res.first->second);
     res.first->second = stream;
   }
   if(g_advancedSettings.m_logLevel > LOG_LEVEL_NORMAL)
@@ -115,6 +115,18 @@ public:
 
   bool Aborted();
 
+  /*!
+   \brief Keep streams that get replaced or disposed instead of deleting them.
+   For callers that hand out streams to another thread while reading, they
+   collect the streams with TakeDisposedStreams and delete them once unused.
+   */
+  void SetKeepDisposedStreams(bool keep) { m_keepDisposedStreams = keep; }
+  void TakeDisposedStreams(std::vector<CDemuxStream*>& streams);
+  /*!
+   \brief Undo an Abort() that was meant for a read which already returned.
+   */
+  void ClearAbort() { m_timeout.SetInfinite(); }
+
   AVFormatContext* m_pFormatContext;
   CDVDInputStream* m_pInput;
 
@@ -127,6 +139,7 @@ protected:
   void AddStream(int streamIdx, CDemuxStream* stream);
   void CreateStreams(unsigned int program = UINT_MAX);
   void DisposeStreams();
+  void DisposeStream(CDemuxStream* stream);
   void ParsePacket(AVPacket *pkt);
   bool IsVideoReady();
   void ResetVideoStreams();
@@ -145,6 +158,8 @@ protected:
   CCriticalSection m_critSection;
   std::map<int, CDemuxStream*> m_streams;
   std::map<int, std::unique_ptr<CDemuxParserFFmpeg>> m_parsers;
+  bool m_keepDisposedStreams = false;
+  std::vector<CDemuxStream*> m_disposedStreams;
 
   AVIOContext* m_ioContext;
 
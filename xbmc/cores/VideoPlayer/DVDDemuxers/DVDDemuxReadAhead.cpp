@@ -0,0 +1,464 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DVDDemuxReadAhead.h"
+#include "DVDDemuxFFmpeg.h"
+#include "DVDDemuxUtils.h"
+#include "TimingConstants.h"
+
+#include <algorithm>
+#include <functional>
+
+// how long Read waits for the reading thread before handing out an empty packet
+#define READAHEAD_WAIT_MS 100
+
+namespace
+{
+
+double GetPacketTime(const DemuxPacket* packet)
+{
+  if (packet->dts != DVD_NOPTS_VALUE)
+    return packet->dts;
+  return packet->pts;
+}
+
+}
+
+CDVDDemuxReadAhead::SStreamSnapshot::~SStreamSnapshot()
+{
+  for (auto stream : retired)
+    delete stream;
+}
+
+CDVDDemuxReadAhead::CDVDDemuxReadAhead(CDVDDemuxFFmpeg* demuxer, unsigned int maxBytes, double maxTime)
+  : CThread("DemuxReadAhead")
+  , m_demuxer(demuxer)
+  , m_maxBytes(maxBytes)
+  , m_maxTime(maxTime * DVD_TIME_BASE)
+{
+  m_bufferStart = DVD_NOPTS_VALUE;
+  m_bufferEnd = DVD_NOPTS_VALUE;
+  m_suspended = false;
+  m_aborted = false;
+
+  m_demuxer->SetKeepDisposedStreams(true);
+  UpdateStreams();
+  UpdateChapters();
+  m_streams = m_readStreams;
+  m_streamLength = m_demuxer->GetStreamLength();
+  m_chapter = m_demuxer->GetChapter();
+  m_fileName = m_demuxer->GetFileName();
+
+  Create();
+}
+
+CDVDDemuxReadAhead::~CDVDDemuxReadAhead()
+{
+  m_bStop = true;
+  m_demuxer->Abort();
+  m_spaceEvent.Set();
+  StopThread(true);
+
+  ClearBuffer();
+  m_streams.reset();
+  m_readStreams.reset();
+}
+
+void CDVDDemuxReadAhead::Process()
+{
+  while (!m_bStop)
+  {
+    {
+      CSingleLock lock(m_bufferSection);
+      if (m_pendingCalls.empty() && (m_suspended || m_endQueued || IsFull()))
+      {
+        lock.Leave();
+        AbortableWait(m_spaceEvent);
+        continue;
+      }
+    }
+
+    CSingleLock lock(m_demuxSection);
+    RunPendingCalls();
+
+    // the player is waiting to get at the demuxer
+    if (m_suspended)
+      continue;
+
+    {
+      CSingleLock bufferLock(m_bufferSection);
+      if (m_endQueued || IsFull())
+        continue;
+    }
+
+    DemuxPacket* packet = m_demuxer->Read();
+    UpdateStreams();
+    m_streamLength = m_demuxer->GetStreamLength();
+    m_chapter = m_demuxer->GetChapter();
+
+    // still under the demuxer lock, so a seek can't slip in before the packet is queued
+    Queue(packet);
+
+    // calls that came in during the read
+    RunPendingCalls();
+  }
+}
+
+bool CDVDDemuxReadAhead::IsFull() const
+{
+  if (m_bufferedBytes >= m_maxBytes)
+    return true;
+
+  return m_bufferStart != DVD_NOPTS_VALUE && m_bufferEnd != DVD_NOPTS_VALUE &&
+         m_bufferEnd - m_bufferStart >= m_maxTime;
+}
+
+void CDVDDemuxReadAhead::Queue(DemuxPacket* packet)
+{
+  CSingleLock lock(m_bufferSection);
+
+  m_buffer.push_back({ packet, m_readStreams });
+  if (packet)
+  {
+    m_bufferedBytes += packet->iSize;
+
+    double time = GetPacketTime(packet);
+    if (time != DVD_NOPTS_VALUE)
+    {
+      if (m_bufferStart == DVD_NOPTS_VALUE)
+        m_bufferStart = time;
+      if (m_bufferEnd == DVD_NOPTS_VALUE || time > m_bufferEnd)
+        m_bufferEnd = time;
+    }
+  }
+  else
+    m_endQueued = true;
+
+  m_dataEvent.Set();
+}
+
+void CDVDDemuxReadAhead::ClearBuffer()
+{
+  CSingleLock lock(m_bufferSection);
+
+  for (auto& item : m_buffer)
+    CDVDDemuxUtils::FreeDemuxPacket(item.packet);
+  m_buffer.clear();
+
+  m_bufferedBytes = 0;
+  m_bufferStart = DVD_NOPTS_VALUE;
+  m_bufferEnd = DVD_NOPTS_VALUE;
+  m_endQueued = false;
+}
+
+void CDVDDemuxReadAhead::UpdateStreams()
+{
+  std::vector<CDemuxStream*> streams = m_demuxer->GetStreams();
+  std::vector<CDemuxStream*> disposed;
+  m_demuxer->TakeDisposedStreams(disposed);
+
+  if (m_readStreams && disposed.empty() && streams == m_readStreams->streams)
+    return;
+
+  StreamSnapshotPtr snapshot(new SStreamSnapshot);
+  snapshot->streams = streams;
+  for (auto stream : streams)
+    snapshot->codecNames.push_back(m_demuxer->CDVDDemux::GetStreamCodecName(stream->demuxerId, stream->uniqueId));
+  snapshot->retired = disposed;
+
+  // nothing refers to the previous snapshot anymore, what it keeps alive has to move on
+  if (m_readStreams && m_readStreams.use_count() == 1)
+  {
+    snapshot->retired.insert(snapshot->retired.end(), m_readStreams->retired.begin(), m_readStreams->retired.end());
+    m_readStreams->retired.clear();
+  }
+
+  m_readStreams = snapshot;
+}
+
+void CDVDDemuxReadAhead::UpdateChapters()
+{
+  m_chapters.clear();
+
+  int count = m_demuxer->GetChapterCount();
+  for (int i = 1; i <= count; i++)
+  {
+    std::string name;
+    m_demuxer->GetChapterName(name, i);
+    m_chapters.push_back(std::make_pair(name, m_demuxer->GetChapterPos(i)));
+  }
+}
+
+void CDVDDemuxReadAhead::Suspend(CSingleTryLock& lock)
+{
+  m_suspended = true;
+
+  // the packet being read is dropped anyway, don't wait for it
+  while (!lock.IsOwner())
+  {
+    m_demuxer->Abort();
+    Sleep(1);
+    lock.try_lock();
+  }
+
+  m_demuxer->ClearAbort();
+  RunPendingCalls();
+  ClearBuffer();
+}
+
+void CDVDDemuxReadAhead::Resume()
+{
+  UpdateStreams();
+  m_streams = m_readStreams;
+  m_streamLength = m_demuxer->GetStreamLength();
+  m_chapter = m_demuxer->GetChapter();
+
+  m_suspended = false;
+  m_spaceEvent.Set();
+}
+
+void CDVDDemuxReadAhead::CallDemuxer(const std::function<void()>& call)
+{
+  // the packet being read is kept, rather than waiting for it the reading thread makes the call
+  CSingleTryLock lock(m_demuxSection);
+  if (!lock.IsOwner())
+  {
+    CSingleLock bufferLock(m_bufferSection);
+    m_pendingCalls.push_back(call);
+    m_spaceEvent.Set();
+    return;
+  }
+
+  RunPendingCalls();
+  call();
+  Resume();
+}
+
+void CDVDDemuxReadAhead::RunPendingCalls()
+{
+  std::vector<std::function<void()>> calls;
+  {
+    CSingleLock lock(m_bufferSection);
+    calls.swap(m_pendingCalls);
+  }
+
+  if (calls.empty())
+    return;
+
+  for (auto& call : calls)
+    call();
+  UpdateStreams();
+  m_streamLength = m_demuxer->GetStreamLength();
+  m_chapter = m_demuxer->GetChapter();
+}
+
+void CDVDDemuxReadAhead::Reset()
+{
+  CSingleTryLock lock(m_demuxSection);
+  Suspend(lock);
+  m_demuxer->Reset();
+  UpdateChapters();
+  m_fileName = m_demuxer->GetFileName();
+  Resume();
+}
+
+void CDVDDemuxReadAhead::Abort()
+{
+  m_aborted = true;
+  m_demuxer->Abort();
+  m_dataEvent.Set();
+}
+
+void CDVDDemuxReadAhead::Flush()
+{
+  CSingleTryLock lock(m_demuxSection);
+  Suspend(lock);
+  m_demuxer->Flush();
+  Resume();
+}
+
+DemuxPacket* CDVDDemuxReadAhead::Read()
+{
+  CSingleLock lock(m_bufferSection);
+
+  if (m_buffer.empty() && !m_aborted)
+  {
+    CSingleExit exit(m_bufferSection);
+    m_dataEvent.WaitMSec(READAHEAD_WAIT_MS);
+  }
+
+  // nothing read in time, an empty packet keeps the player going like a demuxer timeout does
+  if (m_buffer.empty())
+    return CDVDDemuxUtils::AllocateDemuxPacket(0);
+
+  SBufferedPacket item = m_buffer.front();
+  m_buffer.pop_front();
+
+  if (item.packet)
+    m_bufferedBytes -= item.packet->iSize;
+  else
+    m_endQueued = false;
+
+  m_bufferStart = DVD_NOPTS_VALUE;
+  for (auto& next : m_buffer)
+  {
+    if (next.packet && GetPacketTime(next.packet) != DVD_NOPTS_VALUE)
+    {
+      m_bufferStart = GetPacketTime(next.packet);
+      break;
+    }
+  }
+  if (m_bufferStart == DVD_NOPTS_VALUE)
+    m_bufferEnd = DVD_NOPTS_VALUE;
+
+  m_spaceEvent.Set();
+  lock.Leave();
+
+  // the player is done with the streams of the previous packet
+  m_streams = item.streams;
+  return item.packet;
+}
+
+bool CDVDDemuxReadAhead::SeekTime(double time, bool backwards, double* startpts)
+{
+  CSingleTryLock lock(m_demuxSection);
+  Suspend(lock);
+  bool ret = m_demuxer->SeekTime(time, backwards, startpts);
+  Resume();
+  return ret;
+}
+
+bool CDVDDemuxReadAhead::SeekChapter(int chapter, double* startpts)
+{
+  CSingleTryLock lock(m_demuxSection);
+  Suspend(lock);
+  bool ret = m_demuxer->SeekChapter(chapter, startpts);
+  Resume();
+  return ret;
+}
+
+int CDVDDemuxReadAhead::GetChapterCount()
+{
+  return m_chapters.size();
+}
+
+int CDVDDemuxReadAhead::GetChapter()
+{
+  return m_chapter;
+}
+
+void CDVDDemuxReadAhead::GetChapterName(std::string& strChapterName, int chapterIdx)
+{
+  if (chapterIdx <= 0 || chapterIdx > GetChapterCount())
+    chapterIdx = GetChapter();
+  if (chapterIdx <= 0 || chapterIdx > GetChapterCount())
+    return;
+
+  strChapterName = m_chapters[chapterIdx - 1].first;
+}
+
+int64_t CDVDDemuxReadAhead::GetChapterPos(int chapterIdx)
+{
+  if (chapterIdx <= 0 || chapterIdx > GetChapterCount())
+    chapterIdx = GetChapter();
+  if (chapterIdx <= 0 || chapterIdx > GetChapterCount())
+    return 0;
+
+  return m_chapters[chapterIdx - 1].second;
+}
+
+void CDVDDemuxReadAhead::SetSpeed(int iSpeed)
+{
+  CallDemuxer([=]() { m_demuxer->SetSpeed(iSpeed); });
+}
+
+int CDVDDemuxReadAhead::GetStreamLength()
+{
+  return m_streamLength;
+}
+
+CDemuxStream* CDVDDemuxReadAhead::GetStream(int64_t demuxerId, int iStreamId) const
+{
+  // like the ffmpeg demuxer, streams are told apart by id only
+  return GetStream(iStreamId);
+}
+
+CDemuxStream* CDVDDemuxReadAhead::GetStream(int iStreamId) const
+{
+  for (auto stream : m_streams->streams)
+  {
+    if (stream->uniqueId == iStreamId)
+      return stream;
+  }
+  return nullptr;
+}
+
+std::vector<CDemuxStream*> CDVDDemuxReadAhead::GetStreams() const
+{
+  return m_streams->streams;
+}
+
+int CDVDDemuxReadAhead::GetNrOfStreams() const
+{
+  return m_streams->streams.size();
+}
+
+std::string CDVDDemuxReadAhead::GetFileName()
+{
+  return m_fileName;
+}
+
+std::string CDVDDemuxReadAhead::GetStreamCodecName(int64_t demuxerId, int iStreamId)
+{
+  for (size_t i = 0; i < m_streams->streams.size(); i++)
+  {
+    if (m_streams->streams[i]->uniqueId == iStreamId)
+      return m_streams->codecNames[i];
+  }
+  return "";
+}
+
+void CDVDDemuxReadAhead::EnableStream(int64_t demuxerId, int id, bool enable)
+{
+  CallDemuxer([=]() { m_demuxer->EnableStream(demuxerId, id, enable); });
+}
+
+void CDVDDemuxReadAhead::OpenStream(int64_t demuxerId, int id)
+{
+  CallDemuxer([=]() { m_demuxer->OpenStream(demuxerId, id); });
+}
+
+void CDVDDemuxReadAhead::SetVideoResolution(int width, int height)
+{
+  CallDemuxer([=]() { m_demuxer->SetVideoResolution(width, height); });
+}
+
+void CDVDDemuxReadAhead::GetBufferLevel(uint64_t& bytes, double& time, int& level) const
+{
+  CSingleLock lock(m_bufferSection);
+
+  bytes = m_bufferedBytes;
+  time = 0.0;
+  if (m_bufferStart != DVD_NOPTS_VALUE && m_bufferEnd != DVD_NOPTS_VALUE)
+    time = std::max(0.0, (m_bufferEnd - m_bufferStart) / DVD_TIME_BASE);
+
+  double fill = std::max(static_cast<double>(bytes) / m_maxBytes, time * DVD_TIME_BASE / m_maxTime);
+  level = std::min(100, static_cast<int>(fill * 100));
+}
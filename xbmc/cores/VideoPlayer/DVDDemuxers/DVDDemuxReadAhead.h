@@ -0,0 +1,148 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DVDDemux.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+class CDVDDemuxFFmpeg;
+
+/*!
+ \brief Reads packets of an ffmpeg demuxer ahead on its own thread.
+
+ Packets are buffered up to a number of bytes and a duration, Read() hands
+ them out from memory and never waits for I/O. Seeking, flushing and resetting
+ abort a pending read and drop the buffer.
+
+ Every buffered packet remembers the streams the demuxer had when it was read,
+ GetStream and friends answer from the streams of the packet last handed out.
+ Streams the demuxer replaces are deleted once no packet refers to them anymore.
+ Speed and stream changes never wait for a pending read, when the demuxer is busy
+ the reading thread makes the call once the read has returned.
+ All calls but Abort are expected from the thread reading packets.
+ */
+class CDVDDemuxReadAhead : public CDVDDemux, private CThread
+{
+public:
+  /*!
+   \brief Takes ownership of the demuxer and starts reading.
+   \param maxBytes payload bytes to buffer at most
+   \param maxTime seconds of packets to buffer at most
+   */
+  CDVDDemuxReadAhead(CDVDDemuxFFmpeg* demuxer, unsigned int maxBytes, double maxTime);
+  ~CDVDDemuxReadAhead() override;
+
+  void Reset() override;
+  void Abort() override;
+  void Flush() override;
+  DemuxPacket* Read() override;
+  bool SeekTime(double time, bool backwards = false, double* startpts = NULL) override;
+  bool SeekChapter(int chapter, double* startpts = NULL) override;
+  int GetChapterCount() override;
+  int GetChapter() override;
+  void GetChapterName(std::string& strChapterName, int chapterIdx=-1) override;
+  int64_t GetChapterPos(int chapterIdx=-1) override;
+  void SetSpeed(int iSpeed) override;
+  int GetStreamLength() override;
+  CDemuxStream* GetStream(int64_t demuxerId, int iStreamId) const override;
+  std::vector<CDemuxStream*> GetStreams() const override;
+  int GetNrOfStreams() const override;
+  std::string GetFileName() override;
+  std::string GetStreamCodecName(int64_t demuxerId, int iStreamId) override;
+  void EnableStream(int64_t demuxerId, int id, bool enable) override;
+  void OpenStream(int64_t demuxerId, int id) override;
+  void SetVideoResolution(int width, int height) override;
+
+  /*!
+   \brief Buffered payload bytes and seconds, level is the fill in percent of whichever is fuller.
+   */
+  void GetBufferLevel(uint64_t& bytes, double& time, int& level) const;
+
+protected:
+  CDemuxStream* GetStream(int iStreamId) const override;
+  void Process() override;
+
+private:
+  struct SStreamSnapshot
+  {
+    ~SStreamSnapshot();
+
+    std::vector<CDemuxStream*> streams;
+    std::vector<std::string> codecNames;
+    // streams the demuxer dropped before this snapshot was taken, they go with it
+    std::vector<CDemuxStream*> retired;
+  };
+  typedef std::shared_ptr<SStreamSnapshot> StreamSnapshotPtr;
+
+  struct SBufferedPacket
+  {
+    DemuxPacket* packet; // NULL marks the end of stream
+    StreamSnapshotPtr streams;
+  };
+
+  bool IsFull() const;
+  void Queue(DemuxPacket* packet);
+  void ClearBuffer();
+  void UpdateStreams();
+  void UpdateChapters();
+  void Suspend(CSingleTryLock& lock);
+  void Resume();
+  void CallDemuxer(const std::function<void()>& call);
+  void RunPendingCalls();
+
+  std::unique_ptr<CDVDDemuxFFmpeg> m_demuxer;
+  CCriticalSection m_demuxSection; // held around everything the demuxer is asked
+
+  mutable CCriticalSection m_bufferSection;
+  std::deque<SBufferedPacket> m_buffer;
+  uint64_t m_bufferedBytes = 0;
+  double m_bufferStart;
+  double m_bufferEnd;
+  bool m_endQueued = false;
+  CEvent m_dataEvent;
+  CEvent m_spaceEvent;
+  std::atomic<bool> m_suspended;
+  std::atomic<bool> m_aborted;
+  std::vector<std::function<void()>> m_pendingCalls; // made by the reading thread after the current read
+
+  const unsigned int m_maxBytes;
+  const double m_maxTime;
+
+  StreamSnapshotPtr m_readStreams; // reading thread, under m_demuxSection
+  StreamSnapshotPtr m_streams;     // of the packet handed out last
+
+  // updated while reading so callers never wait for a read
+  std::atomic<int> m_streamLength;
+  std::atomic<int> m_chapter;
+  std::vector<std::pair<std::string, int64_t>> m_chapters;
+  std::string m_fileName;
+};
@@ -21,9 +21,14 @@
 #include "DVDDemuxUtils.h"
 #include "TimingConstants.h"
 #include "DemuxCrypto.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "system.h"
 
+#include <algorithm>
+#include <atomic>
+
 #ifdef TARGET_POSIX
 #include "linux/XMemUtils.h"
 #endif
@@ -32,18 +37,221 @@ extern "C" {
 #include "libavcodec/avcodec.h"
 }
 
+// payloads are pooled in power of two size classes from 1 KiB up to 4 MiB, larger ones aren't kept
+#define POOL_MIN_CLASS_SHIFT 10
+#define POOL_CLASSES 13
+// payload bytes kept per size class, but at least POOL_MIN_CLASS_BUFFERS buffers
+#define POOL_CLASS_BYTES (2 * 1024 * 1024)
+#define POOL_MIN_CLASS_BUFFERS 2
+#define POOL_MAX_CLASS_BUFFERS 256
+#define POOL_MAX_PACKETS 1024
+
+namespace
+{
+
+struct CPooledPacket : DemuxPacket
+{
+  CPooledPacket() : DemuxPacket(), next(nullptr), buffer(nullptr), sizeClass(-1)
+  {
+    memset(&avpkt, 0, sizeof(avpkt));
+  }
+
+  CPooledPacket* next;
+  uint8_t* buffer;   // payload owned by the packet
+  int sizeClass;     // pool size class of the payload, -1 if it isn't pooled
+  AVPacket avpkt;    // storage for an attached ffmpeg packet
+};
+
+struct SFreeBuffer
+{
+  SFreeBuffer* next;
+};
+
+/*!
+ \brief Free list that can be returned to from any thread without locking.
+ Taking from it locks, but only the threads taking contend for that lock and
+ they grab everything returned so far at once.
+ */
+template<typename T>
+class CFreeList
+{
+public:
+  void SetMaxSize(unsigned int maxSize) { m_maxSize = maxSize; }
+  unsigned int GetSize() const { return m_size; }
+
+  bool Push(T* node)
+  {
+    if (m_size.fetch_add(1, std::memory_order_relaxed) >= m_maxSize)
+    {
+      m_size--;
+      return false;
+    }
+
+    node->next = m_returned.load(std::memory_order_relaxed);
+    while (!m_returned.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed))
+      ;
+    return true;
+  }
+
+  T* Pop()
+  {
+    CSingleLock lock(m_section);
+    if (m_taken == nullptr)
+      m_taken = m_returned.exchange(nullptr, std::memory_order_acquire);
+
+    T* node = m_taken;
+    if (node != nullptr)
+    {
+      m_taken = node->next;
+      m_size--;
+    }
+    return node;
+  }
+
+private:
+  std::atomic<T*> m_returned{nullptr};
+  T* m_taken = nullptr;
+  std::atomic<unsigned int> m_size{0};
+  unsigned int m_maxSize = 0;
+  CCriticalSection m_section;
+};
+
+class CDemuxPacketPool
+{
+public:
+  CDemuxPacketPool()
+  {
+    m_packets.SetMaxSize(POOL_MAX_PACKETS);
+    for (int i = 0; i < POOL_CLASSES; i++)
+    {
+      unsigned int buffers = POOL_CLASS_BYTES / ClassSize(i);
+      m_buffers[i].SetMaxSize(std::min(std::max(buffers, (unsigned int)POOL_MIN_CLASS_BUFFERS), (unsigned int)POOL_MAX_CLASS_BUFFERS));
+    }
+  }
+
+  ~CDemuxPacketPool()
+  {
+    while (CPooledPacket* packet = m_packets.Pop())
+      delete packet;
+
+    for (int i = 0; i < POOL_CLASSES; i++)
+    {
+      while (SFreeBuffer* buffer = m_buffers[i].Pop())
+        _aligned_free(buffer);
+    }
+  }
+
+  static CDemuxPacketPool& GetInstance()
+  {
+    static CDemuxPacketPool pool;
+    return pool;
+  }
+
+  CPooledPacket* AllocatePacket()
+  {
+    CPooledPacket* packet = m_packets.Pop();
+    if (packet == nullptr)
+      packet = new CPooledPacket();
+
+    m_packetsInUse++;
+    return packet;
+  }
+
+  void FreePacket(CPooledPacket* packet)
+  {
+    m_packetsInUse--;
+
+    if (packet->pkt)
+    {
+      av_packet_unref(packet->pkt);
+      if (packet->pkt != &packet->avpkt)
+        delete packet->pkt;
+    }
+    if (packet->buffer)
+      FreeBuffer(packet->buffer, packet->sizeClass);
+
+    // back to the state of a freshly allocated packet
+    static_cast<DemuxPacket&>(*packet) = DemuxPacket();
+    memset(&packet->avpkt, 0, sizeof(packet->avpkt));
+    packet->buffer = nullptr;
+    packet->sizeClass = -1;
+
+    if (!m_packets.Push(packet))
+      delete packet;
+  }
+
+  uint8_t* AllocateBuffer(size_t size, int& sizeClass)
+  {
+    m_payloads++;
+
+    sizeClass = GetClass(size);
+    if (sizeClass < 0)
+      return static_cast<uint8_t*>(_aligned_malloc(size, 16));
+
+    SFreeBuffer* buffer = m_buffers[sizeClass].Pop();
+    if (buffer != nullptr)
+    {
+      m_payloadsReused++;
+      m_pooledBytes -= ClassSize(sizeClass);
+      return reinterpret_cast<uint8_t*>(buffer);
+    }
+
+    return static_cast<uint8_t*>(_aligned_malloc(ClassSize(sizeClass), 16));
+  }
+
+  void FreeBuffer(uint8_t* buffer, int sizeClass)
+  {
+    if (sizeClass >= 0 && m_buffers[sizeClass].Push(reinterpret_cast<SFreeBuffer*>(buffer)))
+    {
+      m_pooledBytes += ClassSize(sizeClass);
+      return;
+    }
+
+    _aligned_free(buffer);
+  }
+
+  void GetStats(SDemuxPacketPoolStats& stats) const
+  {
+    stats.packetsInUse = std::max(m_packetsInUse.load(), 0);
+    stats.payloads = m_payloads;
+    stats.payloadsReused = m_payloadsReused;
+    stats.pooledBytes = m_pooledBytes;
+  }
+
+private:
+  static size_t ClassSize(int sizeClass)
+  {
+    return static_cast<size_t>(1) << (sizeClass + POOL_MIN_CLASS_SHIFT);
+  }
+
+  static int GetClass(size_t size)
+  {
+    for (int i = 0; i < POOL_CLASSES; i++)
+    {
+      if (size <= ClassSize(i))
+        return i;
+    }
+    return -1;
+  }
+
+  CFreeList<CPooledPacket> m_packets;
+  CFreeList<SFreeBuffer> m_buffers[POOL_CLASSES];
+
+  std::atomic<int> m_packetsInUse{0};
+  std::atomic<uint64_t> m_payloads{0};
+  std::atomic<uint64_t> m_payloadsReused{0};
+  std::atomic<uint64_t> m_pooledBytes{0};
+};
+
+}
+
 void CDVDDemuxUtils::FreeDemuxPacket(DemuxPacket* pPacket)
 {
   if (pPacket)
   {
     try {
-      if (pPacket->pkt)
-      {
-        av_free_packet(pPacket->pkt);
-        delete pPacket->pkt;
-      }
-      else if (pPacket->pData) _aligned_free(pPacket->pData);
-      delete pPacket;
+      // every packet handed out comes from the pool
+      CDemuxPacketPool::GetInstance().FreePacket(static_cast<CPooledPacket*>(pPacket));
     }
     catch(...) {
       CLog::Log(LOGERROR, "%s - Exception thrown while freeing packet", __FUNCTION__);
@@ -53,13 +261,12 @@ void CDVDDemuxUtils::FreeDemuxPacket(DemuxPacket* pPacket)
 
 DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(int iDataSize)
 {
-  DemuxPacket* pPacket = new DemuxPacket;
+  CDemuxPacketPool& pool = CDemuxPacketPool::GetInstance();
+  CPooledPacket* pPacket = pool.AllocatePacket();
   if (!pPacket) return NULL;
 
   try
   {
-    memset(pPacket, 0, sizeof(DemuxPacket));
-
     if (iDataSize > 0)
     {
       // need to allocate a few bytes more.
@@ -71,12 +278,13 @@ DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(int iDataSize)
         * Note, if the first 23 bits of the additional bytes are not 0 then damaged
         * MPEG bitstreams could cause overread and segfault
         */
-      pPacket->pData =(uint8_t*)_aligned_malloc(iDataSize + FF_INPUT_BUFFER_PADDING_SIZE, 16);
-      if (!pPacket->pData)
+      pPacket->buffer = pool.AllocateBuffer(iDataSize + FF_INPUT_BUFFER_PADDING_SIZE, pPacket->sizeClass);
+      if (!pPacket->buffer)
       {
         FreeDemuxPacket(pPacket);
         return NULL;
       }
+      pPacket->pData = pPacket->buffer;
 
       // reset the last 8 bytes to 0;
       memset(pPacket->pData + iDataSize, 0, FF_INPUT_BUFFER_PADDING_SIZE);
@@ -104,3 +312,16 @@ DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(unsigned int iDataSize, unsigne
     ret->cryptoInfo = std::shared_ptr<DemuxCryptoInfo>(new DemuxCryptoInfo(encryptedSubsampleCount));
   return ret;
 }
+
+void CDVDDemuxUtils::AttachAVPacket(DemuxPacket* pPacket, const AVPacket& avpkt)
+{
+  CPooledPacket* pooled = static_cast<CPooledPacket*>(pPacket);
+  pooled->avpkt = avpkt;
+  pooled->pkt = &pooled->avpkt;
+  pooled->pData = avpkt.data;
+}
+
+void CDVDDemuxUtils::GetPacketPoolStats(SDemuxPacketPoolStats& stats)
+{
+  CDemuxPacketPool::GetInstance().GetStats(stats);
+}
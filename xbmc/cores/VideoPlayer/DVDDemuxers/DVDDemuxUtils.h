@@ -22,11 +22,33 @@
 
 #include "DVDDemuxPacket.h"
 
+struct SDemuxPacketPoolStats
+{
+  unsigned int packetsInUse;  // packets allocated and not freed yet
+  uint64_t payloads;          // payload buffers requested
+  uint64_t payloadsReused;    // payload buffers served from the pool
+  uint64_t pooledBytes;       // payload bytes kept for reuse
+};
+
 class CDVDDemuxUtils
 {
 public:
   static void FreeDemuxPacket(DemuxPacket* pPacket);
   static DemuxPacket* AllocateDemuxPacket(int iDataSize = 0);
   static DemuxPacket* AllocateDemuxPacket(unsigned int iDataSize, unsigned int encryptedSubsampleCount);
+  /*!
+   \brief Lets a packet without payload reference the data of an ffmpeg packet instead of copying it.
+   The packet takes over the buffer reference, the caller has to forget avpkt without unreferencing it.
+   */
+  static void AttachAVPacket(DemuxPacket* pPacket, const AVPacket& avpkt);
+  static void GetPacketPoolStats(SDemuxPacketPoolStats& stats);
+};
+
+/*!
+ \brief Deleter returning a packet to the pool, for holding packets in a std::unique_ptr.
+ */
+struct DemuxPacketDeleter
+{
+  void operator()(DemuxPacket* pPacket) const { CDVDDemuxUtils::FreeDemuxPacket(pPacket); }
 };
 
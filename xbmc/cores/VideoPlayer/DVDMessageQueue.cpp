@@ -25,11 +25,41 @@
 #include "TimingConstants.h"
 #include "math.h"
 
-CDVDMessageQueue::CDVDMessageQueue(const std::string &owner) : m_hEvent(true), m_owner(owner)
+// data messages the ring holds before putting falls back to the locked overflow list
+#define MSGQ_RING_SIZE 1024
+
+namespace
+{
+
+DVDMessageRingItem MakeRingItem(CDVDMsg* pMsg)
+{
+  DVDMessageRingItem item = { pMsg, 0, DVD_NOPTS_VALUE };
+  if (pMsg->IsType(CDVDMsg::DEMUXER_PACKET))
+  {
+    DemuxPacket* packet = ((CDVDMsgDemuxerPacket*)pMsg)->GetPacket();
+    if (packet)
+    {
+      item.size = packet->iSize;
+      if (packet->dts != DVD_NOPTS_VALUE)
+        item.time = packet->dts;
+      else if (packet->pts != DVD_NOPTS_VALUE)
+        item.time = packet->pts;
+    }
+  }
+  return item;
+}
+
+}
+
+CDVDMessageQueue::CDVDMessageQueue(const std::string &owner) : m_hEvent(true), m_owner(owner), m_messages(MSGQ_RING_SIZE)
 {
   m_iDataSize     = 0;
   m_bAbortRequest = false;
   m_bInitialized = false;
+  m_drain = false;
+  m_waiting = false;
+  m_overflowCount = 0;
+  m_prioCount = 0;
 
   m_TimeBack = DVD_NOPTS_VALUE;
   m_TimeFront = DVD_NOPTS_VALUE;
@@ -55,15 +85,30 @@ void CDVDMessageQueue::Init()
 
 void CDVDMessageQueue::Flush(CDVDMsg::Message type)
 {
+  // stop both ends of the ring, we are going to be producer and consumer
+  CSingleLock producer(m_producerSection);
+  CSingleLock consumer(m_consumerSection);
   CSingleLock lock(m_section);
 
-  m_messages.remove_if([type](const DVDMessageListItem &item){
+  // rotate the ring once, dropping what matches
+  DVDMessageRingItem item;
+  for (size_t count = m_messages.Size(); count > 0 && m_messages.Pop(item); count--)
+  {
+    if (type == CDVDMsg::NONE || item.message->IsType(type))
+      item.message->Release();
+    else
+      m_messages.Push(item);
+  }
+
+  m_overflow.remove_if([type](const DVDMessageListItem &item){
     return type == CDVDMsg::NONE || item.message->IsType(type);
   });
+  m_overflowCount = m_overflow.size();
 
   m_prioMessages.remove_if([type](const DVDMessageListItem &item){
     return type == CDVDMsg::NONE || item.message->IsType(type);
   });
+  m_prioCount = m_prioMessages.size();
 
   if (type == CDVDMsg::DEMUXER_PACKET ||  type == CDVDMsg::NONE)
   {
@@ -75,8 +120,6 @@ void CDVDMessageQueue::Flush(CDVDMsg::Message type)
 
 void CDVDMessageQueue::Abort()
 {
-  CSingleLock lock(m_section);
-
   m_bAbortRequest = true;
 
   // inform waiter for abort action
@@ -85,8 +128,6 @@ void CDVDMessageQueue::Abort()
 
 void CDVDMessageQueue::End()
 {
-  CSingleLock lock(m_section);
-
   Flush(CDVDMsg::NONE);
 
   m_bInitialized = false;
@@ -106,22 +147,23 @@ MsgQueueReturnCode CDVDMessageQueue::PutBack(CDVDMsg* pMsg, int priority)
 
 MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority, bool front)
 {
-  CSingleLock lock(m_section);
-
+  if (!pMsg)
+  {
+    CLog::Log(LOGFATAL, "CDVDMessageQueue(%s)::Put MSGQ_INVALID_MSG", m_owner.c_str());
+    return MSGQ_INVALID_MSG;
+  }
   if (!m_bInitialized)
   {
     CLog::Log(LOGWARNING, "CDVDMessageQueue(%s)::Put MSGQ_NOT_INITIALIZED", m_owner.c_str());
     pMsg->Release();
     return MSGQ_NOT_INITIALIZED;
   }
-  if (!pMsg)
-  {
-    CLog::Log(LOGFATAL, "CDVDMessageQueue(%s)::Put MSGQ_INVALID_MSG", m_owner.c_str());
-    return MSGQ_INVALID_MSG;
-  }
 
-  if (priority > 0)
+  if (priority > 0 || !front)
   {
+    // priority messages and those put back for the consumer to get next
+    CSingleLock lock(m_section);
+
     int prio = priority;
     if (!front)
       prio++;
@@ -131,47 +173,54 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority, bool front
                              return prio <= item.priority;
                            });
     m_prioMessages.emplace(it, pMsg, priority);
+    m_prioCount++;
+
+    if (priority == 0)
+      m_iDataSize += MakeRingItem(pMsg).size;
   }
   else
   {
-    if (m_messages.empty())
+    CSingleLock lock(m_producerSection);
+
+    if (m_messages.Empty() && m_overflowCount == 0)
     {
-      m_iDataSize = 0;
       m_TimeBack = DVD_NOPTS_VALUE;
       m_TimeFront = DVD_NOPTS_VALUE;
     }
 
-    if (front)
-      m_messages.emplace_front(pMsg, priority);
-    else
-      m_messages.emplace_back(pMsg, priority);
-  }
+    DVDMessageRingItem item = MakeRingItem(pMsg->Acquire());
 
-  if (pMsg->IsType(CDVDMsg::DEMUXER_PACKET) && priority == 0)
-  {
-    DemuxPacket* packet = ((CDVDMsgDemuxerPacket*)pMsg)->GetPacket();
-    if (packet)
+    // once the ring overflowed everything goes to the list until the consumer drained it
+    if (m_overflowCount > 0 || !m_messages.Push(item))
     {
-      m_iDataSize += packet->iSize;
-      if (front)
-        UpdateTimeFront();
-      else
-        UpdateTimeBack();
+      CSingleLock overflowLock(m_section);
+      m_overflow.emplace_front(pMsg, priority);
+      m_overflowCount++;
+      pMsg->Release();
     }
+
+    m_iDataSize += item.size;
+    UpdateTimeFront(item.time);
   }
 
   pMsg->Release();
 
   // inform waiter for new packet
-  m_hEvent.Set();
+  Signal();
 
   return MSGQ_OK;
 }
 
-MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutInMilliSeconds, int &priority)
+void CDVDMessageQueue::Signal()
 {
-  CSingleLock lock(m_section);
+  // pairs with the fence in Get, either we see the waiter or it sees our message
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (m_waiting)
+    m_hEvent.Set();
+}
 
+MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutInMilliSeconds, int &priority)
+{
   *pMsg = NULL;
 
   int ret = 0;
@@ -182,27 +231,12 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
     return MSGQ_NOT_INITIALIZED;
   }
 
+  CSingleLock lock(m_consumerSection);
+
   while (!m_bAbortRequest)
   {
-    std::list<DVDMessageListItem> &msgs = (priority > 0 || !m_prioMessages.empty()) ? m_prioMessages : m_messages;
-
-    if (!msgs.empty() && (msgs.back().priority >= priority || m_drain))
+    if (TakeMessage(pMsg, priority))
     {
-      DVDMessageListItem& item(msgs.back());
-      priority = item.priority;
-
-      if (item.message->IsType(CDVDMsg::DEMUXER_PACKET) && item.priority == 0)
-      {
-        DemuxPacket* packet = ((CDVDMsgDemuxerPacket*)item.message)->GetPacket();
-        if (packet)
-        {
-          m_iDataSize -= packet->iSize;
-        }
-      }
-
-      *pMsg = item.message->Acquire();
-      msgs.pop_back();
-      UpdateTimeBack();
       ret = MSGQ_OK;
       break;
     }
@@ -214,10 +248,23 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
     else
     {
       m_hEvent.Reset();
+      m_waiting = true;
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+
+      // a message may have arrived before producers could see us waiting
+      if (TakeMessage(pMsg, priority))
+      {
+        m_waiting = false;
+        ret = MSGQ_OK;
+        break;
+      }
+
       lock.Leave();
 
       // wait for a new message
-      if (!m_hEvent.WaitMSec(iTimeoutInMilliSeconds))
+      bool signaled = m_hEvent.WaitMSec(iTimeoutInMilliSeconds);
+      m_waiting = false;
+      if (!signaled)
         return MSGQ_TIMEOUT;
 
       lock.Enter();
@@ -230,59 +277,111 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
   return (MsgQueueReturnCode)ret;
 }
 
-void CDVDMessageQueue::UpdateTimeFront()
+bool CDVDMessageQueue::TakeMessage(CDVDMsg** pMsg, int &priority)
 {
-  if (!m_messages.empty())
+  if (priority > 0 || m_prioCount > 0)
   {
-    auto &item = m_messages.front();
-    if (item.message->IsType(CDVDMsg::DEMUXER_PACKET))
+    CSingleLock lock(m_section);
+
+    if (!m_prioMessages.empty() && (m_prioMessages.back().priority >= priority || m_drain))
     {
-      DemuxPacket* packet = ((CDVDMsgDemuxerPacket*)item.message)->GetPacket();
-      if (packet)
-      {
-        if (packet->dts != DVD_NOPTS_VALUE)
-          m_TimeFront = packet->dts;
-        else if (packet->pts != DVD_NOPTS_VALUE)
-          m_TimeFront = packet->pts;
+      DVDMessageListItem& item(m_prioMessages.back());
+      priority = item.priority;
 
-        if (m_TimeBack == DVD_NOPTS_VALUE)
-          m_TimeBack = m_TimeFront;
-      }
+      if (item.priority == 0)
+        m_iDataSize -= MakeRingItem(item.message).size;
+
+      *pMsg = item.message->Acquire();
+      m_prioMessages.pop_back();
+      m_prioCount--;
+      return true;
     }
+    return false;
   }
+
+  if (!TakeDataMessage(pMsg))
+    return false;
+
+  priority = 0;
+  UpdateTimeBack();
+  return true;
 }
 
-void CDVDMessageQueue::UpdateTimeBack()
+bool CDVDMessageQueue::TakeDataMessage(CDVDMsg** pMsg)
 {
-  if (!m_messages.empty())
+  DVDMessageRingItem item;
+  if (m_messages.Pop(item))
   {
-    auto &item = m_messages.back();
-    if (item.message->IsType(CDVDMsg::DEMUXER_PACKET))
-    {
-      DemuxPacket* packet = ((CDVDMsgDemuxerPacket*)item.message)->GetPacket();
-      if (packet)
-      {
-        if (packet->dts != DVD_NOPTS_VALUE)
-          m_TimeBack = packet->dts;
-        else if (packet->pts != DVD_NOPTS_VALUE)
-          m_TimeBack = packet->pts;
+    // the ring's reference goes to the caller
+    *pMsg = item.message;
+    m_iDataSize -= item.size;
+    return true;
+  }
 
-        if (m_TimeFront == DVD_NOPTS_VALUE)
-          m_TimeFront = m_TimeBack;
-      }
-    }
+  // the ring is older than the overflow, only take from it once the ring ran empty
+  if (m_overflowCount == 0)
+    return false;
+
+  CSingleLock lock(m_section);
+  if (m_overflow.empty())
+    return false;
+
+  DVDMessageListItem& entry(m_overflow.back());
+  *pMsg = entry.message->Acquire();
+  m_iDataSize -= MakeRingItem(entry.message).size;
+  m_overflow.pop_back();
+  m_overflowCount--;
+  return true;
+}
+
+void CDVDMessageQueue::UpdateTimeFront(double time)
+{
+  if (time == DVD_NOPTS_VALUE)
+    return;
+
+  m_TimeFront = time;
+
+  double none = DVD_NOPTS_VALUE;
+  m_TimeBack.compare_exchange_strong(none, time);
+}
+
+void CDVDMessageQueue::UpdateTimeBack()
+{
+  double time = DVD_NOPTS_VALUE;
+
+  if (const DVDMessageRingItem* item = m_messages.Front())
+    time = item->time;
+  else if (m_overflowCount > 0)
+  {
+    CSingleLock lock(m_section);
+    if (!m_overflow.empty())
+      time = MakeRingItem(m_overflow.back().message).time;
   }
+
+  if (time == DVD_NOPTS_VALUE)
+    return;
+
+  m_TimeBack = time;
+
+  double none = DVD_NOPTS_VALUE;
+  m_TimeFront.compare_exchange_strong(none, time);
 }
 
 unsigned CDVDMessageQueue::GetPacketCount(CDVDMsg::Message type)
 {
-  CSingleLock lock(m_section);
-
   if (!m_bInitialized)
     return 0;
 
+  CSingleLock producer(m_producerSection);
+  CSingleLock consumer(m_consumerSection);
+  CSingleLock lock(m_section);
+
   unsigned count = 0;
-  for (const auto &item : m_messages)
+  m_messages.ForEach([type, &count](const DVDMessageRingItem &item){
+    if (item.message->IsType(type))
+      count++;
+  });
+  for (const auto &item : m_overflow)
   {
     if(item.message->IsType(type))
       count++;
@@ -298,10 +397,7 @@ unsigned CDVDMessageQueue::GetPacketCount(CDVDMsg::Message type)
 
 void CDVDMessageQueue::WaitUntilEmpty()
 {
-  {
-    CSingleLock lock(m_section);
-    m_drain = true;
-  }
+  m_drain = true;
 
   CLog::Log(LOGNOTICE, "CDVDMessageQueue(%s)::WaitUntilEmpty", m_owner.c_str());
   CDVDMsgGeneralSynchronize* msg = new CDVDMsgGeneralSynchronize(40000, SYNCSOURCE_ANY);
@@ -309,30 +405,27 @@ void CDVDMessageQueue::WaitUntilEmpty()
   msg->Wait(m_bAbortRequest, 0);
   msg->Release();
 
-  {
-    CSingleLock lock(m_section);
-    m_drain = false;
-  }
+  m_drain = false;
 }
 
 int CDVDMessageQueue::GetLevel() const
 {
-  CSingleLock lock(m_section);
+  int dataSize = m_iDataSize;
 
-  if (m_iDataSize > m_iMaxDataSize)
+  if (dataSize > m_iMaxDataSize)
     return 100;
-  if (m_iDataSize == 0)
+  if (dataSize <= 0)
     return 0;
 
   if (IsDataBased())
   {
-    return std::min(100, 100 * m_iDataSize / m_iMaxDataSize);
+    return std::min(100, 100 * dataSize / m_iMaxDataSize);
   }
 
   int level = std::min(100.0, ceil(100.0 * m_TimeSize * (m_TimeFront - m_TimeBack) / DVD_TIME_BASE ));
 
   // if we added lots of packets with NOPTS, make sure that the queue is not signalled empty
-  if (level == 0 && m_iDataSize != 0)
+  if (level == 0 && dataSize != 0)
   {
     CLog::Log(LOGDEBUG, "CDVDMessageQueue::GetLevel() - can't determine level");
     return 1;
@@ -343,8 +436,6 @@ int CDVDMessageQueue::GetLevel() const
 
 int CDVDMessageQueue::GetTimeSize() const
 {
-  CSingleLock lock(m_section);
-
   if (IsDataBased())
     return 0;
   else
@@ -353,7 +444,10 @@ int CDVDMessageQueue::GetTimeSize() const
 
 bool CDVDMessageQueue::IsDataBased() const
 {
-  return (m_TimeBack == DVD_NOPTS_VALUE  ||
-          m_TimeFront == DVD_NOPTS_VALUE ||
-          m_TimeFront <= m_TimeBack);
+  double timeBack = m_TimeBack;
+  double timeFront = m_TimeFront;
+
+  return (timeBack == DVD_NOPTS_VALUE  ||
+          timeFront == DVD_NOPTS_VALUE ||
+          timeFront <= timeBack);
 }
@@ -27,6 +27,7 @@
 #include <algorithm>
 #include "threads/CriticalSection.h"
 #include "threads/Event.h"
+#include "threads/SPSCQueue.h"
 
 struct DVDMessageListItem
 {
@@ -53,6 +54,13 @@ struct DVDMessageListItem
   int priority;
 };
 
+struct DVDMessageRingItem
+{
+  CDVDMsg* message;
+  int size;     // payload size of a demuxer packet, 0 otherwise
+  double time;  // dts or pts of a demuxer packet
+};
+
 enum MsgQueueReturnCode
 {
   MSGQ_OK = 1,
@@ -111,25 +119,39 @@ public:
 private:
 
   MsgQueueReturnCode Put(CDVDMsg* pMsg, int priority, bool front);
-  void UpdateTimeFront();
+  bool TakeMessage(CDVDMsg** pMsg, int &priority);
+  bool TakeDataMessage(CDVDMsg** pMsg);
+  void UpdateTimeFront(double time);
   void UpdateTimeBack();
+  void Signal();
 
   CEvent m_hEvent;
+  /*!
+   \brief Guards the priority messages and the data overflow.
+   Packets put by the demuxer go through the lock-free ring and don't take it.
+   */
   mutable CCriticalSection m_section;
+  CCriticalSection m_producerSection; // serializes threads putting data messages
+  CCriticalSection m_consumerSection; // held while getting, keeps Flush away from the ring
 
   std::atomic<bool> m_bAbortRequest;
-  bool m_bInitialized;
-  bool m_drain = false;
+  std::atomic<bool> m_bInitialized;
+  std::atomic<bool> m_drain;
+  std::atomic<bool> m_waiting;
 
-  int m_iDataSize;
-  double m_TimeFront;
-  double m_TimeBack;
+  std::atomic<int> m_iDataSize;
+  std::atomic<double> m_TimeFront;
+  std::atomic<double> m_TimeBack;
   double m_TimeSize;
 
   int m_iMaxDataSize;
   std::string m_owner;
 
-  std::list<DVDMessageListItem> m_messages;
+  // data messages in order, the overflow takes over while the ring is full
+  XbmcThreads::CSPSCQueue<DVDMessageRingItem> m_messages;
+  std::list<DVDMessageListItem> m_overflow;
+  std::atomic<unsigned int> m_overflowCount;
+
   std::list<DVDMessageListItem> m_prioMessages;
+  std::atomic<unsigned int> m_prioCount;
 };
-
@@ -19,16 +19,26 @@
  */
 
 #include "DVDSubtitleLineCollection.h"
-#include <stddef.h>
 
+#include <algorithm>
+#include <limits>
 
-CDVDSubtitleLineCollection::CDVDSubtitleLineCollection()
+namespace
 {
-  m_pHead = NULL;
-  m_pCurrent = NULL;
-  m_pTail = NULL;
+  const double NoStopTime = std::numeric_limits<double>::lowest();
 
-  m_iSize = 0;
+  bool CompareStartTime(const CDVDOverlay* a, const CDVDOverlay* b)
+  {
+    return a->iPTSStartTime < b->iPTSStartTime;
+  }
+}
+
+CDVDSubtitleLineCollection::CDVDSubtitleLineCollection()
+{
+  m_leaves = 0;
+  m_current = 0;
+  m_sorted = true;
+  m_inOrder = true;
 }
 
 CDVDSubtitleLineCollection::~CDVDSubtitleLineCollection()
@@ -38,85 +48,113 @@ CDVDSubtitleLineCollection::~CDVDSubtitleLineCollection()
 
 void CDVDSubtitleLineCollection::Add(CDVDOverlay* pOverlay)
 {
-  ListElement* pElement = new ListElement;
-  pElement->pOverlay = pOverlay;
-  pElement->pNext = NULL;
-
-  if (!m_pHead)
-  {
-    m_pHead = m_pTail = pElement;
-    m_pCurrent = m_pHead;
-  }
-  else
+  if (!m_overlays.empty() && pOverlay->iPTSStartTime < m_overlays.back()->iPTSStartTime)
   {
-    m_pTail->pNext = pElement;
-    m_pTail = pElement;
+    m_sorted = false;
+    m_inOrder = false;
   }
 
-  m_iSize++;
+  m_overlays.push_back(pOverlay);
+
+  // an unsorted collection gets its tree when it is sorted
+  if (!m_sorted)
+    return;
+
+  if (m_overlays.size() > m_leaves)
+    BuildTree();
+  else
+    UpdateTree(m_overlays.size() - 1);
 }
 
 void CDVDSubtitleLineCollection::Sort()
 {
-  if (!m_pHead || !m_pHead->pNext)
-    return;
-  
-  for (ListElement* p1 = m_pHead; p1->pNext != NULL; p1 = p1->pNext)
+  if (!m_sorted)
   {
-    for (ListElement* p2 = p1->pNext; p2 != NULL; p2 = p2->pNext)
-    {
-      if (p1->pOverlay->iPTSStartTime > p2->pOverlay->iPTSStartTime)
-      {
-        CDVDOverlay* temp = p1->pOverlay;
-        p1->pOverlay = p2->pOverlay;
-        p2->pOverlay = temp;
-      }
-    }
+    // overlays handed out already keep their place so they are not returned twice
+    std::stable_sort(m_overlays.begin() + m_current, m_overlays.end(), CompareStartTime);
+    m_sorted = true;
   }
+
+  // parsers may set stop times after adding an overlay
+  BuildTree();
 }
 
 CDVDOverlay* CDVDSubtitleLineCollection::Get(double iPts)
 {
-  CDVDOverlay* pOverlay = NULL;
+  if (!m_sorted)
+    Sort();
 
-  if (m_pCurrent)
-  {
-    while (m_pCurrent && m_pCurrent->pOverlay->iPTSStopTime < iPts)
-    {
-      m_pCurrent = m_pCurrent->pNext;
-    }
-
-    if (m_pCurrent)
-    {
-      pOverlay = m_pCurrent->pOverlay;
-
-      // advance to the next overlay
-      m_pCurrent = m_pCurrent->pNext;
-    }
-  }
-  return pOverlay;
+  if (m_current >= m_overlays.size())
+    return NULL;
+
+  m_current = FindShowing(1, 0, m_leaves, m_current, iPts);
+  if (m_current >= m_overlays.size())
+    return NULL;
+
+  return m_overlays[m_current++];
 }
 
 void CDVDSubtitleLineCollection::Reset()
 {
-  m_pCurrent = m_pHead;
+  m_current = 0;
 }
 
 void CDVDSubtitleLineCollection::Clear()
 {
-  ListElement* pElement = NULL;
+  for (CDVDOverlay* pOverlay : m_overlays)
+    pOverlay->Release();
+
+  m_overlays.clear();
+  m_stopTree.clear();
+  m_leaves = 0;
+  m_current = 0;
+  m_sorted = true;
+  m_inOrder = true;
+}
 
-  while (m_pHead)
-  {
-    pElement = m_pHead;
-    m_pHead = pElement->pNext;
+double CDVDSubtitleLineCollection::GetLastStartTime() const
+{
+  if (m_overlays.empty())
+    return 0.0;
+  return m_overlays.back()->iPTSStartTime;
+}
 
-    pElement->pOverlay->Release();
-    delete pElement;
+void CDVDSubtitleLineCollection::BuildTree()
+{
+  if (m_leaves < m_overlays.size())
+  {
+    m_leaves = std::max<size_t>(m_leaves, 64);
+    while (m_leaves < m_overlays.size())
+      m_leaves <<= 1;
   }
 
-  m_pTail    = NULL;
-  m_pHead    = NULL;
-  m_pCurrent = NULL;
-  m_iSize    = 0;
+  m_stopTree.assign(m_leaves * 2, NoStopTime);
+  for (size_t i = 0; i < m_overlays.size(); i++)
+    m_stopTree[m_leaves + i] = m_overlays[i]->iPTSStopTime;
+  for (size_t node = m_leaves - 1; node > 0; node--)
+    m_stopTree[node] = std::max(m_stopTree[node * 2], m_stopTree[node * 2 + 1]);
+}
+
+void CDVDSubtitleLineCollection::UpdateTree(size_t index)
+{
+  size_t node = m_leaves + index;
+  m_stopTree[node] = m_overlays[index]->iPTSStopTime;
+  for (node >>= 1; node > 0; node >>= 1)
+    m_stopTree[node] = std::max(m_stopTree[node * 2], m_stopTree[node * 2 + 1]);
+}
+
+// first index from on whose overlay stops at pts or later, end if there is none
+size_t CDVDSubtitleLineCollection::FindShowing(size_t node, size_t begin, size_t end, size_t from, double pts) const
+{
+  if (end <= from || m_stopTree[node] < pts)
+    return m_overlays.size();
+
+  if (end - begin == 1)
+    return begin;
+
+  size_t middle = (begin + end) / 2;
+  size_t index = FindShowing(node * 2, begin, middle, from, pts);
+  if (index < m_overlays.size())
+    return index;
+  return FindShowing(node * 2 + 1, middle, end, from, pts);
 }
@@ -22,39 +22,54 @@
 
 #include "../DVDCodecs/Overlay/DVDOverlay.h"
 
-typedef struct stListElement
-{
-  CDVDOverlay* pOverlay;
-  struct stListElement* pNext;
+#include <stddef.h>
+#include <vector>
 
-} ListElement;
+/*!
+ \brief Overlays of a subtitle file ordered by start time.
 
+ Overlays may overlap. Stop times are kept in a max tree over the sorted array
+ so Get finds the first overlay still showing at a pts in O(log n), whether
+ playback moves on or seeks.
+ */
 class CDVDSubtitleLineCollection
 {
 public:
   CDVDSubtitleLineCollection();
   virtual ~CDVDSubtitleLineCollection();
 
-  //void Lock()   { EnterCriticalSection(&m_critSection); }
-  //void Unlock() { LeaveCriticalSection(&m_critSection); }
-
   void Add(CDVDOverlay* pSubtitle);
+  /*!
+   \brief Sorts by start time. Call it after changing the stop time of an overlay already added.
+   */
   void Sort();
 
-  CDVDOverlay* Get(double iPts = 0LL); // get the first overlay in this fifo
+  /*!
+   \brief Returns the next overlay that has not stopped at iPts and moves past it.
+   Overlays are returned once, Reset makes them available again.
+   */
+  CDVDOverlay* Get(double iPts = 0LL);
 
   void Reset();
 
-  void Remove();
   void Clear();
-  int GetSize() { return m_iSize; }
+  int GetSize() { return static_cast<int>(m_overlays.size()); }
+
+  /*! \brief Start time of the overlay added last, 0 if there is none */
+  double GetLastStartTime() const;
+  /*! \brief False once an overlay was added that starts before the one added ahead of it */
+  bool IsInOrder() const { return m_inOrder; }
 
 private:
-  ListElement* m_pHead;
-  ListElement* m_pCurrent;
-  ListElement* m_pTail;
+  void BuildTree();
+  void UpdateTree(size_t index);
+  size_t FindShowing(size_t node, size_t begin, size_t end, size_t from, double pts) const;
 
-  int m_iSize;
-  //CRITICAL_SECTION m_critSection;
+  std::vector<CDVDOverlay*> m_overlays;
+  // max stop time per subtree, leaves from m_leaves on, unused leaves hold the lowest value
+  std::vector<double> m_stopTree;
+  size_t m_leaves;
+  size_t m_current; // first overlay not handed out since the last reset
+  bool m_sorted;
+  bool m_inOrder;
 };
-
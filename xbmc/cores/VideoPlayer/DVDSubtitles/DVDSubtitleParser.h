@@ -23,11 +23,15 @@
 #include "../DVDCodecs/Overlay/DVDOverlay.h"
 #include "DVDSubtitleStream.h"
 #include "DVDSubtitleLineCollection.h"
+#include "TimingConstants.h"
 
 #include <memory>
 #include <string>
 #include <stdio.h>
 
+// how far ahead of playback streaming parsers read
+#define SUBTITLE_PARSE_AHEAD DVD_SEC_TO_TIME(60)
+
 class CDVDStreamInfo;
 
 class CDVDSubtitleParser
@@ -73,10 +77,23 @@ public:
 
   ~CDVDSubtitleParserText() override = default;
 
+  CDVDOverlay* Parse(double iPts) override
+  {
+    ParseAhead(iPts);
+    return CDVDSubtitleParserCollection::Parse(iPts);
+  }
+  void Dispose() override
+  {
+    m_streaming = false;
+    CDVDSubtitleParserCollection::Dispose();
+  }
+
 protected:
   using CDVDSubtitleParserCollection::Open;
   bool Open()
   {
+    m_streaming = false;
+
     if(m_pStream)
     {
       if(m_pStream->Seek(0, SEEK_SET) == 0)
@@ -88,5 +105,35 @@ protected:
     return m_pStream->Open(m_filename);
   }
 
+  /*!
+   \brief Adds the next subtitle of the stream to the collection.
+   Parsers that can read their file piece by piece implement this and call
+   StartStreaming at the end of Open instead of reading everything there.
+   \return false once the stream has nothing left
+   */
+  virtual bool ParseNext() { return false; }
+
+  void StartStreaming() { m_streaming = true; }
+
+  /*!
+   \brief Reads subtitles until the ones starting within SUBTITLE_PARSE_AHEAD of pts are known.
+   */
+  void ParseAhead(double pts)
+  {
+    while (m_streaming && (m_collection.GetSize() == 0 ||
+                           m_collection.GetLastStartTime() < pts + SUBTITLE_PARSE_AHEAD))
+    {
+      if (!ParseNext())
+        m_streaming = false;
+      // subtitles out of order could show up anywhere in the rest of the file
+      else if (!m_collection.IsInOrder())
+      {
+        while (ParseNext()) ;
+        m_streaming = false;
+      }
+    }
+  }
+
   std::unique_ptr<CDVDSubtitleStream> m_pStream;
+  bool m_streaming = false;
 };
@@ -51,35 +51,38 @@ bool CDVDSubtitleParserMicroDVD::Open(CDVDStreamInfo &hints)
   else
     m_framerate = DVD_TIME_BASE / 25.0;
 
-  char line[1024];
-
-  CRegExp reg;
-  if (!reg.RegComp("\\{([0-9]+)\\}\\{([0-9]+)\\}"))
+  if (!m_reg.RegComp("\\{([0-9]+)\\}\\{([0-9]+)\\}"))
     return false;
-  CDVDSubtitleTagMicroDVD TagConv;
+
+  StartStreaming();
+  return true;
+}
+
+bool CDVDSubtitleParserMicroDVD::ParseNext()
+{
+  char line[1024];
 
   while (m_pStream->ReadLine(line, sizeof(line)))
   {
     if ((strlen(line) > 0) && (line[strlen(line) - 1] == '\r'))
       line[strlen(line) - 1] = 0;
 
-    int pos = reg.RegFind(line);
+    int pos = m_reg.RegFind(line);
     if (pos > -1)
     {
-      const char* text = line + pos + reg.GetFindLen();
-      std::string startFrame(reg.GetMatch(1));
-      std::string endFrame  (reg.GetMatch(2));
+      const char* text = line + pos + m_reg.GetFindLen();
+      std::string startFrame(m_reg.GetMatch(1));
+      std::string endFrame  (m_reg.GetMatch(2));
       CDVDOverlayText* pOverlay = new CDVDOverlayText();
       pOverlay->Acquire(); // increase ref count with one so that we can hold a handle to this overlay
 
       pOverlay->iPTSStartTime = m_framerate * atoi(startFrame.c_str());
       pOverlay->iPTSStopTime  = m_framerate * atoi(endFrame.c_str());
 
-      TagConv.ConvertLine(pOverlay, text, strlen(text));
+      m_tagConv.ConvertLine(pOverlay, text, strlen(text));
       m_collection.Add(pOverlay);
+      return true;
     }
   }
-
-  return true;
+  return false;
 }
-
@@ -21,6 +21,8 @@
  */
 
 #include "DVDSubtitleParser.h"
+#include "DVDSubtitleTagMicroDVD.h"
+#include "utils/RegExp.h"
 
 #include <memory>
 
@@ -31,6 +33,12 @@ public:
   ~CDVDSubtitleParserMicroDVD() override;
 
   bool Open(CDVDStreamInfo &hints) override;
+
+protected:
+  bool ParseNext() override;
+
 private:
   double m_framerate;
+  CRegExp m_reg;
+  CDVDSubtitleTagMicroDVD m_tagConv;
 };
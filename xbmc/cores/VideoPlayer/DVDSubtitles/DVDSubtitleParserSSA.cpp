@@ -73,5 +73,5 @@ void CDVDSubtitleParserSSA::Dispose()
     SAFE_RELEASE(m_libass);
     CLog::Log(LOGINFO, "SSA Parser: Releasing reference to ASS Library");
   }
-  CDVDSubtitleParserCollection::Dispose();
+  CDVDSubtitleParserText::Dispose();
 }
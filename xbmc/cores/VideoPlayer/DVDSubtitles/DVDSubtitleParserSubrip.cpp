@@ -22,7 +22,6 @@
 #include "DVDCodecs/Overlay/DVDOverlayText.h"
 #include "TimingConstants.h"
 #include "utils/StringUtils.h"
-#include "DVDSubtitleTagSami.h"
 
 CDVDSubtitleParserSubrip::CDVDSubtitleParserSubrip(std::unique_ptr<CDVDSubtitleStream> && pStream, const std::string& strFile)
     : CDVDSubtitleParserText(std::move(pStream), strFile)
@@ -39,10 +38,15 @@ bool CDVDSubtitleParserSubrip::Open(CDVDStreamInfo &hints)
   if (!CDVDSubtitleParserText::Open())
     return false;
 
-  CDVDSubtitleTagSami TagConv;
-  if (!TagConv.Init())
+  if (!m_tagConv.Init())
     return false;
 
+  StartStreaming();
+  return true;
+}
+
+bool CDVDSubtitleParserSubrip::ParseNext()
+{
   char line[1024];
   std::string strLine;
 
@@ -79,14 +83,13 @@ bool CDVDSubtitleParserSubrip::Open(CDVDStreamInfo &hints)
           // empty line, next subtitle is about to start
           if (strLine.length() <= 0) break;
 
-          TagConv.ConvertLine(pOverlay, strLine.c_str(), strLine.length());
+          m_tagConv.ConvertLine(pOverlay, strLine.c_str(), strLine.length());
         }
-        TagConv.CloseTag(pOverlay);
+        m_tagConv.CloseTag(pOverlay);
         m_collection.Add(pOverlay);
+        return true;
       }
     }
   }
-  m_collection.Sort();
-  return true;
+  return false;
 }
-
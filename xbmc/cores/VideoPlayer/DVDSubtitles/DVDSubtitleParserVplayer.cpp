@@ -90,7 +90,7 @@ bool CDVDSubtitleParserVplayer::Open(CDVDStreamInfo &hints)
     if (pPrevOverlay)
       pPrevOverlay->iPTSStopTime = pPrevOverlay->iPTSStartTime + iDefaultDuration;
   }
-
+  m_collection.Sort();
   return true;
 }
 
@@ -31,6 +31,7 @@
 #include "DVDInputStreams/DVDInputStreamPVRManager.h"
 
 #include "DVDDemuxers/DVDDemux.h"
+#include "DVDDemuxers/DVDDemuxReadAhead.h"
 #include "DVDDemuxers/DVDDemuxUtils.h"
 #include "DVDDemuxers/DVDDemuxVobsub.h"
 #include "DVDDemuxers/DVDFactoryDemuxer.h"
@@ -132,15 +133,16 @@ static void dump_packet(DemuxPacket *packet, bool video, bool audio)
 #ifdef DEBUG_PLAYBACK
     DemuxPacket p = {0};
     int s = fread(&p, sizeof p, 1, fp);
-    if (s==1)
+    // the payload belongs to the packet pool, so replay only fits into what was demuxed
+    if (s==1 && p.iSize <= packet->iSize)
     {
       packet->iSize = p.iSize;
       packet->dts = p.dts;
       packet->pts = p.pts;
-      _aligned_free(packet->pData);
-      packet->pData = (uint8_t*)_aligned_malloc(packet->iSize + FF_INPUT_BUFFER_PADDING_SIZE, 16);
       fread(packet->pData, packet->iSize, 1, fp);
     }
+    else if (s==1)
+      fseek(fp, p.iSize, SEEK_CUR);
 #else
     if (fwrite(packet, sizeof *packet, 1, fp) == 1)
       fwrite(packet->pData, packet->iSize, 1, fp);
@@ -949,6 +951,19 @@ bool CVideoPlayer::OpenDemuxStream()
     return false;
   }
 
+  // let slow reads from files happen on a thread of their own
+  if (g_advancedSettings.m_videoDemuxReadAheadSecs > 0 &&
+      (m_pInputStream->IsStreamType(DVDSTREAM_TYPE_FILE) || m_pInputStream->IsStreamType(DVDSTREAM_TYPE_FFMPEG)))
+  {
+    if (CDVDDemuxFFmpeg* demuxer = dynamic_cast<CDVDDemuxFFmpeg*>(m_pDemuxer))
+    {
+      CLog::Log(LOGNOTICE, "%s - Reading ahead %.1f s / %d MB", __FUNCTION__,
+                g_advancedSettings.m_videoDemuxReadAheadSecs, g_advancedSettings.m_videoDemuxReadAheadMB);
+      m_pDemuxer = new CDVDDemuxReadAhead(demuxer, g_advancedSettings.m_videoDemuxReadAheadMB * 1024 * 1024,
+                                          g_advancedSettings.m_videoDemuxReadAheadSecs);
+    }
+  }
+
   m_SelectionStreams.Clear(STREAM_NONE, STREAM_SOURCE_DEMUX);
   m_SelectionStreams.Clear(STREAM_NONE, STREAM_SOURCE_NAV);
   m_SelectionStreams.Update(m_pInputStream, m_pDemuxer);
@@ -5164,6 +5179,18 @@ void CVideoPlayer::UpdatePlayState(double timeout)
 
   state.timestamp = m_clock.GetAbsoluteClock();
 
+  uint64_t readAheadBytes = 0;
+  double readAheadTime = 0.0;
+  int readAheadLevel = 0;
+  if (CDVDDemuxReadAhead* readAhead = dynamic_cast<CDVDDemuxReadAhead*>(m_pDemuxer))
+    readAhead->GetBufferLevel(readAheadBytes, readAheadTime, readAheadLevel);
+  CServiceBroker::GetDataCacheCore().SetDemuxReadAhead(readAheadBytes, readAheadTime, readAheadLevel);
+
+  SDemuxPacketPoolStats poolStats;
+  CDVDDemuxUtils::GetPacketPoolStats(poolStats);
+  CServiceBroker::GetDataCacheCore().SetDemuxPacketPool(poolStats.packetsInUse, poolStats.payloads,
+                                                        poolStats.payloadsReused, poolStats.pooledBytes);
+
   CSingleLock lock(m_StateSection);
   m_State = state;
 }
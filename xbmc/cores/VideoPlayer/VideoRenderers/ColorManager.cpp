@@ -44,6 +44,17 @@ CColorManager::CColorManager()
 #if defined(HAVE_LCMS2)
   m_hProfile = NULL;
 #endif  //defined(HAVE_LCMS2)
+
+  const CSettings& settings = CServiceBroker::GetSettings();
+  m_enabled = settings.GetHandle<bool>("videoscreen.cmsenabled");
+  m_cmsMode = settings.GetHandle<int>("videoscreen.cmsmode");
+  m_3dlutFile = settings.GetHandle<std::string>("videoscreen.cms3dlut");
+  m_displayProfile = settings.GetHandle<std::string>("videoscreen.displayprofile");
+  m_whitePoint = settings.GetHandle<int>("videoscreen.cmswhitepoint");
+  m_primaries = settings.GetHandle<int>("videoscreen.cmsprimaries");
+  m_gammaMode = settings.GetHandle<int>("videoscreen.cmsgammamode");
+  m_gamma = settings.GetHandle<int>("videoscreen.cmsgamma");
+  m_lutSize = settings.GetHandle<int>("videoscreen.cmslutsize");
 }
 
 CColorManager::~CColorManager()
@@ -61,7 +72,7 @@ bool CColorManager::IsEnabled()
 {
   //TODO: check that the configuration is valid here (files exist etc)
 
-  return CServiceBroker::GetSettings().GetBool("videoscreen.cmsenabled");
+  return m_enabled.Get();
 }
 
 CMS_PRIMARIES videoFlagsToPrimaries(int flags)
@@ -170,31 +181,31 @@ bool CColorManager::CheckConfiguration(int cmsToken, int flags)
 {
   if (cmsToken != m_curCmsToken)
     return false;
-  if (m_curCmsMode != CServiceBroker::GetSettings().GetInt("videoscreen.cmsmode"))
+  if (m_curCmsMode != m_cmsMode.Get())
     return false;   // CMS mode has changed
   switch (m_curCmsMode)
   {
   case CMS_MODE_3DLUT:
-    if (m_cur3dlutFile != CServiceBroker::GetSettings().GetString("videoscreen.cms3dlut"))
+    if (m_cur3dlutFile != m_3dlutFile.Get())
       return false; // different 3dlut file selected
     break;
   case CMS_MODE_PROFILE:
 #if defined(HAVE_LCMS2)
-    if (m_curIccProfile != CServiceBroker::GetSettings().GetString("videoscreen.displayprofile"))
+    if (m_curIccProfile != m_displayProfile.Get())
       return false; // different ICC profile selected
-    if (m_curIccWhitePoint != CServiceBroker::GetSettings().GetInt("videoscreen.cmswhitepoint"))
+    if (m_curIccWhitePoint != m_whitePoint.Get())
       return false; // whitepoint changed
     {
-      CMS_PRIMARIES primaries = (CMS_PRIMARIES)CServiceBroker::GetSettings().GetInt("videoscreen.cmsprimaries");
+      CMS_PRIMARIES primaries = (CMS_PRIMARIES)m_primaries.Get();
       if (primaries == CMS_PRIMARIES_AUTO) primaries = videoFlagsToPrimaries(flags);
       if (m_curIccPrimaries != primaries)
         return false; // primaries changed
     }
-    if (m_m_curIccGammaMode != (CMS_TRC_TYPE)CServiceBroker::GetSettings().GetInt("videoscreen.cmsgammamode"))
+    if (m_m_curIccGammaMode != (CMS_TRC_TYPE)m_gammaMode.Get())
       return false; // gamma mode changed
-    if (m_curIccGamma != CServiceBroker::GetSettings().GetInt("videoscreen.cmsgamma"))
+    if (m_curIccGamma != m_gamma.Get())
       return false; // effective gamma changed
-    if (m_curClutSize != 1 << CServiceBroker::GetSettings().GetInt("videoscreen.cmslutsize"))
+    if (m_curClutSize != 1 << m_lutSize.Get())
       return false; // CLUT size changed
     // TODO: check other parameters
 #else   //defined(HAVE_LCMS2)
@@ -26,6 +26,8 @@
 
 #include <string>
 
+#include "settings/lib/SettingHandle.h"
+
 enum CMS_MODE
 {
   CMS_MODE_3DLUT,
@@ -160,6 +162,16 @@ private:
   std::string m_cur3dlutFile;
   std::string m_curIccProfile;
 
+  // checked on every frame
+  CSettingHandle<bool> m_enabled;
+  CSettingHandle<int> m_cmsMode;
+  CSettingHandle<std::string> m_3dlutFile;
+  CSettingHandle<std::string> m_displayProfile;
+  CSettingHandle<int> m_whitePoint;
+  CSettingHandle<int> m_primaries;
+  CSettingHandle<int> m_gammaMode;
+  CSettingHandle<int> m_gamma;
+  CSettingHandle<int> m_lutSize;
 };
 
 
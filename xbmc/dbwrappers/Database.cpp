@@ -23,6 +23,7 @@
 #include "filesystem/SpecialProtocol.h"
 #include "filesystem/File.h"
 #include "profiles/ProfilesManager.h"
+#include "utils/DatabaseUtils.h"
 #include "utils/log.h"
 #include "utils/SortUtils.h"
 #include "utils/StringUtils.h"
@@ -673,6 +674,41 @@ bool CDatabase::BuildSQL(const std::string &strQuery, const Filter &filter, std:
   return true;
 }
 
+std::vector<std::string> CDatabase::GetIdLists(const std::set<int> &ids)
+{
+  // keep the queries well below the statement size limits of sqlite and mysql
+  static const size_t maxIds = 500;
+
+  std::vector<std::string> lists;
+  std::string list;
+  size_t count = 0;
+  for (std::set<int>::const_iterator id = ids.begin(); id != ids.end(); ++id)
+  {
+    if (!list.empty())
+      list += ",";
+    list += StringUtils::Format("%i", *id);
+    if (++count == maxIds)
+    {
+      lists.push_back(list);
+      list.clear();
+      count = 0;
+    }
+  }
+  if (!list.empty())
+    lists.push_back(list);
+
+  return lists;
+}
+
+bool CDatabase::BuildSortSQL(const SortDescription &sorting, const MediaType &mediaType, std::string &orderBy) const
+{
+  // the collation used to compare labels is only available with sqlite
+  if (!m_sqlite || !g_advancedSettings.m_databaseSorting)
+    return false;
+
+  return DatabaseUtils::BuildOrderByClause(sorting, mediaType, SQLITE_COLLATION_ALPHANUM, orderBy);
+}
+
 bool CDatabase::BuildSQL(const std::string &strBaseDir, const std::string &strQuery, Filter &filter, std::string &strSQL, CDbUrl &dbUrl)
 {
   SortDescription sorting;
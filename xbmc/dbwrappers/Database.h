@@ -26,9 +26,12 @@ namespace dbiplus {
 }
 
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
+#include "media/MediaType.h"
+
 class DatabaseSettings; // forward
 class CDbUrl;
 struct SortDescription;
@@ -216,6 +219,23 @@ protected:
 
   bool BuildSQL(const std::string &strQuery, const Filter &filter, std::string &strSQL);
 
+  /*! \brief Split a set of ids into comma separated lists short enough to be
+   used in an IN (...) clause, e.g. to load details of many items at once.
+   \param ids the ids to split
+   \return the comma separated lists of ids
+   */
+  static std::vector<std::string> GetIdLists(const std::set<int> &ids);
+
+  /*! \brief Get an ORDER BY clause which lets the database do the sorting
+   described by the given sort description instead of SortUtils.
+   \param sorting the sort description to translate
+   \param mediaType the media type of the view being queried
+   \param orderBy the resulting ORDER BY clause
+   \return true if the database can do the sorting, false otherwise
+   \sa DatabaseUtils::BuildOrderByClause
+   */
+  bool BuildSortSQL(const SortDescription &sorting, const MediaType &mediaType, std::string &orderBy) const;
+
   bool m_sqlite; ///< \brief whether we use sqlite (defaults to true)
 
   std::unique_ptr<dbiplus::Database> m_pDB;
@@ -202,6 +202,38 @@ void Dataset::parse_sql(std::string &sql) {
 }
 
 
+bool Dataset::query(const std::string &sql, const BindParams &params) {
+  if (db == NULL) throw DbErrors("No Database Connection");
+
+  std::string qry;
+  qry.reserve(sql.size());
+  BindParams::const_iterator param = params.begin();
+  bool quoted = false;
+  for (std::string::const_iterator c = sql.begin(); c != sql.end(); ++c) {
+    if (*c == '\'')
+      quoted = !quoted;
+    if (*c != '?' || quoted) {
+      qry += *c;
+      continue;
+    }
+    if (param == params.end())
+      throw DbErrors("Not enough parameters for query: %s", sql.c_str());
+
+    if (param->get_isNull())
+      qry += "NULL";
+    else if (param->get_fType() == ft_String || param->get_fType() == ft_Char)
+      qry += db->prepare("'%s'", param->get_asString().c_str());
+    else if (param->get_fType() == ft_Float || param->get_fType() == ft_Double)
+      qry += param->get_asString();
+    else
+      qry += db->prepare("%lld", (long long)param->get_asInt64());
+    ++param;
+  }
+
+  return query(qry);
+}
+
+
 void Dataset::close(void) {
   haveError  = false;
   frecno = 0;
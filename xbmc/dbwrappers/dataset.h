@@ -183,6 +183,7 @@ enum sqlType {sqlSelect,sqlUpdate,sqlInsert,sqlDelete,sqlExec};
 
 typedef std::list<std::string> StringList;
 typedef std::map<std::string,field_value> ParamList;
+typedef std::vector<field_value> BindParams;
 
 
 class Dataset  {
@@ -308,6 +309,10 @@ public:
   virtual const void* getExecRes()=0;
 /* as open, but with our query exec Sql */
   virtual bool query(const std::string &sql) = 0;
+/* as query, but with each ? placeholder in sql replaced by the matching
+   value in params. Drivers supporting it bind the values to a cached
+   prepared statement instead of formatting them into the SQL text */
+  virtual bool query(const std::string &sql, const BindParams &params);
 /* Close SQL Query*/
   virtual void close();
 /* This function looks for field Field_name with value equal Field_value
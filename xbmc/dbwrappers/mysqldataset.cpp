@@ -1583,8 +1583,7 @@ bool MysqlDataset::query(const std::string &query) {
   // returned rows
   while ((row = mysql_fetch_row(stmt)))
   { // have a row of data
-    sql_record *res = new sql_record;
-    res->resize(numColumns);
+    sql_record *res = result.add_record(numColumns);
     for (unsigned int i = 0; i < numColumns; i++)
     {
       field_value &v = res->at(i);
@@ -1636,7 +1635,6 @@ bool MysqlDataset::query(const std::string &query) {
           break;
       }
     }
-    result.records.push_back(res);
   }
   mysql_free_result(stmt);
   active = true;
@@ -1721,7 +1719,8 @@ void MysqlDataset::free_row(void)
   sql_record *row = result.records[frecno];
   if (row)
   {
-    delete row;
+    // the record itself belongs to the result set, only release its fields
+    sql_record().swap(*row);
     result.records[frecno] = NULL;
   }
 }
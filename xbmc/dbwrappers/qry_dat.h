@@ -28,6 +28,7 @@
  *
  **********************************************************************/
 
+#include <deque>
 #include <map>
 #include <vector>
 #include <iostream>
@@ -77,6 +78,7 @@ private:
 public:
   field_value();
   field_value(const char *s);
+  field_value(const std::string &s);
   field_value(const bool b);
   field_value(const char c);
   field_value(const short s);
@@ -230,15 +232,25 @@ public:
   };
   void clear()
   {
-    for (unsigned int i = 0; i < records.size(); i++)
-      if (records[i])
-        delete records[i];
     records.clear();
+    record_storage.clear();
     record_header.clear();
   };
+  /* adds a new record with ncols fields to the result set. The record
+     is kept in a block allocated storage owned by the result set instead of
+     being allocated on its own, so don't delete it */
+  sql_record* add_record(unsigned int ncols)
+  {
+    record_storage.emplace_back(ncols);
+    records.push_back(&record_storage.back());
+    return records.back();
+  };
 
   record_prop record_header;
   query_data records;
+
+private:
+  std::deque<sql_record> record_storage;
 };
 
 } // namespace
@@ -32,6 +32,7 @@
 #include "sqlitedataset.h"
 #include "utils/log.h"
 #include "system.h" // for Sleep(), OutputDebugString() and GetLastError()
+#include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 
 #ifdef TARGET_POSIX
@@ -57,8 +58,7 @@ int callback(void* res_ptr,int ncol, char** result,char** cols)
 
   if (result != NULL)
   {
-    sql_record *rec = new sql_record;
-    rec->resize(ncol);
+    sql_record *rec = r->add_record(ncol);
     for (int i=0; i<ncol; i++)
     { 
       field_value &v = rec->at(i);
@@ -72,7 +72,6 @@ int callback(void* res_ptr,int ncol, char** result,char** cols)
         v.set_asString(result[i]);
       }
     }
-    r->records.push_back(rec);
   }
   return 0;  
 }
@@ -83,6 +82,55 @@ static int busy_callback(void*, int busyCount)
   return 1;
 }
 
+static void utf8_to_wstring(const unsigned char* str, int len, std::wstring& out)
+{
+  // sqlite hands us raw (and not necessarily valid) UTF-8 for every single
+  // comparison so decode it here instead of going through iconv
+  out.clear();
+  out.reserve(len);
+  for (int i = 0; i < len; )
+  {
+    uint32_t c = str[i++];
+    int extra = 0;
+    if (c >= 0xF0)
+    {
+      c &= 0x07;
+      extra = 3;
+    }
+    else if (c >= 0xE0)
+    {
+      c &= 0x0F;
+      extra = 2;
+    }
+    else if (c >= 0xC0)
+    {
+      c &= 0x1F;
+      extra = 1;
+    }
+    for (; extra > 0 && i < len && (str[i] & 0xC0) == 0x80; extra--)
+      c = (c << 6) | (str[i++] & 0x3F);
+#if WCHAR_MAX <= 0xFFFF
+    if (c > 0xFFFF)
+    {
+      c -= 0x10000;
+      out.push_back(static_cast<wchar_t>(0xD800 + (c >> 10)));
+      c = 0xDC00 + (c & 0x3FF);
+    }
+#endif
+    out.push_back(static_cast<wchar_t>(c));
+  }
+}
+
+static int alphanum_collation(void*, int len1, const void* str1, int len2, const void* str2)
+{
+  std::wstring left, right;
+  utf8_to_wstring(static_cast<const unsigned char*>(str1), len1, left);
+  utf8_to_wstring(static_cast<const unsigned char*>(str2), len2, right);
+
+  int64_t result = StringUtils::AlphaNumericCompare(left.c_str(), right.c_str());
+  return result < 0 ? -1 : (result > 0 ? 1 : 0);
+}
+
 //************* SqliteDatabase implementation ***************
 
 SqliteDatabase::SqliteDatabase() {
@@ -220,6 +268,7 @@ int SqliteDatabase::connect(bool create) {
     if (sqlite3_open_v2(db_fullpath.c_str(), &conn, flags, NULL)==SQLITE_OK)
     {
       sqlite3_busy_handler(conn, busy_callback, NULL);
+      sqlite3_create_collation(conn, SQLITE_COLLATION_ALPHANUM, SQLITE_UTF8, NULL, alphanum_collation);
       char* err=NULL;
       if (setErr(sqlite3_exec(getHandle(),"PRAGMA empty_result_callbacks=ON",NULL,NULL,&err),"PRAGMA empty_result_callbacks=ON") != SQLITE_OK)
       {
@@ -257,6 +306,7 @@ bool SqliteDatabase::exists(void)
 
 void SqliteDatabase::disconnect(void) {
   if (active == false) return;
+  clear_statements();
   sqlite3_close(conn);
   active = false;
 }
@@ -412,6 +462,45 @@ void SqliteDatabase::rollback_transaction() {
 }
 
 
+// methods for prepared statements
+// ---------------------------------------------
+sqlite3_stmt *SqliteDatabase::get_statement(const std::string &sql)
+{
+  std::unordered_map<std::string, StatementList::iterator>::iterator it = statement_index.find(sql);
+  if (it != statement_index.end())
+  {
+    // move it to the front of the list
+    statements.splice(statements.begin(), statements, it->second);
+    return it->second->second;
+  }
+
+  sqlite3_stmt *stmt = NULL;
+  if (setErr(sqlite3_prepare_v2(conn, sql.c_str(), -1, &stmt, NULL), sql.c_str()) != SQLITE_OK)
+    throw DbErrors(getErrorMsg());
+
+  statements.push_front(std::make_pair(sql, stmt));
+  statement_index[sql] = statements.begin();
+
+  // drop the least recently used statement
+  if (statements.size() > SQLITE_STATEMENT_CACHE_SIZE)
+  {
+    statement_index.erase(statements.back().first);
+    sqlite3_finalize(statements.back().second);
+    statements.pop_back();
+  }
+
+  return stmt;
+}
+
+void SqliteDatabase::clear_statements()
+{
+  for (StatementList::iterator it = statements.begin(); it != statements.end(); ++it)
+    sqlite3_finalize(it->second);
+  statements.clear();
+  statement_index.clear();
+}
+
+
 // methods for formatting
 // ---------------------------------------------
 std::string SqliteDatabase::vprepare(const char *format, va_list args)
@@ -636,20 +725,7 @@ const void* SqliteDataset::getExecRes() {
 }
 
 
-bool SqliteDataset::query(const std::string &query) {
-    if(!handle()) throw DbErrors("No Database Connection");
-    std::string qry = query;
-    int fs = qry.find("select");
-    int fS = qry.find("SELECT");
-    if (!( fs >= 0 || fS >=0))                                 
-         throw DbErrors("MUST be select SQL!"); 
-
-  close();
-
-  sqlite3_stmt *stmt = NULL;
-  if (db->setErr(sqlite3_prepare_v2(handle(),query.c_str(),-1,&stmt, NULL),query.c_str()) != SQLITE_OK)
-    throw DbErrors(db->getErrorMsg());
-
+void SqliteDataset::fetch_rows(sqlite3_stmt *stmt) {
   // column headers
   const unsigned int numColumns = sqlite3_column_count(stmt);
   result.record_header.resize(numColumns);
@@ -659,8 +735,7 @@ bool SqliteDataset::query(const std::string &query) {
   // returned rows
   while (sqlite3_step(stmt) == SQLITE_ROW)
   { // have a row of data
-    sql_record *res = new sql_record;
-    res->resize(numColumns);
+    sql_record *res = result.add_record(numColumns);
     for (unsigned int i = 0; i < numColumns; i++)
     {
       field_value &v = res->at(i);
@@ -685,8 +760,25 @@ bool SqliteDataset::query(const std::string &query) {
         break;
       }
     }
-    result.records.push_back(res);
   }
+}
+
+bool SqliteDataset::query(const std::string &query) {
+    if(!handle()) throw DbErrors("No Database Connection");
+    std::string qry = query;
+    int fs = qry.find("select");
+    int fS = qry.find("SELECT");
+    if (!( fs >= 0 || fS >=0))                                 
+         throw DbErrors("MUST be select SQL!"); 
+
+  close();
+
+  sqlite3_stmt *stmt = NULL;
+  if (db->setErr(sqlite3_prepare_v2(handle(),query.c_str(),-1,&stmt, NULL),query.c_str()) != SQLITE_OK)
+    throw DbErrors(db->getErrorMsg());
+
+  fetch_rows(stmt);
+
   if (db->setErr(sqlite3_finalize(stmt),query.c_str()) == SQLITE_OK)
   {
     active = true;
@@ -700,6 +792,60 @@ bool SqliteDataset::query(const std::string &query) {
   }  
 }
 
+bool SqliteDataset::query(const std::string &query, const BindParams &params) {
+  if (!handle()) throw DbErrors("No Database Connection");
+  if (query.find("select") == std::string::npos && query.find("SELECT") == std::string::npos)
+    throw DbErrors("MUST be select SQL!");
+
+  close();
+
+  sqlite3_stmt *stmt = static_cast<SqliteDatabase*>(db)->get_statement(query);
+  if (params.size() != (size_t)sqlite3_bind_parameter_count(stmt))
+    throw DbErrors("Wrong number of parameters for query: %s", query.c_str());
+
+  int rc = SQLITE_OK;
+  for (unsigned int i = 0; i < params.size() && rc == SQLITE_OK; i++)
+  {
+    const field_value &param = params[i];
+    if (param.get_isNull())
+      rc = sqlite3_bind_null(stmt, i + 1);
+    else switch (param.get_fType())
+    {
+    case ft_String:
+    case ft_Char:
+    {
+      const std::string value = param.get_asString();
+      rc = sqlite3_bind_text(stmt, i + 1, value.c_str(), value.size(), SQLITE_TRANSIENT);
+      break;
+    }
+    case ft_Float:
+    case ft_Double:
+      rc = sqlite3_bind_double(stmt, i + 1, param.get_asDouble());
+      break;
+    default:
+      rc = sqlite3_bind_int64(stmt, i + 1, param.get_asInt64());
+      break;
+    }
+  }
+
+  if (rc == SQLITE_OK)
+  {
+    fetch_rows(stmt);
+    rc = sqlite3_reset(stmt);
+  }
+  else
+    sqlite3_reset(stmt);
+  sqlite3_clear_bindings(stmt);
+
+  if (db->setErr(rc, query.c_str()) != SQLITE_OK)
+    throw DbErrors(db->getErrorMsg());
+
+  active = true;
+  ds_state = dsSelect;
+  this->first();
+  return true;
+}
+
 void SqliteDataset::open(const std::string &sql) {
   set_select_sql(sql);
   open();
@@ -779,7 +925,8 @@ void SqliteDataset::free_row(void)
   sql_record *row = result.records[frecno];
   if (row)
   {
-    delete row;
+    // the record itself belongs to the result set, only release its fields
+    sql_record().swap(*row);
     result.records[frecno] = NULL;
   }
 }
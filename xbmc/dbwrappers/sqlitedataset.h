@@ -28,10 +28,19 @@
  *
  **********************************************************************/
 
+#include <list>
 #include <stdio.h>
+#include <unordered_map>
+#include <utility>
 #include "dataset.h"
 #include <sqlite3.h>
 
+/* collation comparing text the way StringUtils::AlphaNumericCompare does */
+#define SQLITE_COLLATION_ALPHANUM "ALPHANUM"
+
+/* number of prepared statements kept per connection */
+#define SQLITE_STATEMENT_CACHE_SIZE 32
+
 namespace dbiplus {
 /***************** Class SqliteDatabase definition ******************
 
@@ -45,6 +54,14 @@ protected:
   bool _in_transaction;
   int last_err;
 
+/* prepared statements, most recently used first */
+  typedef std::list<std::pair<std::string, sqlite3_stmt*> > StatementList;
+  StatementList statements;
+  std::unordered_map<std::string, StatementList::iterator> statement_index;
+
+/* finalizes all cached prepared statements */
+  void clear_statements();
+
 public:
 /* default constructor */
   SqliteDatabase();
@@ -96,6 +113,11 @@ public:
 
   bool in_transaction() override {return _in_transaction;}; 	
 
+/* returns a prepared statement for the given sql from the connection's
+   statement cache, compiling it if necessary. The statement stays owned by
+   the cache and has to be reset after use */
+  sqlite3_stmt *get_statement(const std::string &sql);
+
 };
 
 
@@ -126,6 +148,8 @@ protected:
   void fill_fields() override;
 /* Changing field values during dataset navigation */
   virtual void free_row();  // free the memory allocated for the current row
+/* Steps through the given statement and stores the returned rows */
+  void fetch_rows(sqlite3_stmt *stmt);
 
 public:
 /* constructor */
@@ -148,6 +172,7 @@ or insert() operations default = false) */
   const void* getExecRes() override;
 /* as open, but with our query exec Sql */
   bool query(const std::string &query) override;
+  bool query(const std::string &query, const BindParams &params) override;
 /* func. closes a query */
   void close(void) override;
 /* Cancel changes, made in insert or edit states of dataset */
@@ -113,6 +113,18 @@ extern "C" size_t write_callback(char *buffer,
   return state->WriteCallback(buffer, size, nitems);
 }
 
+/* curl calls this routine to hand over data of a range */
+extern "C" size_t range_write_callback(char *buffer,
+               size_t size,
+               size_t nitems,
+               void *userp)
+{
+  if(userp == NULL) return 0;
+
+  CCurlFile::CRangeReader::SRange *range = (CCurlFile::CRangeReader::SRange *)userp;
+  return range->Write(buffer, size * nitems);
+}
+
 extern "C" size_t read_callback(char *buffer,
                size_t size,
                size_t nitems,
@@ -156,6 +168,78 @@ static inline void* realloc_simple(void *ptr, size_t size)
     return ptr2;
 }
 
+/* wait for any of the transfers of a multi handle to make progress */
+static int8_t WaitForTransfers(CURLM* multiHandle)
+{
+  fd_set fdread;
+  fd_set fdwrite;
+  fd_set fdexcep;
+  int maxfd = -1;
+  FD_ZERO(&fdread);
+  FD_ZERO(&fdwrite);
+  FD_ZERO(&fdexcep);
+
+  // get file descriptors from the transfers
+  g_curlInterface.multi_fdset(multiHandle, &fdread, &fdwrite, &fdexcep, &maxfd);
+
+  long timeout = 0;
+  if (CURLM_OK != g_curlInterface.multi_timeout(multiHandle, &timeout) || timeout == -1 || timeout < 200)
+    timeout = 200;
+
+  XbmcThreads::EndTime endTime(timeout);
+  int rc;
+
+  do
+  {
+    /* On success the value of maxfd is guaranteed to be >= -1. We call
+     * select(maxfd + 1, ...); specially in case of (maxfd == -1) there are
+     * no fds ready yet so we call select(0, ...) --or Sleep() on Windows--
+     * to sleep 100ms, which is the minimum suggested value in the
+     * curl_multi_fdset() doc.
+     */
+    if (maxfd == -1)
+    {
+#ifdef TARGET_WINDOWS
+      /* Windows does not support using select() for sleeping without a dummy
+       * socket. Instead use Windows' Sleep() and sleep for 100ms which is the
+       * minimum suggested value in the curl_multi_fdset() doc.
+       */
+      Sleep(100);
+      rc = 0;
+#else
+      /* Portable sleep for platforms other than Windows. */
+      struct timeval wait = { 0, 100 * 1000 }; /* 100ms */
+      rc = select(0, NULL, NULL, NULL, &wait);
+#endif
+    }
+    else
+    {
+      unsigned int time_left = endTime.MillisLeft();
+      struct timeval wait = { (int)time_left / 1000, ((int)time_left % 1000) * 1000 };
+      rc = select(maxfd + 1, &fdread, &fdwrite, &fdexcep, &wait);
+    }
+#ifdef TARGET_WINDOWS
+  } while(rc == SOCKET_ERROR && WSAGetLastError() == WSAEINTR);
+#else
+  } while(rc == SOCKET_ERROR && errno == EINTR);
+#endif
+
+  if(rc == SOCKET_ERROR)
+  {
+#ifdef TARGET_WINDOWS
+    char buf[256];
+    strerror_s(buf, 256, WSAGetLastError());
+    CLog::Log(LOGERROR, "CCurlFile::WaitForTransfers - Failed with socket error:%s", buf);
+#else
+    char const * str = strerror(errno);
+    CLog::Log(LOGERROR, "CCurlFile::WaitForTransfers - Failed with socket error:%s", str);
+#endif
+
+    return FILLBUFFER_FAIL;
+  }
+  return FILLBUFFER_OK;
+}
+
 size_t CCurlFile::CReadState::HeaderCallback(void *ptr, size_t size, size_t nmemb)
 {
   std::string inString;
@@ -403,6 +487,253 @@ void CCurlFile::CReadState::Disconnect()
   m_curlAliasList = NULL;
 }
 
+size_t CCurlFile::CRangeReader::SRange::Write(char *buffer, size_t size)
+{
+  if (!checked)
+  {
+    // a server ignoring the range sends everything from the start
+    long response = 0;
+    g_curlInterface.easy_getinfo(connection->m_easyHandle, CURLINFO_RESPONSE_CODE, &response);
+    if (response != 206)
+    {
+      CLog::Log(LOGERROR, "CCurlFile::CRangeReader - Server answered range request with %ld", response);
+      failed = true;
+      return 0;
+    }
+    checked = true;
+  }
+
+  if (size > data.size() - filled)
+  {
+    CLog::Log(LOGERROR, "CCurlFile::CRangeReader - Server sent more than the requested range");
+    failed = true;
+    return 0;
+  }
+
+  memcpy(data.data() + filled, buffer, size);
+  filled += size;
+  return size;
+}
+
+CCurlFile::CRangeReader::CRangeReader(CCurlFile& file, CURLM* multiHandle, int64_t fileSize,
+                                      unsigned int connections, unsigned int chunkSize)
+  : m_file(file)
+  , m_multiHandle(multiHandle)
+  , m_fileSize(fileSize)
+  , m_filePos(0)
+  , m_maxTransfers(connections)
+  , m_chunkSize(chunkSize)
+  , m_transfers(0)
+  , m_idleConnections(0)
+{
+  // one more than transferring at most, the spare one is kept open for seeks
+  CURL url(m_file.m_url);
+  for (unsigned int i = 0; i <= m_maxTransfers; i++)
+  {
+    CReadState* connection = new CReadState();
+    g_curlInterface.easy_acquire(url.GetProtocol().c_str(),
+                                 url.GetHostName().c_str(),
+                                 &connection->m_easyHandle,
+                                 NULL);
+    m_connections.emplace_back(connection);
+    m_freeConnections.push_back(connection);
+  }
+}
+
+CCurlFile::CRangeReader::~CRangeReader()
+{
+  for (auto& range : m_ranges)
+    Abort(range);
+}
+
+ssize_t CCurlFile::CRangeReader::Read(void* lpBuf, size_t uiBufSize)
+{
+  if (m_filePos >= m_fileSize)
+    return 0;
+
+  while (true)
+  {
+    Schedule();
+
+    SRange& range = m_ranges.front();
+    size_t offset = (size_t)(m_filePos - range.start);
+    if (range.filled > offset)
+    {
+      size_t want = XMIN(range.filled - offset, uiBufSize);
+      memcpy(lpBuf, range.data.data() + offset, want);
+      m_filePos += want;
+      return want;
+    }
+
+    if (range.failed)
+    {
+      CLog::Log(LOGERROR, "CCurlFile::CRangeReader::Read - Failed to retrieve range at %" PRId64, range.start);
+      return -1;
+    }
+
+    if (m_file.m_state->m_cancelled)
+      return 0;
+
+    int8_t result = Perform();
+    if (result == FILLBUFFER_FAIL)
+      return -1;
+
+    // wait only if none of the transfers finished, else they're restarted first
+    if (result == FILLBUFFER_NO_DATA && range.filled <= offset &&
+        WaitForTransfers(m_multiHandle) != FILLBUFFER_OK)
+      return -1;
+  }
+}
+
+double CCurlFile::CRangeReader::GetDownloadSpeed()
+{
+  double speed = 0.0;
+  for (const auto& range : m_ranges)
+  {
+    double rangeSpeed = 0.0;
+    if (range.connection &&
+        CURLE_OK == g_curlInterface.easy_getinfo(range.connection->m_easyHandle, CURLINFO_SPEED_DOWNLOAD, &rangeSpeed))
+      speed += rangeSpeed;
+  }
+  return speed;
+}
+
+void CCurlFile::CRangeReader::Schedule()
+{
+  int64_t first = m_filePos - m_filePos % m_chunkSize;
+
+  // drop the ranges left behind, all of them when seeking backwards out of them
+  if (!m_ranges.empty() && m_ranges.front().start > first)
+  {
+    for (auto& range : m_ranges)
+      Abort(range);
+    m_ranges.clear();
+  }
+  while (!m_ranges.empty() && m_ranges.front().start < first)
+  {
+    Abort(m_ranges.front());
+    m_ranges.pop_front();
+  }
+
+  // keep as many ranges ahead as connections, the first ones are started first
+  int64_t next = m_ranges.empty() ? first : m_ranges.back().start + m_ranges.back().data.size();
+  while (m_ranges.size() <= m_maxTransfers && next < m_fileSize)
+  {
+    SRange range = {};
+    range.start = next;
+    range.data.resize((size_t)XMIN((int64_t)m_chunkSize, m_fileSize - next));
+    m_ranges.push_back(std::move(range));
+    next += m_ranges.back().data.size();
+  }
+
+  for (auto& range : m_ranges)
+  {
+    // only open another connection while none is spare
+    unsigned int maxTransfers = m_idleConnections > 0 ? m_maxTransfers : m_maxTransfers + 1;
+    if (m_transfers >= maxTransfers || m_freeConnections.empty())
+      break;
+    if (!range.connection && !range.failed && range.filled < range.data.size())
+      Start(range);
+  }
+}
+
+void CCurlFile::CRangeReader::Start(SRange& range)
+{
+  CReadState* connection = m_freeConnections.back();
+  m_freeConnections.pop_back();
+
+  m_file.SetCommonOptions(connection);
+  m_file.SetRequestHeaders(connection);
+
+  CURL_HANDLE* h = connection->m_easyHandle;
+  g_curlInterface.easy_setopt(h, CURLOPT_WRITEDATA, &range);
+  g_curlInterface.easy_setopt(h, CURLOPT_WRITEFUNCTION, range_write_callback);
+
+  // resume where a failed attempt stopped
+  std::string bytes = StringUtils::Format("%" PRId64 "-%" PRId64,
+                                          range.start + (int64_t)range.filled,
+                                          range.start + (int64_t)range.data.size() - 1);
+  g_curlInterface.easy_setopt(h, CURLOPT_RANGE, bytes.c_str());
+
+  connection->m_httpheader.Clear();
+  range.connection = connection;
+  range.checked = false;
+  g_curlInterface.multi_add_handle(m_multiHandle, h);
+
+  m_transfers++;
+  if (m_idleConnections > 0)
+    m_idleConnections--;
+}
+
+void CCurlFile::CRangeReader::Abort(SRange& range)
+{
+  if (!range.connection)
+    return;
+
+  // curl closes the connection of an unfinished transfer
+  g_curlInterface.multi_remove_handle(m_multiHandle, range.connection->m_easyHandle);
+  m_freeConnections.push_back(range.connection);
+  range.connection = NULL;
+  m_transfers--;
+}
+
+void CCurlFile::CRangeReader::Finish(SRange& range, int result)
+{
+  g_curlInterface.multi_remove_handle(m_multiHandle, range.connection->m_easyHandle);
+  m_freeConnections.push_back(range.connection);
+  range.connection = NULL;
+  m_transfers--;
+
+  if (result == CURLE_OK && range.filled == range.data.size())
+  {
+    m_idleConnections++;
+    return;
+  }
+
+  if (range.failed)
+    return;
+
+  CLog::Log(LOGWARNING, "CCurlFile::CRangeReader - Range at %" PRId64 " failed: %s(%d)",
+            range.start, g_curlInterface.easy_strerror((CURLcode)result), result);
+  if (range.retries++ >= g_advancedSettings.m_curlretries)
+    range.failed = true;
+}
+
+int8_t CCurlFile::CRangeReader::Perform()
+{
+  int stillRunning;
+  CURLMcode result = g_curlInterface.multi_perform(m_multiHandle, &stillRunning);
+  if (result == CURLM_CALL_MULTI_PERFORM)
+    return FILLBUFFER_OK;
+  if (result != CURLM_OK)
+  {
+    CLog::Log(LOGERROR, "CCurlFile::CRangeReader - Multi perform failed with code %d, aborting", result);
+    return FILLBUFFER_FAIL;
+  }
+
+  bool finished = false;
+  int msgs;
+  CURLMsg* msg;
+  while ((msg = g_curlInterface.multi_info_read(m_multiHandle, &msgs)))
+  {
+    if (msg->msg != CURLMSG_DONE)
+      continue;
+
+    CURL_HANDLE* easy = msg->easy_handle;
+    CURLcode done = msg->data.result;
+    for (auto& range : m_ranges)
+    {
+      if (range.connection && range.connection->m_easyHandle == easy)
+      {
+        Finish(range, done);
+        finished = true;
+        break;
+      }
+    }
+  }
+
+  return finished ? FILLBUFFER_OK : FILLBUFFER_NO_DATA;
+}
 
 CCurlFile::~CCurlFile()
 {
@@ -440,6 +771,9 @@ CCurlFile::CCurlFile()
   m_cipherlist = "";
   m_state = new CReadState();
   m_oldState = NULL;
+  m_rangeReader = NULL;
+  m_parallelConnections = g_advancedSettings.m_curlParallelConnections;
+  m_parallelChunkSize = g_advancedSettings.m_curlParallelChunkSize;
   m_skipshout = false;
   m_httpresponse = -1;
   m_acceptCharset = "UTF-8,*;q=0.8"; /* prefer UTF-8 if available */
@@ -452,11 +786,20 @@ void CCurlFile::SetBufferSize(unsigned int size)
   m_bufferSize = size;
 }
 
+//Has to be called before Open()
+void CCurlFile::SetParallelConnections(unsigned int connections, unsigned int chunkSize)
+{
+  m_parallelConnections = connections;
+  m_parallelChunkSize = chunkSize;
+}
+
 void CCurlFile::Close()
 {
   if (m_opened && m_forWrite && !m_inError)
       Write(NULL, 0);
 
+  delete m_rangeReader;
+  m_rangeReader = NULL;
   m_state->Disconnect();
   delete m_oldState;
   m_oldState = NULL;
@@ -537,8 +880,8 @@ void CCurlFile::SetCommonOptions(CReadState* state)
   g_curlInterface.easy_setopt(h, CURLOPT_SSL_VERIFYPEER, 0);
   g_curlInterface.easy_setopt(h, CURLOPT_SSL_VERIFYHOST, 0);
 
-  g_curlInterface.easy_setopt(m_state->m_easyHandle, CURLOPT_URL, m_url.c_str());
-  g_curlInterface.easy_setopt(m_state->m_easyHandle, CURLOPT_TRANSFERTEXT, FALSE);
+  g_curlInterface.easy_setopt(h, CURLOPT_URL, m_url.c_str());
+  g_curlInterface.easy_setopt(h, CURLOPT_TRANSFERTEXT, FALSE);
 
   // setup POST data if it is set (and it may be empty)
   if (m_postdataset)
@@ -1087,6 +1430,17 @@ bool CCurlFile::Open(const CURL& url)
     m_url = efurl;
   }
 
+  // read large files in ranges over several connections if asked to, unless the server can't
+  if (m_parallelConnections > 1 && m_seekable && m_multisession &&
+      m_state->m_fileSize > m_parallelChunkSize && !m_postdataset && m_customrequest.empty())
+  {
+    CLog::Log(LOGDEBUG, "CCurlFile::Open - Reading <%s> over %u connections", redactPath.c_str(), m_parallelConnections);
+    int64_t fileSize = m_state->m_fileSize;
+    m_state->Disconnect();
+    m_rangeReader = new CRangeReader(*this, m_state->m_multiHandle, fileSize,
+                                     m_parallelConnections, m_parallelChunkSize);
+  }
+
   return true;
 }
 
@@ -1261,9 +1615,23 @@ bool CCurlFile::Exists(const CURL& url)
   return false;
 }
 
+bool CCurlFile::ReadString(char *szLine, int iLineLength)
+{
+  if (m_rangeReader)
+    return IFile::ReadString(szLine, iLineLength);
+  return m_state->ReadString(szLine, iLineLength);
+}
+
+ssize_t CCurlFile::Read(void* lpBuf, size_t uiBufSize)
+{
+  if (m_rangeReader)
+    return m_rangeReader->Read(lpBuf, uiBufSize);
+  return m_state->Read(lpBuf, uiBufSize);
+}
+
 int64_t CCurlFile::Seek(int64_t iFilePosition, int iWhence)
 {
-  int64_t nextPos = m_state->m_filePos;
+  int64_t nextPos = GetPosition();
   
   if(!m_seekable)
     return -1;
@@ -1277,8 +1645,8 @@ int64_t CCurlFile::Seek(int64_t iFilePosition, int iWhence)
       nextPos += iFilePosition;
       break;
     case SEEK_END:
-      if (m_state->m_fileSize)
-        nextPos = m_state->m_fileSize + iFilePosition;
+      if (GetLength())
+        nextPos = GetLength() + iFilePosition;
       else
         return -1;
       break;
@@ -1287,7 +1655,16 @@ int64_t CCurlFile::Seek(int64_t iFilePosition, int iWhence)
   }
 
   // We can't seek beyond EOF
-  if (m_state->m_fileSize && nextPos > m_state->m_fileSize) return -1;
+  if (GetLength() && nextPos > GetLength()) return -1;
+
+  // the ranges are fetched on the next read
+  if (m_rangeReader)
+  {
+    if (nextPos < 0)
+      return -1;
+    m_rangeReader->Seek(nextPos);
+    return nextPos;
+  }
 
   if(m_state->Seek(nextPos))
     return nextPos;
@@ -1361,12 +1738,14 @@ int64_t CCurlFile::Seek(int64_t iFilePosition, int iWhence)
 int64_t CCurlFile::GetLength()
 {
   if (!m_opened) return 0;
+  if (m_rangeReader) return m_rangeReader->GetLength();
   return m_state->m_fileSize;
 }
 
 int64_t CCurlFile::GetPosition()
 {
   if (!m_opened) return 0;
+  if (m_rangeReader) return m_rangeReader->GetPosition();
   return m_state->m_filePos;
 }
 
@@ -1537,9 +1916,6 @@ ssize_t CCurlFile::CReadState::Read(void* lpBuf, size_t uiBufSize)
 int8_t CCurlFile::CReadState::FillBuffer(unsigned int want)
 {
   int retry = 0;
-  fd_set fdread;
-  fd_set fdwrite;
-  fd_set fdexcep;
 
   // only attempt to fill buffer if transactions still running and buffer
   // doesnt exceed required size already
@@ -1673,69 +2049,8 @@ int8_t CCurlFile::CReadState::FillBuffer(unsigned int want)
     {
       case CURLM_OK:
       {
-        int maxfd = -1;
-        FD_ZERO(&fdread);
-        FD_ZERO(&fdwrite);
-        FD_ZERO(&fdexcep);
-
-        // get file descriptors from the transfers
-        g_curlInterface.multi_fdset(m_multiHandle, &fdread, &fdwrite, &fdexcep, &maxfd);
-
-        long timeout = 0;
-        if (CURLM_OK != g_curlInterface.multi_timeout(m_multiHandle, &timeout) || timeout == -1 || timeout < 200)
-          timeout = 200;
-
-        XbmcThreads::EndTime endTime(timeout);
-        int rc;
-
-        do
-        {
-          /* On success the value of maxfd is guaranteed to be >= -1. We call
-           * select(maxfd + 1, ...); specially in case of (maxfd == -1) there are
-           * no fds ready yet so we call select(0, ...) --or Sleep() on Windows--
-           * to sleep 100ms, which is the minimum suggested value in the
-           * curl_multi_fdset() doc.
-           */
-          if (maxfd == -1)
-          {
-#ifdef TARGET_WINDOWS
-            /* Windows does not support using select() for sleeping without a dummy
-             * socket. Instead use Windows' Sleep() and sleep for 100ms which is the
-             * minimum suggested value in the curl_multi_fdset() doc.
-             */
-            Sleep(100);
-            rc = 0;
-#else
-            /* Portable sleep for platforms other than Windows. */
-            struct timeval wait = { 0, 100 * 1000 }; /* 100ms */
-            rc = select(0, NULL, NULL, NULL, &wait);
-#endif
-          }
-          else
-          {
-            unsigned int time_left = endTime.MillisLeft();
-            struct timeval wait = { (int)time_left / 1000, ((int)time_left % 1000) * 1000 };
-            rc = select(maxfd + 1, &fdread, &fdwrite, &fdexcep, &wait);
-          }
-#ifdef TARGET_WINDOWS
-        } while(rc == SOCKET_ERROR && WSAGetLastError() == WSAEINTR);
-#else
-        } while(rc == SOCKET_ERROR && errno == EINTR);
-#endif
-
-        if(rc == SOCKET_ERROR)
-        {
-#ifdef TARGET_WINDOWS
-          char buf[256];
-          strerror_s(buf, 256, WSAGetLastError());
-          CLog::Log(LOGERROR, "CCurlFile::FillBuffer - Failed with socket error:%s", buf);
-#else
-          char const * str = strerror(errno);
-          CLog::Log(LOGERROR, "CCurlFile::FillBuffer - Failed with socket error:%s", str);
-#endif
-
+        if (WaitForTransfers(m_multiHandle) != FILLBUFFER_OK)
           return FILLBUFFER_FAIL;
-        }
       }
       break;
       case CURLM_CALL_MULTI_PERFORM:
@@ -1933,6 +2248,9 @@ int CCurlFile::IoControl(EIoControl request, void* param)
 
 double CCurlFile::GetDownloadSpeed()
 {
+  if (m_rangeReader)
+    return m_rangeReader->GetDownloadSpeed();
+
   double res = 0.0f;
   g_curlInterface.easy_getinfo(m_state->m_easyHandle, CURLINFO_SPEED_DOWNLOAD, &res);
   return res;
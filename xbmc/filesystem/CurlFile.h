@@ -21,8 +21,11 @@
 
 #include "IFile.h"
 #include "utils/RingBuffer.h"
+#include <deque>
 #include <map>
+#include <memory>
 #include <string>
+#include <vector>
 #include "utils/HttpHeader.h"
 
 namespace XCURL
@@ -58,8 +61,8 @@ namespace XFILE
       int64_t GetLength() override;
       int Stat(const CURL& url, struct __stat64* buffer) override;
       void Close() override;
-      bool ReadString(char *szLine, int iLineLength) override { return m_state->ReadString(szLine, iLineLength); }
-      ssize_t Read(void* lpBuf, size_t uiBufSize) override { return m_state->Read(lpBuf, uiBufSize); }
+      bool ReadString(char *szLine, int iLineLength) override;
+      ssize_t Read(void* lpBuf, size_t uiBufSize) override;
       ssize_t Write(const void* lpBuf, size_t uiBufSize) override;
       virtual std::string GetMimeType() { return m_state->m_httpheader.GetMimeType(); }
       std::string GetContent() override { return m_state->m_httpheader.GetValue("content-type"); }
@@ -93,6 +96,13 @@ namespace XFILE
       void ClearRequestHeaders();
       void SetBufferSize(unsigned int size);
 
+      /*! \brief Read seekable http(s) files over several connections at once.
+       Has to be called before Open(). Sequential reads are split into range requests of
+       chunkSize bytes of which up to connections are in flight, 0 or 1 reads over a
+       single connection. Defaults to the curlparallel* advanced settings.
+       */
+      void SetParallelConnections(unsigned int connections, unsigned int chunkSize);
+
       const CHttpHeader& GetHttpHeader() const { return m_state->m_httpheader; }
       std::string GetServerReportedCharset(void);
       std::string GetURL(void);
@@ -152,6 +162,63 @@ namespace XFILE
           void Disconnect();
       };
 
+      /*!
+       \brief Fetches a file as consecutive byte ranges over several connections.
+
+       The ranges ahead of the read position are requested at the same time on the
+       multi handle of the file's session and kept until they were read, so reading
+       isn't limited by what a single connection delivers. Connections are reused
+       for the following ranges and one more than is transferring is kept open, so
+       a seek doesn't need to wait for a new connection. Ranges the read position
+       leaves are dropped, aborting them if they're still transferring.
+       */
+      class CRangeReader
+      {
+      public:
+        struct SRange
+        {
+          size_t Write(char *buffer, size_t size);
+
+          int64_t start;
+          std::vector<char> data; // sized to the range, valid up to filled
+          size_t filled;
+          CReadState* connection; // while transferring
+          bool checked; // the server answered with the partial content asked for
+          int retries;
+          bool failed;
+        };
+
+        CRangeReader(CCurlFile& file, XCURL::CURLM* multiHandle, int64_t fileSize,
+                     unsigned int connections, unsigned int chunkSize);
+        ~CRangeReader();
+
+        ssize_t Read(void* lpBuf, size_t uiBufSize);
+        void Seek(int64_t pos) { m_filePos = pos; }
+        int64_t GetPosition() const { return m_filePos; }
+        int64_t GetLength() const { return m_fileSize; }
+        double GetDownloadSpeed();
+
+      private:
+        void Schedule();
+        void Start(SRange& range);
+        void Abort(SRange& range);
+        void Finish(SRange& range, int result);
+        int8_t Perform();
+
+        CCurlFile& m_file;
+        XCURL::CURLM* m_multiHandle;
+        const int64_t m_fileSize;
+        int64_t m_filePos;
+        const unsigned int m_maxTransfers;
+        const unsigned int m_chunkSize;
+
+        std::deque<SRange> m_ranges; // consecutive, the first holds the read position
+        std::vector<std::unique_ptr<CReadState>> m_connections;
+        std::vector<CReadState*> m_freeConnections;
+        unsigned int m_transfers;
+        unsigned int m_idleConnections; // left open by finished transfers, as far as we know
+      };
+
     protected:
       void ParseAndCorrectUrl(CURL &url);
       void SetCommonOptions(CReadState* state);
@@ -162,7 +229,10 @@ namespace XFILE
     protected:
       CReadState* m_state;
       CReadState* m_oldState;
+      CRangeReader* m_rangeReader;
       unsigned int m_bufferSize;
+      unsigned int m_parallelConnections;
+      unsigned int m_parallelChunkSize;
       int64_t m_writeOffset;
 
       std::string m_url;
@@ -39,6 +39,8 @@
 #include "messaging/ApplicationMessenger.h"
 #include "URL.h"
 
+#include <tuple>
+
 using namespace XFILE;
 using namespace ADDON;
 using namespace KODI::MESSAGING;
@@ -47,6 +49,23 @@ std::map<int, CPluginDirectory *> CPluginDirectory::globalHandles;
 int CPluginDirectory::handleCounter = 0;
 CCriticalSection CPluginDirectory::m_handleLock;
 
+// items added one by one are passed on to the listing in batches of this size
+#define PENDING_ITEMS_BATCH_SIZE 50
+
+namespace
+{
+struct PendingItems
+{
+  CFileItemList items;
+  int totalItems = 0;
+  bool result = true;
+};
+
+// the items of each handle not passed on yet, always locked before m_handleLock
+std::map<int, PendingItems> pendingItems;
+CCriticalSection pendingItemsLock;
+}
+
 CPluginDirectory::CScriptObserver::CScriptObserver(int scriptId, CEvent &event) :
   CThread("scriptobs"), m_scriptId(scriptId), m_event(event)
 {
@@ -97,9 +116,29 @@ int CPluginDirectory::getNewHandle(CPluginDirectory *cp)
 
 void CPluginDirectory::removeHandle(int handle)
 {
-  CSingleLock lock(m_handleLock);
-  if (!globalHandles.erase(handle))
-    CLog::Log(LOGWARNING, "Attempt to erase invalid handle %i", handle);
+  {
+    CSingleLock lock(m_handleLock);
+    if (!globalHandles.erase(handle))
+      CLog::Log(LOGWARNING, "Attempt to erase invalid handle %i", handle);
+  }
+
+  // drop the items of a plugin that never ended its listing
+  CSingleLock lock(pendingItemsLock);
+  pendingItems.erase(handle);
+}
+
+bool CPluginDirectory::flushPendingItems(int handle)
+{
+  CSingleLock lock(pendingItemsLock);
+  std::map<int, PendingItems>::iterator pending = pendingItems.find(handle);
+  if (pending == pendingItems.end())
+    return true;
+
+  bool result = pending->second.result;
+  if (!pending->second.items.IsEmpty())
+    result = appendItems(handle, &pending->second.items, pending->second.totalItems);
+  pendingItems.erase(pending);
+  return result;
 }
 
 CPluginDirectory *CPluginDirectory::dirFromHandle(int handle)
@@ -155,7 +194,11 @@ bool CPluginDirectory::StartScript(const std::string& strPath, bool retrievingDi
   CLog::Log(LOGDEBUG, "%s - calling plugin %s('%s','%s','%s')", __FUNCTION__, m_addon->Name().c_str(), argv[0].c_str(), argv[1].c_str(), argv[2].c_str());
   bool success = false;
   std::string file = m_addon->LibPath();
-  int id = CScriptInvocationManager::GetInstance().ExecuteAsync(file, m_addon, argv);
+  // plugins run once per folder, let them reuse the interpreter of their last run
+  LanguageInvokerPtr invoker = CScriptInvocationManager::GetInstance().GetLanguageInvoker(file);
+  if (invoker != NULL)
+    invoker->SetReuseInterpreter(true);
+  int id = CScriptInvocationManager::GetInstance().ExecuteAsync(file, invoker, m_addon, argv);
   if (id >= 0)
   { // wait for our script to finish
     std::string scriptName = m_addon->Name();
@@ -193,28 +236,44 @@ bool CPluginDirectory::GetPluginResult(const std::string& strPath, CFileItem &re
 
 bool CPluginDirectory::AddItem(int handle, const CFileItem *item, int totalItems)
 {
-  CSingleLock lock(m_handleLock);
-  CPluginDirectory *dir = dirFromHandle(handle);
-  if (!dir)
-    return false;
+  // the items are passed on in batches so the listing isn't locked for every item,
+  // a cancelled listing is therefore noticed one batch late
+  CSingleLock lock(pendingItemsLock);
+  std::map<int, PendingItems>::iterator pending = pendingItems.find(handle);
+  if (pending == pendingItems.end())
+  {
+    if (!dirFromHandle(handle))
+      return false;
+    pending = pendingItems.emplace(std::piecewise_construct, std::forward_as_tuple(handle), std::forward_as_tuple()).first;
+  }
 
-  CFileItemPtr pItem(new CFileItem(*item));
-  dir->m_listItems->Add(pItem);
-  dir->m_totalItems = totalItems;
+  pending->second.items.Add(CFileItemPtr(new CFileItem(*item)));
+  pending->second.totalItems = totalItems;
+  if (pending->second.items.Size() < PENDING_ITEMS_BATCH_SIZE)
+    return pending->second.result;
 
-  return !dir->m_cancelled;
+  pending->second.result = appendItems(handle, &pending->second.items, totalItems);
+  pending->second.items.Clear();
+  return pending->second.result;
 }
 
 bool CPluginDirectory::AddItems(int handle, const CFileItemList *items, int totalItems)
+{
+  // keep the order of the items added before
+  if (!flushPendingItems(handle))
+    return false;
+
+  return appendItems(handle, items, totalItems);
+}
+
+bool CPluginDirectory::appendItems(int handle, const CFileItemList *items, int totalItems)
 {
   CSingleLock lock(m_handleLock);
   CPluginDirectory *dir = dirFromHandle(handle);
   if (!dir)
     return false;
 
-  CFileItemList pItemList;
-  pItemList.Copy(*items);
-  dir->m_listItems->Append(pItemList);
+  dir->m_listItems->Append(*items);
   dir->m_totalItems = totalItems;
 
   return !dir->m_cancelled;
@@ -222,6 +281,8 @@ bool CPluginDirectory::AddItems(int handle, const CFileItemList *items, int tota
 
 void CPluginDirectory::EndOfDirectory(int handle, bool success, bool replaceListing, bool cacheToDisc)
 {
+  flushPendingItems(handle);
+
   CSingleLock lock(m_handleLock);
   CPluginDirectory *dir = dirFromHandle(handle);
   if (!dir)
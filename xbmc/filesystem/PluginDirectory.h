@@ -53,7 +53,9 @@ public:
   static bool GetPluginResult(const std::string& strPath, CFileItem &resultItem);
 
   // callbacks from python
+  // copies the item and passes it on with the next batch
   static bool AddItem(int handle, const CFileItem *item, int totalItems);
+  // shares the items with the directory, they must not be changed afterwards
   static bool AddItems(int handle, const CFileItemList *items, int totalItems);
   static void EndOfDirectory(int handle, bool success, bool replaceListing, bool cacheToDisc);
   static void AddSortMethod(int handle, SORT_METHOD sortMethod, const std::string &label2Mask);
@@ -73,6 +75,8 @@ private:
   static int getNewHandle(CPluginDirectory *cp);
   static void removeHandle(int handle);
   static CPluginDirectory *dirFromHandle(int handle);
+  static bool flushPendingItems(int handle);
+  static bool appendItems(int handle, const CFileItemList *items, int totalItems);
   static CCriticalSection m_handleLock;
   static int handleCounter;
 
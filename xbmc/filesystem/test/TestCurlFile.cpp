@@ -0,0 +1,290 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#if defined(TARGET_POSIX)
+
+#include "URL.h"
+#include "filesystem/CurlFile.h"
+#include "threads/SystemClock.h"
+#include "utils/StringUtils.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#define TEST_FILE_SIZE   (2 * 1024 * 1024)
+#define TEST_CHUNK_SIZE  (128 * 1024)
+#define TEST_RATE        (4 * 1024 * 1024) // bytes per second and connection
+
+namespace
+{
+
+/*!
+ \brief Serves a single file over keep-alive connections, honouring byte ranges.
+ Each connection sends at most TEST_RATE bytes per second, like a throttling server.
+ */
+class CRangeServer
+{
+public:
+  CRangeServer()
+  {
+    for (int i = 0; i < TEST_FILE_SIZE; i++)
+      m_data.push_back((char)((i * 7) ^ (i >> 11)));
+
+    m_socket = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(m_socket, (sockaddr*)&addr, sizeof(addr));
+    socklen_t len = sizeof(addr);
+    getsockname(m_socket, (sockaddr*)&addr, &len);
+    m_port = ntohs(addr.sin_port);
+    listen(m_socket, 16);
+
+    m_acceptThread = std::thread([this]() { Accept(); });
+  }
+
+  ~CRangeServer()
+  {
+    m_stop = true;
+    shutdown(m_socket, SHUT_RDWR);
+    close(m_socket);
+    m_acceptThread.join();
+
+    // curl keeps connections open beyond the file
+    std::lock_guard<std::mutex> lock(m_threadsMutex);
+    for (int client : m_clients)
+      shutdown(client, SHUT_RDWR);
+    for (auto& thread : m_threads)
+      thread.join();
+    for (int client : m_clients)
+      close(client);
+  }
+
+  std::string GetUrl() const { return StringUtils::Format("http://127.0.0.1:%d/file.mkv", m_port); }
+  const std::vector<char>& GetData() const { return m_data; }
+
+  std::atomic<int> m_connections{0}; // accepted so far
+  std::atomic<int> m_transfers{0};
+  std::atomic<int> m_maxTransfers{0}; // most sent at the same time
+
+private:
+  void Accept()
+  {
+    while (!m_stop)
+    {
+      int client = accept(m_socket, NULL, NULL);
+      if (client < 0)
+        break;
+      m_connections++;
+      std::lock_guard<std::mutex> lock(m_threadsMutex);
+      m_clients.push_back(client);
+      m_threads.emplace_back([this, client]() { Serve(client); });
+    }
+  }
+
+  void Serve(int client)
+  {
+    std::string request;
+    char buffer[4096];
+    while (!m_stop)
+    {
+      size_t end = request.find("\r\n\r\n");
+      if (end == std::string::npos)
+      {
+        ssize_t received = recv(client, buffer, sizeof(buffer), 0);
+        if (received <= 0)
+          break;
+        request.append(buffer, received);
+        continue;
+      }
+
+      std::string header = request.substr(0, end);
+      request.erase(0, end + 4);
+      if (!Respond(client, header))
+        break;
+    }
+    shutdown(client, SHUT_RDWR);
+  }
+
+  bool Respond(int client, const std::string& header)
+  {
+    int64_t first = 0;
+    int64_t last = TEST_FILE_SIZE - 1;
+    bool partial = false;
+
+    std::vector<std::string> lines = StringUtils::Split(header, "\r\n");
+    for (const auto& line : lines)
+    {
+      if (StringUtils::StartsWithNoCase(line, "range: bytes="))
+      {
+        std::string range = line.substr(13);
+        size_t dash = range.find('-');
+        first = strtoll(range.substr(0, dash).c_str(), NULL, 10);
+        if (dash + 1 < range.size())
+          last = std::min<int64_t>(last, strtoll(range.substr(dash + 1).c_str(), NULL, 10));
+        partial = true;
+      }
+    }
+
+    std::string response;
+    if (partial)
+    {
+      response = "HTTP/1.1 206 Partial Content\r\n";
+      response += StringUtils::Format("Content-Range: bytes %lld-%lld/%d\r\n", (long long)first, (long long)last, TEST_FILE_SIZE);
+    }
+    else
+      response = "HTTP/1.1 200 OK\r\n";
+    response += "Accept-Ranges: bytes\r\nContent-Type: video/x-matroska\r\n";
+    response += StringUtils::Format("Content-Length: %lld\r\n\r\n", (long long)(last - first + 1));
+    if (!Send(client, response.c_str(), response.size()))
+      return false;
+
+    int transfers = ++m_transfers;
+    int max = m_maxTransfers;
+    while (transfers > max && !m_maxTransfers.compare_exchange_weak(max, transfers))
+      ;
+
+    // send slices spread out over time to limit the rate of this connection
+    const size_t slice = TEST_RATE / 100;
+    bool sent = true;
+    for (int64_t pos = first; pos <= last && sent && !m_stop; pos += slice)
+    {
+      sent = Send(client, m_data.data() + pos, std::min<int64_t>(slice, last - pos + 1));
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    m_transfers--;
+    return sent;
+  }
+
+  static bool Send(int client, const char* data, size_t size)
+  {
+    while (size > 0)
+    {
+      ssize_t sent = send(client, data, size, MSG_NOSIGNAL);
+      if (sent <= 0)
+        return false;
+      data += sent;
+      size -= sent;
+    }
+    return true;
+  }
+
+  std::vector<char> m_data;
+  int m_socket;
+  int m_port;
+  std::atomic<bool> m_stop{false};
+  std::thread m_acceptThread;
+  std::mutex m_threadsMutex;
+  std::vector<std::thread> m_threads;
+  std::vector<int> m_clients; // closed with the server
+};
+
+unsigned int ReadAll(CRangeServer& server, unsigned int connections)
+{
+  XFILE::CCurlFile file;
+  file.SetParallelConnections(connections, TEST_CHUNK_SIZE);
+  unsigned int start = XbmcThreads::SystemClockMillis();
+  EXPECT_TRUE(file.Open(CURL(server.GetUrl())));
+  EXPECT_EQ(TEST_FILE_SIZE, file.GetLength());
+
+  std::vector<char> read;
+  char buffer[32 * 1024];
+  ssize_t size;
+  while ((size = file.Read(buffer, sizeof(buffer))) > 0)
+    read.insert(read.end(), buffer, buffer + size);
+  EXPECT_EQ(0, size);
+  EXPECT_TRUE(read == server.GetData());
+  unsigned int duration = XbmcThreads::SystemClockMillis() - start;
+  file.Close();
+  return duration;
+}
+
+}
+
+TEST(TestCurlFile, ParallelRead)
+{
+  CRangeServer server;
+  unsigned int duration = ReadAll(server, 4);
+
+  // the initial connection of Open, then the ranges over at most one more than in flight
+  EXPECT_LT(1, server.m_maxTransfers);
+  EXPECT_GE(4 + 1 + 1, server.m_connections);
+  RecordProperty("parallel_ms", duration);
+}
+
+TEST(TestCurlFile, SingleConnectionRead)
+{
+  CRangeServer server;
+  unsigned int duration = ReadAll(server, 0);
+
+  EXPECT_EQ(1, server.m_maxTransfers);
+  RecordProperty("single_ms", duration);
+}
+
+TEST(TestCurlFile, ParallelSeek)
+{
+  CRangeServer server;
+  const std::vector<char>& data = server.GetData();
+
+  XFILE::CCurlFile file;
+  file.SetParallelConnections(4, TEST_CHUNK_SIZE);
+  ASSERT_TRUE(file.Open(CURL(server.GetUrl())));
+
+  // forwards and backwards, within the ranges fetched and beyond them
+  const int64_t positions[] = { 1000, 5000, 300000, 299000, TEST_CHUNK_SIZE - 10,
+                                TEST_FILE_SIZE - 20000, 4000, TEST_FILE_SIZE - 10 };
+  char buffer[16 * 1024];
+  for (int64_t pos : positions)
+  {
+    ASSERT_EQ(pos, file.Seek(pos, SEEK_SET));
+    EXPECT_EQ(pos, file.GetPosition());
+
+    size_t want = (size_t)std::min<int64_t>(sizeof(buffer), TEST_FILE_SIZE - pos);
+    size_t got = 0;
+    while (got < want)
+    {
+      ssize_t size = file.Read(buffer + got, want - got);
+      ASSERT_LT(0, size);
+      got += size;
+    }
+    EXPECT_EQ(0, memcmp(buffer, data.data() + pos, want)) << "at " << pos;
+    EXPECT_EQ(pos + (int64_t)want, file.GetPosition());
+  }
+
+  EXPECT_EQ(0, file.Read(buffer, sizeof(buffer)));
+  EXPECT_EQ(TEST_FILE_SIZE - 100, file.Seek(-100, SEEK_END));
+  EXPECT_EQ(-1, file.Seek(TEST_FILE_SIZE + 1, SEEK_SET));
+  file.Close();
+}
+
+#endif
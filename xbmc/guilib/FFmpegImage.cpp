@@ -145,6 +145,15 @@ CFFmpegImage::~CFFmpegImage()
   av_frame_free(&m_pFrame);
   // someone could have forgotten to call us
   CleanupLocalOutputBuffer();
+  Close();
+
+  m_buf.data = nullptr;
+  m_buf.pos = 0;
+  m_buf.size = 0;
+}
+
+void CFFmpegImage::Close()
+{
   if (m_fctx)
   {
     avcodec_free_context(&m_codec_ctx);
@@ -152,17 +161,13 @@ CFFmpegImage::~CFFmpegImage()
   }
   if (m_ioctx)
     FreeIOCtx(&m_ioctx);
-
-  m_buf.data = nullptr;
-  m_buf.pos = 0;
-  m_buf.size = 0;
 }
 
 bool CFFmpegImage::LoadImageFromMemory(unsigned char* buffer, unsigned int bufSize,
                                       unsigned int width, unsigned int height)
 {
     
-  if (!Initialize(buffer, bufSize))
+  if (!Initialize(buffer, bufSize, width, height))
   {
     //log
     return false;
@@ -171,10 +176,72 @@ bool CFFmpegImage::LoadImageFromMemory(unsigned char* buffer, unsigned int bufSi
   av_frame_free(&m_pFrame);
   m_pFrame = ExtractFrame();
 
+  // not every JPEG can be decoded scaled down, try again at full size
+  if (!m_pFrame && m_codec_ctx && m_codec_ctx->lowres > 0)
+  {
+    CLog::Log(LOGDEBUG, "%s - Decoding at 1/%i of the size failed, retrying at full size", __FUNCTION__, 1 << m_codec_ctx->lowres);
+    Close();
+    if (!Initialize(buffer, bufSize))
+      return false;
+    m_pFrame = ExtractFrame();
+  }
+
   return !(m_pFrame == nullptr);
 }
 
-bool CFFmpegImage::Initialize(unsigned char* buffer, unsigned int bufSize)
+// reads the size from the frame header of a JPEG
+bool CFFmpegImage::GetJpegSize(const unsigned char* buffer, unsigned int bufSize, unsigned int& width, unsigned int& height)
+{
+  if (bufSize < 2 || buffer[0] != 0xFF || buffer[1] != 0xD8)
+    return false;
+
+  unsigned int pos = 2; // behind the start of image marker
+  while (pos + 4 <= bufSize)
+  {
+    if (buffer[pos] != 0xFF)
+      return false;
+
+    unsigned char marker = buffer[pos + 1];
+    if (marker == 0xFF) // fill byte
+    {
+      pos++;
+      continue;
+    }
+    if (marker == 0xDA || marker == 0xD9) // start of scan or end of image before any frame
+      return false;
+
+    unsigned int length = (buffer[pos + 2] << 8) | buffer[pos + 3];
+    // SOF0 to SOF15, except for DHT, JPG and DAC which share the range
+    if (marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC)
+    {
+      if (pos + 9 > bufSize)
+        return false;
+      height = (buffer[pos + 5] << 8) | buffer[pos + 6];
+      width = (buffer[pos + 7] << 8) | buffer[pos + 8];
+      return width > 0 && height > 0;
+    }
+    pos += 2 + length;
+  }
+  return false;
+}
+
+// the number of times a JPEG can be halved while decoding and still cover width x height
+int CFFmpegImage::GetJpegScale(unsigned int jpegWidth, unsigned int jpegHeight, unsigned int width, unsigned int height, int maxScale)
+{
+  // the size the image is shown at, keeping the aspect ratio
+  float scale = std::min(std::min((float)width / jpegWidth, (float)height / jpegHeight), 1.0f);
+  float neededWidth = scale * jpegWidth;
+  float neededHeight = scale * jpegHeight;
+
+  int lowres = 0;
+  while (lowres < maxScale &&
+         (jpegWidth >> (lowres + 1)) >= neededWidth &&
+         (jpegHeight >> (lowres + 1)) >= neededHeight)
+    lowres++;
+  return lowres;
+}
+
+bool CFFmpegImage::Initialize(unsigned char* buffer, unsigned int bufSize, unsigned int width, unsigned int height)
 {
   int bufferSize = 4096;
   uint8_t* fbuffer = (uint8_t*)av_malloc(bufferSize + FF_INPUT_BUFFER_PADDING_SIZE);
@@ -269,6 +336,16 @@ bool CFFmpegImage::Initialize(unsigned char* buffer, unsigned int bufSize)
     return false;
   }
 
+  // let the decoder scale JPEGs down in the DCT domain, swscale only does what's left
+  unsigned int jpegWidth, jpegHeight;
+  if (codec_params->codec_id == AV_CODEC_ID_MJPEG && width > 0 && height > 0 &&
+      GetJpegSize(buffer, bufSize, jpegWidth, jpegHeight))
+  {
+    m_codec_ctx->lowres = GetJpegScale(jpegWidth, jpegHeight, width, height, av_codec_get_max_lowres(codec));
+    m_originalWidth = jpegWidth;
+    m_originalHeight = jpegHeight;
+  }
+
   if (avcodec_open2(m_codec_ctx, codec, NULL) < 0)
   {
     avformat_close_input(&m_fctx);
@@ -313,8 +390,12 @@ AVFrame* CFFmpegImage::ExtractFrame()
   av_frame_set_pkt_duration(frame, av_rescale_q(frame->pkt_duration, m_fctx->streams[0]->time_base, AVRational{ 1, 1000 }));
   m_height = frame->height;
   m_width = frame->width;
-  m_originalWidth = m_width;
-  m_originalHeight = m_height;
+  // a JPEG decoded scaled down keeps the size it has in the file
+  if (m_codec_ctx->lowres == 0)
+  {
+    m_originalWidth = m_width;
+    m_originalHeight = m_height;
+  }
 
   const AVPixFmtDescriptor* pixDescriptor = av_pix_fmt_desc_get(static_cast<AVPixelFormat>(frame->format));
   if (pixDescriptor && ((pixDescriptor->flags & (AV_PIX_FMT_FLAG_ALPHA | AV_PIX_FMT_FLAG_PAL)) != 0))
@@ -488,8 +569,8 @@ bool CFFmpegImage::DecodeFrame(AVFrame* frame, unsigned int width, unsigned int
 
   // assumption quadratic maximums e.g. 2048x2048
   float ratio = m_width / (float)m_height;
-  unsigned int nHeight = m_originalHeight;
-  unsigned int nWidth = m_originalWidth;
+  unsigned int nHeight = frame->height;
+  unsigned int nWidth = frame->width;
   if (nHeight > height)
   {
     nHeight = height;
@@ -501,7 +582,7 @@ bool CFFmpegImage::DecodeFrame(AVFrame* frame, unsigned int width, unsigned int
     nHeight = (unsigned int)(nWidth / ratio + 0.5f);
   }
 
-  struct SwsContext* context = sws_getContext(m_originalWidth, m_originalHeight, pixFormat,
+  struct SwsContext* context = sws_getContext(frame->width, frame->height, pixFormat,
     nWidth, nHeight, AV_PIX_FMT_RGB32, SWS_BICUBIC, NULL, NULL, NULL);
 
   if (range == AVCOL_RANGE_JPEG)
@@ -514,7 +595,7 @@ bool CFFmpegImage::DecodeFrame(AVFrame* frame, unsigned int width, unsigned int
     sws_setColorspaceDetails(context, inv_table, srcRange, table, dstRange, brightness, contrast, saturation);
   }
 
-  sws_scale(context, frame->data, frame->linesize, 0, m_originalHeight,
+  sws_scale(context, frame->data, frame->linesize, 0, frame->height,
     pictureRGB->data, pictureRGB->linesize);
   sws_freeContext(context);
 
@@ -66,6 +66,8 @@ struct AVPacket;
 
 class CFFmpegImage : public IImage
 {
+  friend class TestFFmpegImageHelper;
+
 public:
   explicit CFFmpegImage(const std::string& strMimeType);
   ~CFFmpegImage() override;
@@ -81,12 +83,20 @@ public:
                                   unsigned int &bufferoutSize) override;
   void ReleaseThumbnailBuffer() override;
 
-  bool Initialize(unsigned char* buffer, unsigned int bufSize);
+  /*!
+   \brief Open the image for decoding
+   \param width,height the size the image is needed at, 0 for the full size. JPEGs are
+   decoded at the smallest of 1/2, 1/4 or 1/8 of their size still covering it.
+   */
+  bool Initialize(unsigned char* buffer, unsigned int bufSize, unsigned int width = 0, unsigned int height = 0);
 
   std::shared_ptr<Frame> ReadFrame();
 
 private:
   static void FreeIOCtx(AVIOContext** ioctx);
+  static bool GetJpegSize(const unsigned char* buffer, unsigned int bufSize, unsigned int& width, unsigned int& height);
+  static int GetJpegScale(unsigned int jpegWidth, unsigned int jpegHeight, unsigned int width, unsigned int height, int maxScale);
+  void Close();
   AVFrame* ExtractFrame();
   bool DecodeFrame(AVFrame* m_pFrame, unsigned int width, unsigned int height, unsigned int pitch, unsigned char * const pixels);
   static int EncodeFFmpegFrame(AVCodecContext *avctx, AVPacket *pkt, int *got_packet, AVFrame *frame);
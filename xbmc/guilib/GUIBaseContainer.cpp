@@ -576,11 +576,12 @@ void CGUIBaseContainer::OnJumpLetter(char letter, bool skip /*=false*/)
   // find the current letter we're focused on
   unsigned int offset = CorrectOffset(GetOffset(), GetCursor());
   unsigned int i      = (offset + ((skip) ? 1 : 0)) % m_items.size();
+  bool ignoreArticles = CServiceBroker::GetSettings().GetBool(CSettings::SETTING_FILELISTS_IGNORETHEWHENSORTING);
   do
   {
     CGUIListItemPtr item = m_items[i];
     std::string label = item->GetLabel();
-    if (CServiceBroker::GetSettings().GetBool(CSettings::SETTING_FILELISTS_IGNORETHEWHENSORTING))
+    if (ignoreArticles)
       label = SortUtils::RemoveArticles(label);
     if (0 == strnicmp(label.c_str(), m_match.c_str(), m_match.size()))
     {
@@ -681,6 +682,24 @@ CGUIListItemPtr CGUIBaseContainer::GetListItem(int offset, unsigned int flag) co
   return CGUIListItemPtr();
 }
 
+void CGUIBaseContainer::GetVisibleItems(std::vector<CGUIListItemPtr> &items) const
+{
+  items.clear();
+  if (!m_items.size() || !m_layout)
+    return;
+
+  // start at the row shown first while scrolling, and count the one partly scrolled in
+  int row = (int)(m_scroller.GetValue() / m_layout->Size(m_orientation));
+  int itemsPerRow = std::max(1, CorrectOffset(1, 0) - CorrectOffset(0, 0));
+  int count = std::min((int)m_items.size(), itemsPerRow * (m_itemsPerPage + 1));
+  for (int i = 0; i < count; i++)
+  {
+    int item = CorrectOffset(row, i);
+    if (item >= 0 && item < (int)m_items.size())
+      items.push_back(m_items[item]);
+  }
+}
+
 CGUIListItemLayout *CGUIBaseContainer::GetFocusedLayout() const
 {
   CGUIListItemPtr item = GetListItem(0);
@@ -76,6 +76,7 @@ public:
   void LoadListProvider(TiXmlElement *content, int defaultItem, bool defaultAlways);
 
   CGUIListItemPtr GetListItem(int offset, unsigned int flag = 0) const override;
+  void GetVisibleItems(std::vector<CGUIListItemPtr> &items) const override;
 
   bool GetCondition(int condition, int data) const override;
   std::string GetLabel(int info) const override;
@@ -19,6 +19,7 @@
  */
 
 #include "GUIColorManager.h"
+#include "GUITextLayout.h"
 
 #include <utility>
 
@@ -47,6 +48,8 @@ void CGUIColorManager::Clear()
 void CGUIColorManager::Load(const std::string &colorFile)
 {
   Clear();
+  // layouts have the colors of the previous map resolved already
+  CGUITextLayout::ClearCache();
 
   // load the global color map if it exists
   CXBMCTinyXML xmlDoc;
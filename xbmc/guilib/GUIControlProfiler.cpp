@@ -229,7 +229,8 @@ CGUIControlProfilerItem *CGUIControlProfilerItem::FindOrAddControl(CGUIControl *
 }
 
 CGUIControlProfiler::CGUIControlProfiler(void)
-: m_ItemHead(NULL, NULL, NULL), m_pLastItem(NULL), m_iMaxFrameCount(200), m_iFrameCount(0)
+: m_ItemHead(NULL, NULL, NULL), m_pLastItem(NULL), m_iMaxFrameCount(200), m_iFrameCount(0),
+  m_i64FrameStart(0), m_frameTime(0), m_maxFrameTime(0), m_textLayoutTime(0), m_textLayoutCount(0), m_textLayoutCached(0)
 // m_bIsRunning(false), no isRunning because it is static
 {
   m_fPerfScale = 100000.0f / CurrentHostFrequency();
@@ -252,6 +253,25 @@ void CGUIControlProfiler::Start(void)
   m_bIsRunning = true;
   m_pLastItem = NULL;
   m_ItemHead.Reset(this);
+  m_i64FrameStart = 0;
+  m_frameTime = 0;
+  m_maxFrameTime = 0;
+  m_textLayoutTime = 0;
+  m_textLayoutCount = 0;
+  m_textLayoutCached = 0;
+}
+
+void CGUIControlProfiler::BeginFrame(void)
+{
+  m_i64FrameStart = CurrentHostCounter();
+}
+
+void CGUIControlProfiler::AddTextLayout(int64_t start, bool cached)
+{
+  m_textLayoutTime += (unsigned int)(m_fPerfScale * (CurrentHostCounter() - start));
+  m_textLayoutCount++;
+  if (cached)
+    m_textLayoutCached++;
 }
 
 void CGUIControlProfiler::BeginVisibility(CGUIControl *pControl)
@@ -308,6 +328,15 @@ CGUIControlProfilerItem *CGUIControlProfiler::FindOrAddControl(CGUIControl *pCon
 
 void CGUIControlProfiler::EndFrame(void)
 {
+  if (m_i64FrameStart)
+  {
+    unsigned int frameTime = (unsigned int)(m_fPerfScale * (CurrentHostCounter() - m_i64FrameStart));
+    m_frameTime += frameTime;
+    if (frameTime > m_maxFrameTime)
+      m_maxFrameTime = frameTime;
+    m_i64FrameStart = 0;
+  }
+
   m_iFrameCount++;
   if (m_iFrameCount >= m_iMaxFrameCount)
   {
@@ -340,6 +369,20 @@ bool CGUIControlProfiler::SaveResults(void)
   root->SetAttribute("timeunit", "ms");
   doc.LinkEndChild(root);
 
+  // Note time is stored in 1/100 milliseconds but reported in ms
+  TiXmlElement *elem = new TiXmlElement("skinrendertime");
+  str = StringUtils::Format("%u", m_frameTime / 100);
+  elem->SetAttribute("max", StringUtils::Format("%u", m_maxFrameTime / 100).c_str());
+  elem->LinkEndChild(new TiXmlText(str.c_str()));
+  root->LinkEndChild(elem);
+
+  elem = new TiXmlElement("labelupdates");
+  elem->SetAttribute("count", StringUtils::Format("%u", m_textLayoutCount).c_str());
+  elem->SetAttribute("cached", StringUtils::Format("%u", m_textLayoutCached).c_str());
+  str = StringUtils::Format("%u", m_textLayoutTime / 100);
+  elem->LinkEndChild(new TiXmlText(str.c_str()));
+  root->LinkEndChild(elem);
+
   m_ItemHead.SaveToXML(root);
   return doc.SaveFile(m_strOutputFile);
 }
@@ -66,11 +66,16 @@ public:
   static bool IsRunning(void);
 
   void Start(void);
+  void BeginFrame(void);
   void EndFrame(void);
   void BeginVisibility(CGUIControl *pControl);
   void EndVisibility(CGUIControl *pControl);
   void BeginRender(CGUIControl *pControl);
   void EndRender(CGUIControl *pControl);
+  /*! \brief Accounts a label layout update that started at the given host counter.
+   \param cached true if the layout was taken from the text layout cache
+   */
+  void AddTextLayout(int64_t start, bool cached);
   int GetMaxFrameCount(void) const { return m_iMaxFrameCount; };
   void SetMaxFrameCount(int iMaxFrameCount) { m_iMaxFrameCount = iMaxFrameCount; };
   void SetOutputFile(const std::string &strOutputFile) { m_strOutputFile = strOutputFile; };
@@ -93,6 +98,14 @@ private:
   std::string m_strOutputFile;
   int m_iMaxFrameCount;
   int m_iFrameCount;
+
+  // whole windows, and label updates across all controls
+  int64_t m_i64FrameStart;
+  unsigned int m_frameTime;
+  unsigned int m_maxFrameTime;
+  unsigned int m_textLayoutTime;
+  unsigned int m_textLayoutCount;
+  unsigned int m_textLayoutCached;
 };
 
 #define GUIPROFILER_VISIBILITY_BEGIN(x) { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().BeginVisibility(x); }
@@ -39,6 +39,7 @@ CGUIRSSControl::CGUIRSSControl(int parentID, int controlID, float posX, float po
   m_rtl = false;
   m_stopped = false;
   m_urlset = 1;
+  m_enabled = CServiceBroker::GetSettings().GetHandle<bool>(CSettings::SETTING_LOOKANDFEEL_ENABLERSSFEEDS);
   ControlType = GUICONTROL_RSS;
 }
 
@@ -58,6 +59,7 @@ CGUIRSSControl::CGUIRSSControl(const CGUIRSSControl &from)
   m_rtl = from.m_rtl;
   m_stopped = from.m_stopped;
   m_urlset = 1;
+  m_enabled = from.m_enabled;
   ControlType = GUICONTROL_RSS;
 }
 
@@ -96,7 +98,7 @@ bool CGUIRSSControl::UpdateColors()
 void CGUIRSSControl::Process(unsigned int currentTime, CDirtyRegionList &dirtyregions)
 {
   bool dirty = false;
-  if (CServiceBroker::GetSettings().GetBool(CSettings::SETTING_LOOKANDFEEL_ENABLERSSFEEDS) && CRssManager::GetInstance().IsActive())
+  if (m_enabled.Get() && CRssManager::GetInstance().IsActive())
   {
     CSingleLock lock(m_criticalSection);
     // Create RSS background/worker thread if needed
@@ -157,7 +159,7 @@ void CGUIRSSControl::Process(unsigned int currentTime, CDirtyRegionList &dirtyre
 void CGUIRSSControl::Render()
 {
   // only render the control if they are enabled
-  if (CServiceBroker::GetSettings().GetBool(CSettings::SETTING_LOOKANDFEEL_ENABLERSSFEEDS) && CRssManager::GetInstance().IsActive())
+  if (m_enabled.Get() && CRssManager::GetInstance().IsActive())
   {
 
     if (m_label.font)
@@ -32,6 +32,7 @@
 
 #include "GUIControl.h"
 #include "GUILabel.h"
+#include "settings/lib/SettingHandle.h"
 #include "utils/IRssObserver.h"
 
 typedef uint32_t color_t;
@@ -84,5 +85,6 @@ protected:
   bool m_dirty;
   bool m_stopped;
   int  m_urlset;
+  CSettingHandle<bool> m_enabled; // checked every frame
 };
 #endif
@@ -22,8 +22,147 @@
 #include "GUIFont.h"
 #include "GUIControl.h"
 #include "GUIColorManager.h"
+#include "GUIControlProfiler.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
 #include "utils/CharsetConverter.h"
 #include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+#include "utils/Utf8Utils.h"
+
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+// number of laid out labels shared between all controls
+#define TEXT_LAYOUT_CACHE_SIZE       1024
+// longer texts (plots, text boxes) are rarely shared and not worth keeping
+#define TEXT_LAYOUT_CACHE_MAX_LENGTH 1024
+
+namespace
+{
+
+struct SLayoutKey
+{
+  SLayoutKey(const std::string &text, bool wide, const CGUIFont *font, color_t color, float maxWidth, float maxHeight, bool forceLTRReadingOrder)
+    : text(text), wide(wide), font(font), style(font ? font->GetStyle() : 0), color(color),
+      maxWidth(maxWidth > 0 ? maxWidth : 0), maxHeight(maxHeight), forceLTRReadingOrder(forceLTRReadingOrder)
+  {
+  }
+
+  std::string text; // utf8, or the raw bytes of the wide string
+  bool wide;
+  const CGUIFont *font;
+  uint32_t style;
+  color_t color;
+  float maxWidth; // 0 if the text is not wrapped
+  float maxHeight;
+  bool forceLTRReadingOrder;
+
+  bool operator==(const SLayoutKey &right) const
+  {
+    return text == right.text && wide == right.wide && font == right.font && style == right.style &&
+           color == right.color && maxWidth == right.maxWidth && maxHeight == right.maxHeight &&
+           forceLTRReadingOrder == right.forceLTRReadingOrder;
+  }
+};
+
+struct SLayoutKeyHash
+{
+  size_t operator()(const SLayoutKey &key) const
+  {
+    size_t hash = std::hash<std::string>()(key.text);
+    hash ^= std::hash<const void*>()(key.font) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= std::hash<float>()(key.maxWidth) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    return hash;
+  }
+};
+
+struct SLayout
+{
+  vecColors colors;
+  std::vector<CGUIString> lines;
+  float width;
+  float height;
+};
+
+/*!
+ \brief Least recently used layouts, looked up by everything that goes into laying out a label.
+ The same strings show up in many controls (list items scrolling by, labels of
+ different windows) so layouts are shared process wide.
+ */
+class CLayoutCache
+{
+public:
+  std::shared_ptr<const SLayout> Get(const SLayoutKey &key)
+  {
+    CSingleLock lock(m_section);
+    auto it = m_layouts.find(key);
+    if (it == m_layouts.end())
+      return std::shared_ptr<const SLayout>();
+
+    m_used.splice(m_used.begin(), m_used, it->second.used);
+    return it->second.layout;
+  }
+
+  void Add(SLayoutKey &&key, std::shared_ptr<const SLayout> layout)
+  {
+    CSingleLock lock(m_section);
+    auto result = m_layouts.emplace(std::move(key), SEntry());
+    if (!result.second)
+      return;
+
+    m_used.push_front(&result.first->first);
+    result.first->second.layout = std::move(layout);
+    result.first->second.used = m_used.begin();
+
+    if (m_layouts.size() > TEXT_LAYOUT_CACHE_SIZE)
+    {
+      m_layouts.erase(*m_used.back());
+      m_used.pop_back();
+    }
+  }
+
+  void Clear()
+  {
+    CSingleLock lock(m_section);
+    m_layouts.clear();
+    m_used.clear();
+  }
+
+private:
+  struct SEntry
+  {
+    std::shared_ptr<const SLayout> layout;
+    std::list<const SLayoutKey*>::iterator used;
+  };
+
+  CCriticalSection m_section;
+  std::unordered_map<SLayoutKey, SEntry, SLayoutKeyHash> m_layouts;
+  std::list<const SLayoutKey*> m_used; // most recently used first
+};
+
+// never destroyed, the font manager still clears it during static destruction
+CLayoutCache& GetLayoutCache()
+{
+  static CLayoutCache* cache = new CLayoutCache();
+  return *cache;
+}
+
+// bidi flipping only changes text with right to left characters or explicit bidi marks
+bool IsBidiCharacter(character_t letter)
+{
+  letter &= 0xffff;
+  return (letter >= 0x0590 && letter <= 0x08FF) ||  // hebrew, arabic, syriac, thaana, nko, ...
+         (letter >= 0x200E && letter <= 0x200F) ||  // LRM, RLM
+         (letter >= 0x202A && letter <= 0x202E) ||  // embeddings and overrides
+         (letter >= 0x2066 && letter <= 0x2069) ||  // isolates
+         (letter >= 0xD800 && letter <= 0xDFFF) ||  // surrogates
+         (letter >= 0xFB1D && letter <= 0xFDFF) ||  // hebrew and arabic presentation forms
+         (letter >= 0xFE70 && letter <= 0xFEFF);
+}
+
+}
 
 CGUIString::CGUIString(iString start, iString end, bool carriageReturn)
 {
@@ -217,11 +356,23 @@ bool CGUITextLayout::Update(const std::string &text, float maxWidth, bool forceU
   if (text == m_lastUtf8Text && !forceUpdate && !m_lastUpdateW)
     return false;
 
+  int64_t start = CGUIControlProfiler::IsRunning() ? CurrentHostCounter() : 0;
+
   m_lastUtf8Text = text;
   m_lastUpdateW = false;
-  std::wstring utf16;
-  g_charsetConverter.utf8ToW(text, utf16, false);
-  UpdateCommon(utf16, maxWidth, forceLTRReadingOrder);
+
+  bool cached = LoadLayout(text, false, maxWidth, forceLTRReadingOrder);
+  if (!cached)
+  {
+    std::wstring utf16;
+    if (!CUtf8Utils::Utf8ToW(text, utf16))
+      g_charsetConverter.utf8ToW(text, utf16, false);
+    UpdateCommon(utf16, maxWidth, forceLTRReadingOrder);
+    StoreLayout(text, false, maxWidth, forceLTRReadingOrder);
+  }
+
+  if (start)
+    CGUIControlProfiler::Instance().AddTextLayout(start, cached);
   return true;
 }
 
@@ -230,12 +381,58 @@ bool CGUITextLayout::UpdateW(const std::wstring &text, float maxWidth /*= 0*/, b
   if (text == m_lastText && !forceUpdate && m_lastUpdateW)
     return false;
 
+  int64_t start = CGUIControlProfiler::IsRunning() ? CurrentHostCounter() : 0;
+
   m_lastText = text;
   m_lastUpdateW = true;
-  UpdateCommon(text, maxWidth, forceLTRReadingOrder);
+
+  std::string bytes(reinterpret_cast<const char*>(text.c_str()), text.size() * sizeof(wchar_t));
+  bool cached = LoadLayout(bytes, true, maxWidth, forceLTRReadingOrder);
+  if (!cached)
+  {
+    UpdateCommon(text, maxWidth, forceLTRReadingOrder);
+    StoreLayout(bytes, true, maxWidth, forceLTRReadingOrder);
+  }
+
+  if (start)
+    CGUIControlProfiler::Instance().AddTextLayout(start, cached);
+  return true;
+}
+
+bool CGUITextLayout::LoadLayout(const std::string &text, bool wide, float maxWidth, bool forceLTRReadingOrder)
+{
+  if (text.empty() || text.size() > TEXT_LAYOUT_CACHE_MAX_LENGTH)
+    return false;
+
+  std::shared_ptr<const SLayout> layout = GetLayoutCache().Get(SLayoutKey(text, wide, m_font, m_textColor, m_wrap ? maxWidth : 0, m_maxHeight, forceLTRReadingOrder));
+  if (!layout)
+    return false;
+
+  m_colors = layout->colors;
+  m_lines = layout->lines;
+  m_textWidth = layout->width;
+  m_textHeight = layout->height;
   return true;
 }
 
+void CGUITextLayout::StoreLayout(const std::string &text, bool wide, float maxWidth, bool forceLTRReadingOrder) const
+{
+  if (text.empty() || text.size() > TEXT_LAYOUT_CACHE_MAX_LENGTH)
+    return;
+
+  std::shared_ptr<SLayout> layout = std::make_shared<SLayout>();
+  layout->colors = m_colors;
+  layout->lines = m_lines;
+  layout->width = m_textWidth;
+  layout->height = m_textHeight;
+  GetLayoutCache().Add(SLayoutKey(text, wide, m_font, m_textColor, m_wrap ? maxWidth : 0, m_maxHeight, forceLTRReadingOrder), std::move(layout));
+}
+
+void CGUITextLayout::ClearCache()
+{
+  GetLayoutCache().Clear();
+}
+
 void CGUITextLayout::UpdateCommon(const std::wstring &text, float maxWidth, bool forceLTRReadingOrder)
 {
   // parse the text for style information
@@ -276,6 +473,10 @@ void CGUITextLayout::BidiTransform(std::vector<CGUIString> &lines, bool forceLTR
   {
     CGUIString &line = lines[i];
 
+    // most lines have nothing to flip, skip the round trip through fribidi
+    if (std::find_if(line.m_text.begin(), line.m_text.end(), IsBidiCharacter) == line.m_text.end())
+      continue;
+
     // reserve enough space in the flipped text
     vecText flippedText;
     flippedText.reserve(line.m_text.size());
@@ -675,7 +876,8 @@ void CGUITextLayout::AppendToUTF32(const std::string &utf8, character_t colStyle
 {
   std::wstring utf16;
   // no need to bidiflip here - it's done in BidiTransform above
-  g_charsetConverter.utf8ToW(utf8, utf16, false);
+  if (!CUtf8Utils::Utf8ToW(utf8, utf16))
+    g_charsetConverter.utf8ToW(utf8, utf16, false);
   AppendToUTF32(utf16, colStyle, utf32);
 }
 
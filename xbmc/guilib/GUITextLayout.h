@@ -111,6 +111,11 @@ public:
   static void DrawText(CGUIFont *font, float x, float y, color_t color, color_t shadowColor, const std::string &text, uint32_t align);
   static void Filter(std::string &text);
 
+  /*! \brief Drops all layouts shared between labels.
+   Needs to be called whenever fonts or colors are reloaded or fonts are deleted.
+   */
+  static void ClearCache();
+
 protected:
   void LineBreakText(const vecText &text, std::vector<CGUIString> &lines);
   void WrapText(const vecText &text, float maxWidth);
@@ -144,6 +149,12 @@ protected:
   float m_textWidth;
   float m_textHeight;
 private:
+  /*! \brief Takes lines, colors and extent from the layout cache if the text was laid out before.
+   \param text the text, utf8 or the bytes of a wide string
+   */
+  bool LoadLayout(const std::string &text, bool wide, float maxWidth, bool forceLTRReadingOrder);
+  void StoreLayout(const std::string &text, bool wide, float maxWidth, bool forceLTRReadingOrder) const;
+
   inline bool IsSpace(character_t letter) const XBMC_FORCE_INLINE
   {
     return (letter & 0xffff) == L' ';
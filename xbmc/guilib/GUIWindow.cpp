@@ -365,6 +365,8 @@ void CGUIWindow::DoRender()
   // to occur.
   if (!m_bAllocated) return;
 
+  if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().BeginFrame();
+
   g_graphicsContext.SetRenderingResolution(m_coordsRes, m_needsScaling);
 
   g_graphicsContext.AddGUITransform();
@@ -22,6 +22,7 @@
 
 #include "GUIControl.h"
 #include <memory>
+#include <vector>
 
 typedef std::shared_ptr<CGUIListItem> CGUIListItemPtr;
 
@@ -51,4 +52,9 @@ public:
 
   virtual CGUIListItemPtr GetListItem(int offset, unsigned int flag = 0) const = 0;
   virtual std::string GetLabel(int info) const                                 = 0;
+
+  /*! \brief Get the items currently on screen
+   \param items [out] the visible items, empty if the container can't tell
+   */
+  virtual void GetVisibleItems(std::vector<CGUIListItemPtr> &items) const { items.clear(); }
 };
@@ -21,7 +21,9 @@
 #include "TextureManager.h"
 
 #include <cassert>
+#include <typeinfo>
 
+#include "addons/AddonEvents.h"
 #include "addons/Skin.h"
 #include "filesystem/Directory.h"
 #include "filesystem/File.h"
@@ -43,6 +45,9 @@
 #endif
 #include "FFmpegImage.h"
 
+// number of media names found in the texture paths remembered before starting over
+#define FOUND_PATHS_CACHE_SIZE 2048
+
 /************************************************************************/
 /*                                                                      */
 /************************************************************************/
@@ -263,17 +268,14 @@ bool CGUITextureManager::HasTexture(const std::string &textureName, std::string
     return false;
 
   // Check our loaded and bundled textures - we store in bundles using \\.
-  std::string bundledName = CTextureBundle::Normalize(textureName);
-  for (int i = 0; i < (int)m_vecTextures.size(); ++i)
+  if (m_textures.find(textureName) != m_textures.end())
   {
-    CTextureMap *pMap = m_vecTextures[i];
-    if (pMap->GetName() == textureName)
-    {
-      if (size) *size = 1;
-      return true;
-    }
+    if (size) *size = 1;
+    return true;
   }
 
+  std::string bundledName = CTextureBundle::Normalize(textureName);
+
   for (int i = 0; i < 2; i++)
   {
     if (m_TexBundle[i].HasFile(bundledName))
@@ -305,28 +307,23 @@ const CTextureArray& CGUITextureManager::Load(const std::string& strTextureName,
 
   if (size) // we found the texture
   {
-    for (int i = 0; i < (int)m_vecTextures.size(); ++i)
+    TextureMaps::iterator i = m_textures.find(strTextureName);
+    if (i != m_textures.end())
     {
-      CTextureMap *pMap = m_vecTextures[i];
-      if (pMap->GetName() == strTextureName)
-      {
-        //CLog::Log(LOGDEBUG, "Total memusage %u", GetMemoryUsage());
-        return pMap->GetTexture();
-      }
+      //CLog::Log(LOGDEBUG, "Total memusage %u", GetMemoryUsage());
+      return i->second->GetTexture();
     }
     // Whoops, not there.
     return emptyTexture;
   }
 
-  for (ilistUnused i = m_unusedTextures.begin(); i != m_unusedTextures.end(); ++i)
+  auto unused = m_unusedIndex.find(strTextureName);
+  if (unused != m_unusedIndex.end())
   {
-    CTextureMap* pMap = i->first;
-    if (pMap->GetName() == strTextureName && i->second > 0)
-    {
-      m_vecTextures.push_back(pMap);
-      m_unusedTextures.erase(i);
-      return pMap->GetTexture();
-    }
+    CTextureMap* pMap = unused->second->first;
+    RemoveUnusedTexture(unused->second);
+    m_textures.insert(std::make_pair(strTextureName, pMap));
+    return pMap->GetTexture();
   }
 
   if (checkBundleOnly && bundle == -1)
@@ -371,7 +368,7 @@ const CTextureArray& CGUITextureManager::Load(const std::string& strTextureName,
     delete[] pTextures;
     delete[] Delay;
 
-    m_vecTextures.push_back(pMap);
+    m_textures.insert(std::make_pair(strTextureName, pMap));
     return pMap->GetTexture();
   }
   else if (StringUtils::EndsWithNoCase(strPath, ".gif") ||
@@ -428,7 +425,7 @@ const CTextureArray& CGUITextureManager::Load(const std::string& strTextureName,
 
     file.Close();
 
-    m_vecTextures.push_back(pMap);
+    m_textures.insert(std::make_pair(strTextureName, pMap));
     return pMap->GetTexture();
   }
 
@@ -455,7 +452,7 @@ const CTextureArray& CGUITextureManager::Load(const std::string& strTextureName,
 
   CTextureMap* pMap = new CTextureMap(strTextureName, width, height, 0);
   pMap->Add(pTexture, 100);
-  m_vecTextures.push_back(pMap);
+  m_textures.insert(std::make_pair(strTextureName, pMap));
 
 #ifdef _DEBUG_TEXTURES
   int64_t end, freq;
@@ -474,40 +471,59 @@ void CGUITextureManager::ReleaseTexture(const std::string& strTextureName, bool
 {
   CSingleLock lock(g_graphicsContext);
 
-  ivecTextures i;
-  i = m_vecTextures.begin();
-  while (i != m_vecTextures.end())
+  TextureMaps::iterator i = m_textures.find(strTextureName);
+  if (i != m_textures.end())
   {
-    CTextureMap* pMap = *i;
-    if (pMap->GetName() == strTextureName)
+    CTextureMap* pMap = i->second;
+    if (pMap->Release())
     {
-      if (pMap->Release())
-      {
-        //CLog::Log(LOGINFO, "  cleanup:%s", strTextureName.c_str());
-        // add to our textures to free
-        m_unusedTextures.push_back(std::make_pair(pMap, immediately ? 0 : XbmcThreads::SystemClockMillis()));
-        i = m_vecTextures.erase(i);
-      }
-      return;
+      //CLog::Log(LOGINFO, "  cleanup:%s", strTextureName.c_str());
+      // add to our textures to free
+      AddUnusedTexture(pMap, immediately);
+      m_textures.erase(i);
     }
-    ++i;
+    return;
   }
   CLog::Log(LOGWARNING, "%s: Unable to release texture %s", __FUNCTION__, strTextureName.c_str());
 }
 
+void CGUITextureManager::AddUnusedTexture(CTextureMap* pMap, bool immediately)
+{
+  if (immediately)
+  {
+    // never reused and due for freeing right away, so it goes before everything released with a delay
+    m_unusedTextures.push_front(std::make_pair(pMap, 0));
+    return;
+  }
+
+  ilistUnused it = m_unusedTextures.insert(m_unusedTextures.end(), std::make_pair(pMap, XbmcThreads::SystemClockMillis()));
+
+  // a texture that's still unused was not reusable, otherwise it would have been picked up on load
+  m_unusedIndex[pMap->GetName()] = it;
+}
+
+void CGUITextureManager::RemoveUnusedTexture(ilistUnused it)
+{
+  auto index = m_unusedIndex.find(it->first->GetName());
+  if (index != m_unusedIndex.end() && index->second == it)
+    m_unusedIndex.erase(index);
+  m_unusedTextures.erase(it);
+}
+
 void CGUITextureManager::FreeUnusedTextures(unsigned int timeDelay)
 {
   unsigned int currFrameTime = XbmcThreads::SystemClockMillis();
   CSingleLock lock(g_graphicsContext);
-  for (ilistUnused i = m_unusedTextures.begin(); i != m_unusedTextures.end();)
+  // unused textures are ordered by release time, so stop at the first one still to be kept
+  while (!m_unusedTextures.empty())
   {
-    if (currFrameTime - i->second >= timeDelay)
-    {
-      delete i->first;
-      i = m_unusedTextures.erase(i);
-    }
-    else
-      ++i;
+    ilistUnused i = m_unusedTextures.begin();
+    if (i->second > 0 && currFrameTime - i->second < timeDelay)
+      break;
+
+    CTextureMap* pMap = i->first;
+    RemoveUnusedTexture(i);
+    delete pMap;
   }
 
 #if defined(HAS_GL) || defined(HAS_GLES)
@@ -535,28 +551,29 @@ void CGUITextureManager::Cleanup()
 {
   CSingleLock lock(g_graphicsContext);
 
-  ivecTextures i;
-  i = m_vecTextures.begin();
-  while (i != m_vecTextures.end())
+  TextureMaps::iterator i = m_textures.begin();
+  while (i != m_textures.end())
   {
-    CTextureMap* pMap = *i;
+    CTextureMap* pMap = i->second;
     CLog::Log(LOGWARNING, "%s: Having to cleanup texture %s", __FUNCTION__, pMap->GetName().c_str());
     delete pMap;
-    i = m_vecTextures.erase(i);
+    i = m_textures.erase(i);
   }
 
   m_TexBundle[0] = CTextureBundle(true);
   m_TexBundle[1] = CTextureBundle();
   FreeUnusedTextures();
+
+  ClearFoundPaths();
 }
 
 void CGUITextureManager::Dump() const
 {
-  CLog::Log(LOGDEBUG, "{0}: total texturemaps size: {1}", __FUNCTION__, m_vecTextures.size());
+  CLog::Log(LOGDEBUG, "{0}: total texturemaps size: {1}", __FUNCTION__, m_textures.size());
 
-  for (int i = 0; i < (int)m_vecTextures.size(); ++i)
+  for (TextureMaps::const_iterator i = m_textures.begin(); i != m_textures.end(); ++i)
   {
-    const CTextureMap* pMap = m_vecTextures[i];
+    const CTextureMap* pMap = i->second;
     if (!pMap->IsEmpty())
       pMap->Dump();
   }
@@ -566,16 +583,15 @@ void CGUITextureManager::Flush()
 {
   CSingleLock lock(g_graphicsContext);
 
-  ivecTextures i;
-  i = m_vecTextures.begin();
-  while (i != m_vecTextures.end())
+  TextureMaps::iterator i = m_textures.begin();
+  while (i != m_textures.end())
   {
-    CTextureMap* pMap = *i;
+    CTextureMap* pMap = i->second;
     pMap->Flush();
     if (pMap->IsEmpty() )
     {
       delete pMap;
-      i = m_vecTextures.erase(i);
+      i = m_textures.erase(i);
     }
     else
     {
@@ -587,9 +603,9 @@ void CGUITextureManager::Flush()
 unsigned int CGUITextureManager::GetMemoryUsage() const
 {
   unsigned int memUsage = 0;
-  for (int i = 0; i < (int)m_vecTextures.size(); ++i)
+  for (TextureMaps::const_iterator i = m_textures.begin(); i != m_textures.end(); ++i)
   {
-    memUsage += m_vecTextures[i]->GetMemoryUsage();
+    memUsage += i->second->GetMemoryUsage();
   }
   return memUsage;
 }
@@ -598,12 +614,14 @@ void CGUITextureManager::SetTexturePath(const std::string &texturePath)
 {
   CSingleLock lock(m_section);
   m_texturePaths.clear();
+  ClearFoundPaths();
   AddTexturePath(texturePath);
 }
 
 void CGUITextureManager::AddTexturePath(const std::string &texturePath)
 {
   CSingleLock lock(m_section);
+  // only found media is remembered and earlier paths win, so an appended path can't change it
   if (!texturePath.empty())
     m_texturePaths.push_back(texturePath);
 }
@@ -616,11 +634,39 @@ void CGUITextureManager::RemoveTexturePath(const std::string &texturePath)
     if (*it == texturePath)
     {
       m_texturePaths.erase(it);
+      // windows add and remove their own path around every call, forget only what was found there
+      for (unsigned int i = 0; i < 2; i++)
+      {
+        std::unordered_map<std::string, std::string> &found = m_foundPaths[i];
+        for (auto entry = found.begin(); entry != found.end();)
+        {
+          if (entry->second == URIUtils::AddFileToFolder(texturePath, "media", entry->first))
+            entry = found.erase(entry);
+          else
+            ++entry;
+        }
+      }
       return;
     }
   }
 }
 
+void CGUITextureManager::OnAddonEvent(const ADDON::AddonEvent& event)
+{
+  // an add-on or skin update may add or remove media
+  if (typeid(event) == typeid(ADDON::AddonEvents::InstalledChanged) ||
+      typeid(event) == typeid(ADDON::AddonEvents::ReInstalled) ||
+      typeid(event) == typeid(ADDON::AddonEvents::UnInstalled))
+    ClearFoundPaths();
+}
+
+void CGUITextureManager::ClearFoundPaths()
+{
+  CSingleLock lock(m_section);
+  m_foundPaths[0].clear();
+  m_foundPaths[1].clear();
+}
+
 std::string CGUITextureManager::GetTexturePath(const std::string &textureName, bool directory /* = false */)
 {
   if (CURL::IsFullPath(textureName))
@@ -628,18 +674,23 @@ std::string CGUITextureManager::GetTexturePath(const std::string &textureName, b
   else
   { // texture doesn't include the full path, so check all fallbacks
     CSingleLock lock(m_section);
+
+    // media folders are probed for every control, remember what was found there.
+    // Misses aren't remembered, they may be added any time and their names are unbounded.
+    std::unordered_map<std::string, std::string> &found = m_foundPaths[directory ? 1 : 0];
+    auto cached = found.find(textureName);
+    if (cached != found.end())
+      return cached->second;
+
     for (std::vector<std::string>::iterator it = m_texturePaths.begin(); it != m_texturePaths.end(); ++it)
     {
       std::string path = URIUtils::AddFileToFolder(it->c_str(), "media", textureName);
-      if (directory)
-      {
-        if (XFILE::CDirectory::Exists(path))
-          return path;
-      }
-      else
+      if (directory ? XFILE::CDirectory::Exists(path) : XFILE::CFile::Exists(path))
       {
-        if (XFILE::CFile::Exists(path))
-          return path;
+        if (found.size() >= FOUND_PATHS_CACHE_SIZE)
+          found.clear();
+        found.insert(std::make_pair(textureName, path));
+        return path;
       }
     }
   }
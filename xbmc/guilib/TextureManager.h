@@ -25,12 +25,18 @@
 #pragma once
 
 #include <list>
+#include <unordered_map>
 #include <vector>
 #include <utility>
 
 #include "TextureBundle.h"
 #include "threads/CriticalSection.h"
 
+namespace ADDON
+{
+  struct AddonEvent;
+}
+
 /************************************************************************/
 /*                                                                      */
 /************************************************************************/
@@ -121,19 +127,29 @@ public:
   void AddTexturePath(const std::string &texturePath);    ///< Add a new path to the paths to check when loading media
   void SetTexturePath(const std::string &texturePath);    ///< Set a single path as the path to check when loading media (clear then add)
   void RemoveTexturePath(const std::string &texturePath); ///< Remove a path from the paths to check when loading media
+  void OnAddonEvent(const ADDON::AddonEvent& event);      ///< Forget found media when add-ons are installed or removed
 
   void FreeUnusedTextures(unsigned int timeDelay = 0); ///< Free textures (called from app thread only)
   void ReleaseHwTexture(unsigned int texture);
 protected:
-  std::vector<CTextureMap*> m_vecTextures;
-  std::list<std::pair<CTextureMap*, unsigned int> > m_unusedTextures;
+  typedef std::unordered_map<std::string, CTextureMap*> TextureMaps;
+  typedef std::list<std::pair<CTextureMap*, unsigned int> > UnusedTextures;
+  typedef UnusedTextures::iterator ilistUnused;
+
+  void AddUnusedTexture(CTextureMap* pMap, bool immediately);
+  void RemoveUnusedTexture(ilistUnused it);
+
+  TextureMaps m_textures; ///< textures in use, by name
+  UnusedTextures m_unusedTextures; ///< released textures, least recently released first
+  std::unordered_map<std::string, ilistUnused> m_unusedIndex; ///< released textures that may be reused, by name
   std::vector<unsigned int> m_unusedHwTextures;
-  typedef std::vector<CTextureMap*>::iterator ivecTextures;
-  typedef std::list<std::pair<CTextureMap*, unsigned int> >::iterator ilistUnused;
   // we have 2 texture bundles (one for the base textures, one for the theme)
   CTextureBundle m_TexBundle[2];
 
+  void ClearFoundPaths();
+
   std::vector<std::string> m_texturePaths;
+  std::unordered_map<std::string, std::string> m_foundPaths[2]; ///< media files (0) and directories (1) found in m_texturePaths, by name
   CCriticalSection m_section;
 };
 
@@ -20,6 +20,7 @@
 
 #include "XBTF.h"
 
+#include <algorithm>
 #include <cstring>
 #include <utility>
 
@@ -214,8 +215,7 @@ uint64_t CXBTFBase::GetHeaderSize() const
 
 bool CXBTFBase::Exists(const std::string& name) const
 {
-  CXBTFFile dummy;
-  return Get(name, dummy);
+  return m_files.find(name) != m_files.end();
 }
 
 bool CXBTFBase::Get(const std::string& name, CXBTFFile& file) const
@@ -236,6 +236,10 @@ std::vector<CXBTFFile> CXBTFBase::GetFiles() const
   for (const auto& file : m_files)
     files.push_back(file.second);
 
+  // keep the order independent of the hashing, the bundle layout written by TexturePacker follows it
+  std::sort(files.begin(), files.end(),
+            [](const CXBTFFile& a, const CXBTFFile& b) { return a.GetPath() < b.GetPath(); });
+
   return files;
 }
 
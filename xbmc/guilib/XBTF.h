@@ -19,8 +19,8 @@
  *
  */
 
-#include <map>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <stdint.h>
@@ -107,6 +107,9 @@ public:
 
   bool Exists(const std::string& name) const;
   bool Get(const std::string& name, CXBTFFile& file) const;
+  /*!
+   \brief Returns all files ordered by path
+   */
   std::vector<CXBTFFile> GetFiles() const;
   void AddFile(const CXBTFFile& file);
   void UpdateFile(const CXBTFFile& file);
@@ -114,5 +117,5 @@ public:
 protected:
   CXBTFBase() = default;
 
-  std::map<std::string, CXBTFFile> m_files;
+  std::unordered_map<std::string, CXBTFFile> m_files;
 };
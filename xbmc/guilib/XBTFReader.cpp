@@ -22,43 +22,77 @@
 #include <stdio.h>
 #include <string.h>
 #include <sys/stat.h>
+#ifndef TARGET_WINDOWS
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 #include "XBTFReader.h"
 #include "guilib/XBTF.h"
 #include "utils/EndianSwap.h"
 
 #ifdef TARGET_WINDOWS
+#include <io.h>
 #include "filesystem/SpecialProtocol.h"
 #include "utils/CharsetConverter.h"
 #include "platform/win32/PlatformDefs.h"
 #endif
 
-static bool ReadString(FILE* file, char* str, size_t max_length)
+namespace
 {
-  if (file == nullptr || str == nullptr || max_length <= 0)
-    return false;
+// reads the index either from the mapped bundle or from the file
+class CIndexSource
+{
+public:
+  CIndexSource(const uint8_t* data, uint64_t size, FILE* file)
+    : m_data(data), m_size(size), m_file(file), m_position(0)
+  { }
+
+  bool Read(void* buffer, size_t size)
+  {
+    if (m_data != nullptr)
+    {
+      if (m_size - m_position < size)
+        return false;
+      memcpy(buffer, m_data + m_position, size);
+    }
+    else if (fread(buffer, 1, size, m_file) != size)
+      return false;
 
-  return (fread(str, max_length, 1, file) == 1);
+    m_position += size;
+    return true;
+  }
+
+  uint64_t GetPosition() const { return m_position; }
+
+private:
+  const uint8_t* m_data;
+  uint64_t m_size;
+  FILE* m_file;
+  uint64_t m_position;
+};
 }
 
-static bool ReadUInt32(FILE* file, uint32_t& value)
+static bool ReadString(CIndexSource& source, char* str, size_t max_length)
 {
-  if (file == nullptr)
+  if (str == nullptr || max_length <= 0)
     return false;
 
-  if (fread(&value, sizeof(uint32_t), 1, file) != 1)
+  return source.Read(str, max_length);
+}
+
+static bool ReadUInt32(CIndexSource& source, uint32_t& value)
+{
+  if (!source.Read(&value, sizeof(uint32_t)))
     return false;
 
   value = Endian_SwapLE32(value);
   return true;
 }
 
-static bool ReadUInt64(FILE* file, uint64_t& value)
+static bool ReadUInt64(CIndexSource& source, uint64_t& value)
 {
-  if (file == nullptr)
-    return false;
-
-  if (fread(&value, sizeof(uint64_t), 1, file) != 1)
+  if (!source.Read(&value, sizeof(uint64_t)))
     return false;
 
   value = Endian_SwapLE64(value);
@@ -68,7 +102,12 @@ static bool ReadUInt64(FILE* file, uint64_t& value)
 CXBTFReader::CXBTFReader()
   : CXBTFBase(),
     m_path(),
-    m_file(nullptr)
+    m_file(nullptr),
+    m_data(nullptr),
+    m_size(0)
+#ifdef TARGET_WINDOWS
+    , m_mapping(nullptr)
+#endif
 { }
 
 CXBTFReader::~CXBTFReader()
@@ -76,7 +115,7 @@ CXBTFReader::~CXBTFReader()
   Close();
 }
 
-bool CXBTFReader::Open(const std::string& path)
+bool CXBTFReader::Open(const std::string& path, bool alwaysMap)
 {
   if (path.empty())
     return false;
@@ -93,9 +132,17 @@ bool CXBTFReader::Open(const std::string& path)
   if (m_file == nullptr)
     return false;
 
+  // a mapped bundle that is truncated while open crashes the next read past its end,
+  // so only bundles nobody can rewrite in place are mapped, the others and those
+  // failing to map are read with fread
+  if (alwaysMap || !IsWritable())
+    Map();
+
+  CIndexSource source(m_data, m_size, m_file);
+
   // read the magic word
   char magic[4];
-  if (!ReadString(m_file, magic, sizeof(magic)))
+  if (!ReadString(source, magic, sizeof(magic)))
     return false;
 
   if (strncmp(XBTF_MAGIC.c_str(), magic, sizeof(magic)) != 0)
@@ -103,16 +150,17 @@ bool CXBTFReader::Open(const std::string& path)
 
   // read the version
   char version[1];
-  if (!ReadString(m_file, version, sizeof(version)))
+  if (!ReadString(source, version, sizeof(version)))
     return false;
 
   if (strncmp(XBTF_VERSION.c_str(), version, sizeof(version)) != 0)
     return false;
 
   unsigned int nofFiles;
-  if (!ReadUInt32(m_file, nofFiles))
+  if (!ReadUInt32(source, nofFiles))
     return false;
 
+  m_files.reserve(nofFiles);
   for (uint32_t i = 0; i < nofFiles; i++)
   {
     CXBTFFile xbtfFile;
@@ -122,47 +170,47 @@ bool CXBTFReader::Open(const std::string& path)
     // one extra char to null terminate the string with the following memset
     char path[CXBTFFile::MaximumPathLength + 1];
     memset(path, 0, sizeof(path));
-    if (!ReadString(m_file, path, sizeof(path) - 1))
+    if (!ReadString(source, path, sizeof(path) - 1))
       return false;
     xbtfFile.SetPath(path);
 
-    if (!ReadUInt32(m_file, u32))
+    if (!ReadUInt32(source, u32))
       return false;
     xbtfFile.SetLoop(u32);
 
     unsigned int nofFrames;
-    if (!ReadUInt32(m_file, nofFrames))
+    if (!ReadUInt32(source, nofFrames))
       return false;
 
     for (uint32_t j = 0; j < nofFrames; j++)
     {
       CXBTFFrame frame;
 
-      if (!ReadUInt32(m_file, u32))
+      if (!ReadUInt32(source, u32))
         return false;
       frame.SetWidth(u32);
 
-      if (!ReadUInt32(m_file, u32))
+      if (!ReadUInt32(source, u32))
         return false;
       frame.SetHeight(u32);
 
-      if (!ReadUInt32(m_file, u32))
+      if (!ReadUInt32(source, u32))
         return false;
       frame.SetFormat(u32);
 
-      if (!ReadUInt64(m_file, u64))
+      if (!ReadUInt64(source, u64))
         return false;
       frame.SetPackedSize(u64);
 
-      if (!ReadUInt64(m_file, u64))
+      if (!ReadUInt64(source, u64))
         return false;
       frame.SetUnpackedSize(u64);
 
-      if (!ReadUInt32(m_file, u32))
+      if (!ReadUInt32(source, u32))
         return false;
       frame.SetDuration(u32);
 
-      if (!ReadUInt64(m_file, u64))
+      if (!ReadUInt64(source, u64))
         return false;
       frame.SetOffset(u64);
 
@@ -173,13 +221,78 @@ bool CXBTFReader::Open(const std::string& path)
   }
 
   // Sanity check
-  uint64_t pos = static_cast<uint64_t>(ftell(m_file));
-  if (pos != GetHeaderSize())
+  if (source.GetPosition() != GetHeaderSize())
     return false;
 
   return true;
 }
 
+bool CXBTFReader::IsWritable() const
+{
+#ifdef TARGET_WINDOWS
+  std::wstring strPathW;
+  g_charsetConverter.utf8ToW(CSpecialProtocol::TranslatePath(m_path), strPathW, false);
+  // an open mapping makes overwriting the file fail, so play safe as the attributes don't tell about ACLs
+  return _waccess(strPathW.c_str(), 2) == 0;
+#else
+  return access(m_path.c_str(), W_OK) == 0;
+#endif
+}
+
+bool CXBTFReader::Map()
+{
+#ifdef TARGET_WINDOWS
+  HANDLE file = reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(m_file)));
+  LARGE_INTEGER size;
+  if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &size) || size.QuadPart <= 0)
+    return false;
+
+  m_mapping = CreateFileMapping(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (m_mapping == nullptr)
+    return false;
+
+  m_data = static_cast<const uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+  if (m_data == nullptr)
+  {
+    CloseHandle(m_mapping);
+    m_mapping = nullptr;
+    return false;
+  }
+
+  m_size = static_cast<uint64_t>(size.QuadPart);
+#else
+  struct stat fileStat;
+  if (fstat(fileno(m_file), &fileStat) == -1 || fileStat.st_size <= 0)
+    return false;
+
+  void* data = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_SHARED, fileno(m_file), 0);
+  if (data == MAP_FAILED)
+    return false;
+
+  m_data = static_cast<const uint8_t*>(data);
+  m_size = static_cast<uint64_t>(fileStat.st_size);
+#endif
+
+  return true;
+}
+
+void CXBTFReader::Unmap()
+{
+  if (m_data == nullptr)
+    return;
+
+#ifdef TARGET_WINDOWS
+  UnmapViewOfFile(m_data);
+  CloseHandle(m_mapping);
+  m_mapping = nullptr;
+#else
+  munmap(const_cast<uint8_t*>(m_data), static_cast<size_t>(m_size));
+#endif
+
+  m_data = nullptr;
+  m_size = 0;
+}
+
 bool CXBTFReader::IsOpen() const
 {
   return m_file != nullptr;
@@ -187,6 +300,8 @@ bool CXBTFReader::IsOpen() const
 
 void CXBTFReader::Close()
 {
+  Unmap();
+
   if (m_file != nullptr)
   {
     fclose(m_file);
@@ -211,6 +326,16 @@ time_t CXBTFReader::GetLastModificationTimestamp() const
 
 bool CXBTFReader::Load(const CXBTFFrame& frame, unsigned char* buffer) const
 {
+  if (m_data != nullptr)
+  {
+    const uint8_t* data = GetFrameData(frame);
+    if (data == nullptr)
+      return false;
+
+    memcpy(buffer, data, static_cast<size_t>(frame.GetPackedSize()));
+    return true;
+  }
+
   if (m_file == nullptr)
     return false;
 
@@ -226,3 +351,14 @@ bool CXBTFReader::Load(const CXBTFFrame& frame, unsigned char* buffer) const
 
   return true;
 }
+
+const uint8_t* CXBTFReader::GetFrameData(const CXBTFFrame& frame) const
+{
+  if (m_data == nullptr)
+    return nullptr;
+
+  if (frame.GetOffset() > m_size || frame.GetPackedSize() > m_size - frame.GetOffset())
+    return nullptr;
+
+  return m_data + frame.GetOffset();
+}
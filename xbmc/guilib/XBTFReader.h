@@ -33,17 +33,43 @@ public:
   CXBTFReader();
   ~CXBTFReader() override;
 
-  bool Open(const std::string& path);
+  /*!
+   \brief Opens a bundle and reads its index.
+   Bundles that can't be written to are memory mapped. Writable ones might be
+   rewritten in place by an add-on update while open, so their frames are read
+   with fread unless mapping is forced.
+   \param path path of the bundle
+   \param alwaysMap map the bundle even if it is writable
+   */
+  bool Open(const std::string& path, bool alwaysMap = false);
   bool IsOpen() const;
+  bool IsMapped() const { return m_data != nullptr; }
   void Close();
 
   time_t GetLastModificationTimestamp() const;
 
   bool Load(const CXBTFFrame& frame, unsigned char* buffer) const;
 
+  /*!
+   \brief Returns the frame's data as stored in the bundle without copying it.
+   The data stays valid until the reader is closed.
+   \return pointer into the mapped bundle or nullptr if the bundle isn't mapped
+           or the frame lies outside of it, use Load() then
+   */
+  const uint8_t* GetFrameData(const CXBTFFrame& frame) const;
+
 private:
+  bool IsWritable() const;
+  bool Map();
+  void Unmap();
+
   std::string m_path;
   FILE* m_file;
+  const uint8_t* m_data;
+  uint64_t m_size;
+#ifdef TARGET_WINDOWS
+  void* m_mapping;
+#endif
 };
 
 typedef std::shared_ptr<CXBTFReader> CXBTFReaderPtr;
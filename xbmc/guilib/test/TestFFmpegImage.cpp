@@ -0,0 +1,182 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "guilib/FFmpegImage.h"
+
+#include <stdint.h>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+class TestFFmpegImageHelper
+{
+public:
+  static bool GetJpegSize(const std::vector<uint8_t>& data, unsigned int& width, unsigned int& height)
+  {
+    return CFFmpegImage::GetJpegSize(data.data(), data.size(), width, height);
+  }
+
+  static int GetJpegScale(unsigned int jpegWidth, unsigned int jpegHeight, unsigned int width, unsigned int height, int maxScale)
+  {
+    return CFFmpegImage::GetJpegScale(jpegWidth, jpegHeight, width, height, maxScale);
+  }
+};
+
+namespace
+{
+void AppendSegment(std::vector<uint8_t>& data, uint8_t marker, const std::vector<uint8_t>& payload)
+{
+  data.push_back(0xFF);
+  data.push_back(marker);
+  data.push_back(static_cast<uint8_t>((payload.size() + 2) >> 8));
+  data.push_back(static_cast<uint8_t>(payload.size() + 2));
+  data.insert(data.end(), payload.begin(), payload.end());
+}
+
+// start of image, a JFIF header, a huffman table and the frame header of a width x height image
+std::vector<uint8_t> CreateJpegHeader(uint8_t frameMarker, unsigned int width, unsigned int height)
+{
+  std::vector<uint8_t> data = { 0xFF, 0xD8 };
+  AppendSegment(data, 0xE0, { 'J', 'F', 'I', 'F', 0, 1, 1, 0, 0, 1, 0, 1, 0, 0 });
+  AppendSegment(data, 0xC4, std::vector<uint8_t>(20, 0));
+  AppendSegment(data, frameMarker, { 8,
+                                     static_cast<uint8_t>(height >> 8), static_cast<uint8_t>(height),
+                                     static_cast<uint8_t>(width >> 8), static_cast<uint8_t>(width),
+                                     3, 1, 0x22, 0, 2, 0x11, 1, 3, 0x11, 1 });
+  return data;
+}
+
+// whether a decoded size still covers the size the image is shown at within width x height
+bool Covers(uint64_t jpegWidth, uint64_t jpegHeight, uint64_t width, uint64_t height, uint64_t decodedWidth, uint64_t decodedHeight)
+{
+  bool coversWidth = decodedWidth >= width || decodedWidth * jpegHeight >= jpegWidth * height || decodedWidth >= jpegWidth;
+  bool coversHeight = decodedHeight >= height || decodedHeight * jpegWidth >= jpegHeight * width || decodedHeight >= jpegHeight;
+  return coversWidth && coversHeight;
+}
+}
+
+TEST(TestFFmpegImage, GetJpegSize)
+{
+  unsigned int width = 0, height = 0;
+  EXPECT_TRUE(TestFFmpegImageHelper::GetJpegSize(CreateJpegHeader(0xC0, 4000, 3000), width, height));
+  EXPECT_EQ(4000U, width);
+  EXPECT_EQ(3000U, height);
+
+  // progressive
+  EXPECT_TRUE(TestFFmpegImageHelper::GetJpegSize(CreateJpegHeader(0xC2, 641, 479), width, height));
+  EXPECT_EQ(641U, width);
+  EXPECT_EQ(479U, height);
+
+  // fill bytes between segments
+  std::vector<uint8_t> data = CreateJpegHeader(0xC0, 1920, 1080);
+  data.insert(data.begin() + 2, { 0xFF, 0xFF });
+  EXPECT_TRUE(TestFFmpegImageHelper::GetJpegSize(data, width, height));
+  EXPECT_EQ(1920U, width);
+  EXPECT_EQ(1080U, height);
+}
+
+TEST(TestFFmpegImage, GetJpegSizeTruncated)
+{
+  unsigned int width = 0, height = 0;
+  std::vector<uint8_t> data = CreateJpegHeader(0xC0, 4000, 3000);
+
+  // cut off within the frame header, before the size is complete
+  std::vector<uint8_t> truncated(data.begin(), data.end() - 12);
+  EXPECT_FALSE(TestFFmpegImageHelper::GetJpegSize(truncated, width, height));
+
+  // cut off within the JFIF header, the frame header is out of reach
+  truncated.assign(data.begin(), data.begin() + 10);
+  EXPECT_FALSE(TestFFmpegImageHelper::GetJpegSize(truncated, width, height));
+
+  truncated.assign(data.begin(), data.begin() + 2);
+  EXPECT_FALSE(TestFFmpegImageHelper::GetJpegSize(truncated, width, height));
+  EXPECT_FALSE(TestFFmpegImageHelper::GetJpegSize(std::vector<uint8_t>(), width, height));
+
+  // a segment claiming more than there is
+  truncated.assign({ 0xFF, 0xD8 });
+  AppendSegment(truncated, 0xE0, std::vector<uint8_t>(14, 0));
+  truncated[5] = 0xFF;
+  truncated.insert(truncated.end(), data.end() - 19, data.end());
+  EXPECT_FALSE(TestFFmpegImageHelper::GetJpegSize(truncated, width, height));
+
+  // no frame header before the image data
+  truncated.assign({ 0xFF, 0xD8 });
+  AppendSegment(truncated, 0xDA, std::vector<uint8_t>(10, 0));
+  truncated.insert(truncated.end(), data.end() - 19, data.end());
+  EXPECT_FALSE(TestFFmpegImageHelper::GetJpegSize(truncated, width, height));
+
+  // a frame header of an empty image
+  EXPECT_FALSE(TestFFmpegImageHelper::GetJpegSize(CreateJpegHeader(0xC0, 0, 3000), width, height));
+}
+
+TEST(TestFFmpegImage, GetJpegSizeNotJpeg)
+{
+  unsigned int width = 0, height = 0;
+  std::vector<uint8_t> png = { 0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A, 0, 0, 0, 0x0D, 'I', 'H', 'D', 'R',
+                               0, 0, 0x0F, 0xA0, 0, 0, 0x0B, 0xB8, 8, 2, 0, 0, 0 };
+  EXPECT_FALSE(TestFFmpegImageHelper::GetJpegSize(png, width, height));
+
+  // a valid frame header without the start of image marker
+  std::vector<uint8_t> data = CreateJpegHeader(0xC0, 4000, 3000);
+  data[1] = 0x00;
+  EXPECT_FALSE(TestFFmpegImageHelper::GetJpegSize(data, width, height));
+
+  // garbage instead of a marker
+  data = CreateJpegHeader(0xC0, 4000, 3000);
+  data[2] = 0x00;
+  EXPECT_FALSE(TestFFmpegImageHelper::GetJpegSize(data, width, height));
+}
+
+TEST(TestFFmpegImage, GetJpegScale)
+{
+  EXPECT_EQ(3, TestFFmpegImageHelper::GetJpegScale(4000, 3000, 500, 500, 3));
+  EXPECT_EQ(2, TestFFmpegImageHelper::GetJpegScale(4000, 3000, 501, 501, 3));
+  EXPECT_EQ(0, TestFFmpegImageHelper::GetJpegScale(1920, 1080, 1920, 1080, 3));
+  // larger than the image
+  EXPECT_EQ(0, TestFFmpegImageHelper::GetJpegScale(800, 600, 1920, 1080, 3));
+  // limited by the decoder
+  EXPECT_EQ(1, TestFFmpegImageHelper::GetJpegScale(4000, 3000, 100, 100, 1));
+  EXPECT_EQ(0, TestFFmpegImageHelper::GetJpegScale(4000, 3000, 100, 100, 0));
+}
+
+TEST(TestFFmpegImage, GetJpegScaleNeverBelowRequested)
+{
+  static const unsigned int sizes[][2] = { { 4000, 3000 }, { 3000, 4000 }, { 5184, 3456 },
+                                           { 1920, 1080 }, { 1023, 767 }, { 641, 479 }, { 7, 5 } };
+
+  for (const auto& size : sizes)
+  {
+    for (unsigned int width = 1; width <= 2100; width += 13)
+    {
+      for (unsigned int height = 1; height <= 2100; height += 17)
+      {
+        int scale = TestFFmpegImageHelper::GetJpegScale(size[0], size[1], width, height, 3);
+        ASSERT_GE(scale, 0);
+        ASSERT_LE(scale, 3);
+        EXPECT_TRUE(Covers(size[0], size[1], width, height, size[0] >> scale, size[1] >> scale))
+          << size[0] << "x" << size[1] << " at " << width << "x" << height << " scaled by " << scale;
+        // and doesn't decode larger than needed either
+        if (scale < 3)
+          EXPECT_FALSE(Covers(size[0], size[1], width, height, size[0] >> (scale + 1), size[1] >> (scale + 1)))
+            << size[0] << "x" << size[1] << " at " << width << "x" << height << " scaled by " << scale;
+      }
+    }
+  }
+}
@@ -0,0 +1,182 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "addons/AddonEvents.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "guilib/TextureManager.h"
+#include "utils/Stopwatch.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+
+#include "gtest/gtest.h"
+
+namespace
+{
+class CTestTextureManager : public CGUITextureManager
+{
+public:
+  // a texture map without frames, so nothing has to be decoded or uploaded
+  void AddTexture(const std::string &name)
+  {
+    m_textures.insert(std::make_pair(name, new CTextureMap(name, 1, 1, 0)));
+  }
+
+  size_t GetUnusedCount() const { return m_unusedTextures.size(); }
+};
+}
+
+class TestTextureManager : public testing::Test
+{
+protected:
+  TestTextureManager()
+  {
+    m_skinPath = URIUtils::AddFileToFolder(CSpecialProtocol::TranslatePath("special://temp/"), "TestTextureManager");
+    XFILE::CDirectory::Create(URIUtils::AddFileToFolder(m_skinPath, "media"));
+  }
+
+  ~TestTextureManager() override
+  {
+    XFILE::CDirectory::RemoveRecursive(m_skinPath);
+  }
+
+  std::vector<std::string> CreateMedia(unsigned int count)
+  {
+    std::vector<std::string> names;
+    for (unsigned int i = 0; i < count; i++)
+    {
+      std::string name = StringUtils::Format("texture%u.png", i);
+      XFILE::CFile file;
+      if (file.OpenForWrite(URIUtils::AddFileToFolder(m_skinPath, "media", name), true))
+        file.Close();
+      names.push_back(name);
+    }
+    return names;
+  }
+
+  // loads and releases every texture the way a window does when it's opened and closed
+  static void OpenWindow(CTestTextureManager &manager, const std::vector<std::string> &names)
+  {
+    for (std::vector<std::string>::const_iterator it = names.begin(); it != names.end(); ++it)
+      manager.Load(*it);
+    for (std::vector<std::string>::const_iterator it = names.begin(); it != names.end(); ++it)
+      manager.ReleaseTexture(*it);
+  }
+
+  std::string m_skinPath;
+};
+
+TEST_F(TestTextureManager, ReuseReleasedTexture)
+{
+  std::vector<std::string> names = CreateMedia(2);
+  CTestTextureManager manager;
+  manager.SetTexturePath(m_skinPath);
+  manager.AddTexture(names[0]);
+  manager.AddTexture(names[1]);
+
+  const CTextureArray *texture = &manager.Load(names[0]);
+  manager.ReleaseTexture(names[0]);
+  manager.ReleaseTexture(names[1], true);
+  EXPECT_EQ(2U, manager.GetUnusedCount());
+
+  // only textures released with a delay are picked up again
+  EXPECT_EQ(texture, &manager.Load(names[0]));
+  EXPECT_EQ(1U, manager.GetUnusedCount());
+
+  manager.FreeUnusedTextures(60000);
+  EXPECT_EQ(0U, manager.GetUnusedCount());
+  manager.ReleaseTexture(names[0]);
+  manager.FreeUnusedTextures();
+  EXPECT_EQ(0U, manager.GetUnusedCount());
+}
+
+TEST_F(TestTextureManager, GetTexturePath)
+{
+  std::vector<std::string> names = CreateMedia(1);
+  CTestTextureManager manager;
+  manager.SetTexturePath("special://temp/missing");
+  EXPECT_TRUE(manager.GetTexturePath(names[0]).empty());
+
+  // found files depend on the paths currently searched
+  manager.AddTexturePath(m_skinPath);
+  EXPECT_EQ(URIUtils::AddFileToFolder(m_skinPath, "media", names[0]), manager.GetTexturePath(names[0]));
+  manager.RemoveTexturePath(m_skinPath);
+  EXPECT_TRUE(manager.GetTexturePath(names[0]).empty());
+}
+
+TEST_F(TestTextureManager, GetTexturePathWindowPath)
+{
+  std::vector<std::string> names = CreateMedia(1);
+  CTestTextureManager manager;
+  manager.SetTexturePath(m_skinPath);
+  EXPECT_EQ(URIUtils::AddFileToFolder(m_skinPath, "media", names[0]), manager.GetTexturePath(names[0]));
+
+  // a window adding and removing its own path doesn't forget media found in the skin
+  XFILE::CFile::Delete(URIUtils::AddFileToFolder(m_skinPath, "media", names[0]));
+  manager.AddTexturePath("special://temp/missing");
+  manager.RemoveTexturePath("special://temp/missing");
+  EXPECT_EQ(URIUtils::AddFileToFolder(m_skinPath, "media", names[0]), manager.GetTexturePath(names[0]));
+}
+
+TEST_F(TestTextureManager, GetTexturePathAddedMedia)
+{
+  CTestTextureManager manager;
+  manager.SetTexturePath(m_skinPath);
+  EXPECT_TRUE(manager.GetTexturePath("texture0.png").empty());
+
+  // missing media isn't remembered, an add-on update may add it
+  std::vector<std::string> names = CreateMedia(1);
+  EXPECT_EQ(URIUtils::AddFileToFolder(m_skinPath, "media", names[0]), manager.GetTexturePath(names[0]));
+
+  // found media is remembered until add-ons change
+  XFILE::CFile::Delete(URIUtils::AddFileToFolder(m_skinPath, "media", names[0]));
+  EXPECT_FALSE(manager.GetTexturePath(names[0]).empty());
+  manager.OnAddonEvent(ADDON::AddonEvents::UnInstalled("skin.test"));
+  EXPECT_TRUE(manager.GetTexturePath(names[0]).empty());
+}
+
+TEST_F(TestTextureManager, OpenWindowBenchmark)
+{
+  const unsigned int sizes[] = { 500, 4000 };
+  std::vector<std::string> names = CreateMedia(sizes[1]);
+
+  for (unsigned int size : sizes)
+  {
+    CTestTextureManager manager;
+    manager.SetTexturePath(m_skinPath);
+    for (unsigned int i = 0; i < size; i++)
+      manager.AddTexture(names[i]);
+
+    // a window using a fixed number of textures while the skin has more and more of them loaded
+    std::vector<std::string> window(names.begin(), names.begin() + 200);
+    OpenWindow(manager, window);
+
+    CStopWatch watch;
+    watch.StartZero();
+    for (int i = 0; i < 10; i++)
+      OpenWindow(manager, window);
+    RecordProperty(StringUtils::Format("OpenWindowMs%u", size), (int)(watch.GetElapsedMilliseconds()));
+
+    EXPECT_EQ(window.size(), manager.GetUnusedCount());
+    manager.FreeUnusedTextures();
+    manager.Flush();
+  }
+}
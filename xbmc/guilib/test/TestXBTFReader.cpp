@@ -0,0 +1,158 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/SpecialProtocol.h"
+#include "guilib/XBTFReader.h"
+#include "utils/URIUtils.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "gtest/gtest.h"
+
+namespace
+{
+void AppendUInt32(std::vector<uint8_t>& data, uint32_t value)
+{
+  for (int i = 0; i < 4; i++)
+    data.push_back(static_cast<uint8_t>(value >> (i * 8)));
+}
+
+void AppendUInt64(std::vector<uint8_t>& data, uint64_t value)
+{
+  for (int i = 0; i < 8; i++)
+    data.push_back(static_cast<uint8_t>(value >> (i * 8)));
+}
+
+// a bundle with a single uncompressed frame stored at the given offset
+std::vector<uint8_t> CreateBundle(const std::string& name, uint64_t offset, const std::vector<uint8_t>& pixels)
+{
+  std::vector<uint8_t> data;
+  data.insert(data.end(), XBTF_MAGIC.begin(), XBTF_MAGIC.end());
+  data.insert(data.end(), XBTF_VERSION.begin(), XBTF_VERSION.end());
+  AppendUInt32(data, 1);
+
+  char path[CXBTFFile::MaximumPathLength] = {};
+  strncpy(path, name.c_str(), sizeof(path) - 1);
+  data.insert(data.end(), path, path + sizeof(path));
+  AppendUInt32(data, 0); // loop
+  AppendUInt32(data, 1); // frames
+
+  AppendUInt32(data, 2); // width
+  AppendUInt32(data, 1); // height
+  AppendUInt32(data, XB_FMT_A8R8G8B8);
+  AppendUInt64(data, pixels.size()); // packed size
+  AppendUInt64(data, pixels.size()); // unpacked size
+  AppendUInt32(data, 0); // duration
+  AppendUInt64(data, offset);
+
+  data.resize(static_cast<size_t>(offset), 0);
+  data.insert(data.end(), pixels.begin(), pixels.end());
+  return data;
+}
+}
+
+class TestXBTFReader : public testing::Test
+{
+protected:
+  TestXBTFReader()
+  {
+    m_path = URIUtils::AddFileToFolder(CSpecialProtocol::TranslatePath("special://temp/"), "TestXBTFReader.xbt");
+  }
+
+  ~TestXBTFReader() override
+  {
+    remove(m_path.c_str());
+  }
+
+  void Write(const std::vector<uint8_t>& data)
+  {
+    FILE* file = fopen(m_path.c_str(), "wb");
+    ASSERT_TRUE(file != nullptr);
+    fwrite(data.data(), 1, data.size(), file);
+    fclose(file);
+  }
+
+  std::string m_path;
+};
+
+TEST_F(TestXBTFReader, PageAlignedFrame)
+{
+  std::vector<uint8_t> pixels(8);
+  for (size_t i = 0; i < pixels.size(); i++)
+    pixels[i] = static_cast<uint8_t>(i + 1);
+  Write(CreateBundle("media/test.png", 4096, pixels));
+
+  CXBTFReader reader;
+  ASSERT_TRUE(reader.Open(m_path, true));
+  ASSERT_TRUE(reader.IsMapped());
+  EXPECT_TRUE(reader.Exists("media/test.png"));
+  EXPECT_FALSE(reader.Exists("media/other.png"));
+
+  CXBTFFile file;
+  ASSERT_TRUE(reader.Get("media/test.png", file));
+  ASSERT_EQ(1U, file.GetFrames().size());
+
+  const CXBTFFrame& frame = file.GetFrames()[0];
+  EXPECT_EQ(4096U, frame.GetOffset());
+  const uint8_t* data = reader.GetFrameData(frame);
+  ASSERT_TRUE(data != nullptr);
+  EXPECT_EQ(0, memcmp(pixels.data(), data, pixels.size()));
+
+  std::vector<uint8_t> buffer(pixels.size());
+  EXPECT_TRUE(reader.Load(frame, buffer.data()));
+  EXPECT_EQ(pixels, buffer);
+}
+
+TEST_F(TestXBTFReader, TruncatedFrame)
+{
+  std::vector<uint8_t> data = CreateBundle("test.png", 1024, std::vector<uint8_t>(16, 0xff));
+  data.resize(data.size() - 1);
+  Write(data);
+
+  CXBTFReader reader;
+  ASSERT_TRUE(reader.Open(m_path, true));
+
+  CXBTFFile file;
+  ASSERT_TRUE(reader.Get("test.png", file));
+  EXPECT_TRUE(reader.GetFrameData(file.GetFrames()[0]) == nullptr);
+
+  std::vector<uint8_t> buffer(16);
+  EXPECT_FALSE(reader.Load(file.GetFrames()[0], buffer.data()));
+}
+
+TEST_F(TestXBTFReader, WritableBundle)
+{
+  std::vector<uint8_t> pixels(8, 0x7f);
+  Write(CreateBundle("media/test.png", 1024, pixels));
+
+  // the bundle might be rewritten while open, so it's read instead of mapped
+  CXBTFReader reader;
+  ASSERT_TRUE(reader.Open(m_path));
+  EXPECT_FALSE(reader.IsMapped());
+
+  CXBTFFile file;
+  ASSERT_TRUE(reader.Get("media/test.png", file));
+  EXPECT_TRUE(reader.GetFrameData(file.GetFrames()[0]) == nullptr);
+
+  std::vector<uint8_t> buffer(pixels.size());
+  EXPECT_TRUE(reader.Load(file.GetFrames()[0], buffer.data()));
+  EXPECT_EQ(pixels, buffer);
+}
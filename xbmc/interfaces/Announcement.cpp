@@ -0,0 +1,70 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "Announcement.h"
+#include "threads/SingleLock.h"
+#include "utils/JSONVariantWriter.h"
+
+using namespace ANNOUNCEMENT;
+
+CAnnouncement::CAnnouncement(AnnouncementFlag flag, const std::string &sender, const std::string &message, const CVariant &data)
+  : m_flag(flag),
+    m_sender(sender),
+    m_message(message),
+    m_data(data),
+    m_hasJSONRPC{ false, false },
+    m_hasJSONData{ false, false }
+{ }
+
+const std::string& CAnnouncement::GetJSONRPC(bool compact) const
+{
+  CSingleLock lock(m_critSection);
+  if (!m_hasJSONRPC[compact])
+  {
+    CVariant root;
+    root["jsonrpc"] = "2.0";
+    root["method"] = std::string(AnnouncementFlagToString(m_flag)) + "." + m_message;
+    root["params"]["data"] = m_data;
+    root["params"]["sender"] = m_sender;
+
+    CJSONVariantWriter::Write(root, m_jsonrpc[compact], compact);
+    m_hasJSONRPC[compact] = true;
+  }
+
+  return m_jsonrpc[compact];
+}
+
+const std::string& CAnnouncement::GetJSONData(bool compact) const
+{
+  CSingleLock lock(m_critSection);
+  if (!m_hasJSONData[compact])
+  {
+    if (!CJSONVariantWriter::Write(m_data, m_jsonData[compact], compact))
+      m_jsonData[compact].clear();
+    m_hasJSONData[compact] = true;
+  }
+
+  return m_jsonData[compact];
+}
+
+void IAnnouncer::OnAnnouncement(const CAnnouncement &announcement)
+{
+  Announce(announcement.GetFlag(), announcement.GetSender().c_str(), announcement.GetMessage().c_str(), announcement.GetData());
+}
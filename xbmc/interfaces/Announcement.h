@@ -0,0 +1,73 @@
+#pragma once
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string>
+
+#include "IAnnouncer.h"
+#include "threads/CriticalSection.h"
+#include "utils/Variant.h"
+
+namespace ANNOUNCEMENT
+{
+  /*!
+   \brief An immutable announcement shared by all announcers.
+
+   The JSON representations are only generated when an announcer first
+   asks for them and are then reused by every other announcer, so an event
+   is serialized once no matter how many transports or clients receive it.
+   */
+  class CAnnouncement
+  {
+  public:
+    CAnnouncement(AnnouncementFlag flag, const std::string &sender, const std::string &message, const CVariant &data);
+
+    AnnouncementFlag GetFlag() const { return m_flag; }
+    const std::string& GetSender() const { return m_sender; }
+    const std::string& GetMessage() const { return m_message; }
+    const CVariant& GetData() const { return m_data; }
+
+    /*!
+     \brief Returns the announcement as a JSON-RPC notification
+     \param compact Whether to use compact or pretty printed JSON
+     */
+    const std::string& GetJSONRPC(bool compact) const;
+    /*!
+     \brief Returns the announcement data serialized as JSON
+     \param compact Whether to use compact or pretty printed JSON
+     */
+    const std::string& GetJSONData(bool compact) const;
+
+  private:
+    CAnnouncement(const CAnnouncement&) = delete;
+    CAnnouncement& operator=(const CAnnouncement&) = delete;
+
+    const AnnouncementFlag m_flag;
+    const std::string m_sender;
+    const std::string m_message;
+    const CVariant m_data;
+
+    mutable CCriticalSection m_critSection;
+    mutable std::string m_jsonrpc[2];
+    mutable std::string m_jsonData[2];
+    mutable bool m_hasJSONRPC[2];
+    mutable bool m_hasJSONData[2];
+  };
+}
@@ -19,6 +19,7 @@
  */
 
 #include "AnnouncementManager.h"
+#include "Announcement.h"
 #include "threads/SingleLock.h"
 #include <stdio.h>
 #include "utils/log.h"
@@ -31,9 +32,18 @@
 #include "pvr/channels/PVRChannel.h"
 #include "PlayListPlayer.h"
 #include "ServiceBroker.h"
+#include "settings/AdvancedSettings.h"
+#include "utils/JobManager.h"
 
 #define LOOKUP_PROPERTY "database-lookup"
 
+// announcements that describe a state, so an identical newer one makes an older one redundant
+#define ANNOUNCE_COALESCE (VideoLibrary | AudioLibrary | Player)
+// how many of the most recently queued announcements are checked for duplicates
+#define COALESCE_DEPTH 64
+// number of database lookups remembered before the cache is reset
+#define LOOKUP_CACHE_SIZE 64
+
 using namespace ANNOUNCEMENT;
 
 CAnnouncementManager::CAnnouncementManager() : CThread("Announce")
@@ -60,6 +70,20 @@ void CAnnouncementManager::Deinitialize()
   m_bStop = true;
   m_queueEvent.Set();
   StopThread();
+  {
+    CSingleLock lock (m_queueSection);
+    m_announcementQueue.clear();
+  }
+
+  // the lookup jobs refer to this manager
+  CSingleLock lookupLock (m_lookupSection);
+  while (m_lookupsRunning > 0)
+  {
+    CSingleExit ex(m_lookupSection);
+    m_lookupsFinished.Wait();
+  }
+  lookupLock.Leave();
+
   CSingleLock lock (m_critSection);
   m_announcers.clear();
 }
@@ -117,30 +141,235 @@ void CAnnouncementManager::Announce(AnnouncementFlag flag, const char *sender, c
   if (item != nullptr)
     announcement.item = CFileItemPtr(new CFileItem(*item));
 
+  InvalidateLookups(flag, announcement.message);
+  if (NeedsLookup(announcement.item))
+    announcement.lookupDone = StartLookup(announcement.item);
+
+  // give identical announcements following in a burst the chance to be merged into this one
+  announcement.due.Set((flag & ANNOUNCE_COALESCE) ? g_advancedSettings.m_announcementWindow : 0);
+
   {
-    CSingleLock lock (m_critSection);
-    m_announcementQueue.push_back(announcement);
+    CSingleLock lock (m_queueSection);
+    if (Coalesce(announcement))
+    {
+      CLog::Log(LOGDEBUG, "CAnnouncementManager - Coalesced announcement: %s from %s", message, sender);
+      return;
+    }
+    m_announcementQueue.push_back(std::move(announcement));
   }
   m_queueEvent.Set();
 }
 
-void CAnnouncementManager::DoAnnounce(AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data)
+bool CAnnouncementManager::Coalesce(const CAnnounceData &announcement)
+{
+  if ((announcement.flag & ANNOUNCE_COALESCE) == 0)
+    return false;
+
+  if (announcement.item != nullptr && announcement.item->GetPath().empty())
+    return false;
+
+  unsigned int depth = 0;
+  for (auto it = m_announcementQueue.rbegin(); it != m_announcementQueue.rend() && depth < COALESCE_DEPTH; ++it, ++depth)
+  {
+    if (it->flag != announcement.flag || it->message != announcement.message || it->sender != announcement.sender)
+      continue;
+
+    if ((it->item == nullptr) != (announcement.item == nullptr))
+      continue;
+    if (it->item != nullptr &&
+       (it->item->GetPath() != announcement.item->GetPath() || it->item->m_lStartOffset != announcement.item->m_lStartOffset))
+      continue;
+
+    if (it->data != announcement.data)
+      continue;
+
+    // the queued one keeps its position and due time, so neither the order of
+    // announcements nor a steady stream of duplicates can hold it back
+    return true;
+  }
+
+  return false;
+}
+
+void CAnnouncementManager::DoAnnounce(const CAnnouncement &announcement)
 {
-  CLog::Log(LOGDEBUG, "CAnnouncementManager - Announcement: %s from %s", message, sender);
+  CLog::Log(LOGDEBUG, "CAnnouncementManager - Announcement: %s from %s", announcement.GetMessage().c_str(), announcement.GetSender().c_str());
 
+  // only announcers are guarded here, so a slow announcer doesn't block anyone queueing announcements
   CSingleLock lock (m_critSection);
 
   // Make a copy of announcers. They may be removed or even remove themselves during execution of IAnnouncer::Announce()!
   std::vector<IAnnouncer *> announcers(m_announcers);
   for (unsigned int i = 0; i < announcers.size(); i++)
-    announcers[i]->Announce(flag, sender, message, data);
+    announcers[i]->OnAnnouncement(announcement);
+}
+
+bool CAnnouncementManager::NeedsLookup(const CFileItemPtr &item)
+{
+  //! @todo Can be removed once this is properly handled when starting playback of a file
+  if (item == nullptr || item->GetPath().empty() || item->HasPVRChannelInfoTag() ||
+     (item->HasProperty(LOOKUP_PROPERTY) && !item->GetProperty(LOOKUP_PROPERTY).asBoolean()))
+    return false;
+
+  if (item->HasVideoInfoTag() && !item->HasPVRRecordingInfoTag())
+    return item->GetVideoInfoTag()->m_iDbId <= 0;
+  if (item->HasVideoInfoTag())
+    return false;
+  if (item->HasMusicInfoTag())
+    return item->GetMusicInfoTag()->GetDatabaseId() <= 0;
+
+  return false;
+}
+
+std::shared_ptr<CEvent> CAnnouncementManager::StartLookup(const CFileItemPtr &item)
+{
+  std::shared_ptr<CEvent> done = std::make_shared<CEvent>(true);
+  {
+    CSingleLock lock(m_lookupSection);
+    if (m_bStop)
+      return nullptr;
+    m_lookupsRunning++;
+  }
+
+  // the item is a copy owned by the announcement, nothing else touches it until done is set
+  CJobManager::GetInstance().Submit([this, item, done]()
+  {
+    if (item->HasVideoInfoTag())
+      LookupVideo(item);
+    else
+      LookupSong(item);
+    done->Set();
+
+    CSingleLock lock(m_lookupSection);
+    if (--m_lookupsRunning == 0)
+      m_lookupsFinished.Set();
+  });
+
+  return done;
+}
+
+bool CAnnouncementManager::LookupVideo(const CFileItemPtr &item)
+{
+  std::string path = item->GetPath();
+  std::string videoInfoTagPath(item->GetVideoInfoTag()->m_strFileNameAndPath);
+  if (StringUtils::StartsWith(videoInfoTagPath, "removable://"))
+    path = videoInfoTagPath;
+
+  unsigned int version;
+  {
+    CSingleLock lock(m_lookupSection);
+    LookupCache::const_iterator it = m_videoLookups.find(path);
+    if (it != m_videoLookups.end())
+    {
+      if (it->second.id > 0)
+      {
+        item->GetVideoInfoTag()->m_iDbId = it->second.id;
+        item->GetVideoInfoTag()->m_type = it->second.type;
+      }
+      return it->second.id > 0;
+    }
+    version = m_videoLookupsVersion;
+  }
+
+  CVideoDatabase videodatabase;
+  if (!videodatabase.Open())
+    return false;
+
+  CLookupResult result = { -1, "" };
+  if (videodatabase.LoadVideoInfo(path, *item->GetVideoInfoTag(), VideoDbDetailsNone))
+  {
+    result.id = item->GetVideoInfoTag()->m_iDbId;
+    result.type = item->GetVideoInfoTag()->m_type;
+  }
+  videodatabase.Close();
+
+  CSingleLock lock(m_lookupSection);
+  if (version == m_videoLookupsVersion)
+  {
+    if (m_videoLookups.size() >= LOOKUP_CACHE_SIZE)
+      m_videoLookups.clear();
+    m_videoLookups.insert(std::make_pair(path, result));
+  }
+
+  return result.id > 0;
+}
+
+bool CAnnouncementManager::LookupSong(const CFileItemPtr &item)
+{
+  std::string key = item->GetPath() + "|" + std::to_string(item->m_lStartOffset);
+
+  unsigned int version;
+  {
+    CSingleLock lock(m_lookupSection);
+    LookupCache::const_iterator it = m_musicLookups.find(key);
+    if (it != m_musicLookups.end())
+    {
+      if (it->second.id > 0)
+        item->GetMusicInfoTag()->SetDatabaseId(it->second.id, it->second.type);
+      return it->second.id > 0;
+    }
+    version = m_musicLookupsVersion;
+  }
+
+  CMusicDatabase musicdatabase;
+  if (!musicdatabase.Open())
+    return false;
+
+  CLookupResult result = { -1, MediaTypeSong };
+  CSong song;
+  if (musicdatabase.GetSongByFileName(item->GetPath(), song, item->m_lStartOffset))
+  {
+    item->GetMusicInfoTag()->SetSong(song);
+    result.id = item->GetMusicInfoTag()->GetDatabaseId();
+  }
+  musicdatabase.Close();
+
+  CSingleLock lock(m_lookupSection);
+  if (version == m_musicLookupsVersion)
+  {
+    if (m_musicLookups.size() >= LOOKUP_CACHE_SIZE)
+      m_musicLookups.clear();
+    m_musicLookups.insert(std::make_pair(key, result));
+  }
+
+  return result.id > 0;
+}
+
+void CAnnouncementManager::InvalidateLookups(AnnouncementFlag flag, const std::string &message)
+{
+  if ((flag & (VideoLibrary | AudioLibrary)) == 0)
+    return;
+
+  bool all = message == "OnRemove" || message == "OnScanFinished" || message == "OnCleanFinished";
+
+  CSingleLock lock(m_lookupSection);
+  for (int i = 0; i < 2; i++)
+  {
+    LookupCache &lookups = i == 0 ? m_videoLookups : m_musicLookups;
+    if ((flag & (i == 0 ? VideoLibrary : AudioLibrary)) == 0)
+      continue;
+
+    if (all)
+      lookups.clear();
+    else
+    {
+      for (LookupCache::iterator it = lookups.begin(); it != lookups.end();)
+      {
+        if (it->second.id <= 0)
+          it = lookups.erase(it);
+        else
+          ++it;
+      }
+    }
+    (i == 0 ? m_videoLookupsVersion : m_musicLookupsVersion)++;
+  }
 }
 
 void CAnnouncementManager::DoAnnounce(AnnouncementFlag flag, const char *sender, const char *message, CFileItemPtr item, const CVariant &data)
 {
   if (item == nullptr)
   {
-    DoAnnounce(flag, sender, message, data);
+    DoAnnounce(CAnnouncement(flag, sender, message, data));
     return;
   }
 
@@ -163,26 +392,9 @@ void CAnnouncementManager::DoAnnounce(AnnouncementFlag flag, const char *sender,
   }
   else if (item->HasVideoInfoTag() && !item->HasPVRRecordingInfoTag())
   {
+    // looked up when the announcement was queued if missing
     id = item->GetVideoInfoTag()->m_iDbId;
 
-    //! @todo Can be removed once this is properly handled when starting playback of a file
-    if (id <= 0 && !item->GetPath().empty() &&
-       (!item->HasProperty(LOOKUP_PROPERTY) || item->GetProperty(LOOKUP_PROPERTY).asBoolean()))
-    {
-      CVideoDatabase videodatabase;
-      if (videodatabase.Open())
-      {
-        std::string path = item->GetPath();
-        std::string videoInfoTagPath(item->GetVideoInfoTag()->m_strFileNameAndPath);
-        if (StringUtils::StartsWith(videoInfoTagPath, "removable://"))
-          path = videoInfoTagPath;
-        if (videodatabase.LoadVideoInfo(path, *item->GetVideoInfoTag(), VideoDbDetailsNone))
-          id = item->GetVideoInfoTag()->m_iDbId;
-
-        videodatabase.Close();
-      }
-    }
-
     if (!item->GetVideoInfoTag()->m_type.empty())
       type = item->GetVideoInfoTag()->m_type;
     else
@@ -223,27 +435,10 @@ void CAnnouncementManager::DoAnnounce(AnnouncementFlag flag, const char *sender,
   }
   else if (item->HasMusicInfoTag())
   {
+    // looked up when the announcement was queued if missing
     id = item->GetMusicInfoTag()->GetDatabaseId();
     type = MediaTypeSong;
 
-    //! @todo Can be removed once this is properly handled when starting playback of a file
-    if (id <= 0 && !item->GetPath().empty() &&
-       (!item->HasProperty(LOOKUP_PROPERTY) || item->GetProperty(LOOKUP_PROPERTY).asBoolean()))
-    {
-      CMusicDatabase musicdatabase;
-      if (musicdatabase.Open())
-      {
-        CSong song;
-        if (musicdatabase.GetSongByFileName(item->GetPath(), song, item->m_lStartOffset))
-        {
-          item->GetMusicInfoTag()->SetSong(song);
-          id = item->GetMusicInfoTag()->GetDatabaseId();
-        }
-
-        musicdatabase.Close();
-      }
-    }
-
     if (id <= 0)
     {
       //! @todo Can be removed once this is properly handled when starting playback of a file
@@ -280,7 +475,7 @@ void CAnnouncementManager::DoAnnounce(AnnouncementFlag flag, const char *sender,
   if (id > 0)
     object["item"]["id"] = id;
 
-  DoAnnounce(flag, sender, message, object);
+  DoAnnounce(CAnnouncement(flag, sender, message, object));
 }
 
 void CAnnouncementManager::Process()
@@ -289,19 +484,33 @@ void CAnnouncementManager::Process()
 
   while (!m_bStop)
   {
-    CSingleLock lock (m_critSection);
+    CSingleLock lock (m_queueSection);
     if (!m_announcementQueue.empty())
     {
-      auto announcement = m_announcementQueue.front();
+      unsigned int wait = m_announcementQueue.front().due.MillisLeft();
+      if (wait > 0)
+      {
+        CSingleExit ex(m_queueSection);
+        m_queueEvent.WaitMSec(wait);
+        continue;
+      }
+
+      auto announcement = std::move(m_announcementQueue.front());
       m_announcementQueue.pop_front();
       {
-        CSingleExit ex(m_critSection);
+        CSingleExit ex(m_queueSection);
+        // announcements are sent in order, so wait for the lookup running since it was queued
+        if (announcement.lookupDone)
+        {
+          if (AbortableWait(*announcement.lookupDone) == WAIT_INTERRUPTED)
+            break;
+        }
         DoAnnounce(announcement.flag, announcement.sender.c_str(), announcement.message.c_str(), announcement.item, announcement.data);
       }
     }
     else
     {
-      CSingleExit ex(m_critSection);
+      CSingleExit ex(m_queueSection);
       m_queueEvent.Wait();
     }
   }
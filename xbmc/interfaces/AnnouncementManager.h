@@ -18,11 +18,15 @@
  *  <http://www.gnu.org/licenses/>.
  *
  */
+#include <list>
+#include <map>
+#include <memory>
 #include <vector>
 
 #include "IAnnouncer.h"
 #include "FileItem.h"
 #include "threads/CriticalSection.h"
+#include "threads/SystemClock.h"
 #include "threads/Thread.h"
 #include "threads/Event.h"
 #include "utils/Variant.h"
@@ -31,6 +35,8 @@ class CVariant;
 
 namespace ANNOUNCEMENT
 {
+  class CAnnouncement;
+
   class CAnnouncementManager : public CThread
   {
   public:
@@ -55,7 +61,7 @@ namespace ANNOUNCEMENT
   protected:
     void Process() override;
     void DoAnnounce(AnnouncementFlag flag, const char *sender, const char *message, CFileItemPtr item, const CVariant &data);
-    void DoAnnounce(AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data);
+    void DoAnnounce(const CAnnouncement &announcement);
 
     struct CAnnounceData
     {
@@ -64,7 +70,19 @@ namespace ANNOUNCEMENT
       std::string message;
       CFileItemPtr item;
       CVariant data;
+      XbmcThreads::EndTime due; //!< when the announcement may be sent at the earliest
+      std::shared_ptr<CEvent> lookupDone; //!< set once the database lookup of the item is done, empty if it needs none
     };
+
+    /*!
+     \brief Whether an announcement identical to the given one is still queued
+     Only announcements describing a state (library and player events) are
+     coalesced, the queued one is sent at its own position and the given one is dropped.
+     \param announcement the announcement about to be queued
+     \return true if the announcement is already queued, false otherwise
+     */
+    bool Coalesce(const CAnnounceData &announcement);
+
     std::list<CAnnounceData> m_announcementQueue;
     CEvent m_queueEvent;
 
@@ -72,7 +90,42 @@ namespace ANNOUNCEMENT
     CAnnouncementManager(const CAnnouncementManager&);
     CAnnouncementManager const& operator=(CAnnouncementManager const&);
 
+    struct CLookupResult
+    {
+      int id;
+      std::string type;
+    };
+    typedef std::map<std::string, CLookupResult> LookupCache;
+
+    /*!
+     \brief Whether the item lacks a database id the announcement has to look up
+     */
+    static bool NeedsLookup(const CFileItemPtr &item);
+    /*!
+     \brief Looks up the database id of the item in a job, sets the returned event when done
+     */
+    std::shared_ptr<CEvent> StartLookup(const CFileItemPtr &item);
+    bool LookupVideo(const CFileItemPtr &item);
+    bool LookupSong(const CFileItemPtr &item);
+    /*!
+     \brief Forgets lookups a library change may have made wrong
+     Misses are dropped on every change, as scanning adds items one by one. Found
+     items are only dropped once items were removed or a scan or clean finished.
+     */
+    void InvalidateLookups(AnnouncementFlag flag, const std::string &message);
+
     CCriticalSection m_critSection;
     std::vector<IAnnouncer *> m_announcers;
+
+    CCriticalSection m_queueSection;
+
+    // database lookups done for items without a db id, by jobs so they don't hold up the queue
+    CCriticalSection m_lookupSection;
+    LookupCache m_videoLookups;
+    LookupCache m_musicLookups;
+    unsigned int m_videoLookupsVersion = 0; //!< changed on invalidation, so running lookups don't store stale results
+    unsigned int m_musicLookupsVersion = 0;
+    unsigned int m_lookupsRunning = 0;
+    CEvent m_lookupsFinished;
   };
 }
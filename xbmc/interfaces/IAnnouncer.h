@@ -22,6 +22,8 @@
 class CVariant;
 namespace ANNOUNCEMENT
 {
+  class CAnnouncement;
+
   enum AnnouncementFlag
   {
     Player        = 0x001,
@@ -79,5 +81,11 @@ namespace ANNOUNCEMENT
     IAnnouncer() = default;
     virtual ~IAnnouncer() = default;
     virtual void Announce(AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data) = 0;
+    /*!
+     \brief Receives an announcement together with its shared serialized forms.
+     Announcers that send JSON should override this to reuse the serialization
+     done for the other announcers. By default it forwards to Announce().
+     */
+    virtual void OnAnnouncement(const CAnnouncement &announcement);
   };
 }
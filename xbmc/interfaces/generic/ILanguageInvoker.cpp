@@ -27,6 +27,7 @@
 ILanguageInvoker::ILanguageInvoker(ILanguageInvocationHandler *invocationHandler)
   : m_id(-1),
     m_state(InvokerStateUninitialized),
+    m_reuseInterpreter(false),
     m_invocationHandler(invocationHandler)
 { }
 
@@ -51,6 +51,12 @@ public:
   int GetId() const { return m_id; }
   const ADDON::AddonPtr& GetAddon() const { return m_addon; }
   void SetAddon(const ADDON::AddonPtr &addon) { m_addon = addon; }
+  /*!
+   * \brief Allows the script to run in an interpreter kept from an earlier run
+   * of the same add-on, if the language supports it.
+   */
+  void SetReuseInterpreter(bool reuseInterpreter) { m_reuseInterpreter = reuseInterpreter; }
+  bool GetReuseInterpreter() const { return m_reuseInterpreter; }
   InvokerState GetState() const { return m_state; }
   bool IsActive() const;
   bool IsRunning() const;
@@ -75,6 +81,7 @@ protected:
 private:
   int m_id;
   InvokerState m_state;
+  bool m_reuseInterpreter;
   ILanguageInvocationHandler *m_invocationHandler;
 };
 
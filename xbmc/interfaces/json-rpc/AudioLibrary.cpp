@@ -880,6 +880,19 @@ JSONRPC_STATUS CAudioLibrary::GetAdditionalArtistDetails(const CVariant &paramet
   return OK;
 }
 
+void CAudioLibrary::SetGenreIds(const std::map<int, std::vector<int> > &genres, int id, CFileItem &item)
+{
+  CVariant genreidObj(CVariant::VariantTypeArray);
+  std::map<int, std::vector<int> >::const_iterator itGenres = genres.find(id);
+  if (itGenres != genres.end())
+  {
+    for (std::vector<int>::const_iterator genreid = itGenres->second.begin(); genreid != itGenres->second.end(); ++genreid)
+      genreidObj.push_back(*genreid);
+  }
+
+  item.SetProperty("genreid", genreidObj);
+}
+
 JSONRPC_STATUS CAudioLibrary::GetAdditionalAlbumDetails(const CVariant &parameterObject, CFileItemList &items, CMusicDatabase &musicdatabase)
 {
   if (!musicdatabase.Open())
@@ -891,22 +904,19 @@ JSONRPC_STATUS CAudioLibrary::GetAdditionalAlbumDetails(const CVariant &paramete
   if (!CheckForAdditionalProperties(parameterObject["properties"], checkProperties, additionalProperties))
     return OK;
 
-  for (int i = 0; i < items.Size(); i++)
+  if (additionalProperties.find("genreid") != additionalProperties.end())
   {
-    CFileItemPtr item = items[i];
-    if (additionalProperties.find("genreid") != additionalProperties.end())
-    {
-      std::vector<int> genreids;
-      if (musicdatabase.GetGenresByAlbum(item->GetMusicInfoTag()->GetDatabaseId(), genreids))
-      {
-        CVariant genreidObj(CVariant::VariantTypeArray);
-        for (std::vector<int>::const_iterator genreid = genreids.begin(); genreid != genreids.end(); ++genreid)
-          genreidObj.push_back(*genreid);
+    // get the genres of all albums at once
+    std::set<int> albumids;
+    for (int i = 0; i < items.Size(); i++)
+      albumids.insert(items[i]->GetMusicInfoTag()->GetDatabaseId());
 
-        item->SetProperty("genreid", genreidObj);
-      }
+    std::map<int, std::vector<int> > genres;
+    if (musicdatabase.GetGenresByAlbums(albumids, genres))
+    {
+      for (int i = 0; i < items.Size(); i++)
+        SetGenreIds(genres, items[i]->GetMusicInfoTag()->GetDatabaseId(), *items[i]);
     }
- 
   }
 
   return OK;
@@ -929,21 +939,24 @@ JSONRPC_STATUS CAudioLibrary::GetAdditionalSongDetails(const CVariant &parameter
   if (!CheckForAdditionalProperties(parameterObject["properties"], checkProperties, additionalProperties))
     return OK;
 
-  for (int i = 0; i < items.Size(); i++)
+  if (additionalProperties.find("genreid") != additionalProperties.end())
   {
-    CFileItemPtr item = items[i];
-    if (additionalProperties.find("genreid") != additionalProperties.end())
-    {
-      std::vector<int> genreids;
-      if (musicdatabase.GetGenresBySong(item->GetMusicInfoTag()->GetDatabaseId(), genreids))
-      {
-        CVariant genreidObj(CVariant::VariantTypeArray);
-        for (std::vector<int>::const_iterator genreid = genreids.begin(); genreid != genreids.end(); ++genreid)
-          genreidObj.push_back(*genreid);
+    // get the genres of all songs at once
+    std::set<int> songids;
+    for (int i = 0; i < items.Size(); i++)
+      songids.insert(items[i]->GetMusicInfoTag()->GetDatabaseId());
 
-        item->SetProperty("genreid", genreidObj);
-      }
+    std::map<int, std::vector<int> > genres;
+    if (musicdatabase.GetGenresBySongs(songids, genres))
+    {
+      for (int i = 0; i < items.Size(); i++)
+        SetGenreIds(genres, items[i]->GetMusicInfoTag()->GetDatabaseId(), *items[i]);
     }
+  }
+
+  for (int i = 0; i < items.Size(); i++)
+  {
+    CFileItemPtr item = items[i];
     if (item->GetMusicInfoTag()->GetAlbumId() > 0)
     {
       if (additionalProperties.find("albumartist") != additionalProperties.end() ||
@@ -19,6 +19,7 @@
  *
  */
 
+#include <map>
 #include <set>
 #include <string>
 #include <vector>
@@ -68,6 +69,7 @@ namespace JSONRPC
   private:
     static void FillAlbumItem(const CAlbum &album, const std::string &path, CFileItemPtr &item);
     static void FillItemArtistIDs(const std::vector<int> artistids, CFileItemPtr &item);
+    static void SetGenreIds(const std::map<int, std::vector<int> > &genres, int id, CFileItem &item);
     
     static bool CheckForAdditionalProperties(const CVariant &properties, const std::set<std::string> &checkProperties, std::set<std::string> &foundProperties);
   };
@@ -193,7 +193,8 @@ void CFileItemHandler::FillDetails(const ISerializable *info, const CFileItemPtr
   CVariant serialization;
   info->Serialize(serialization);
 
-  bool fetchedArt = false;
+  // library lists may have loaded the art of all their items at once
+  bool fetchedArt = item->GetProperty("libraryartfilled").asBoolean();
 
   std::set<std::string> originalFields = fields;
 
@@ -18,6 +18,9 @@
  *
  */
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
 #include <string.h>
 
 #include "JSONRPC.h"
@@ -30,6 +33,8 @@
 #include "interfaces/AnnouncementManager.h"
 #include "playlists/SmartPlayList.h"
 #include "settings/AdvancedSettings.h"
+#include "threads/Event.h"
+#include "utils/JobManager.h"
 #include "utils/log.h"
 #include "utils/StringUtils.h"
 #include "utils/Variant.h"
@@ -254,15 +259,7 @@ std::string CJSONRPC::MethodCall(const std::string &inputString, ITransportLayer
       }
       else
       {
-        for (CVariant::const_iterator_array itr = inputroot.begin_array(); itr != inputroot.end_array(); itr++)
-        {
-          CVariant response;
-          if (HandleMethodCall(*itr, response, transport, client))
-          {
-            outputroot.append(response);
-            hasResponse = true;
-          }
-        }
+        hasResponse = HandleBatchCall(inputroot, outputroot, transport, client);
       }
     }
     else
@@ -282,6 +279,150 @@ std::string CJSONRPC::MethodCall(const std::string &inputString, ITransportLayer
   return str;
 }
 
+// maximum number of jobs helping with the read-only calls of one batch
+#define MAX_BATCH_JOBS 4
+
+/*!
+ \brief Consecutive read-only calls of a batch request.
+
+ The calls are claimed one by one by the thread handling the batch and by up
+ to MAX_BATCH_JOBS helper jobs. The batch thread only ever waits for calls
+ that have already been claimed, so it never depends on a helper job actually
+ getting scheduled.
+ */
+class CJSONRPC::CBatchCalls : public std::enable_shared_from_this<CJSONRPC::CBatchCalls>
+{
+public:
+  CBatchCalls(const CVariant &requests, unsigned int begin, unsigned int end, ITransportLayer *transport, IClient *client)
+    : m_requests(requests),
+      m_begin(begin),
+      m_end(end),
+      m_transport(transport),
+      m_client(client),
+      m_responses(end - begin),
+      m_hasResponse(end - begin, 0),
+      m_next(begin),
+      m_done(0)
+  { }
+
+  void Run()
+  {
+    const unsigned int jobs = std::min<unsigned int>(m_end - m_begin - 1, MAX_BATCH_JOBS);
+    for (unsigned int i = 0; i < jobs; i++)
+    {
+      CJob *job = new CBatchCallJob(shared_from_this());
+      if (CJobManager::GetInstance().AddJob(job, NULL, CJob::PRIORITY_HIGH) == 0)
+      {
+        delete job;
+        break;
+      }
+    }
+
+    while (RunNext())
+      ;
+    m_finished.Wait();
+  }
+
+  bool AppendResponses(CVariant &responses) const
+  {
+    bool hasResponse = false;
+    for (unsigned int i = 0; i < m_responses.size(); i++)
+    {
+      if (m_hasResponse[i])
+      {
+        responses.append(m_responses[i]);
+        hasResponse = true;
+      }
+    }
+    return hasResponse;
+  }
+
+private:
+  class CBatchCallJob : public CJob
+  {
+  public:
+    explicit CBatchCallJob(const std::shared_ptr<CBatchCalls> &calls) : m_calls(calls) { }
+    bool DoWork() override
+    {
+      while (m_calls->RunNext())
+        ;
+      return true;
+    }
+    const char *GetType() const override { return "jsonrpcbatch"; }
+  private:
+    std::shared_ptr<CBatchCalls> m_calls;
+  };
+
+  bool RunNext()
+  {
+    // a job starting after all calls have been claimed must not touch the
+    // requests anymore, they belong to the batch thread
+    const unsigned int index = m_next++;
+    if (index >= m_end)
+      return false;
+
+    const unsigned int slot = index - m_begin;
+    m_hasResponse[slot] = HandleMethodCall(m_requests[index], m_responses[slot], m_transport, m_client) ? 1 : 0;
+    if (++m_done == m_end - m_begin)
+      m_finished.Set();
+    return true;
+  }
+
+  const CVariant &m_requests;
+  const unsigned int m_begin;
+  const unsigned int m_end;
+  ITransportLayer *m_transport;
+  IClient *m_client;
+  std::vector<CVariant> m_responses;
+  std::vector<char> m_hasResponse;
+  std::atomic<unsigned int> m_next;
+  std::atomic<unsigned int> m_done;
+  CEvent m_finished;
+};
+
+bool CJSONRPC::HandleBatchCall(const CVariant& requests, CVariant& responses, ITransportLayer *transport, IClient *client)
+{
+  bool hasResponse = false;
+  const unsigned int size = requests.size();
+  unsigned int index = 0;
+  while (index < size)
+  {
+    unsigned int end = index;
+    while (end < size && IsReadOnlyCall(requests[end]))
+      end++;
+
+    if (end - index > 1)
+    {
+      std::shared_ptr<CBatchCalls> calls(new CBatchCalls(requests, index, end, transport, client));
+      calls->Run();
+      hasResponse |= calls->AppendResponses(responses);
+      index = end;
+    }
+    else
+    {
+      CVariant response;
+      if (HandleMethodCall(requests[index], response, transport, client))
+      {
+        responses.append(response);
+        hasResponse = true;
+      }
+      index++;
+    }
+  }
+
+  return hasResponse;
+}
+
+bool CJSONRPC::IsReadOnlyCall(const CVariant& request)
+{
+  if (!IsProperJSONRPC(request))
+    return false;
+
+  std::string methodName = request["method"].asString();
+  StringUtils::ToLower(methodName);
+  return CJSONServiceDescription::IsReadOnly(methodName);
+}
+
 bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client)
 {
   JSONRPC_STATUS errorCode = OK;
@@ -73,7 +73,21 @@ namespace JSONRPC
     static JSONRPC_STATUS NotifyAll(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
   
   private:
+    class CBatchCalls;
+
     static bool HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client);
+    /*!
+     \brief Handles the calls of a batch request
+     \param requests Array of requests of the batch
+     \param responses Array the responses are appended to, in request order
+     \return True if at least one call produced a response
+
+     Consecutive calls of read-only methods are handled concurrently on the
+     job system, every other call waits for all previous calls and is handled
+     on its own.
+     */
+    static bool HandleBatchCall(const CVariant& requests, CVariant& responses, ITransportLayer *transport, IClient *client);
+    static bool IsReadOnlyCall(const CVariant& request);
     static inline bool IsProperJSONRPC(const CVariant& inputroot);
 
     inline static void BuildResponse(const CVariant& request, JSONRPC_STATUS code, const CVariant& result, CVariant& response);
@@ -391,6 +391,16 @@ namespace JSONRPC
      */
     static JSONRPC_STATUS CheckCall(const char* method, const CVariant &requestParameters, ITransportLayer *transport, IClient *client, bool notification, MethodCall &methodCall, CVariant &outputParameters);
     
+    /*!
+     \brief Checks whether the given method only reads data
+     \param method Lower case name of the method
+     \return True if the method exists and needs no permission other than ReadData
+
+     Read-only methods don't change any state and may therefore be executed
+     concurrently with each other.
+     */
+    static bool IsReadOnly(const std::string &method);
+
     static JSONSchemaTypeDefinitionPtr GetType(const std::string &identification);
 
     static void Cleanup();
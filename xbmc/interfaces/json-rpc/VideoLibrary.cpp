@@ -1010,6 +1010,8 @@ int CVideoLibrary::RequiresAdditionalDetails(const MediaType& mediaType, const C
       details = details | VideoDbDetailsStream;
     else if (propertyValue == "tag")
       details = details | VideoDbDetailsTag;
+    else if (propertyValue == "art" || propertyValue == "thumbnail" || propertyValue == "fanart")
+      details = details | VideoDbDetailsArt;
   }
   return details;
 }
@@ -53,7 +53,7 @@ namespace XBMCAddon
         bool bIsFolder = pItem->GetNumValuesSet() > 2 ? pItem->third() : false;
         pListItem->item->SetPath(url);
         pListItem->item->m_bIsFolder = bIsFolder;
-        fitems.Add(pListItem->item);
+        fitems.Add(CFileItemPtr(new CFileItem(*pListItem->item)));
       }
 
       // call the directory class to add our items
@@ -0,0 +1,279 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// python.h should always be included first before any other includes
+#include <Python.h>
+
+#include "PythonInterpreterPool.h"
+
+#include <vector>
+
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+
+void CPythonInterpreterPool::SetSize(unsigned int size)
+{
+  CSingleLock lock(m_critical);
+  m_size = size;
+}
+
+unsigned int CPythonInterpreterPool::GetSize() const
+{
+  CSingleLock lock(m_critical);
+  return m_size;
+}
+
+bool CPythonInterpreterPool::IsEmpty() const
+{
+  CSingleLock lock(m_critical);
+  return m_interpreters.empty();
+}
+
+void* CPythonInterpreterPool::Acquire(const std::string &addonId)
+{
+  PyInterpreterState *interpreter = NULL;
+  {
+    CSingleLock lock(m_critical);
+    std::list<Interpreter>::iterator spare = m_interpreters.end();
+    std::list<Interpreter>::iterator it;
+    for (it = m_interpreters.begin(); it != m_interpreters.end(); ++it)
+    {
+      if (it->addonId == addonId)
+        break;
+      if (it->addonId.empty() && spare == m_interpreters.end())
+        spare = it;
+    }
+
+    if (it == m_interpreters.end())
+      it = spare;
+    if (it == m_interpreters.end())
+      return NULL;
+
+    interpreter = static_cast<PyInterpreterState*>(it->interpreter);
+    m_interpreters.erase(it);
+  }
+
+  return PyThreadState_New(interpreter);
+}
+
+void CPythonInterpreterPool::Release(void *threadState, const std::string &addonId, const std::string &addonPath)
+{
+  PyThreadState *state = static_cast<PyThreadState*>(threadState);
+  if (!IsEnabled() || !Reset(addonPath))
+  {
+    Py_EndInterpreter(state);
+    return;
+  }
+
+  PyInterpreterState *interpreter = state->interp;
+  PyThreadState_Clear(state);
+  PyThreadState_Swap(NULL);
+  PyThreadState_Delete(state);
+
+  std::vector<void*> evicted;
+  {
+    CSingleLock lock(m_critical);
+    // make room by dropping the least recently used add-on before any spare
+    while (!m_interpreters.empty() && m_interpreters.size() >= m_size)
+    {
+      std::list<Interpreter>::iterator victim = m_interpreters.end();
+      for (std::list<Interpreter>::iterator it = m_interpreters.begin(); it != m_interpreters.end(); ++it)
+      {
+        if (!it->addonId.empty() || victim == m_interpreters.end() || victim->addonId.empty())
+          victim = it;
+      }
+      evicted.push_back(victim->interpreter);
+      m_interpreters.erase(victim);
+    }
+
+    if (m_size > 0)
+      m_interpreters.push_front({ interpreter, addonId, XbmcThreads::SystemClockMillis() });
+    else
+      evicted.push_back(interpreter);
+  }
+
+  for (std::vector<void*>::const_iterator it = evicted.begin(); it != evicted.end(); ++it)
+    End(*it);
+}
+
+bool CPythonInterpreterPool::Warm(const Initializer &initializer)
+{
+  {
+    CSingleLock lock(m_critical);
+    if (m_interpreters.size() >= m_size)
+      return false;
+    for (std::list<Interpreter>::const_iterator it = m_interpreters.begin(); it != m_interpreters.end(); ++it)
+    {
+      if (it->addonId.empty())
+        return false;
+    }
+  }
+
+  PyThreadState *old = PyThreadState_Swap(NULL);
+  PyThreadState *state = Py_NewInterpreter();
+  if (state == NULL)
+  {
+    PyThreadState_Swap(old);
+    CLog::Log(LOGERROR, "CPythonInterpreterPool: failed to create an interpreter");
+    return false;
+  }
+
+  if (initializer)
+    initializer();
+  PyErr_Clear();
+
+  PyInterpreterState *interpreter = state->interp;
+  PyThreadState_Clear(state);
+  PyThreadState_Swap(NULL);
+  PyThreadState_Delete(state);
+
+  bool added = false;
+  {
+    CSingleLock lock(m_critical);
+    if (m_interpreters.size() < m_size)
+    {
+      m_interpreters.push_front({ interpreter, "", XbmcThreads::SystemClockMillis() });
+      added = true;
+    }
+  }
+
+  if (!added)
+    End(interpreter);
+  PyThreadState_Swap(old);
+
+  return added;
+}
+
+bool CPythonInterpreterPool::HasExpired(unsigned int maxIdleMs) const
+{
+  CSingleLock lock(m_critical);
+  unsigned int now = XbmcThreads::SystemClockMillis();
+  for (std::list<Interpreter>::const_iterator it = m_interpreters.begin(); it != m_interpreters.end(); ++it)
+  {
+    if (now - it->lastUsed > maxIdleMs)
+      return true;
+  }
+
+  return false;
+}
+
+void CPythonInterpreterPool::Expire(unsigned int maxIdleMs)
+{
+  std::vector<void*> expired;
+  {
+    CSingleLock lock(m_critical);
+    unsigned int now = XbmcThreads::SystemClockMillis();
+    for (std::list<Interpreter>::iterator it = m_interpreters.begin(); it != m_interpreters.end();)
+    {
+      if (now - it->lastUsed > maxIdleMs)
+      {
+        expired.push_back(it->interpreter);
+        it = m_interpreters.erase(it);
+      }
+      else
+        ++it;
+    }
+  }
+
+  for (std::vector<void*>::const_iterator it = expired.begin(); it != expired.end(); ++it)
+    End(*it);
+}
+
+void CPythonInterpreterPool::Clear()
+{
+  std::list<Interpreter> interpreters;
+  {
+    CSingleLock lock(m_critical);
+    interpreters.swap(m_interpreters);
+  }
+
+  for (std::list<Interpreter>::const_iterator it = interpreters.begin(); it != interpreters.end(); ++it)
+    End(it->interpreter);
+}
+
+void CPythonInterpreterPool::End(void *interpreter)
+{
+  // Py_EndInterpreter() needs a current thread state of the interpreter
+  PyThreadState *state = PyThreadState_New(static_cast<PyInterpreterState*>(interpreter));
+  PyThreadState *old = PyThreadState_Swap(state);
+  Py_EndInterpreter(state);
+  PyThreadState_Swap(old);
+}
+
+bool CPythonInterpreterPool::Reset(const std::string &addonPath)
+{
+  PyObject *modules = PyImport_GetModuleDict(); // borrowed ref, no need to delete
+  if (modules == NULL)
+    return false;
+
+  // drop the modules of the add-on itself so the next run imports them afresh
+  std::string addonFolder = addonPath;
+  if (!addonFolder.empty())
+    URIUtils::AddSlashAtEnd(addonFolder);
+
+  std::vector<PyObject*> stale;
+  PyObject *key, *value;
+  Py_ssize_t pos = 0;
+  while (PyDict_Next(modules, &pos, &key, &value))
+  {
+    if (value == NULL || !PyModule_Check(value))
+      continue;
+
+    const char *file = PyModule_GetFilename(value); // returns internal data, don't delete or modify
+    if (file == NULL)
+    {
+      PyErr_Clear();
+      continue;
+    }
+
+    if (!addonFolder.empty() && StringUtils::StartsWith(file, addonFolder))
+    {
+      Py_INCREF(key);
+      stale.push_back(key);
+    }
+  }
+
+  for (std::vector<PyObject*>::const_iterator it = stale.begin(); it != stale.end(); ++it)
+  {
+    PyDict_DelItem(modules, *it);
+    Py_DECREF(*it);
+  }
+
+  // replace __main__ by an empty module like the one of a new interpreter
+  if (PyDict_GetItemString(modules, "__main__") != NULL)
+    PyDict_DelItemString(modules, "__main__");
+  PyObject *main = PyImport_AddModule((char*)"__main__"); // borrowed ref, no need to delete
+  PyObject *builtins = PyImport_ImportModule((char*)"__builtin__"); // must call Py_DECREF when finished
+  bool result = main != NULL && builtins != NULL &&
+                PyDict_SetItemString(PyModule_GetDict(main), "__builtins__", builtins) == 0;
+  Py_XDECREF(builtins);
+
+  if (!result || PyErr_Occurred())
+  {
+    PyErr_Clear();
+    CLog::Log(LOGWARNING, "CPythonInterpreterPool: failed to reset an interpreter, not keeping it");
+    return false;
+  }
+
+  return true;
+}
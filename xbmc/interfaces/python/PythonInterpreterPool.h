@@ -0,0 +1,126 @@
+#pragma once
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <functional>
+#include <list>
+#include <string>
+
+#include "threads/CriticalSection.h"
+
+/*!
+ \brief Python sub-interpreters kept alive between script runs.
+
+ Creating a sub-interpreter and importing the Kodi modules into it costs more
+ than most plugins spend listing a folder. The pool keeps pre-warmed spare
+ interpreters with the Kodi modules already imported and, after a run, keeps
+ the interpreter for the next run of the same add-on so that the modules it
+ imported from its dependencies don't have to be imported again.
+
+ An interpreter is only ever reused by the add-on it was first used for. When
+ it is released the modules imported from the add-on's own folder and the
+ __main__ module are dropped, so every run imports and executes the add-on's
+ code afresh.
+
+ All methods taking or returning thread states have to be called with the
+ global interpreter lock held. The thread states are PyThreadState* but the
+ Python headers are kept out of this header.
+ */
+class CPythonInterpreterPool
+{
+public:
+  typedef std::function<void()> Initializer;
+
+  CPythonInterpreterPool() = default;
+  ~CPythonInterpreterPool() = default;
+
+  /*!
+   \brief Sets the number of interpreters to keep, 0 disables the pool.
+   */
+  void SetSize(unsigned int size);
+  unsigned int GetSize() const;
+  bool IsEnabled() const { return GetSize() > 0; }
+
+  /*!
+   \brief Gets an interpreter for the given add-on.
+
+   Prefers the interpreter the add-on used last and otherwise takes a spare.
+   The returned thread state belongs to the calling thread and has not been
+   swapped in.
+
+   \param addonId identifier and version of the add-on
+   \return thread state of a pooled interpreter or NULL if there is none
+   */
+  void* Acquire(const std::string &addonId);
+
+  /*!
+   \brief Returns the interpreter of a finished run to the pool.
+
+   The thread state has to be the current one and the only one of its
+   interpreter. It is deleted and the current thread state is NULL afterwards.
+   If the pool is disabled or full the interpreter is ended instead.
+
+   \param threadState thread state returned by Acquire() or Py_NewInterpreter()
+   \param addonId identifier and version of the add-on
+   \param addonPath path of the add-on folder, modules imported from it are dropped
+   */
+  void Release(void *threadState, const std::string &addonId, const std::string &addonPath);
+
+  /*!
+   \brief Creates a spare interpreter unless there is one already or the pool is full.
+
+   \param initializer called with the new interpreter swapped in to import the Kodi modules
+   \return true if a spare was created
+   */
+  bool Warm(const Initializer &initializer);
+
+  /*!
+   \brief Whether there are interpreters that haven't been used for the given time.
+   Doesn't need the global interpreter lock.
+   */
+  bool HasExpired(unsigned int maxIdleMs) const;
+
+  /*!
+   \brief Ends the interpreters that haven't been used for the given time.
+   */
+  void Expire(unsigned int maxIdleMs);
+
+  /*!
+   \brief Ends all pooled interpreters, has to be called before Py_Finalize().
+   */
+  void Clear();
+
+  bool IsEmpty() const;
+
+private:
+  struct Interpreter
+  {
+    void *interpreter;
+    std::string addonId; // empty for spares
+    unsigned int lastUsed;
+  };
+
+  static void End(void *interpreter);
+  static bool Reset(const std::string &addonPath);
+
+  unsigned int m_size = 0;
+  std::list<Interpreter> m_interpreters; // most recently used first
+  CCriticalSection m_critical;
+};
@@ -20,6 +20,7 @@
 
 // python.h should always be included first before any other includes
 #include <Python.h>
+#include <algorithm>
 #include <iterator>
 #include <osdefs.h>
 
@@ -37,6 +38,7 @@
 #include "interfaces/legacy/Addon.h"
 #include "interfaces/python/LanguageHook.h"
 #include "interfaces/python/PyContext.h"
+#include "interfaces/python/PythonInterpreterPool.h"
 #include "interfaces/python/pythreadstate.h"
 #include "interfaces/python/swig.h"
 #include "interfaces/python/XBPython.h"
@@ -169,7 +171,15 @@ bool CPythonInvoker::execute(const std::string &script, const std::vector<std::s
 
   // get the global lock
   PyEval_AcquireLock();
-  PyThreadState* state = Py_NewInterpreter();
+
+  // take an interpreter with the modules already imported from the pool if possible
+  bool reuseInterpreter = canReuseInterpreter();
+  PyThreadState* state = NULL;
+  if (reuseInterpreter)
+    state = static_cast<PyThreadState*>(g_pythonParser.GetInterpreterPool().Acquire(getInterpreterPoolKey()));
+  bool pooled = state != NULL;
+  if (!pooled)
+    state = Py_NewInterpreter();
   if (state == NULL)
   {
     PyEval_ReleaseLock();
@@ -182,7 +192,13 @@ bool CPythonInvoker::execute(const std::string &script, const std::vector<std::s
   XBMCAddon::AddonClass::Ref<XBMCAddon::Python::PythonLanguageHook> languageHook(new XBMCAddon::Python::PythonLanguageHook(state->interp));
   languageHook->RegisterMe();
 
-  onInitialization();
+  if (pooled)
+  {
+    CLog::Log(LOGDEBUG, "CPythonInvoker(%d, %s): using a pooled interpreter", GetId(), m_sourceFile.c_str());
+    runInitializationScript();
+  }
+  else
+    onInitialization();
   setState(InvokerStateInitialized);
 
   std::string realFilename(CSpecialProtocol::TranslatePath(m_sourceFile));
@@ -412,11 +428,15 @@ bool CPythonInvoker::execute(const std::string &script, const std::vector<std::s
   //    http://bugs.python.org/issue10582
   // and that causes major failures. So we are not going to go back in
   // to run the GC if that's the case.
-  if (!m_stop && languageHook->HasRegisteredAddonClasses() && !systemExitThrown &&
+  if (!m_stop && (languageHook->HasRegisteredAddonClasses() || reuseInterpreter) && !systemExitThrown &&
       PyRun_SimpleString(GC_SCRIPT) == -1)
     CLog::Log(LOGERROR, "CPythonInvoker(%d, %s): failed to run the gc to clean up after running prior to shutting down the Interpreter", GetId(), m_sourceFile.c_str());
 
-  Py_EndInterpreter(state);
+  // only keep interpreters of scripts that ended normally and left nothing behind
+  if (reuseInterpreter && !m_stop && !systemExitThrown && !languageHook->HasRegisteredAddonClasses())
+    g_pythonParser.GetInterpreterPool().Release(state, getInterpreterPoolKey(), CSpecialProtocol::TranslatePath(m_addon->Path()));
+  else
+    Py_EndInterpreter(state);
 
   // If we still have objects left around, produce an error message detailing what's been left behind
   if (languageHook->HasRegisteredAddonClasses())
@@ -431,6 +451,20 @@ bool CPythonInvoker::execute(const std::string &script, const std::vector<std::s
 
   setState(stateToSet);
 
+  // replace the spare interpreter once the script is done and nobody waits for it anymore
+  if (reuseInterpreter)
+  {
+    PyEval_AcquireLock();
+    g_pythonParser.GetInterpreterPool().Warm([this]()
+    {
+      XBMCAddon::AddonClass::Ref<XBMCAddon::Python::PythonLanguageHook> warmHook(new XBMCAddon::Python::PythonLanguageHook(PyThreadState_Get()->interp));
+      warmHook->RegisterMe();
+      onInitialization();
+      warmHook->UnregisterMe();
+    });
+    PyEval_ReleaseLock();
+  }
+
   return true;
 }
 
@@ -555,6 +589,11 @@ void CPythonInvoker::onInitialization()
     initializeModules(getModules());
   }
 
+  runInitializationScript();
+}
+
+void CPythonInvoker::runInitializationScript()
+{
   // get a possible initialization script
   const char* runscript = getInitializationScript();
   if (runscript!= NULL && strlen(runscript) > 0)
@@ -633,6 +672,17 @@ bool CPythonInvoker::initializeModule(PythonModuleInitialization module)
   return true;
 }
 
+bool CPythonInvoker::canReuseInterpreter() const
+{
+  return m_addon != NULL && GetReuseInterpreter() && g_pythonParser.GetInterpreterPool().IsEnabled();
+}
+
+std::string CPythonInvoker::getInterpreterPoolKey() const
+{
+  // a new version of the add-on must not see the modules of the old one
+  return m_addon->ID() + "-" + m_addon->Version().asString();
+}
+
 void CPythonInvoker::getAddonModuleDeps(const ADDON::AddonPtr& addon, std::set<std::string>& paths)
 {
   ADDON::ADDONDEPS deps = addon->GetDeps();
@@ -676,6 +726,11 @@ void CPythonInvoker::addNativePath(const std::string& path)
   if (path.empty())
     return;
 
+  // the sys.path of a pooled interpreter still holds the paths of its last run
+  std::vector<std::string> paths = StringUtils::Split(m_pythonPath, PY_PATH_SEP);
+  if (std::find(paths.begin(), paths.end(), path) != paths.end())
+    return;
+
   if (!m_pythonPath.empty())
     m_pythonPath += PY_PATH_SEP;
 
@@ -63,6 +63,9 @@ protected:
 
 private:
   void initializeModules(const std::map<std::string, PythonModuleInitialization> &modules);
+  void runInitializationScript();
+  bool canReuseInterpreter() const;
+  std::string getInterpreterPoolKey() const;
   bool initializeModule(PythonModuleInitialization module);
   void addPath(const std::string& path); // add path in UTF-8 encoding
   void addNativePath(const std::string& path); // add path in system/Python encoding
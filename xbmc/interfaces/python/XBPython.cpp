@@ -29,7 +29,7 @@
 #include "XBPython.h"
 #include "filesystem/File.h"
 #include "filesystem/SpecialProtocol.h"
-#include "utils/JSONVariantWriter.h"
+#include "interfaces/Announcement.h"
 #include "utils/log.h"
 #include "utils/Variant.h"
 #include "Util.h"
@@ -48,6 +48,9 @@
 
 using namespace ANNOUNCEMENT;
 
+// Time pooled interpreters are kept without being used
+#define PYTHON_POOL_IDLE_TIME 600000 // ms
+
 XBPython::XBPython()
 {
   m_bInitialized      = false;
@@ -80,6 +83,13 @@ XBPython::~XBPython()
 
 void XBPython::Announce(AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data)
 {
+  OnAnnouncement(CAnnouncement(flag, sender, message, data));
+}
+
+void XBPython::OnAnnouncement(const CAnnouncement &announcement)
+{
+  AnnouncementFlag flag = announcement.GetFlag();
+  const char *message = announcement.GetMessage().c_str();
   if (flag & VideoLibrary)
   {
    if (strcmp(message, "OnScanFinished") == 0)
@@ -114,9 +124,9 @@ void XBPython::Announce(AnnouncementFlag flag, const char *sender, const char *m
      OnDPMSActivated();
   }
 
-  std::string jsonData;
-  if (CJSONVariantWriter::Write(data, jsonData, g_advancedSettings.m_jsonOutputCompact))
-    OnNotification(sender, std::string(ANNOUNCEMENT::AnnouncementFlagToString(flag)) + "." + std::string(message), jsonData);
+  const std::string &jsonData = announcement.GetJSONData(g_advancedSettings.m_jsonOutputCompact);
+  if (!jsonData.empty())
+    OnNotification(announcement.GetSender(), std::string(ANNOUNCEMENT::AnnouncementFlagToString(flag)) + "." + announcement.GetMessage(), jsonData);
 }
 
 // message all registered callbacks that we started playing
@@ -462,6 +472,8 @@ void XBPython::Finalize()
       PyEval_AcquireLock();
       PyThreadState_Swap(curTs);
 
+      // Py_Finalize only ends the main interpreter
+      m_interpreterPool.Clear();
       Py_Finalize();
       PyEval_ReleaseLock();
     }
@@ -525,7 +537,17 @@ void XBPython::Process()
     CSingleLock l2(m_critSection);
     if(m_iDllScriptCounter == 0 && (XbmcThreads::SystemClockMillis() - m_endtime) > 10000 )
     {
-      Finalize();
+      // pooled interpreters keep python loaded until they haven't been used for a while
+      if (m_interpreterPool.HasExpired(PYTHON_POOL_IDLE_TIME))
+      {
+        CSingleExit exit(m_critSection);
+        PyEval_AcquireLock();
+        m_interpreterPool.Expire(PYTHON_POOL_IDLE_TIME);
+        PyEval_ReleaseLock();
+      }
+
+      if (m_iDllScriptCounter == 0 && m_interpreterPool.IsEmpty())
+        Finalize();
     }
   }
 }
@@ -618,6 +640,7 @@ bool XBPython::OnScriptInitialized(ILanguageInvoker *invoker)
       CLog::Log(LOGERROR, "Python threadstate is NULL.");
     PyEval_ReleaseLock();
 
+    m_interpreterPool.SetSize(g_advancedSettings.m_pythonInterpreterPoolSize);
     m_bInitialized = true;
   }
 
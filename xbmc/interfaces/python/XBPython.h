@@ -26,6 +26,7 @@
 #include "threads/Thread.h"
 #include "interfaces/IAnnouncer.h"
 #include "interfaces/generic/ILanguageInvocationHandler.h"
+#include "interfaces/python/PythonInterpreterPool.h"
 #include "ServiceBroker.h"
 
 #include <memory>
@@ -79,6 +80,7 @@ public:
   void OnQueueNextItem() override;
 
   void Announce(ANNOUNCEMENT::AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data) override;
+  void OnAnnouncement(const ANNOUNCEMENT::CAnnouncement &announcement) override;
   void RegisterPythonPlayerCallBack(IPlayerCallback* pCallback);
   void UnregisterPythonPlayerCallBack(IPlayerCallback* pCallback);
   void RegisterPythonMonitorCallBack(XBMCAddon::xbmc::Monitor* pCallback);
@@ -110,6 +112,8 @@ public:
   void UnregisterExtensionLib(LibraryLoader *pLib);
   void UnloadExtensionLibs();
 
+  CPythonInterpreterPool& GetInterpreterPool() { return m_interpreterPool; }
+
 private:
   void Finalize();
 
@@ -131,6 +135,9 @@ private:
   // any global events that scripts should be using
   CEvent m_globalEvent;
 
+  // interpreters kept between plugin runs
+  CPythonInterpreterPool m_interpreterPool;
+
   // in order to finalize and unload the python library, need to save all the extension libraries that are
   // loaded by it and unload them first (not done by finalize)
   PythonExtensionLibraries m_extensions;
@@ -0,0 +1,266 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// python.h should always be included first before any other includes
+#include <Python.h>
+
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "interfaces/python/PythonInterpreterPool.h"
+#include "threads/SystemClock.h"
+#include "utils/URIUtils.h"
+
+#include "gtest/gtest.h"
+
+#define RUN_COUNT 20
+
+#if defined(TARGET_WINDOWS)
+#define PATH_SEPARATOR ";"
+#else
+#define PATH_SEPARATOR ":"
+#endif
+
+// stands in for the Kodi modules, which need a running application
+#define INITIALIZATION_SCRIPT \
+  "import json, re, urllib, urlparse, datetime, xml.dom.minidom\n"
+
+// a plugin listing a folder with the help of its own modules and a module of a dependency
+#define PLUGIN_SCRIPT \
+  "import sys\n" \
+  "leftover = 'items' in globals()\n" \
+  "warm = 'shared' in sys.modules\n" \
+  "import shared\n" \
+  "from resources.lib import listing\n" \
+  "listing.RUNS.append(int(sys.argv[1]))\n" \
+  "runs = len(listing.RUNS)\n" \
+  "items = listing.build(shared.parse(sys.argv[2]))\n"
+
+#define LISTING_MODULE \
+  "import json\n" \
+  "RUNS = []\n" \
+  "def build(count):\n" \
+  "  return [json.dumps({'label': 'Item %d' % i, 'path': 'plugin://plugin.test/?item=%d' % i}) for i in range(count)]\n"
+
+#define SHARED_MODULE \
+  "import urlparse\n" \
+  "def parse(query):\n" \
+  "  return int(urlparse.parse_qs(query)['count'][0])\n"
+
+struct PluginResult
+{
+  bool ran = false;
+  bool leftover = true;
+  bool warm = false;
+  long runs = 0;
+  long items = 0;
+};
+
+class TestPythonInterpreterPool : public ::testing::Test
+{
+protected:
+  static void SetUpTestCase()
+  {
+    if (Py_IsInitialized())
+      return;
+
+    Py_Initialize();
+    PyEval_InitThreads();
+    s_mainThreadState = PyEval_SaveThread();
+  }
+
+  static void TearDownTestCase()
+  {
+    if (s_mainThreadState == NULL)
+      return;
+
+    PyEval_RestoreThread(s_mainThreadState);
+    Py_Finalize();
+    s_mainThreadState = NULL;
+  }
+
+  void SetUp() override
+  {
+    m_root = CSpecialProtocol::TranslatePath("special://temp/pythonpool");
+    XFILE::CDirectory::RemoveRecursive(m_root);
+    m_pluginPath = URIUtils::AddFileToFolder(m_root, "plugin.test");
+    m_modulePath = URIUtils::AddFileToFolder(m_root, "script.module.shared", "lib");
+    for (const std::string &directory : { m_root, m_pluginPath, URIUtils::AddFileToFolder(m_pluginPath, "resources"),
+                                          URIUtils::AddFileToFolder(m_pluginPath, "resources", "lib"),
+                                          URIUtils::GetParentPath(m_modulePath), m_modulePath })
+      XFILE::CDirectory::Create(directory);
+
+    WriteFile(URIUtils::AddFileToFolder(m_pluginPath, "resources", "__init__.py"), "");
+    WriteFile(URIUtils::AddFileToFolder(m_pluginPath, "resources", "lib", "__init__.py"), "");
+    WriteFile(URIUtils::AddFileToFolder(m_pluginPath, "resources", "lib", "listing.py"), LISTING_MODULE);
+    WriteFile(URIUtils::AddFileToFolder(m_modulePath, "shared.py"), SHARED_MODULE);
+  }
+
+  void TearDown() override
+  {
+    PyEval_AcquireLock();
+    m_pool.Clear();
+    PyEval_ReleaseLock();
+    XFILE::CDirectory::RemoveRecursive(m_root);
+  }
+
+  void WriteFile(const std::string &path, const std::string &content)
+  {
+    XFILE::CFile file;
+    ASSERT_TRUE(file.OpenForWrite(path, true));
+    ASSERT_EQ(static_cast<ssize_t>(content.size()), file.Write(content.c_str(), content.size()));
+    file.Close();
+  }
+
+  static void Initialize()
+  {
+    PyRun_SimpleString(INITIALIZATION_SCRIPT);
+  }
+
+  // runs the plugin in the current interpreter like CPythonInvoker does
+  PluginResult RunPlugin(int handle)
+  {
+    std::string path = m_pluginPath + PATH_SEPARATOR + m_modulePath + PATH_SEPARATOR + Py_GetPath();
+    PySys_SetPath(const_cast<char*>(path.c_str()));
+    std::string handleArgument = std::to_string(handle);
+    char *argv[] = { const_cast<char*>("plugin://plugin.test/"), const_cast<char*>(handleArgument.c_str()), const_cast<char*>("count=200") };
+    PySys_SetArgv(3, argv);
+
+    PluginResult result;
+    PyObject *moduleDict = PyModule_GetDict(PyImport_AddModule("__main__"));
+    PyObject *ret = PyRun_String(PLUGIN_SCRIPT, Py_file_input, moduleDict, moduleDict);
+    if (ret == NULL)
+    {
+      PyErr_Print();
+      return result;
+    }
+    Py_DECREF(ret);
+
+    result.ran = true;
+    result.leftover = PyObject_IsTrue(PyDict_GetItemString(moduleDict, "leftover")) != 0;
+    result.warm = PyObject_IsTrue(PyDict_GetItemString(moduleDict, "warm")) != 0;
+    result.runs = PyInt_AsLong(PyDict_GetItemString(moduleDict, "runs"));
+    result.items = PyList_Size(PyDict_GetItemString(moduleDict, "items"));
+    return result;
+  }
+
+  PluginResult RunCold(int handle)
+  {
+    PyEval_AcquireLock();
+    PyThreadState *state = Py_NewInterpreter();
+    Initialize();
+    PluginResult result = RunPlugin(handle);
+    Py_EndInterpreter(state);
+    PyEval_ReleaseLock();
+    return result;
+  }
+
+  PluginResult RunPooled(const std::string &addonId, int handle)
+  {
+    PyEval_AcquireLock();
+    PyThreadState *state = static_cast<PyThreadState*>(m_pool.Acquire(addonId));
+    if (state != NULL)
+      PyThreadState_Swap(state);
+    else
+    {
+      state = Py_NewInterpreter();
+      Initialize();
+    }
+    PluginResult result = RunPlugin(handle);
+    m_pool.Release(state, addonId, m_pluginPath);
+    m_pool.Warm(Initialize);
+    PyEval_ReleaseLock();
+    return result;
+  }
+
+  static PyThreadState *s_mainThreadState;
+  CPythonInterpreterPool m_pool;
+  std::string m_root;
+  std::string m_pluginPath;
+  std::string m_modulePath;
+};
+
+PyThreadState *TestPythonInterpreterPool::s_mainThreadState = NULL;
+
+TEST_F(TestPythonInterpreterPool, ColdAndPooledRuns)
+{
+  m_pool.SetSize(2);
+
+  unsigned int start = XbmcThreads::SystemClockMillis();
+  for (int i = 1; i <= RUN_COUNT; i++)
+  {
+    PluginResult result = RunCold(i);
+    ASSERT_TRUE(result.ran);
+    EXPECT_EQ(200, result.items);
+  }
+  unsigned int coldTime = XbmcThreads::SystemClockMillis() - start;
+
+  // the first run creates the interpreter and warms a spare
+  RunPooled("plugin.test-1.0.0", 0);
+
+  start = XbmcThreads::SystemClockMillis();
+  for (int i = 1; i <= RUN_COUNT; i++)
+  {
+    PluginResult result = RunPooled("plugin.test-1.0.0", i);
+    ASSERT_TRUE(result.ran);
+    EXPECT_EQ(200, result.items);
+  }
+  unsigned int pooledTime = XbmcThreads::SystemClockMillis() - start;
+
+  RecordProperty("cold_ms", coldTime);
+  RecordProperty("pooled_ms", pooledTime);
+}
+
+TEST_F(TestPythonInterpreterPool, Isolation)
+{
+  m_pool.SetSize(2);
+
+  PluginResult first = RunPooled("plugin.test-1.0.0", 1);
+  ASSERT_TRUE(first.ran);
+  EXPECT_FALSE(first.warm);
+
+  // the same add-on gets its interpreter back with the dependency still
+  // imported, but its own modules and __main__ are new
+  PluginResult second = RunPooled("plugin.test-1.0.0", 2);
+  ASSERT_TRUE(second.ran);
+  EXPECT_TRUE(second.warm);
+  EXPECT_FALSE(second.leftover);
+  EXPECT_EQ(1, second.runs);
+
+  // another add-on gets the spare, which has never run an add-on
+  PluginResult other = RunPooled("plugin.other-1.0.0", 3);
+  ASSERT_TRUE(other.ran);
+  EXPECT_FALSE(other.warm);
+  EXPECT_FALSE(other.leftover);
+  EXPECT_EQ(1, other.runs);
+}
+
+TEST_F(TestPythonInterpreterPool, Disabled)
+{
+  EXPECT_FALSE(m_pool.IsEnabled());
+
+  PluginResult result = RunPooled("plugin.test-1.0.0", 1);
+  ASSERT_TRUE(result.ran);
+  EXPECT_TRUE(m_pool.IsEmpty());
+
+  PyEval_AcquireLock();
+  EXPECT_TRUE(m_pool.Acquire("plugin.test-1.0.0") == NULL);
+  PyEval_ReleaseLock();
+}
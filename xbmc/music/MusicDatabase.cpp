@@ -104,6 +104,7 @@ static void AnnounceUpdate(const std::string& content, int id)
 CMusicDatabase::CMusicDatabase(void)
 {
   m_translateBlankArtist = true;
+  m_batch = false;
 }
 
 CMusicDatabase::~CMusicDatabase(void)
@@ -396,7 +397,8 @@ int CMusicDatabase::AddAlbumInfoSong(int idAlbum, const CSong& song)
 
 bool CMusicDatabase::AddAlbum(CAlbum& album)
 {
-  BeginTransaction();
+  if (!m_batch)
+    BeginTransaction();
 
   album.idAlbum = AddAlbum(album.strAlbum,
                            album.strMusicBrainzAlbumID,
@@ -465,13 +467,15 @@ bool CMusicDatabase::AddAlbum(CAlbum& album)
   for (const auto &albumArt : album.art)
     SetArtForItem(album.idAlbum, MediaTypeAlbum, albumArt.first, albumArt.second);
 
-  CommitTransaction();
+  if (!m_batch)
+    CommitTransaction();
   return true;
 }
 
 bool CMusicDatabase::UpdateAlbum(CAlbum& album)
 {
-  BeginTransaction();
+  if (!m_batch)
+    BeginTransaction();
 
   UpdateAlbum(album.idAlbum,
               album.strAlbum, album.strMusicBrainzAlbumID,
@@ -558,7 +562,8 @@ bool CMusicDatabase::UpdateAlbum(CAlbum& album)
   if (!album.art.empty())
     SetArtForItem(album.idAlbum, MediaTypeAlbum, album.art);
 
-  CommitTransaction();
+  if (!m_batch)
+    CommitTransaction();
   return true;
 }
 
@@ -1894,6 +1899,44 @@ bool CMusicDatabase::GetGenresByAlbum(int idAlbum, std::vector<int>& genres)
   return false;
 }
 
+bool CMusicDatabase::GetGenresByAlbums(const std::set<int>& idAlbums, std::map<int, std::vector<int> >& genres)
+{
+  return GetGenresByItems("album_genre", "idAlbum", idAlbums, genres);
+}
+
+bool CMusicDatabase::GetGenresBySongs(const std::set<int>& idSongs, std::map<int, std::vector<int> >& genres)
+{
+  return GetGenresByItems("song_genre", "idSong", idSongs, genres);
+}
+
+bool CMusicDatabase::GetGenresByItems(const std::string& table, const std::string& idField, const std::set<int>& ids, std::map<int, std::vector<int> >& genres)
+{
+  try
+  {
+    for (const auto &idList : GetIdLists(ids))
+    {
+      std::string strSQL = PrepareSQL("SELECT %s, idGenre FROM %s WHERE %s IN (%s) ORDER BY %s, iOrder ASC",
+                                      idField.c_str(), table.c_str(), idField.c_str(), idList.c_str(), idField.c_str());
+      if (!m_pDS->query(strSQL))
+        return false;
+
+      while (!m_pDS->eof())
+      {
+        genres[m_pDS->fv(0).get_asInt()].push_back(m_pDS->fv(1).get_asInt());
+        m_pDS->next();
+      }
+      m_pDS->close();
+    }
+
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s(%s) failed", __FUNCTION__, table.c_str());
+  }
+  return false;
+}
+
 bool CMusicDatabase::GetGenresBySong(int idSong, std::vector<int>& genres)
 {
   try
@@ -3936,14 +3979,23 @@ bool CMusicDatabase::GetArtistsByWhere(const std::string& strBaseDir, const Filt
     if (!BuildSQL(strSQLExtra, extFilter, strSQLExtra))
       return false;
 
+    // Let the database do the sorting if possible
+    std::string strSortSQL;
+    sorting = sortDescription;
+    if (!countOnly && extFilter.order.empty() && extFilter.limit.empty() &&
+        BuildSortSQL(sorting, MediaTypeArtist, strSortSQL))
+      sorting.sortBy = SortByNone;
+
     // Apply the limiting directly here if there's no special sorting but limiting
     if (extFilter.limit.empty() &&
-        sortDescription.sortBy == SortByNone &&
-       (sortDescription.limitStart > 0 || sortDescription.limitEnd > 0))
+        sorting.sortBy == SortByNone &&
+       (sorting.limitStart > 0 || sorting.limitEnd > 0))
     {
       total = (int)strtol(GetSingleValue(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, m_pDS).c_str(), NULL, 10);
-      strSQLExtra += DatabaseUtils::BuildLimitClause(sortDescription.limitEnd, sortDescription.limitStart);
+      strSQLExtra += strSortSQL + DatabaseUtils::BuildLimitClause(sorting.limitEnd, sorting.limitStart);
     }
+    else
+      strSQLExtra += strSortSQL;
 
     strSQL = PrepareSQL(strSQL.c_str(), !extFilter.fields.empty() && extFilter.fields.compare("*") != 0 ? extFilter.fields.c_str() : "artistview.*") + strSQLExtra;
 
@@ -3974,7 +4026,7 @@ bool CMusicDatabase::GetArtistsByWhere(const std::string& strBaseDir, const Filt
     
     DatabaseResults results;
     results.reserve(iRowsFound);
-    if (!SortUtils::SortFromDataset(sortDescription, MediaTypeArtist, m_pDS, results))
+    if (!SortUtils::SortFromDataset(sorting, MediaTypeArtist, m_pDS, results))
       return false;
 
     // get data from returned rows
@@ -4095,14 +4147,23 @@ bool CMusicDatabase::GetAlbumsByWhere(const std::string &baseDir, const Filter &
     if (!BuildSQL(strSQLExtra, extFilter, strSQLExtra))
       return false;
 
+    // Let the database do the sorting if possible
+    std::string strSortSQL;
+    sorting = sortDescription;
+    if (!countOnly && extFilter.order.empty() && extFilter.limit.empty() &&
+        BuildSortSQL(sorting, MediaTypeAlbum, strSortSQL))
+      sorting.sortBy = SortByNone;
+
     // Apply the limiting directly here if there's no special sorting but limiting
     if (extFilter.limit.empty() &&
-        sortDescription.sortBy == SortByNone &&
-       (sortDescription.limitStart > 0 || sortDescription.limitEnd > 0))
+        sorting.sortBy == SortByNone &&
+       (sorting.limitStart > 0 || sorting.limitEnd > 0))
     {
       total = (int)strtol(GetSingleValue(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, m_pDS).c_str(), NULL, 10);
-      strSQLExtra += DatabaseUtils::BuildLimitClause(sortDescription.limitEnd, sortDescription.limitStart);
+      strSQLExtra += strSortSQL + DatabaseUtils::BuildLimitClause(sorting.limitEnd, sorting.limitStart);
     }
+    else
+      strSQLExtra += strSortSQL;
 
     strSQL = PrepareSQL(strSQL, !filter.fields.empty() && filter.fields.compare("*") != 0 ? filter.fields.c_str() : "albumview.*") + strSQLExtra;
 
@@ -4138,7 +4199,7 @@ bool CMusicDatabase::GetAlbumsByWhere(const std::string &baseDir, const Filter &
     
     DatabaseResults results;
     results.reserve(iRowsFound);
-    if (!SortUtils::SortFromDataset(sortDescription, MediaTypeAlbum, m_pDS, results))
+    if (!SortUtils::SortFromDataset(sorting, MediaTypeAlbum, m_pDS, results))
       return false;
 
     // get data from returned rows
@@ -4493,14 +4554,23 @@ bool CMusicDatabase::GetSongsByWhere(const std::string &baseDir, const Filter &f
     if (!BuildSQL(strSQLExtra, extFilter, strSQLExtra))
       return false;
 
+    // Let the database do the sorting if possible
+    std::string strSortSQL;
+    sorting = sortDescription;
+    if (extFilter.order.empty() && extFilter.limit.empty() &&
+        BuildSortSQL(sorting, MediaTypeSong, strSortSQL))
+      sorting.sortBy = SortByNone;
+
     // Apply the limiting directly here if there's no special sorting but limiting
     if (extFilter.limit.empty() &&
-        sortDescription.sortBy == SortByNone &&
-       (sortDescription.limitStart > 0 || sortDescription.limitEnd > 0))
+        sorting.sortBy == SortByNone &&
+       (sorting.limitStart > 0 || sorting.limitEnd > 0))
     {
       total = (int)strtol(GetSingleValue(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, m_pDS).c_str(), NULL, 10);
-      strSQLExtra += DatabaseUtils::BuildLimitClause(sortDescription.limitEnd, sortDescription.limitStart);
+      strSQLExtra += strSortSQL + DatabaseUtils::BuildLimitClause(sorting.limitEnd, sorting.limitStart);
     }
+    else
+      strSQLExtra += strSortSQL;
 
     strSQL = PrepareSQL(strSQL, !filter.fields.empty() && filter.fields.compare("*") != 0 ? filter.fields.c_str() : "songview.*") + strSQLExtra;
 
@@ -4523,7 +4593,7 @@ bool CMusicDatabase::GetSongsByWhere(const std::string &baseDir, const Filter &f
     
     DatabaseResults results;
     results.reserve(iRowsFound);
-    if (!SortUtils::SortFromDataset(sortDescription, MediaTypeSong, m_pDS, results))
+    if (!SortUtils::SortFromDataset(sorting, MediaTypeSong, m_pDS, results))
       return false;
 
     // get data from returned rows
@@ -5931,6 +6001,30 @@ int CMusicDatabase::GetSongIDFromPath(const std::string &filePath)
   return -1;
 }
 
+void CMusicDatabase::BeginBatch()
+{
+  if (m_batch)
+    return;
+  BeginTransaction();
+  m_batch = true;
+}
+
+bool CMusicDatabase::CommitBatch()
+{
+  if (!m_batch)
+    return true;
+  m_batch = false;
+  return CommitTransaction();
+}
+
+void CMusicDatabase::RollbackBatch()
+{
+  if (!m_batch)
+    return;
+  m_batch = false;
+  RollbackTransaction();
+}
+
 bool CMusicDatabase::CommitTransaction()
 {
   if (CDatabase::CommitTransaction())
@@ -22,6 +22,7 @@
 \brief
 */
 #pragma once
+#include <map>
 #include <utility>
 #include <vector>
 
@@ -100,6 +101,17 @@ public:
 
   bool Open() override;
   bool CommitTransaction() override;
+
+  /*! \brief Group the changes of many albums into one transaction
+   AddAlbum and UpdateAlbum join the batch instead of committing on their own,
+   saving the database a sync to disk per album. Nothing is written before
+   CommitBatch() is called, RollbackBatch() discards all changes of the batch.
+   Keep the batch short, the database is locked for other writers while it is open.
+   */
+  void BeginBatch();
+  bool CommitBatch();
+  void RollbackBatch();
+
   void EmptyCache();
   void Clean();
   int  Cleanup(bool bShowProgress=true);
@@ -361,8 +373,22 @@ public:
   bool AddSongGenre(int idGenre, int idSong, int iOrder);
   bool GetGenresBySong(int idSong, std::vector<int>& genres);
 
+  /*! \brief Get the genre ids of several songs at once
+   \param idSongs the ids of the songs
+   \param genres the genre ids (in order) mapped by song id
+   \return true if the query succeeded, false otherwise
+   */
+  bool GetGenresBySongs(const std::set<int>& idSongs, std::map<int, std::vector<int> >& genres);
+
   bool AddAlbumGenre(int idGenre, int idAlbum, int iOrder);
   bool GetGenresByAlbum(int idAlbum, std::vector<int>& genres);
+
+  /*! \brief Get the genre ids of several albums at once
+   \param idAlbums the ids of the albums
+   \param genres the genre ids (in order) mapped by album id
+   \return true if the query succeeded, false otherwise
+   */
+  bool GetGenresByAlbums(const std::set<int>& idAlbums, std::map<int, std::vector<int> >& genres);
   bool DeleteAlbumGenresByAlbum(int idAlbum);
 
   bool GetGenresByArtist(int idArtist, CFileItem* item);
@@ -557,6 +583,15 @@ private:
    */
   virtual void CreateViews();
 
+  /*! \brief Get the genre ids of several songs or albums at once
+   \param table the genre link table, song_genre or album_genre
+   \param idField the name of the item id column in the link table
+   \param ids the ids of the items
+   \param genres the genre ids (in order) mapped by item id
+   \return true if the query succeeded, false otherwise
+   */
+  bool GetGenresByItems(const std::string& table, const std::string& idField, const std::set<int>& ids, std::map<int, std::vector<int> >& genres);
+
   CSong GetSongFromDataset();
   CSong GetSongFromDataset(const dbiplus::sql_record* const record, int offset = 0);
   CArtist GetArtistFromDataset(dbiplus::Dataset* pDS, int offset = 0, bool needThumb = true);
@@ -589,6 +624,7 @@ private:
   int GetSongIDFromPath(const std::string &filePath);
 
   bool m_translateBlankArtist;
+  bool m_batch;
 
   // Fields should be ordered as they
   // appear in the songview
@@ -31,7 +31,7 @@
 
 using namespace MUSIC_INFO;
 
-CMusicThumbLoader::CMusicThumbLoader() : CThumbLoader()
+CMusicThumbLoader::CMusicThumbLoader() : CThumbLoader(THUMB_LOADER_WORKERS)
 {
   m_musicDatabase = new CMusicDatabase;
 }
@@ -49,6 +49,7 @@
 #include "music/tags/MusicInfoTagLoaderFactory.h"
 #include "MusicAlbumInfo.h"
 #include "MusicInfoScraper.h"
+#include "MusicTagReader.h"
 #include "NfoFile.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
@@ -67,6 +68,12 @@ using namespace MUSICDATABASEDIRECTORY;
 using namespace MUSIC_GRABBER;
 using namespace ADDON;
 
+// files whose tags are read at the same time, mostly waiting for the network
+#define MUSIC_SCAN_TAG_READERS 4
+// songs and milliseconds to collect in one database transaction
+#define MUSIC_SCAN_BATCH_SONGS 500
+#define MUSIC_SCAN_BATCH_TIME 10000
+
 CMusicInfoScanner::CMusicInfoScanner()
 : CThread("MusicInfoScanner"),
   m_needsCleanup(false),
@@ -81,6 +88,9 @@ CMusicInfoScanner::CMusicInfoScanner()
   m_itemCount=0;
   m_flags = 0;
   m_bClean = false;
+  m_batchSongs = 0;
+  m_batchStart = 0;
+  m_batchAlbums = 0;
 }
 
 CMusicInfoScanner::~CMusicInfoScanner() = default;
@@ -185,6 +195,7 @@ void CMusicInfoScanner::Process()
       }
 
       m_fileCountReader.StopThread();
+      m_tagReader.reset();
 
       m_musicDatabase.EmptyCache();
       
@@ -502,14 +513,19 @@ bool CMusicInfoScanner::DoScan(const std::string& strDirectory)
     items.Sort(SortByLabel, SortOrderAscending);
 
     // and then scan in the new information from tags
-    if (RetrieveMusicInfo(strDirectory, items) > 0)
+    int songsAdded = RetrieveMusicInfo(strDirectory, items);
+    if (songsAdded > 0)
     {
       if (m_handle)
         OnDirectoryScanned(strDirectory);
     }
 
-    // save information about this folder
-    m_musicDatabase.SetPathHash(strDirectory, hash);
+    // save information about this folder along with its songs, unless they weren't all added
+    if (songsAdded >= 0)
+      m_musicDatabase.SetPathHash(strDirectory, hash);
+    m_musicDatabase.CommitBatch();
+    if (songsAdded >= 0)
+      SetArtistArtwork();
   }
   else
   { // path is the same - no need to rescan
@@ -549,11 +565,13 @@ INFO_RET CMusicInfoScanner::ScanTags(const CFileItemList& items, CFileItemList&
 {
   std::vector<std::string> regexps = g_advancedSettings.m_audioExcludeFromScanRegExps;
 
+  // pick the songs first, so their tags are read in the background while
+  // they are added in order below
+  std::vector<CFileItemPtr> songs;
+  std::vector<CFileItemPtr> unread;
+  std::vector<int> readIndex;
   for (int i = 0; i < items.Size(); ++i)
   {
-    if (m_bStop)
-      return INFO_CANCELLED;
-
     CFileItemPtr pItem = items[i];
 
     if (CUtil::ExcludeFileOrFolder(pItem->GetPath(), regexps))
@@ -562,16 +580,40 @@ INFO_RET CMusicInfoScanner::ScanTags(const CFileItemList& items, CFileItemList&
     if (pItem->m_bIsFolder || pItem->IsPlayList() || pItem->IsPicture() || pItem->IsLyrics())
       continue;
 
-    m_currentItem++;
+    songs.push_back(pItem);
+    if (pItem->GetMusicInfoTag()->Loaded())
+      readIndex.push_back(-1);
+    else
+    {
+      readIndex.push_back(unread.size());
+      unread.push_back(pItem);
+    }
+  }
 
-    CMusicInfoTag& tag = *pItem->GetMusicInfoTag();
-    if (!tag.Loaded())
+  if (!unread.empty())
+  {
+    if (!m_tagReader)
+      m_tagReader.reset(new CMusicTagReader(MUSIC_SCAN_TAG_READERS, m_bStop));
+    m_tagReader->Read(unread);
+  }
+
+  for (size_t i = 0; i < songs.size(); ++i)
+  {
+    if (m_bStop)
     {
-      std::unique_ptr<IMusicInfoTagLoader> pLoader (CMusicInfoTagLoaderFactory::CreateLoader(*pItem));
-      if (NULL != pLoader.get())
-        pLoader->Load(pItem->GetPath(), tag);
+      if (m_tagReader)
+        m_tagReader->Cancel();
+      return INFO_CANCELLED;
     }
 
+    CFileItemPtr pItem = songs[i];
+
+    m_currentItem++;
+
+    CMusicInfoTag& tag = *pItem->GetMusicInfoTag();
+    if (readIndex[i] >= 0)
+      m_tagReader->Wait(readIndex[i]);
+
     if (m_handle && m_itemCount>0)
       m_handle->SetPercentage(m_currentItem / (float)m_itemCount * 100);
 
@@ -594,6 +636,21 @@ INFO_RET CMusicInfoScanner::ScanTags(const CFileItemList& items, CFileItemList&
   return INFO_ADDED;
 }
 
+void CMusicInfoScanner::CommitBatch(int songsAdded)
+{
+  m_batchSongs += songsAdded;
+  if (m_batchSongs < MUSIC_SCAN_BATCH_SONGS &&
+      XbmcThreads::SystemClockMillis() - m_batchStart < MUSIC_SCAN_BATCH_TIME)
+    return;
+
+  // the albums committed so far stay even if the rest of the directory is rolled back
+  m_musicDatabase.CommitBatch();
+  m_musicDatabase.BeginBatch();
+  m_batchSongs = 0;
+  m_batchStart = XbmcThreads::SystemClockMillis();
+  m_batchAlbums = m_albumsAdded.size();
+}
+
 static bool SortSongsByTrack(const CSong& song, const CSong& song2)
 {
   return song.iTrack < song2.iTrack;
@@ -795,7 +852,10 @@ int CMusicInfoScanner::RetrieveMusicInfo(const std::string& strDirectory, CFileI
     m_needsCleanup = true;
 
   CFileItemList scannedItems;
-  if (ScanTags(items, scannedItems) == INFO_CANCELLED || scannedItems.Size() == 0)
+  INFO_RET ret = ScanTags(items, scannedItems);
+  if (ret == INFO_CANCELLED)
+    return -1;
+  if (scannedItems.Size() == 0)
     return 0;
 
   VECALBUMS albums;
@@ -816,45 +876,80 @@ int CMusicInfoScanner::RetrieveMusicInfo(const std::string& strDirectory, CFileI
 
   int numAdded = 0;
 
+  // All tags and art have been read, so only database writes happen while the batch is open
+  m_musicDatabase.BeginBatch();
+  m_batchSongs = 0;
+  m_batchStart = XbmcThreads::SystemClockMillis();
+  m_batchAlbums = m_albumsAdded.size();
+  m_artistArtwork.clear();
+  bool complete = true;
+
   // Add all albums to the library
   for (VECALBUMS::iterator album = albums.begin(); album != albums.end(); ++album)
   {
     if (m_bStop)
+    {
+      complete = false;
       break;
+    }
 
     // mark albums without a title as singles
     if (album->strAlbum.empty())
       album->releaseType = CAlbum::Single;
 
     album->strPath = strDirectory;
-    m_musicDatabase.AddAlbum(*album);
+    if (!m_musicDatabase.AddAlbum(*album) || album->idAlbum < 0)
+    {
+      complete = false;
+      break;
+    }
     m_albumsAdded.emplace_back(album->idAlbum);
 
     // Yuk - this is a kludgy way to do what we want to do, but it will work to sort
     // out artist fanart until we can restructure the artist fanart to work more
     // like the album fanart. This has to be done after we've added the album so
     // we have the artist IDs to update, but before we call UpdateDatabaseArtistInfo.
+    // Looking for the artwork reads the folders, so it's left until the batch is committed.
     if (albums.size() == 1 &&
         !album->artistCredits.empty() &&
         !StringUtils::EqualsNoCase(album->artistCredits[0].GetArtist(), "various artists") &&
         !StringUtils::EqualsNoCase(album->artistCredits[0].GetArtist(), "various"))
     {
-      CArtist artist;
-      if (m_musicDatabase.GetArtist(album->artistCredits[0].GetArtistId(), artist))
-      {
-        artist.strPath = URIUtils::GetParentPath(strDirectory);
-        m_musicDatabase.SetArtForItem(artist.idArtist, MediaTypeArtist, GetArtistArtwork(artist));
-      }
+      m_artistArtwork.emplace_back(album->artistCredits[0].GetArtistId(), URIUtils::GetParentPath(strDirectory));
     }
     numAdded += album->songs.size();
+    CommitBatch(album->songs.size());
   }
 
   if (m_handle)
     m_handle->SetTitle(g_localizeStrings.Get(505));
 
+  // don't leave half of a directory behind when the scan was stopped or a write failed
+  if (!complete)
+  {
+    m_musicDatabase.RollbackBatch();
+    m_albumsAdded.resize(m_batchAlbums);
+    m_artistArtwork.clear();
+    return -1;
+  }
+
   return numAdded;
 }
 
+void CMusicInfoScanner::SetArtistArtwork()
+{
+  for (const auto &artistArtwork : m_artistArtwork)
+  {
+    CArtist artist;
+    if (m_musicDatabase.GetArtist(artistArtwork.first, artist))
+    {
+      artist.strPath = artistArtwork.second;
+      m_musicDatabase.SetArtForItem(artist.idArtist, MediaTypeArtist, GetArtistArtwork(artist));
+    }
+  }
+  m_artistArtwork.clear();
+}
+
 void MUSIC_INFO::CMusicInfoScanner::ScrapeInfoAddedAlbums()
 {
   /* Strategy: Having scanned tags, make a list of albums and add them to the library, only then try
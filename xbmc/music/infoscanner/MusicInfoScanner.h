@@ -24,12 +24,16 @@
 #include "music/MusicDatabase.h"
 #include "threads/Thread.h"
 
+#include <memory>
+
 class CAlbum;
 class CArtist;
 class CGUIDialogProgressBarHandle;
 
 namespace MUSIC_INFO
 {
+class CMusicTagReader;
+
 /*! \brief return values from the information lookup functions
  */
 enum INFO_RET 
@@ -176,8 +180,10 @@ protected:
    and populate a new FileItemList with the files that were successfully scanned.
    Add album to library, populate a list of album ids added for possible scraping later.
    Any files which couldn't be scanned (no/bad tags) are discarded in the process.
+   The albums are added in a database batch that is left open for the caller to commit.
    \param items [in] list of FileItems to scan
    \param scannedItems [in] list to populate with the scannedItems
+   \return number of songs added, -1 if the scan was stopped or a write failed and nothing was kept
    */
   int RetrieveMusicInfo(const std::string& strDirectory, CFileItemList& items);
 
@@ -187,10 +193,21 @@ protected:
     Given a list of FileItems, scan in the tags for those FileItems
    and populate a new FileItemList with the files that were successfully scanned.
    Any files which couldn't be scanned (no/bad tags) are discarded in the process.
+   The tags are read on a few threads at once, scannedItems keeps the order of items.
    \param items [in] list of FileItems to scan
    \param scannedItems [in] list to populate with the scannedItems
    */
   INFO_RET ScanTags(const CFileItemList& items, CFileItemList& scannedItems);
+
+  /*! \brief Commit the albums added so far once enough songs or time piled up
+   Only called between the database writes of a directory, never around reading files.
+   \param songsAdded [in] songs of the album just added
+   */
+  void CommitBatch(int songsAdded);
+  /*! \brief Set the artwork of the artists collected by RetrieveMusicInfo
+   Done outside the batch as it looks for the artwork in the folders.
+   */
+  void SetArtistArtwork();
   int GetPathHash(const CFileItemList &items, std::string &hash);
   void GetAlbumArtwork(long id, const CAlbum &artist);
 
@@ -227,5 +244,10 @@ protected:
   std::set<std::string> m_seenPaths;
   int m_flags;
   CThread m_fileCountReader;
+  std::unique_ptr<CMusicTagReader> m_tagReader;
+  int m_batchSongs;
+  unsigned int m_batchStart;
+  size_t m_batchAlbums; ///< Size of m_albumsAdded when the open batch was begun
+  std::vector<std::pair<int, std::string>> m_artistArtwork; ///< Artist ids and paths to look for artwork in
 };
 }
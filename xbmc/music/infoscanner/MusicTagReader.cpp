@@ -0,0 +1,135 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "MusicTagReader.h"
+#include "FileItem.h"
+#include "music/tags/MusicInfoTag.h"
+#include "music/tags/MusicInfoTagLoaderFactory.h"
+#include "threads/SingleLock.h"
+
+using namespace MUSIC_INFO;
+
+CMusicTagReader::CMusicTagReader(unsigned int threads, const std::atomic<bool>& stop)
+  : m_stop(stop),
+    m_workEvent(true)
+{
+  for (unsigned int i = 0; i < threads; i++)
+  {
+    m_threads.emplace_back(new CThread(this, "MusicTagReader"));
+    m_threads.back()->Create();
+  }
+}
+
+CMusicTagReader::~CMusicTagReader()
+{
+  {
+    CSingleLock lock(m_section);
+    m_quit = true;
+    m_items.clear();
+    m_workEvent.Set();
+  }
+  for (auto& thread : m_threads)
+    thread->StopThread(true);
+}
+
+void CMusicTagReader::Read(const std::vector<CFileItemPtr>& items)
+{
+  Cancel();
+
+  CSingleLock lock(m_section);
+  m_items = items;
+  m_done.assign(items.size(), false);
+  m_next = 0;
+  m_workEvent.Set();
+}
+
+void CMusicTagReader::Wait(size_t index)
+{
+  while (true)
+  {
+    {
+      CSingleLock lock(m_section);
+      if (index >= m_done.size() || m_done[index])
+        return;
+    }
+    m_doneEvent.Wait();
+  }
+}
+
+void CMusicTagReader::Cancel()
+{
+  while (true)
+  {
+    {
+      CSingleLock lock(m_section);
+      m_items.clear();
+      m_done.clear();
+      m_next = 0;
+      if (m_busy == 0)
+        return;
+    }
+    m_doneEvent.Wait();
+  }
+}
+
+void CMusicTagReader::Run()
+{
+  while (true)
+  {
+    CFileItemPtr item;
+    size_t index = 0;
+    {
+      CSingleLock lock(m_section);
+      if (m_quit)
+        return;
+      if (m_next < m_items.size())
+      {
+        index = m_next++;
+        item = m_items[index];
+        m_busy++;
+      }
+      else
+        m_workEvent.Reset();
+    }
+
+    if (!item)
+    {
+      m_workEvent.Wait();
+      continue;
+    }
+
+    if (!m_stop)
+    {
+      CMusicInfoTag& tag = *item->GetMusicInfoTag();
+      std::unique_ptr<IMusicInfoTagLoader> pLoader(CMusicInfoTagLoaderFactory::CreateLoader(*item));
+      if (NULL != pLoader.get())
+        pLoader->Load(item->GetPath(), tag);
+    }
+
+    {
+      CSingleLock lock(m_section);
+      m_busy--;
+      // the queue may have been dropped meanwhile
+      if (index < m_items.size() && m_items[index] == item)
+        m_done[index] = true;
+    }
+    m_doneEvent.Set();
+  }
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "threads/Thread.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+class CFileItem;
+typedef std::shared_ptr<CFileItem> CFileItemPtr;
+
+namespace MUSIC_INFO
+{
+/*!
+ \brief Reads the tags of music files on a few threads of its own.
+
+ Files are handed to the threads in the order they were queued, so the first
+ ones are ready first while the later ones are still being read. Once the stop
+ flag is raised, files not yet started are skipped.
+ All calls are expected from the same thread.
+ */
+class CMusicTagReader : private IRunnable
+{
+public:
+  /*!
+   \param threads number of files read at the same time
+   \param stop flag to skip the remaining files on
+   */
+  CMusicTagReader(unsigned int threads, const std::atomic<bool>& stop);
+  ~CMusicTagReader() override;
+
+  /*! \brief Start reading the tags of the given items.
+   Whatever was queued before is dropped.
+   */
+  void Read(const std::vector<CFileItemPtr>& items);
+
+  /*! \brief Wait until the tag of the index-th queued item was read or skipped.
+   */
+  void Wait(size_t index);
+
+  /*! \brief Drop the items not yet started and wait for those being read.
+   */
+  void Cancel();
+
+private:
+  void Run() override;
+
+  const std::atomic<bool>& m_stop;
+  std::vector<std::unique_ptr<CThread>> m_threads;
+
+  CCriticalSection m_section;
+  std::vector<CFileItemPtr> m_items;
+  std::vector<bool> m_done;
+  size_t m_next = 0;
+  unsigned int m_busy = 0;
+  bool m_quit = false;
+  CEvent m_workEvent;
+  CEvent m_doneEvent;
+};
+}
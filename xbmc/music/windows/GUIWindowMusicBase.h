@@ -72,6 +72,7 @@ protected:
   void UpdateButtons() override;
 
   bool GetDirectory(const std::string &strDirectory, CFileItemList &items) override;
+  CBackgroundInfoLoader* GetBackgroundLoader() override { return &m_thumbLoader; }
   virtual void OnRetrieveMusicInfo(CFileItemList& items);
   void OnPrepareFileItems(CFileItemList &items) override;
   void AddItemToPlayList(const CFileItemPtr &pItem, CFileItemList &queuedItems);
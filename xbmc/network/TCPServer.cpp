@@ -19,14 +19,24 @@
  */
 
 #include "TCPServer.h"
+#include <algorithm>
 #include <stdio.h>
 #include <stdlib.h>
 #include <memory.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
+#if defined(TARGET_LINUX)
+#include <sys/epoll.h>
+#elif defined(TARGET_POSIX)
+#include <poll.h>
+#endif
+#if defined(TARGET_POSIX)
+#include <fcntl.h>
+#endif
 
 #include "settings/AdvancedSettings.h"
 #include "interfaces/json-rpc/JSONRPC.h"
+#include "interfaces/Announcement.h"
 #include "interfaces/AnnouncementManager.h"
 #include "utils/log.h"
 #include "utils/Variant.h"
@@ -61,9 +71,50 @@ using namespace JSONRPC;
 using namespace ANNOUNCEMENT;
 
 #define RECEIVEBUFFER 1024
+#define MAX_EVENTS    64
+#define LISTEN_BACKLOG 128
+
+// number of requests executed at the same time, over all clients
+#define REQUEST_WORKERS     4
+// per client limits above which no more requests are read from the client
+#define MAX_QUEUED_REQUESTS 16
+#define MAX_QUEUED_OUTPUT   (1024 * 1024)
+
+#if defined(TARGET_WINDOWS)
+#define poll WSAPoll
+#endif
 
 CTCPServer *CTCPServer::ServerInstance = NULL;
 
+static bool WouldBlock()
+{
+#if defined(TARGET_WINDOWS)
+  return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+  return errno == EAGAIN || errno == EWOULDBLOCK;
+#endif
+}
+
+// WSAPoll reports its errors through WSAGetLastError() and leaves errno alone
+static bool Interrupted()
+{
+#if defined(TARGET_WINDOWS)
+  return WSAGetLastError() == WSAEINTR;
+#else
+  return errno == EINTR;
+#endif
+}
+
+static void SetNonBlocking(SOCKET fd)
+{
+#if defined(TARGET_WINDOWS)
+  u_long nonblocking = 1;
+  ioctlsocket(fd, FIONBIO, &nonblocking);
+#else
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+#endif
+}
+
 bool CTCPServer::StartServer(int port, bool nonlocal)
 {
   StopServer(true);
@@ -112,11 +163,14 @@ bool CTCPServer::IsRunning()
   return ((CThread*)ServerInstance)->IsRunning();
 }
 
-CTCPServer::CTCPServer(int port, bool nonlocal) : CThread("TCPServer")
+CTCPServer::CTCPServer(int port, bool nonlocal) : CThread("TCPServer"),
+  m_requestQueue(false, REQUEST_WORKERS, CJob::PRIORITY_DEDICATED),
+  m_pendingJobs(0)
 {
   m_port = port;
   m_nonlocal = nonlocal;
   m_sdpd = NULL;
+  m_epoll = -1;
 }
 
 void CTCPServer::Process()
@@ -125,112 +179,243 @@ void CTCPServer::Process()
 
   while (!m_bStop)
   {
-    SOCKET          max_fd = 0;
-    fd_set          rfds;
-    struct timeval  to     = {1, 0};
-    FD_ZERO(&rfds);
-
+#if defined(TARGET_LINUX)
+    struct epoll_event events[MAX_EVENTS];
+    int res = epoll_wait(m_epoll, events, MAX_EVENTS, 1000);
+#else
+    std::vector<struct pollfd> fds;
     for (std::vector<SOCKET>::iterator it = m_servers.begin(); it != m_servers.end(); ++it)
     {
-      FD_SET(*it, &rfds);
-      if ((intptr_t)*it > (intptr_t)max_fd)
-        max_fd = *it;
+      struct pollfd fd = {};
+      fd.fd = *it;
+      fd.events = POLLIN;
+      fds.push_back(fd);
     }
 
-    for (unsigned int i = 0; i < m_connections.size(); i++)
     {
-      FD_SET(m_connections[i]->m_socket, &rfds);
-      if ((intptr_t)m_connections[i]->m_socket > (intptr_t)max_fd)
-        max_fd = m_connections[i]->m_socket;
+      CSingleLock lock(m_connectionsSection);
+      for (Connections::iterator it = m_connections.begin(); it != m_connections.end(); ++it)
+      {
+        struct pollfd fd = {};
+        fd.fd = it->first;
+        fd.events = (it->second->WantsInput() ? POLLIN : 0) |
+                    (it->second->GetPendingOutput() > 0 ? POLLOUT : 0);
+        fds.push_back(fd);
+      }
     }
 
-    int res = select((intptr_t)max_fd+1, &rfds, NULL, NULL, &to);
+    // output queued by the workers is only noticed when the poll returns,
+    // so keep the timeout short
+    int res = poll(fds.data(), fds.size(), 100);
+#endif
+
     if (res < 0)
     {
-      CLog::Log(LOGERROR, "JSONRPC Server: Select failed");
+      if (Interrupted())
+        continue;
+
+      CLog::Log(LOGERROR, "JSONRPC Server: Poll failed");
       Sleep(1000);
       Initialize();
+      continue;
     }
-    else if (res > 0)
+
+#if defined(TARGET_LINUX)
+    for (int i = 0; i < res; i++)
     {
-      for (int i = m_connections.size() - 1; i >= 0; i--)
-      {
-        int socket = m_connections[i]->m_socket;
-        if (FD_ISSET(socket, &rfds))
-        {
-          char buffer[RECEIVEBUFFER] = {};
-          int  nread = 0;
-          nread = recv(socket, (char*)&buffer, RECEIVEBUFFER, 0);
-          bool close = false;
-          if (nread > 0)
-          {
-            std::string response;
-            if (m_connections[i]->IsNew())
-            {
-              CWebSocket *websocket = CWebSocketManager::Handle(buffer, nread, response);
-
-              if (!response.empty())
-                m_connections[i]->Send(response.c_str(), response.size());
-
-              if (websocket != NULL)
-              {
-                // Replace the CTCPClient with a CWebSocketClient
-                CWebSocketClient *websocketClient = new CWebSocketClient(websocket, *(m_connections[i]));
-                delete m_connections[i];
-                m_connections.erase(m_connections.begin() + i);
-                m_connections.insert(m_connections.begin() + i, websocketClient);
-              }
-            }
-
-            if (response.size() <= 0)
-              m_connections[i]->PushBuffer(this, buffer, nread);
-
-            close = m_connections[i]->Closing();
-          }
-          else
-            close = true;
-
-          if (close)
-          {
-            CLog::Log(LOGINFO, "JSONRPC Server: Disconnection detected");
-            m_connections[i]->Disconnect();
-            delete m_connections[i];
-            m_connections.erase(m_connections.begin() + i);
-          }
-        }
-      }
+      const uint32_t flags = events[i].events;
+      if (!HandleSocket(events[i].data.fd, (flags & (EPOLLIN | EPOLLHUP)) != 0,
+                        (flags & EPOLLOUT) != 0, (flags & EPOLLERR) != 0))
+        break;
+    }
+#else
+    for (unsigned int i = 0; i < fds.size() && res > 0; i++)
+    {
+      const int flags = fds[i].revents;
+      if (flags == 0)
+        continue;
 
-      for (std::vector<SOCKET>::iterator it = m_servers.begin(); it != m_servers.end(); ++it)
-      {
-        if (FD_ISSET(*it, &rfds))
-        {
-          CLog::Log(LOGDEBUG, "JSONRPC Server: New connection detected");
-          CTCPClient *newconnection = new CTCPClient();
-          newconnection->m_socket = accept(*it, (sockaddr*)&newconnection->m_cliaddr, &newconnection->m_addrlen);
-
-          if (newconnection->m_socket == INVALID_SOCKET)
-          {
-            CLog::Log(LOGERROR, "JSONRPC Server: Accept of new connection failed: %d", errno);
-            if (EBADF == errno)
-            {
-              Sleep(1000);
-              Initialize();
-              break;
-            }
-          }
-          else
-          {
-            CLog::Log(LOGINFO, "JSONRPC Server: New connection added");
-            m_connections.push_back(newconnection);
-          }
-        }
-      }
+      res--;
+      if (!HandleSocket(fds[i].fd, (flags & (POLLIN | POLLHUP)) != 0,
+                        (flags & POLLOUT) != 0, (flags & (POLLERR | POLLNVAL)) != 0))
+        break;
     }
+#endif
   }
 
   Deinitialize();
 }
 
+bool CTCPServer::HandleSocket(SOCKET fd, bool readable, bool writable, bool failed)
+{
+  if (IsServerSocket(fd))
+    return !readable || AcceptConnection(fd);
+
+  std::shared_ptr<CTCPClient> client;
+  {
+    CSingleLock lock(m_connectionsSection);
+    Connections::iterator it = m_connections.find(fd);
+    if (it == m_connections.end())
+      return true;
+    client = it->second;
+  }
+
+  bool close = failed;
+  if (!close && writable)
+    close = !client->SendPending();
+  if (!close && readable)
+    close = !ReadFromClient(client);
+
+  if (close)
+  {
+    CLog::Log(LOGINFO, "JSONRPC Server: Disconnection detected");
+    RemoveConnection(client);
+  }
+  else
+    UpdateEvents(client.get());
+
+  return true;
+}
+
+bool CTCPServer::AcceptConnection(SOCKET server)
+{
+  CLog::Log(LOGDEBUG, "JSONRPC Server: New connection detected");
+  std::shared_ptr<CTCPClient> newconnection(new CTCPClient());
+  newconnection->m_socket = accept(server, (sockaddr*)&newconnection->m_cliaddr, &newconnection->m_addrlen);
+
+  if (newconnection->m_socket == INVALID_SOCKET)
+  {
+    CLog::Log(LOGERROR, "JSONRPC Server: Accept of new connection failed: %d", errno);
+    if (EBADF == errno)
+    {
+      Sleep(1000);
+      Initialize();
+      return false;
+    }
+    return true;
+  }
+
+  SetNonBlocking(newconnection->m_socket);
+  CLog::Log(LOGINFO, "JSONRPC Server: New connection added");
+
+  {
+    CSingleLock lock(m_connectionsSection);
+    m_connections[newconnection->m_socket] = newconnection;
+  }
+
+#if defined(TARGET_LINUX)
+  struct epoll_event event = {};
+  event.events = EPOLLIN;
+  event.data.fd = newconnection->m_socket;
+  newconnection->m_events = EPOLLIN;
+  if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, newconnection->m_socket, &event) < 0)
+  {
+    CLog::Log(LOGERROR, "JSONRPC Server: Failed to watch new connection: %d", errno);
+    RemoveConnection(newconnection);
+  }
+#endif
+  return true;
+}
+
+bool CTCPServer::ReadFromClient(std::shared_ptr<CTCPClient> &client)
+{
+  char buffer[RECEIVEBUFFER] = {};
+  int  nread = recv(client->m_socket, (char*)&buffer, RECEIVEBUFFER, 0);
+  if (nread < 0 && WouldBlock())
+    return true;
+  if (nread <= 0)
+    return false;
+
+  std::string response;
+  if (client->IsNew())
+  {
+    CWebSocket *websocket = CWebSocketManager::Handle(buffer, nread, response);
+
+    if (!response.empty())
+      client->Send(response.c_str(), response.size());
+
+    if (websocket != NULL)
+    {
+      // Replace the CTCPClient with a CWebSocketClient. The old client
+      // gives up the socket so late announcements can't reach it unframed.
+      CSingleLock clientLock(client->m_critSection);
+      std::shared_ptr<CTCPClient> websocketClient(new CWebSocketClient(websocket, *client));
+      client->m_socket = INVALID_SOCKET;
+      clientLock.Leave();
+
+      CSingleLock lock(m_connectionsSection);
+      m_connections[websocketClient->m_socket] = websocketClient;
+      client = websocketClient;
+    }
+  }
+
+  if (response.size() <= 0)
+    client->PushBuffer(this, buffer, nread);
+
+  return !client->Closing();
+}
+
+void CTCPServer::RemoveConnection(const std::shared_ptr<CTCPClient> &client)
+{
+  SOCKET fd;
+  {
+    CSingleLock lock(client->m_critSection);
+    fd = client->m_socket;
+#if defined(TARGET_LINUX)
+    // the socket may stay open if a websocket close handshake is still pending
+    if (fd != INVALID_SOCKET)
+      epoll_ctl(m_epoll, EPOLL_CTL_DEL, fd, NULL);
+#endif
+  }
+
+  client->Disconnect();
+
+  CSingleLock lock(m_connectionsSection);
+  Connections::iterator it = m_connections.find(fd);
+  if (it != m_connections.end() && it->second == client)
+    m_connections.erase(it);
+}
+
+void CTCPServer::UpdateEvents(CTCPClient *client)
+{
+#if defined(TARGET_LINUX)
+  CSingleLock lock(client->m_critSection);
+  if (client->m_socket == INVALID_SOCKET)
+    return;
+
+  int events = 0;
+  if (client->WantsInput())
+    events |= EPOLLIN;
+  if (client->GetPendingOutput() > 0)
+    events |= EPOLLOUT;
+  if (events == client->m_events)
+    return;
+
+  struct epoll_event event = {};
+  event.events = events;
+  event.data.fd = client->m_socket;
+  if (epoll_ctl(m_epoll, EPOLL_CTL_MOD, client->m_socket, &event) == 0)
+    client->m_events = events;
+#endif
+}
+
+bool CTCPServer::IsServerSocket(SOCKET fd) const
+{
+  return std::find(m_servers.begin(), m_servers.end(), fd) != m_servers.end();
+}
+
+void CTCPServer::QueueRequest(CTCPClient *client, const std::string &request)
+{
+  if (client->QueueRequest(request))
+    QueueJob(client->shared_from_this());
+}
+
+void CTCPServer::QueueJob(const std::shared_ptr<CTCPClient> &client)
+{
+  m_pendingJobs++;
+  m_requestQueue.AddJob(new CRequestJob(this, client));
+}
+
 bool CTCPServer::PrepareDownload(const char *path, CVariant &details, std::string &protocol)
 {
   return false;
@@ -248,17 +433,39 @@ int CTCPServer::GetCapabilities()
 
 void CTCPServer::Announce(AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data)
 {
-  std::string str = IJSONRPCAnnouncer::AnnouncementToJSONRPC(flag, sender, message, data, g_advancedSettings.m_jsonOutputCompact);
+  OnAnnouncement(CAnnouncement(flag, sender, message, data));
+}
 
-  for (unsigned int i = 0; i < m_connections.size(); i++)
+void CTCPServer::OnAnnouncement(const CAnnouncement &announcement)
+{
+  AnnouncementFlag flag = announcement.GetFlag();
+  const std::string &str = announcement.GetJSONRPC(g_advancedSettings.m_jsonOutputCompact);
+
+  std::vector<std::shared_ptr<CTCPClient> > clients;
+  {
+    CSingleLock lock(m_connectionsSection);
+    clients.reserve(m_connections.size());
+    for (Connections::iterator it = m_connections.begin(); it != m_connections.end(); ++it)
+      clients.push_back(it->second);
+  }
+
+  for (std::vector<std::shared_ptr<CTCPClient> >::iterator it = clients.begin(); it != clients.end(); ++it)
   {
     {
-      CSingleLock lock (m_connections[i]->m_critSection);
-      if ((m_connections[i]->GetAnnouncementFlags() & flag) == 0)
+      CSingleLock lock ((*it)->m_critSection);
+      if (((*it)->GetAnnouncementFlags() & flag) == 0)
+        continue;
+
+      // don't let a client that stopped reading pile up announcements
+      if ((*it)->GetPendingOutput() >= MAX_QUEUED_OUTPUT)
+      {
+        CLog::Log(LOGDEBUG, "JSONRPC Server: Dropping announcement for slow client");
         continue;
+      }
     }
 
-    m_connections[i]->Send(str.c_str(), str.size());
+    (*it)->Send(str.c_str(), str.size());
+    UpdateEvents(it->get());
   }
 }
 
@@ -273,6 +480,24 @@ bool CTCPServer::Initialize()
 
   if (started)
   {
+#if defined(TARGET_LINUX)
+    m_epoll = epoll_create1(EPOLL_CLOEXEC);
+    if (m_epoll < 0)
+    {
+      CLog::Log(LOGERROR, "JSONRPC Server: Failed to create epoll instance: %d", errno);
+      Deinitialize();
+      return false;
+    }
+
+    for (std::vector<SOCKET>::iterator it = m_servers.begin(); it != m_servers.end(); ++it)
+    {
+      struct epoll_event event = {};
+      event.events = EPOLLIN;
+      event.data.fd = *it;
+      epoll_ctl(m_epoll, EPOLL_CTL_ADD, *it, &event);
+    }
+#endif
+
     CAnnouncementManager::GetInstance().AddAnnouncer(this);
     CLog::Log(LOGINFO, "JSONRPC Server: Successfully initialized");
     return true;
@@ -469,7 +694,7 @@ bool CTCPServer::InitializeTCP()
 
   Deinitialize();
 
-  if ((fd = CreateTCPServerSocket(m_port, !m_nonlocal, 10, "JSONRPC")) == INVALID_SOCKET)
+  if ((fd = CreateTCPServerSocket(m_port, !m_nonlocal, LISTEN_BACKLOG, "JSONRPC")) == INVALID_SOCKET)
     return false;
 
   m_servers.push_back(fd);
@@ -478,13 +703,25 @@ bool CTCPServer::InitializeTCP()
 
 void CTCPServer::Deinitialize()
 {
-  for (unsigned int i = 0; i < m_connections.size(); i++)
   {
-    m_connections[i]->Disconnect();
-    delete m_connections[i];
+    CSingleLock lock(m_connectionsSection);
+    for (Connections::iterator it = m_connections.begin(); it != m_connections.end(); ++it)
+      it->second->Disconnect();
+
+    m_connections.clear();
   }
 
-  m_connections.clear();
+  // running requests still reference this server
+  m_requestQueue.CancelJobs();
+  while (true)
+  {
+    {
+      CSingleLock lock(m_jobsSection);
+      if (m_pendingJobs == 0)
+        break;
+    }
+    m_jobsFinished.Wait();
+  }
 
   for (unsigned int i = 0; i < m_servers.size(); i++)
     closesocket(m_servers[i]);
@@ -497,6 +734,12 @@ void CTCPServer::Deinitialize()
   m_sdpd = NULL;
 #endif
 
+#if defined(TARGET_LINUX)
+  if (m_epoll >= 0)
+    close(m_epoll);
+  m_epoll = -1;
+#endif
+
   CAnnouncementManager::GetInstance().RemoveAnnouncer(this);
 }
 
@@ -509,6 +752,9 @@ CTCPServer::CTCPClient::CTCPClient()
   m_endBrackets = 0;
   m_beginChar = 0;
   m_endChar = 0;
+  m_outputOffset = 0;
+  m_processing = false;
+  m_events = 0;
 
   m_addrlen = sizeof(m_cliaddr);
 }
@@ -542,12 +788,101 @@ bool CTCPServer::CTCPClient::SetAnnouncementFlags(int flags)
 
 void CTCPServer::CTCPClient::Send(const char *data, unsigned int size)
 {
-  unsigned int sent = 0;
-  do
+  CSingleLock lock (m_critSection);
+  if (m_socket == INVALID_SOCKET)
+    return;
+
+  m_output.append(data, size);
+  if (!WriteToSocket())
   {
-    CSingleLock lock (m_critSection);
-    sent += send(m_socket, data + sent, size - sent, 0);
-  } while (sent < size);
+    // the event loop notices the broken connection and cleans up
+    m_output.clear();
+    m_outputOffset = 0;
+  }
+}
+
+bool CTCPServer::CTCPClient::SendPending()
+{
+  CSingleLock lock (m_critSection);
+  if (m_socket == INVALID_SOCKET)
+    return false;
+
+  return WriteToSocket();
+}
+
+bool CTCPServer::CTCPClient::WriteToSocket()
+{
+  while (m_outputOffset < m_output.size())
+  {
+    int sent = send(m_socket, m_output.data() + m_outputOffset, m_output.size() - m_outputOffset, 0);
+    if (sent < 0 && WouldBlock())
+      break;
+    if (sent <= 0)
+      return false;
+
+    m_outputOffset += sent;
+  }
+
+  if (m_outputOffset == m_output.size())
+  {
+    m_output.clear();
+    m_outputOffset = 0;
+  }
+  else if (m_outputOffset > m_output.size() / 2)
+  {
+    m_output.erase(0, m_outputOffset);
+    m_outputOffset = 0;
+  }
+
+  return true;
+}
+
+size_t CTCPServer::CTCPClient::GetPendingOutput()
+{
+  CSingleLock lock (m_critSection);
+  return m_output.size() - m_outputOffset;
+}
+
+bool CTCPServer::CTCPClient::WantsInput()
+{
+  CSingleLock lock (m_critSection);
+  return m_requests.size() < MAX_QUEUED_REQUESTS && m_output.size() - m_outputOffset < MAX_QUEUED_OUTPUT;
+}
+
+bool CTCPServer::CTCPClient::QueueRequest(const std::string &request)
+{
+  CSingleLock lock (m_critSection);
+  m_requests.push_back(request);
+  if (m_processing)
+    return false;
+
+  m_processing = true;
+  return true;
+}
+
+bool CTCPServer::CTCPClient::NextRequest(std::string &request)
+{
+  CSingleLock lock (m_critSection);
+  if (m_requests.empty())
+    return false;
+
+  request.swap(m_requests.front());
+  m_requests.pop_front();
+  return true;
+}
+
+bool CTCPServer::CTCPClient::RequestDone()
+{
+  CSingleLock lock (m_critSection);
+  if (m_socket == INVALID_SOCKET)
+    m_requests.clear();
+
+  if (m_requests.empty())
+  {
+    m_processing = false;
+    return false;
+  }
+  return true;
 }
 
 void CTCPServer::CTCPClient::PushBuffer(CTCPServer *host, const char *buffer, int length)
@@ -578,8 +913,7 @@ void CTCPServer::CTCPClient::PushBuffer(CTCPServer *host, const char *buffer, in
         m_endBrackets++;
       if (m_beginBrackets > 0 && m_endBrackets > 0 && m_beginBrackets == m_endBrackets)
       {
-        std::string line = CJSONRPC::MethodCall(m_buffer, host, this);
-        Send(line.c_str(), line.size());
+        host->QueueRequest(this, m_buffer);
         m_beginChar = m_beginBrackets = m_endBrackets = 0;
         m_buffer.clear();
       }
@@ -610,6 +944,11 @@ void CTCPServer::CTCPClient::Copy(const CTCPClient& client)
   m_beginChar         = client.m_beginChar;
   m_endChar           = client.m_endChar;
   m_buffer            = client.m_buffer;
+  m_output            = client.m_output;
+  m_outputOffset      = client.m_outputOffset;
+  m_requests          = client.m_requests;
+  m_processing        = client.m_processing;
+  m_events            = client.m_events;
 }
 
 CTCPServer::CWebSocketClient::CWebSocketClient(CWebSocket *websocket)
@@ -645,6 +984,8 @@ CTCPServer::CWebSocketClient& CTCPServer::CWebSocketClient::operator=(const CWeb
 
 void CTCPServer::CWebSocketClient::Send(const char *data, unsigned int size)
 {
+  // keep the frames of one message together when several threads send
+  CSingleLock lock (m_critSection);
   const CWebSocketMessage *msg = m_websocket->Send(WebSocketTextFrame, data, size);
   if (msg == NULL || !msg->IsComplete())
     return;
@@ -700,3 +1041,33 @@ void CTCPServer::CWebSocketClient::Disconnect()
   }
 }
 
+CTCPServer::CRequestJob::CRequestJob(CTCPServer *host, const std::shared_ptr<CTCPClient> &client)
+  : m_host(host),
+    m_client(client)
+{ }
+
+CTCPServer::CRequestJob::~CRequestJob()
+{
+  // the host may be gone as soon as the lock is released
+  CSingleLock lock(m_host->m_jobsSection);
+  if (--m_host->m_pendingJobs == 0)
+    m_host->m_jobsFinished.Set();
+}
+
+bool CTCPServer::CRequestJob::DoWork()
+{
+  std::string request;
+  if (m_client->NextRequest(request))
+  {
+    std::string response = CJSONRPC::MethodCall(request, m_host, m_client.get());
+    m_client->Send(response.c_str(), response.size());
+  }
+
+  // give other clients a turn before handling the next request of this one
+  if (m_client->RequestDone())
+    m_host->QueueJob(m_client);
+
+  // output may be waiting and the client may accept input again
+  m_host->UpdateEvents(m_client.get());
+  return true;
+}
@@ -19,6 +19,11 @@
  *
  */
 
+#include <atomic>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
 #include <vector>
 #include <sys/socket.h>
 
@@ -27,13 +32,24 @@
 #include "interfaces/json-rpc/IJSONRPCAnnouncer.h"
 #include "interfaces/json-rpc/ITransportLayer.h"
 #include "threads/CriticalSection.h"
+#include "threads/Event.h"
 #include "threads/Thread.h"
+#include "utils/JobManager.h"
 #include "websocket/WebSocket.h"
 
 class CVariant;
 
 namespace JSONRPC
 {
+  /*!
+   \brief JSON-RPC server for raw TCP, WebSocket and bluetooth clients.
+
+   A single event loop thread accepts connections, reads from the non-blocking sockets
+   and splits the input into requests. The requests are executed on a bounded worker
+   pool, one request per client at a time so responses keep their order. Responses
+   and announcements are written directly while the socket accepts data, the rest is
+   queued per client and written by the event loop once the socket becomes writable.
+   */
   class CTCPServer : public ITransportLayer, public JSONRPC::IJSONRPCAnnouncer, public CThread
   {
   public:
@@ -46,6 +62,7 @@ namespace JSONRPC
     int GetCapabilities() override;
 
     void Announce(ANNOUNCEMENT::AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data) override;
+    void OnAnnouncement(const ANNOUNCEMENT::CAnnouncement &announcement) override;
   protected:
     void Process() override;
   private:
@@ -55,7 +72,7 @@ namespace JSONRPC
     bool InitializeTCP();
     void Deinitialize();
 
-    class CTCPClient : public IClient
+    class CTCPClient : public IClient, public std::enable_shared_from_this<CTCPClient>
     {
     public:
       CTCPClient();
@@ -69,6 +86,9 @@ namespace JSONRPC
       int GetAnnouncementFlags() override;
       bool SetAnnouncementFlags(int flags) override;
 
+      /*! \brief Queue data for the client and write as much of it as the socket takes
+       without blocking. May be called from any thread.
+       */
       virtual void Send(const char *data, unsigned int size);
       virtual void PushBuffer(CTCPServer *host, const char *buffer, int length);
       virtual void Disconnect();
@@ -76,6 +96,30 @@ namespace JSONRPC
       virtual bool IsNew() const { return m_new; }
       virtual bool Closing() const { return false; }
 
+      /*! \brief Write queued output, called by the event loop when the socket is writable.
+       \return false if the connection failed
+       */
+      bool SendPending();
+      size_t GetPendingOutput();
+      /*! \brief Whether the event loop should read more requests from this client, false while
+       too many requests or too much output are waiting for it.
+       */
+      bool WantsInput();
+
+      /*! \brief Queue a complete request for execution.
+       \return true if the caller must schedule a job to process it
+       */
+      bool QueueRequest(const std::string &request);
+      bool NextRequest(std::string &request);
+      /*! \brief Called by the job after handling a request.
+       \return true if more requests are waiting and another job must be scheduled,
+       false if the client went idle
+       */
+      bool RequestDone();
+
+      /*! \brief Events last registered with the event loop, guarded by m_critSection */
+      int m_events;
+
       SOCKET m_socket;
       sockaddr_storage m_cliaddr;
       socklen_t m_addrlen;
@@ -83,12 +127,17 @@ namespace JSONRPC
 
     protected:
       void Copy(const CTCPClient& client);
+      bool WriteToSocket();
     private:
       bool m_new;
       int m_announcementflags;
       int m_beginBrackets, m_endBrackets;
       char m_beginChar, m_endChar;
       std::string m_buffer;
+      std::string m_output;
+      size_t m_outputOffset;
+      std::deque<std::string> m_requests;
+      bool m_processing;
     };
 
     class CWebSocketClient : public CTCPClient
@@ -111,11 +160,43 @@ namespace JSONRPC
       CWebSocket *m_websocket;
     };
 
-    std::vector<CTCPClient*> m_connections;
+    class CRequestJob : public CJob
+    {
+    public:
+      CRequestJob(CTCPServer *host, const std::shared_ptr<CTCPClient> &client);
+      ~CRequestJob() override;
+      bool DoWork() override;
+      const char *GetType() const override { return "jsonrpcrequest"; }
+      // a client never has more than one job queued, and a job may queue its successor while running
+      bool operator==(const CJob *job) const override { return this == job; }
+    private:
+      CTCPServer *m_host;
+      std::shared_ptr<CTCPClient> m_client;
+    };
+
+    typedef std::map<SOCKET, std::shared_ptr<CTCPClient> > Connections;
+
+    void QueueRequest(CTCPClient *client, const std::string &request);
+    void QueueJob(const std::shared_ptr<CTCPClient> &client);
+    bool HandleSocket(SOCKET fd, bool readable, bool writable, bool failed);
+    bool AcceptConnection(SOCKET server);
+    bool ReadFromClient(std::shared_ptr<CTCPClient> &client);
+    void RemoveConnection(const std::shared_ptr<CTCPClient> &client);
+    void UpdateEvents(CTCPClient *client);
+    bool IsServerSocket(SOCKET fd) const;
+
+    Connections m_connections;
+    CCriticalSection m_connectionsSection;
     std::vector<SOCKET> m_servers;
     int m_port;
     bool m_nonlocal;
     void* m_sdpd;
+    int m_epoll;
+
+    CJobQueue m_requestQueue;
+    std::atomic<int> m_pendingJobs;
+    CCriticalSection m_jobsSection;
+    CEvent m_jobsFinished; ///< Set when the last pending request job has finished
 
     static CTCPServer *ServerInstance;
   };
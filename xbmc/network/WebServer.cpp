@@ -113,6 +113,25 @@ static MHD_Response* create_response(size_t size, void* data, int free, int copy
 #endif
 }
 
+// compares If-None-Match against an entity tag, weak tags match their strong counterparts
+static bool MatchesEntityTag(const std::string& ifNoneMatch, const std::string& entityTag)
+{
+  std::vector<std::string> entityTags = StringUtils::Split(ifNoneMatch, ",");
+  for (auto tag : entityTags)
+  {
+    tag = StringUtils::Trim(tag);
+    if (tag == "*")
+      return true;
+
+    if (StringUtils::StartsWith(tag, "W/"))
+      tag.erase(0, 2);
+    if (tag == entityTag)
+      return true;
+  }
+
+  return false;
+}
+
 int CWebServer::AskForAuthentication(const HTTPRequest& request) const
 {
   struct MHD_Response *response = create_response(0, nullptr, MHD_NO, MHD_NO);
@@ -225,6 +244,14 @@ int CWebServer::HandlePartialRequest(struct MHD_Connection *connection, Connecti
         if (handler->CanBeCached())
         {
           bool cacheable = IsRequestCacheable(request);
+          bool notModified = false;
+
+          // handle If-None-Match (but only if the response is cacheable)
+          std::string entityTag;
+          handler->GetEntityTag(entityTag);
+          std::string ifNoneMatch = HTTPRequestHandlerUtils::GetRequestHeaderValue(connection, MHD_HEADER_KIND, MHD_HTTP_HEADER_IF_NONE_MATCH);
+          if (cacheable && !entityTag.empty() && MatchesEntityTag(ifNoneMatch, entityTag))
+            notModified = true;
 
           CDateTime lastModified;
           if (handler->GetLastModifiedDate(lastModified) && lastModified.IsValid())
@@ -235,28 +262,31 @@ int CWebServer::HandlePartialRequest(struct MHD_Connection *connection, Connecti
 
             CDateTime ifModifiedSinceDate;
             CDateTime ifUnmodifiedSinceDate;
-            // handle If-Modified-Since (but only if the response is cacheable)
-            if (cacheable &&
+            // handle If-Modified-Since (but only if the response is cacheable and If-None-Match wasn't sent)
+            if (cacheable && ifNoneMatch.empty() &&
               ifModifiedSinceDate.SetFromRFC1123DateTime(ifModifiedSince) &&
               lastModified.GetAsUTCDateTime() <= ifModifiedSinceDate)
-            {
-              struct MHD_Response *response = create_response(0, nullptr, MHD_NO, MHD_NO);
-              if (response == nullptr)
-              {
-                CLog::Log(LOGERROR, "CWebServer[%hu]: failed to create a HTTP 304 response", m_port);
-                return MHD_NO;
-              }
-
-              return FinalizeRequest(handler, MHD_HTTP_NOT_MODIFIED, response);
-            }
+              notModified = true;
             // handle If-Unmodified-Since
             else if (ifUnmodifiedSinceDate.SetFromRFC1123DateTime(ifUnmodifiedSince) &&
               lastModified.GetAsUTCDateTime() > ifUnmodifiedSinceDate)
               return SendErrorResponse(request, MHD_HTTP_PRECONDITION_FAILED, request.method);
           }
 
+          if (notModified)
+          {
+            struct MHD_Response *response = create_response(0, nullptr, MHD_NO, MHD_NO);
+            if (response == nullptr)
+            {
+              CLog::Log(LOGERROR, "CWebServer[%hu]: failed to create a HTTP 304 response", m_port);
+              return MHD_NO;
+            }
+
+            return FinalizeRequest(handler, MHD_HTTP_NOT_MODIFIED, response);
+          }
+
           // pass the requested ranges on to the request handler
-          handler->SetRequestRanged(IsRequestRanged(request, lastModified));
+          handler->SetRequestRanged(IsRequestRanged(request, lastModified, entityTag));
         }
       }
       // if we got a POST request we need to take care of the POST data
@@ -406,6 +436,11 @@ int CWebServer::FinalizeRequest(const std::shared_ptr<IHTTPRequestHandler>& hand
   if (handler->GetLastModifiedDate(lastModified) && lastModified.IsValid())
     handler->AddResponseHeader(MHD_HTTP_HEADER_LAST_MODIFIED, lastModified.GetAsRFC1123DateTime());
 
+  // if the request handler has set an entity tag, add it
+  std::string entityTag;
+  if (handler->GetEntityTag(entityTag) && !entityTag.empty())
+    handler->AddResponseHeader(MHD_HTTP_HEADER_ETAG, entityTag);
+
   // check if the request handler has set Cache-Control and add it if not
   if (!handler->HasResponseHeader(MHD_HTTP_HEADER_CACHE_CONTROL))
   {
@@ -498,17 +533,24 @@ bool CWebServer::IsRequestCacheable(const HTTPRequest& request) const
   return true;
 }
 
-bool CWebServer::IsRequestRanged(const HTTPRequest& request, const CDateTime &lastModified) const
+bool CWebServer::IsRequestRanged(const HTTPRequest& request, const CDateTime &lastModified, const std::string &entityTag) const
 {
   // parse the Range header and store it in the request object
   CHttpRanges ranges;
   bool ranged = ranges.Parse(HTTPRequestHandlerUtils::GetRequestHeaderValue(request.connection, MHD_HEADER_KIND, MHD_HTTP_HEADER_RANGE));
 
   // handle If-Range header but only if the Range header is present
-  if (ranged && lastModified.IsValid())
+  if (ranged)
   {
     std::string ifRange = HTTPRequestHandlerUtils::GetRequestHeaderValue(request.connection, MHD_HEADER_KIND, MHD_HTTP_HEADER_IF_RANGE);
-    if (!ifRange.empty() && lastModified.IsValid())
+
+    // an entity tag has to match exactly, otherwise we have to serve the whole file
+    if (StringUtils::StartsWith(ifRange, "\"") || StringUtils::StartsWith(ifRange, "W/"))
+    {
+      if (entityTag.empty() || ifRange != entityTag)
+        ranges.Clear();
+    }
+    else if (!ifRange.empty() && lastModified.IsValid())
     {
       CDateTime ifRangeDate;
       ifRangeDate.SetFromRFC1123DateTime(ifRange);
@@ -83,7 +83,7 @@ private:
   bool IsAuthenticated(const HTTPRequest& request) const;
 
   bool IsRequestCacheable(const HTTPRequest& request) const;
-  bool IsRequestRanged(const HTTPRequest& request, const CDateTime &lastModified) const;
+  bool IsRequestRanged(const HTTPRequest& request, const CDateTime &lastModified, const std::string &entityTag) const;
 
   void SetupPostDataProcessing(const HTTPRequest& request, ConnectionHandler *connectionHandler, std::shared_ptr<IHTTPRequestHandler> handler, void **con_cls) const;
   bool ProcessPostData(const HTTPRequest& request, ConnectionHandler *connectionHandler, const char *upload_data, size_t *upload_data_size, void **con_cls) const;
@@ -21,11 +21,14 @@
 #include <map>
 
 #include "HTTPImageTransformationHandler.h"
+#include "TextureCache.h"
 #include "TextureCacheJob.h"
 #include "URL.h"
+#include "filesystem/File.h"
 #include "filesystem/ImageFile.h"
 #include "network/WebServer.h"
 #include "network/httprequesthandler/HTTPRequestHandlerUtils.h"
+#include "utils/Crc32.h"
 #include "utils/Mime.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
@@ -38,6 +41,10 @@ static const std::string ImageBasePath = "/image/";
 
 CHTTPImageTransformationHandler::CHTTPImageTransformationHandler()
   : m_url(),
+    m_imagePath(),
+    m_hash(),
+    m_entityTag(),
+    m_cachedFile(),
     m_lastModified(),
     m_buffer(NULL),
     m_responseData()
@@ -46,6 +53,10 @@ CHTTPImageTransformationHandler::CHTTPImageTransformationHandler()
 CHTTPImageTransformationHandler::CHTTPImageTransformationHandler(const HTTPRequest &request)
   : IHTTPRequestHandler(request),
     m_url(),
+    m_imagePath(),
+    m_hash(),
+    m_entityTag(),
+    m_cachedFile(),
     m_lastModified(),
     m_buffer(NULL),
     m_responseData()
@@ -58,18 +69,35 @@ CHTTPImageTransformationHandler::CHTTPImageTransformationHandler(const HTTPReque
     return;
   }
 
-  XFILE::CImageFile imageFile;
   const CURL pathToUrl(m_url);
-  if (!imageFile.Exists(pathToUrl))
-  {
-    m_response.status = MHD_HTTP_NOT_FOUND;
-    m_response.type = HTTPError;
-    return;
-  }
 
   m_response.type = HTTPMemoryDownloadNoFreeCopy;
   m_response.status = MHD_HTTP_OK;
 
+  // get the transformation options
+  std::map<std::string, std::string> options;
+  HTTPRequestHandlerUtils::GetRequestHeaderValues(m_request.connection, MHD_GET_ARGUMENT_KIND, options);
+
+  std::vector<std::string> urlOptions;
+  std::map<std::string, std::string>::const_iterator option = options.find(TRANSFORMATION_OPTION_WIDTH);
+  if (option != options.end())
+    urlOptions.push_back(TRANSFORMATION_OPTION_WIDTH "=" + option->second);
+
+  option = options.find(TRANSFORMATION_OPTION_HEIGHT);
+  if (option != options.end())
+    urlOptions.push_back(TRANSFORMATION_OPTION_HEIGHT "=" + option->second);
+
+  option = options.find(TRANSFORMATION_OPTION_SCALING_ALGORITHM);
+  if (option != options.end())
+    urlOptions.push_back(TRANSFORMATION_OPTION_SCALING_ALGORITHM "=" + option->second);
+
+  m_imagePath = m_url;
+  if (!urlOptions.empty())
+  {
+    m_imagePath += "?";
+    m_imagePath += StringUtils::Join(urlOptions, "&");
+  }
+
   // determine the content type
   std::string ext = URIUtils::GetExtension(pathToUrl.GetHostName());
   StringUtils::ToLower(ext);
@@ -77,11 +105,55 @@ CHTTPImageTransformationHandler::CHTTPImageTransformationHandler(const HTTPReque
 
   //! @todo determine the maximum age
 
-  // determine the last modified date
+  // an earlier resize is served without accessing the original image until it is due to be checked
+  bool needsCheck = true;
+  std::string cachedHash;
+  std::string cachedFile = CTextureCache::GetInstance().GetResizedImage(m_imagePath, cachedHash, needsCheck);
   struct __stat64 statBuffer;
+  if (!cachedFile.empty() && !needsCheck)
+  {
+    m_cachedFile = cachedFile;
+    m_hash = cachedHash;
+    m_entityTag = StringUtils::Format("\"%08x-%s\"", Crc32::Compute(m_imagePath), m_hash.c_str());
+    if (XFILE::CFile::Stat(m_cachedFile, &statBuffer) == 0)
+      SetLastModified(statBuffer);
+    return;
+  }
+
+  XFILE::CImageFile imageFile;
+  if (!imageFile.Exists(pathToUrl))
+  {
+    m_response.status = MHD_HTTP_NOT_FOUND;
+    m_response.type = HTTPError;
+    return;
+  }
+
+  // the entity tag covers the transformation and the state of the source image
+  unsigned int width, height;
+  CPictureScalingAlgorithm::Algorithm scalingAlgorithm;
+  std::string additionalInfo;
+  std::string source = CTextureCacheJob::DecodeImageURL(m_imagePath, width, height, scalingAlgorithm, additionalInfo);
+  m_hash = CTextureCacheJob::GetImageHash(source);
+  if (m_hash == "BADHASH")
+    m_hash.clear();
+  // keep serving the earlier resize if the original can't be checked right now
+  if (m_hash.empty() && !cachedFile.empty())
+  {
+    m_cachedFile = cachedFile;
+    m_hash = cachedHash;
+  }
+  if (!m_hash.empty())
+    m_entityTag = StringUtils::Format("\"%08x-%s\"", Crc32::Compute(m_imagePath), m_hash.c_str());
+
+  // determine the last modified date
   if (imageFile.Stat(pathToUrl, &statBuffer) != 0)
     return;
 
+  SetLastModified(statBuffer);
+}
+
+void CHTTPImageTransformationHandler::SetLastModified(const struct __stat64 &statBuffer)
+{
   struct tm *time;
 #ifdef HAVE_LOCALTIME_R
   struct tm result = {};
@@ -98,7 +170,7 @@ CHTTPImageTransformationHandler::CHTTPImageTransformationHandler(const HTTPReque
 CHTTPImageTransformationHandler::~CHTTPImageTransformationHandler()
 {
   m_responseData.clear();
-  delete m_buffer;
+  delete[] m_buffer;
   m_buffer = NULL;
 }
 
@@ -130,33 +202,18 @@ int CHTTPImageTransformationHandler::HandleRequest()
     return MHD_YES;
   }
 
-  // get the transformation options
-  std::map<std::string, std::string> options;
-  HTTPRequestHandlerUtils::GetRequestHeaderValues(m_request.connection, MHD_GET_ARGUMENT_KIND, options);
-
-  std::vector<std::string> urlOptions;
-  std::map<std::string, std::string>::const_iterator option = options.find(TRANSFORMATION_OPTION_WIDTH);
-  if (option != options.end())
-    urlOptions.push_back(TRANSFORMATION_OPTION_WIDTH "=" + option->second);
-
-  option = options.find(TRANSFORMATION_OPTION_HEIGHT);
-  if (option != options.end())
-    urlOptions.push_back(TRANSFORMATION_OPTION_HEIGHT "=" + option->second);
-
-  option = options.find(TRANSFORMATION_OPTION_SCALING_ALGORITHM);
-  if (option != options.end())
-    urlOptions.push_back(TRANSFORMATION_OPTION_SCALING_ALGORITHM "=" + option->second);
-
-  std::string imagePath = m_url;
-  if (!urlOptions.empty())
+  // serve the resized image from the texture cache, resizing it only once
+  if (m_cachedFile.empty() && !m_hash.empty())
+    m_cachedFile = CTextureCache::GetInstance().CacheResizedImage(m_imagePath, m_hash);
+  if (!m_cachedFile.empty())
   {
-    imagePath += "?";
-    imagePath += StringUtils::Join(urlOptions, "&");
+    m_response.type = HTTPFileDownload;
+    return MHD_YES;
   }
 
   // resize the image into the local buffer
   size_t bufferSize;
-  if (!CTextureCacheJob::ResizeTexture(imagePath, m_buffer, bufferSize))
+  if (!CTextureCacheJob::ResizeTexture(m_imagePath, m_buffer, bufferSize))
   {
     m_response.status = MHD_HTTP_INTERNAL_SERVER_ERROR;
     m_response.type = HTTPError;
@@ -188,3 +245,12 @@ bool CHTTPImageTransformationHandler::GetLastModifiedDate(CDateTime &lastModifie
   lastModified = m_lastModified;
   return true;
 }
+
+bool CHTTPImageTransformationHandler::GetEntityTag(std::string &entityTag) const
+{
+  if (m_entityTag.empty())
+    return false;
+
+  entityTag = m_entityTag;
+  return true;
+}
@@ -39,7 +39,9 @@ public:
   bool CanHandleRanges() const override { return true; }
   bool CanBeCached() const override { return true; }
   bool GetLastModifiedDate(CDateTime &lastModified) const override;
+  bool GetEntityTag(std::string &entityTag) const override;
 
+  std::string GetResponseFile() const override { return m_cachedFile; }
   HttpResponseRanges GetResponseData() const override { return m_responseData; }
 
   // priority must be higher than the one of CHTTPImageHandler
@@ -49,7 +51,13 @@ protected:
   explicit CHTTPImageTransformationHandler(const HTTPRequest &request);
 
 private:
+  void SetLastModified(const struct __stat64 &statBuffer);
+
   std::string m_url;
+  std::string m_imagePath;
+  std::string m_hash;
+  std::string m_entityTag;
+  std::string m_cachedFile;
   CDateTime m_lastModified;
 
   uint8_t* m_buffer;
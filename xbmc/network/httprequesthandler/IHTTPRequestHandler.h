@@ -150,6 +150,13 @@ public:
   * \details This is only used if the response can be cached.
   */
   virtual bool GetLastModifiedDate(CDateTime &lastModified) const { return false; }
+
+  /*!
+  * \brief Returns the strong entity tag (ETag) of the response data, including the quotes.
+  *
+  * \details This is only used if the response can be cached.
+  */
+  virtual bool GetEntityTag(std::string &entityTag) const { return false; }
  
   /*!
    * \brief Returns the ranges with raw data belonging to the response.
@@ -58,6 +58,31 @@ using namespace XFILE;
 #define TEST_FILES_HTML         TEST_FILES_DATA ".html"
 #define TEST_FILES_RANGES       TEST_FILES_DATA "-ranges.txt"
 
+#define TEST_ENTITY_TAG         "\"0123abcd-test\""
+
+// serves the same files as CHTTPVfsHandler but with an entity tag
+class CHTTPEntityTagHandler : public CHTTPVfsHandler
+{
+public:
+  CHTTPEntityTagHandler() = default;
+  ~CHTTPEntityTagHandler() override = default;
+
+  IHTTPRequestHandler* Create(const HTTPRequest &request) const override { return new CHTTPEntityTagHandler(request); }
+
+  int GetPriority() const override { return CHTTPVfsHandler::GetPriority() + 1; }
+
+  bool GetEntityTag(std::string &entityTag) const override
+  {
+    entityTag = TEST_ENTITY_TAG;
+    return true;
+  }
+
+protected:
+  explicit CHTTPEntityTagHandler(const HTTPRequest &request)
+    : CHTTPVfsHandler(request)
+  { }
+};
+
 class TestWebServer : public testing::Test
 {
 protected:
@@ -83,6 +108,7 @@ protected:
     if (webserver.IsStarted())
       webserver.Stop();
 
+    webserver.UnregisterRequestHandler(&m_entityTagHandler);
     webserver.UnregisterRequestHandler(&m_vfsHandler);
     webserver.UnregisterRequestHandler(&m_jsonRpcHandler);
 
@@ -349,6 +375,7 @@ protected:
   CWebServer webserver;
   CHTTPJsonRpcHandler m_jsonRpcHandler;
   CHTTPVfsHandler m_vfsHandler;
+  CHTTPEntityTagHandler m_entityTagHandler;
   std::string baseUrl;
   std::string sourcePath;
 };
@@ -702,6 +729,70 @@ TEST_F(TestWebServer, CanGetCachedFileWithNewerIfUnmodifiedSince)
   CheckRangesTestFileResponse(curl);
 }
 
+TEST_F(TestWebServer, CanGetCachedFileWithMatchingIfNoneMatch)
+{
+  webserver.RegisterRequestHandler(&m_entityTagHandler);
+
+  // get the file with the entity tag of the file
+  std::string result;
+  CCurlFile curl;
+  curl.SetRequestHeader(MHD_HTTP_HEADER_RANGE, "");
+  curl.SetRequestHeader(MHD_HTTP_HEADER_IF_NONE_MATCH, TEST_ENTITY_TAG);
+  ASSERT_TRUE(curl.Get(GetUrlOfTestFile(TEST_FILES_RANGES), result));
+  ASSERT_TRUE(result.empty());
+
+  const CHttpHeader& httpHeader = curl.GetHttpHeader();
+  std::string httpStatusString = StringUtils::Format(" %d ", MHD_HTTP_NOT_MODIFIED);
+  EXPECT_TRUE(httpHeader.GetProtoLine().find(httpStatusString) != std::string::npos);
+}
+
+TEST_F(TestWebServer, CanGetCachedFileWithWeakIfNoneMatch)
+{
+  webserver.RegisterRequestHandler(&m_entityTagHandler);
+
+  // get the file with a list of entity tags containing the weak entity tag of the file
+  std::string result;
+  CCurlFile curl;
+  curl.SetRequestHeader(MHD_HTTP_HEADER_RANGE, "");
+  curl.SetRequestHeader(MHD_HTTP_HEADER_IF_NONE_MATCH, "\"other\", W/" TEST_ENTITY_TAG);
+  ASSERT_TRUE(curl.Get(GetUrlOfTestFile(TEST_FILES_RANGES), result));
+  ASSERT_TRUE(result.empty());
+
+  const CHttpHeader& httpHeader = curl.GetHttpHeader();
+  std::string httpStatusString = StringUtils::Format(" %d ", MHD_HTTP_NOT_MODIFIED);
+  EXPECT_TRUE(httpHeader.GetProtoLine().find(httpStatusString) != std::string::npos);
+}
+
+TEST_F(TestWebServer, CanGetCachedFileWithOtherIfNoneMatch)
+{
+  webserver.RegisterRequestHandler(&m_entityTagHandler);
+
+  // get the file with a different entity tag
+  std::string result;
+  CCurlFile curl;
+  curl.SetRequestHeader(MHD_HTTP_HEADER_RANGE, "");
+  curl.SetRequestHeader(MHD_HTTP_HEADER_IF_NONE_MATCH, "\"other\"");
+  ASSERT_TRUE(curl.Get(GetUrlOfTestFile(TEST_FILES_RANGES), result));
+  EXPECT_STREQ(TEST_FILES_DATA_RANGES, result.c_str());
+  CheckRangesTestFileResponse(curl);
+  EXPECT_STREQ(TEST_ENTITY_TAG, curl.GetHttpHeader().GetValue(MHD_HTTP_HEADER_ETAG).c_str());
+}
+
+TEST_F(TestWebServer, CanGetCachedFileWithMatchingIfNoneMatchForcingNoCache)
+{
+  webserver.RegisterRequestHandler(&m_entityTagHandler);
+
+  // get the file with the entity tag of the file but forcing no caching
+  std::string result;
+  CCurlFile curl;
+  curl.SetRequestHeader(MHD_HTTP_HEADER_RANGE, "");
+  curl.SetRequestHeader(MHD_HTTP_HEADER_IF_NONE_MATCH, TEST_ENTITY_TAG);
+  curl.SetRequestHeader(MHD_HTTP_HEADER_CACHE_CONTROL, "no-cache");
+  ASSERT_TRUE(curl.Get(GetUrlOfTestFile(TEST_FILES_RANGES), result));
+  EXPECT_STREQ(TEST_FILES_DATA_RANGES, result.c_str());
+  CheckRangesTestFileResponse(curl);
+}
+
 TEST_F(TestWebServer, CanGetRangedFileRange0_)
 {
   const std::string rangedFileContent = TEST_FILES_DATA_RANGES;
@@ -902,4 +993,55 @@ TEST_F(TestWebServer, CanGetCachedRangedFileWithNewerIfRange)
   curl.SetRequestHeader(MHD_HTTP_HEADER_IF_RANGE, lastModifiedNewer.GetAsRFC1123DateTime());
   ASSERT_TRUE(curl.Get(GetUrlOfTestFile(TEST_FILES_RANGES), result));
   CheckRangesTestFileResponse(curl, result, ranges);
-}
\ No newline at end of file
+}
+
+TEST_F(TestWebServer, CanGetCachedRangedFileWithMatchingEntityTagIfRange)
+{
+  const std::string rangedFileContent = TEST_FILES_DATA_RANGES;
+  const std::string range = "bytes=0-";
+
+  CHttpRanges ranges;
+  ASSERT_TRUE(ranges.Parse(range, rangedFileContent.size()));
+
+  webserver.RegisterRequestHandler(&m_entityTagHandler);
+
+  // get the whole file (but ranged) with the entity tag of the file as If-Range value
+  std::string result;
+  CCurlFile curl;
+  curl.SetRequestHeader(MHD_HTTP_HEADER_RANGE, range);
+  curl.SetRequestHeader(MHD_HTTP_HEADER_IF_RANGE, TEST_ENTITY_TAG);
+  ASSERT_TRUE(curl.Get(GetUrlOfTestFile(TEST_FILES_RANGES), result));
+  CheckRangesTestFileResponse(curl, result, ranges);
+}
+
+TEST_F(TestWebServer, CanGetCachedRangedFileWithWeakEntityTagIfRange)
+{
+  const std::string range = "bytes=0-";
+
+  webserver.RegisterRequestHandler(&m_entityTagHandler);
+
+  // get the whole file (but ranged) with the weak entity tag of the file as If-Range value
+  std::string result;
+  CCurlFile curl;
+  curl.SetRequestHeader(MHD_HTTP_HEADER_RANGE, range);
+  curl.SetRequestHeader(MHD_HTTP_HEADER_IF_RANGE, "W/" TEST_ENTITY_TAG);
+  ASSERT_TRUE(curl.Get(GetUrlOfTestFile(TEST_FILES_RANGES), result));
+  EXPECT_STREQ(TEST_FILES_DATA_RANGES, result.c_str());
+  CheckRangesTestFileResponse(curl);
+}
+
+TEST_F(TestWebServer, CanGetCachedRangedFileWithOtherEntityTagIfRange)
+{
+  const std::string range = "bytes=0-";
+
+  webserver.RegisterRequestHandler(&m_entityTagHandler);
+
+  // get the whole file (but ranged) with a different entity tag as If-Range value
+  std::string result;
+  CCurlFile curl;
+  curl.SetRequestHeader(MHD_HTTP_HEADER_RANGE, range);
+  curl.SetRequestHeader(MHD_HTTP_HEADER_IF_RANGE, "\"other\"");
+  ASSERT_TRUE(curl.Get(GetUrlOfTestFile(TEST_FILES_RANGES), result));
+  EXPECT_STREQ(TEST_FILES_DATA_RANGES, result.c_str());
+  CheckRangesTestFileResponse(curl);
+}
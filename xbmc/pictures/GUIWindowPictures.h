@@ -35,6 +35,7 @@ public:
 
 protected:
   bool GetDirectory(const std::string &strDirectory, CFileItemList& items) override;
+  CBackgroundInfoLoader* GetBackgroundLoader() override { return &m_thumbLoader; }
   void OnItemInfo(int item);
   bool OnClick(int iItem, const std::string &player = "") override;
   void UpdateButtons() override;
@@ -209,6 +209,19 @@ bool CPicture::CacheTexture(CBaseTexture *texture, uint32_t &dest_width, uint32_
                       texture->GetOrientation(), dest_width, dest_height, dest, scalingAlgorithm);
 }
 
+void CPicture::GetMaxCacheSize(uint32_t &width, uint32_t &height)
+{
+  // the fanart res only applies to 16x9 images, which is only known after decoding
+  uint32_t max_height = std::max(g_advancedSettings.m_imageRes, g_advancedSettings.m_fanartRes);
+  uint32_t max_width = max_height * 16/9;
+
+  width = width ? std::min(width, max_width) : max_width;
+  height = height ? std::min(height, max_height) : max_height;
+
+  // images are rotated after decoding, so either side may end up being the width
+  width = height = std::max(width, height);
+}
+
 bool CPicture::CacheTexture(uint8_t *pixels, uint32_t width, uint32_t height, uint32_t pitch, int orientation,
   uint32_t &dest_width, uint32_t &dest_height, const std::string &dest,
   CPictureScalingAlgorithm::Algorithm scalingAlgorithm /* = CPictureScalingAlgorithm::NoAlgorithm */)
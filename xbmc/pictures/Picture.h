@@ -59,6 +59,13 @@ public:
     uint32_t &dest_width, uint32_t &dest_height, const std::string &dest,
     CPictureScalingAlgorithm::Algorithm scalingAlgorithm = CPictureScalingAlgorithm::NoAlgorithm);
 
+  /*! \brief Limit a size to the largest one CacheTexture will store, whatever the aspect ratio and orientation.
+   Lets images be decoded no larger than needed before they are cached.
+   \param width [in/out] maximum width in pixels, 0 for no limit - replaced with the limit
+   \param height [in/out] maximum height in pixels, 0 for no limit - replaced with the limit
+   */
+  static void GetMaxCacheSize(uint32_t &width, uint32_t &height);
+
 private:
   static void GetScale(unsigned int width, unsigned int height, unsigned int &out_width, unsigned int &out_height);
   static bool ScaleImage(uint8_t *in_pixels, unsigned int in_width, unsigned int in_height, unsigned int in_pitch,
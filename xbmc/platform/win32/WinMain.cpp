@@ -28,6 +28,7 @@
 #include "settings/AdvancedSettings.h"
 #include "utils/CPUInfo.h"
 #include "utils/Environment.h"
+#include "utils/log.h"
 #include "utils/CharsetConverter.h" // Required to initialize converters before usage
 
 
@@ -38,6 +39,8 @@
 // Minidump creation function
 LONG WINAPI CreateMiniDump(EXCEPTION_POINTERS* pEp)
 {
+  // write out whatever the log writer thread hasn't picked up yet
+  CLog::Flush();
   win32_exception::write_stacktrace(pEp);
   win32_exception::write_minidump(pEp);
   return pEp->ExceptionRecord->ExceptionCode;
@@ -35,6 +35,7 @@ public:
 protected:
   void OnItemLoaded(CFileItem* pItem) override {};
   bool Update(const std::string& strDirectory, bool updateFilterPath = true) override;
+  CBackgroundInfoLoader* GetBackgroundLoader() override { return &m_thumbLoader; }
   bool OnPlayMedia(int iItem, const std::string& = "") override;
   void GetContextButtons(int itemNumber, CContextButtons &buttons) override;
   bool OnContextButton(int itemNumber, CONTEXT_BUTTON button) override;
@@ -166,6 +166,8 @@ void CAdvancedSettings::Initialize()
   m_DXVAAllowHqScaling = true;
   m_videoFpsDetect = 1;
   m_videoBusyDialogDelay_ms = 500;
+  m_videoDemuxReadAheadSecs = 0.0f;
+  m_videoDemuxReadAheadMB = 64;
 
   m_mediacodecForceSoftwareRendering = false;
 
@@ -332,6 +334,8 @@ void CAdvancedSettings::Initialize()
   m_curlretries = 2;
   m_curlDisableIPV6 = false;      //Certain hardware/OS combinations have trouble
                                   //with ipv6.
+  m_curlParallelConnections = 0;
+  m_curlParallelChunkSize = 1024 * 1024;
 
 #if defined(TARGET_DARWIN_IOS)
   m_startFullScreen = true;
@@ -384,6 +388,9 @@ void CAdvancedSettings::Initialize()
 
   m_jsonOutputCompact = true;
   m_jsonTcpPort = 9090;
+  m_announcementWindow = 0;
+
+  m_pythonInterpreterPoolSize = 0;
 
   m_enableMultimediaKeys = false;
 
@@ -400,6 +407,7 @@ void CAdvancedSettings::Initialize()
 
   m_databaseMusic.Reset();
   m_databaseVideo.Reset();
+  m_databaseSorting = true;
 
   m_pictureExtensions = ".png|.jpg|.jpeg|.bmp|.gif|.ico|.tif|.tiff|.tga|.pcx|.cbz|.zip|.cbr|.rar|.rss|.webp|.jp2|.apng";
   m_musicExtensions = ".nsv|.m4a|.flac|.aac|.strm|.pls|.rm|.rma|.mpa|.wav|.wma|.ogg|.mp3|.mp2|.m3u|.gdm|.imf|.m15|.sfx|.uni|.ac3|.dts|.cue|.aif|.aiff|.wpl|.ape|.mac|.mpc|.mp+|.mpp|.shn|.zip|.rar|.wv|.dsp|.xsp|.xwav|.waa|.wvs|.wam|.gcm|.idsp|.mpdsp|.mss|.spt|.rsd|.sap|.cmc|.cmr|.dmc|.mpt|.mpd|.rmt|.tmc|.tm8|.tm2|.oga|.url|.pxml|.tta|.rss|.wtv|.mka|.tak|.opus|.dff|.dsf|.m4b";
@@ -712,6 +720,11 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     // the busy dialog is shown when starting video playback.
     XMLUtils::GetInt(pElement, "busydialogdelayms", m_videoBusyDialogDelay_ms, 0, 1000);
 
+    // read packets from local and network files ahead on their own thread,
+    // up to this many seconds and megabytes. 0 seconds disables it.
+    XMLUtils::GetFloat(pElement, "demuxreadaheadsecs", m_videoDemuxReadAheadSecs, 0.0f, 60.0f);
+    XMLUtils::GetInt(pElement, "demuxreadaheadmb", m_videoDemuxReadAheadMB, 1, 512);
+
     // Store global display latency settings
     TiXmlElement* pVideoLatency = pElement->FirstChildElement("latency");
     if (pVideoLatency)
@@ -819,6 +832,8 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetInt(pElement, "curllowspeedtime", m_curllowspeedtime, 1, 1000);
     XMLUtils::GetInt(pElement, "curlretries", m_curlretries, 0, 10);
     XMLUtils::GetBoolean(pElement,"disableipv6", m_curlDisableIPV6);
+    XMLUtils::GetInt(pElement, "curlparallelconnections", m_curlParallelConnections, 0, 16);
+    XMLUtils::GetUInt(pElement, "curlparallelchunksize", m_curlParallelChunkSize, 64 * 1024, 64 * 1024 * 1024);
   }
 
   pElement = pRootElement->FirstChildElement("cache");
@@ -836,6 +851,12 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetUInt(pElement, "tcpport", m_jsonTcpPort);
   }
 
+  XMLUtils::GetUInt(pRootElement, "announcementwindow", m_announcementWindow, 0, 5000);
+
+  pElement = pRootElement->FirstChildElement("python");
+  if (pElement)
+    XMLUtils::GetUInt(pElement, "interpreterpool", m_pythonInterpreterPoolSize, 0, 16);
+
   pElement = pRootElement->FirstChildElement("samba");
   if (pElement)
   {
@@ -1207,6 +1228,8 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetBoolean(pDatabase, "compression", m_databaseSavestates.compression);
   }
 
+  XMLUtils::GetBoolean(pRootElement, "databasesorting", m_databaseSorting);
+
   pElement = pRootElement->FirstChildElement("enablemultimediakeys");
   if (pElement)
   {
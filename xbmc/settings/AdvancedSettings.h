@@ -192,6 +192,8 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_DXVAAllowHqScaling;
     int  m_videoFpsDetect;
     int  m_videoBusyDialogDelay_ms;
+    float m_videoDemuxReadAheadSecs;
+    int  m_videoDemuxReadAheadMB;
     bool m_mediacodecForceSoftwareRendering;
 
     std::string m_videoDefaultPlayer;
@@ -302,6 +304,8 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     int m_curllowspeedtime;
     int m_curlretries;
     bool m_curlDisableIPV6;
+    int m_curlParallelConnections;      // range requests in flight per http file, 0 to stream over one
+    unsigned int m_curlParallelChunkSize; // bytes per range request
 
     bool m_fullScreen;
     bool m_startFullScreen;
@@ -341,6 +345,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     DatabaseSettings m_databaseEpg;   /*!< advanced EPG database setup */
     DatabaseSettings m_databaseADSP;  /*!< advanced audio dsp database setup */
     DatabaseSettings m_databaseSavestates; /*!< advanced savestate database setup */
+    bool m_databaseSorting; /*!< let the database sort and limit library listings where possible */
 
     bool m_guiVisualizeDirtyRegions;
     int  m_guiAlgorithmDirtyRegions;
@@ -355,6 +360,9 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
 
     bool m_jsonOutputCompact;
     unsigned int m_jsonTcpPort;
+    unsigned int m_announcementWindow; /*!< ms library and player announcements are held back to coalesce identical ones */
+
+    unsigned int m_pythonInterpreterPoolSize; /*!< python interpreters kept between plugin runs, 0 to create one per run */
 
     bool m_enableMultimediaKeys;
     std::vector<std::string> m_settingsFiles;
@@ -192,6 +192,17 @@ std::shared_ptr<CSettingSection> CSettingsBase::GetSection(const std::string& se
   return m_settingsManager->GetSection(section);
 }
 
+template<typename TValue>
+CSettingHandle<TValue> CSettingsBase::GetHandle(const std::string& id) const
+{
+  return m_settingsManager->GetHandle<TValue>(id);
+}
+
+template CSettingHandle<bool> CSettingsBase::GetHandle<bool>(const std::string& id) const;
+template CSettingHandle<int> CSettingsBase::GetHandle<int>(const std::string& id) const;
+template CSettingHandle<double> CSettingsBase::GetHandle<double>(const std::string& id) const;
+template CSettingHandle<std::string> CSettingsBase::GetHandle<std::string>(const std::string& id) const;
+
 bool CSettingsBase::GetBool(const std::string& id) const
 {
   return m_settingsManager->GetBool(id);
@@ -27,6 +27,7 @@
 #include "threads/CriticalSection.h"
 
 class CSetting;
+template<typename TValue> class CSettingHandle;
 class CSettingSection;
 class CSettingsManager;
 class CVariant;
@@ -130,6 +131,18 @@ public:
    \return Setting section with the given identifier or NULL if the identifier is unknown
    */
   std::shared_ptr<CSettingSection> GetSection(const std::string& section) const;
+  /*!
+   \brief Gets a handle to the setting with the given identifier for reading
+   it repeatedly without looking it up again.
+
+   Available for bool, int, double and std::string settings.
+
+   \param id Setting identifier
+   \return Handle to the setting, invalid if the identifier is unknown or the setting has another type
+   \sa CSettingsManager::GetHandle()
+   */
+  template<typename TValue>
+  CSettingHandle<TValue> GetHandle(const std::string& id) const;
 
   /*!
    \brief Gets the boolean value of the setting with the given identifier.
@@ -572,6 +572,7 @@ CSettingBool::CSettingBool(const std::string &id, const CSettingBool &setting)
 CSettingBool::CSettingBool(const std::string &id, int label, bool value, CSettingsManager *settingsManager /* = nullptr */)
   : CTraitedSetting(id, settingsManager)
   , m_value(value)
+  , m_published(value)
   , m_default(value)
 {
   SetLabel(label);
@@ -592,7 +593,10 @@ bool CSettingBool::Deserialize(const TiXmlNode *node, bool update /* = false */)
   // get the default value
   bool value;
   if (XMLUtils::GetBoolean(node, SETTING_XML_ELM_DEFAULT, value))
+  {
     m_value = m_default = value;
+    publish();
+  }
   else if (!update)
   {
     CLog::Log(LOGERROR, "CSettingBool: error reading the default value of \"%s\"", m_id.c_str());
@@ -651,6 +655,7 @@ bool CSettingBool::SetValue(bool value)
   }
 
   m_changed = m_value != m_default;
+  publish();
   OnSettingChanged(shared_from_base<CSettingBool>());
   return true;
 }
@@ -661,7 +666,10 @@ void CSettingBool::SetDefault(bool value)
 
   m_default = value;
   if (!m_changed)
+  {
     m_value = m_default;
+    publish();
+  }
 }
 
 void CSettingBool::copy(const CSettingBool &setting)
@@ -669,6 +677,7 @@ void CSettingBool::copy(const CSettingBool &setting)
   CSetting::Copy(setting);
 
   m_value = setting.m_value;
+  publish();
   m_default = setting.m_default;
 }
   
@@ -701,6 +710,7 @@ CSettingInt::CSettingInt(const std::string &id, const CSettingInt &setting)
 CSettingInt::CSettingInt(const std::string &id, int label, int value, CSettingsManager *settingsManager /* = nullptr */)
   : CTraitedSetting(id, settingsManager)
   , m_value(value)
+  , m_published(value)
   , m_default(value)
 {
   SetLabel(label);
@@ -709,6 +719,7 @@ CSettingInt::CSettingInt(const std::string &id, int label, int value, CSettingsM
 CSettingInt::CSettingInt(const std::string &id, int label, int value, int minimum, int step, int maximum, CSettingsManager *settingsManager /* = nullptr */)
   : CTraitedSetting(id, settingsManager)
   , m_value(value)
+  , m_published(value)
   , m_default(value)
   , m_min(minimum)
   , m_step(step)
@@ -720,6 +731,7 @@ CSettingInt::CSettingInt(const std::string &id, int label, int value, int minimu
 CSettingInt::CSettingInt(const std::string &id, int label, int value, const TranslatableIntegerSettingOptions &options, CSettingsManager *settingsManager /* = nullptr */)
   : CTraitedSetting(id, settingsManager)
   , m_value(value)
+  , m_published(value)
   , m_default(value)
   , m_translatableOptions(options)
 {
@@ -741,7 +753,10 @@ bool CSettingInt::Deserialize(const TiXmlNode *node, bool update /* = false */)
   // get the default value
   int value;
   if (XMLUtils::GetInt(node, SETTING_XML_ELM_DEFAULT, value))
+  {
     m_value = m_default = value;
+    publish();
+  }
   else if (!update)
   {
     CLog::Log(LOGERROR, "CSettingInt: error reading the default value of \"%s\"", m_id.c_str());
@@ -871,6 +886,7 @@ bool CSettingInt::SetValue(int value)
   }
 
   m_changed = m_value != m_default;
+  publish();
   OnSettingChanged(shared_from_base<CSettingInt>());
   return true;
 }
@@ -881,7 +897,10 @@ void CSettingInt::SetDefault(int value)
 
   m_default = value;
   if (!m_changed)
+  {
     m_value = m_default;
+    publish();
+  }
 }
 
 SettingOptionsType CSettingInt::GetOptionsType() const
@@ -948,6 +967,7 @@ void CSettingInt::copy(const CSettingInt &setting)
   CExclusiveLock lock(m_critical);
 
   m_value = setting.m_value;
+  publish();
   m_default = setting.m_default;
   m_min = setting.m_min;
   m_step = setting.m_step;
@@ -986,6 +1006,7 @@ CSettingNumber::CSettingNumber(const std::string &id, const CSettingNumber &sett
 CSettingNumber::CSettingNumber(const std::string &id, int label, float value, CSettingsManager *settingsManager /* = nullptr */)
   : CTraitedSetting(id, settingsManager)
   , m_value(value)
+  , m_published(value)
   , m_default(value)
 {
   SetLabel(label);
@@ -994,6 +1015,7 @@ CSettingNumber::CSettingNumber(const std::string &id, int label, float value, CS
 CSettingNumber::CSettingNumber(const std::string &id, int label, float value, float minimum, float step, float maximum, CSettingsManager *settingsManager /* = nullptr */)
   : CTraitedSetting(id, settingsManager)
   , m_value(value)
+  , m_published(value)
   , m_default(value)
   , m_min(minimum)
   , m_step(step)
@@ -1017,7 +1039,10 @@ bool CSettingNumber::Deserialize(const TiXmlNode *node, bool update /* = false *
   // get the default value
   double value;
   if (XMLUtils::GetDouble(node, SETTING_XML_ELM_DEFAULT, value))
+  {
     m_value = m_default = value;
+    publish();
+  }
   else if (!update)
   {
     CLog::Log(LOGERROR, "CSettingNumber: error reading the default value of \"%s\"", m_id.c_str());
@@ -1107,6 +1132,7 @@ bool CSettingNumber::SetValue(double value)
   }
 
   m_changed = m_value != m_default;
+  publish();
   OnSettingChanged(shared_from_base<CSettingNumber>());
   return true;
 }
@@ -1117,7 +1143,10 @@ void CSettingNumber::SetDefault(double value)
 
   m_default = value;
   if (!m_changed)
+  {
     m_value = m_default;
+    publish();
+  }
 }
 
 void CSettingNumber::copy(const CSettingNumber &setting)
@@ -1126,6 +1155,7 @@ void CSettingNumber::copy(const CSettingNumber &setting)
   CExclusiveLock lock(m_critical);
 
   m_value = setting.m_value;
+  publish();
   m_default = setting.m_default;
   m_min = setting.m_min;
   m_step = setting.m_step;
@@ -1158,6 +1188,7 @@ CSettingString::CSettingString(const std::string &id, const CSettingString &sett
 CSettingString::CSettingString(const std::string &id, int label, const std::string &value, CSettingsManager *settingsManager /* = nullptr */)
   : CTraitedSetting(id, settingsManager)
   , m_value(value)
+  , m_published(std::make_shared<const std::string>(value))
   , m_default(value)
 {
   SetLabel(label);
@@ -1218,7 +1249,10 @@ bool CSettingString::Deserialize(const TiXmlNode *node, bool update /* = false *
   std::string value;
   if (XMLUtils::GetString(node, SETTING_XML_ELM_DEFAULT, value) &&
      (!value.empty() || m_allowEmpty))
+  {
     m_value = m_default = value;
+    publish();
+  }
   else if (!update && !m_allowEmpty)
   {
     CLog::Log(LOGERROR, "CSettingString: error reading the default value of \"%s\"", m_id.c_str());
@@ -1274,6 +1308,7 @@ bool CSettingString::SetValue(const std::string &value)
   }
 
   m_changed = m_value != m_default;
+  publish();
   OnSettingChanged(shared_from_base<CSettingString>());
   return true;
 }
@@ -1284,7 +1319,10 @@ void CSettingString::SetDefault(const std::string &value)
 
   m_default = value;
   if (!m_changed)
+  {
     m_value = m_default;
+    publish();
+  }
 }
 
 SettingOptionsType CSettingString::GetOptionsType() const
@@ -1351,6 +1389,7 @@ void CSettingString::copy(const CSettingString &setting)
 
   CExclusiveLock lock(m_critical);
   m_value = setting.m_value;
+  publish();
   m_default = setting.m_default;
   m_allowEmpty = setting.m_allowEmpty;
   m_translatableOptions = setting.m_translatableOptions;
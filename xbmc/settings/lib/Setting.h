@@ -19,6 +19,7 @@
  *
  */
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <set>
@@ -246,15 +247,21 @@ public:
   void Reset() override { SetValue(m_default); }
 
   bool GetValue() const { CSharedLock lock(m_critical); return m_value; }
+  /*! \brief The value as of the last completed change, read without locking.
+   Unlike GetValue() it doesn't see a value while its change is still being checked by the callbacks.
+   */
+  bool GetPublishedValue() const { return m_published.load(std::memory_order_acquire); }
   bool SetValue(bool value);
   bool GetDefault() const { return m_default; }
   void SetDefault(bool value);
 
 private:
   void copy(const CSettingBool &setting);
+  void publish() { m_published.store(m_value, std::memory_order_release); }
   bool fromString(const std::string &strValue, bool &value) const;
 
   bool m_value = false;
+  std::atomic<bool> m_published{false};
   bool m_default = false;
 };
 
@@ -285,6 +292,7 @@ public:
   void Reset() override { SetValue(m_default); }
 
   int GetValue() const { CSharedLock lock(m_critical); return m_value; }
+  int GetPublishedValue() const { return m_published.load(std::memory_order_acquire); }
   bool SetValue(int value);
   int GetDefault() const { return m_default; }
   void SetDefault(int value);
@@ -316,9 +324,11 @@ public:
 
 private:
   void copy(const CSettingInt &setting);
+  void publish() { m_published.store(m_value, std::memory_order_release); }
   static bool fromString(const std::string &strValue, int &value);
 
   int m_value = 0;
+  std::atomic<int> m_published{0};
   int m_default = 0;
   int m_min = 0;
   int m_step = 1;
@@ -357,6 +367,7 @@ public:
   void Reset() override { SetValue(m_default); }
 
   double GetValue() const { CSharedLock lock(m_critical); return m_value; }
+  double GetPublishedValue() const { return m_published.load(std::memory_order_acquire); }
   bool SetValue(double value);
   double GetDefault() const { return m_default; }
   void SetDefault(double value);
@@ -370,9 +381,11 @@ public:
 
 private:
   virtual void copy(const CSettingNumber &setting);
+  void publish() { m_published.store(m_value, std::memory_order_release); }
   static bool fromString(const std::string &strValue, double &value);
 
   double m_value = 0.0;
+  std::atomic<double> m_published{0.0};
   double m_default = 0.0;
   double m_min = 0.0;
   double m_step = 1.0;
@@ -403,6 +416,8 @@ public:
   void Reset() override { SetValue(m_default); }
 
   virtual const std::string& GetValue() const { CSharedLock lock(m_critical); return m_value; }
+  //! \sa CSettingBool::GetPublishedValue()
+  std::shared_ptr<const std::string> GetPublishedValue() const { return std::atomic_load(&m_published); }
   virtual bool SetValue(const std::string &value);
   virtual const std::string& GetDefault() const { return m_default; }
   virtual void SetDefault(const std::string &value);
@@ -430,8 +445,10 @@ public:
 
 protected:
   virtual void copy(const CSettingString &setting);
+  void publish() { std::atomic_store(&m_published, std::make_shared<const std::string>(m_value)); }
 
   std::string m_value;
+  std::shared_ptr<const std::string> m_published = std::make_shared<const std::string>();
   std::string m_default;
   bool m_allowEmpty = false;
   TranslatableStringSettingOptions m_translatableOptions;
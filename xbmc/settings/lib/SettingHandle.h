@@ -0,0 +1,105 @@
+#pragma once
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "Setting.h"
+#include "SettingType.h"
+
+template<typename TValue>
+struct SettingHandleTraits;
+
+template<>
+struct SettingHandleTraits<bool>
+{
+  using Setting = CSettingBool;
+  static const SettingType Type = SettingType::Boolean;
+};
+
+template<>
+struct SettingHandleTraits<int>
+{
+  using Setting = CSettingInt;
+  static const SettingType Type = SettingType::Integer;
+};
+
+template<>
+struct SettingHandleTraits<double>
+{
+  using Setting = CSettingNumber;
+  static const SettingType Type = SettingType::Number;
+};
+
+template<>
+struct SettingHandleTraits<std::string>
+{
+  using Setting = CSettingString;
+  static const SettingType Type = SettingType::String;
+};
+
+/*!
+ \ingroup settings
+ \brief Typed access to a single setting, looked up once by its identifier.
+
+ Reading a handle is a single atomic load of the value published by the last
+ completed change of the setting, without looking it up or locking, so handles
+ can be kept and read in render loops and per item loops. Changes still go
+ through the setting and trigger the callbacks and conditions as usual.
+
+ \sa CSettingsManager::GetHandle()
+ */
+template<typename TValue>
+class CSettingHandle
+{
+public:
+  using Setting = typename SettingHandleTraits<TValue>::Setting;
+
+  CSettingHandle() = default;
+  explicit CSettingHandle(std::shared_ptr<Setting> setting) : m_setting(std::move(setting)) { }
+
+  bool IsValid() const { return m_setting != nullptr; }
+  std::shared_ptr<Setting> GetSetting() const { return m_setting; }
+
+  /*!
+   \brief Gets the value of the setting.
+
+   \return Value of the setting or the default constructed value if the handle is invalid
+   */
+  TValue Get() const { return m_setting != nullptr ? m_setting->GetPublishedValue() : TValue(); }
+  /*!
+   \brief Sets the value of the setting.
+
+   \param value Value to set
+   \return True if setting the value was successful, false otherwise
+   */
+  bool Set(const TValue& value) const { return m_setting != nullptr && m_setting->SetValue(value); }
+
+private:
+  std::shared_ptr<Setting> m_setting;
+};
+
+template<>
+inline std::string CSettingHandle<std::string>::Get() const
+{
+  return m_setting != nullptr ? *m_setting->GetPublishedValue() : std::string();
+}
@@ -603,7 +603,6 @@ SettingDependencyMap CSettingsManager::GetDependencies(SettingConstPtr setting)
 
 bool CSettingsManager::GetBool(const std::string &id) const
 {
-  CSharedLock lock(m_settingsCritical);
   SettingPtr setting = GetSetting(id);
   if (setting == nullptr || setting->GetType() != SettingType::Boolean)
     return false;
@@ -633,7 +632,6 @@ bool CSettingsManager::ToggleBool(const std::string &id)
 
 int CSettingsManager::GetInt(const std::string &id) const
 {
-  CSharedLock lock(m_settingsCritical);
   SettingPtr setting = GetSetting(id);
   if (setting == nullptr || setting->GetType() != SettingType::Integer)
     return 0;
@@ -653,7 +651,6 @@ bool CSettingsManager::SetInt(const std::string &id, int value)
 
 double CSettingsManager::GetNumber(const std::string &id) const
 {
-  CSharedLock lock(m_settingsCritical);
   SettingPtr setting = GetSetting(id);
   if (setting == nullptr || setting->GetType() != SettingType::Number)
     return 0.0;
@@ -673,7 +670,6 @@ bool CSettingsManager::SetNumber(const std::string &id, double value)
 
 std::string CSettingsManager::GetString(const std::string &id) const
 {
-  CSharedLock lock(m_settingsCritical);
   SettingPtr setting = GetSetting(id);
   if (setting == nullptr || setting->GetType() != SettingType::String)
     return "";
@@ -693,7 +689,6 @@ bool CSettingsManager::SetString(const std::string &id, const std::string &value
 
 std::vector< std::shared_ptr<CSetting> > CSettingsManager::GetList(const std::string &id) const
 {
-  CSharedLock lock(m_settingsCritical);
   SettingPtr setting = GetSetting(id);
   if (setting == nullptr || setting->GetType() != SettingType::List)
     return std::vector< std::shared_ptr<CSetting> >();
@@ -754,25 +749,33 @@ bool CSettingsManager::Serialize(TiXmlNode *parent) const
 
   CSharedLock lock(m_settingsCritical);
 
+  // write the settings sorted by their identifier, the index has no order
+  std::vector<const SettingMap::value_type*> settings;
+  settings.reserve(m_settings.size());
   for (const auto& setting : m_settings)
+    settings.push_back(&setting);
+  std::sort(settings.begin(), settings.end(),
+            [](const SettingMap::value_type* lhs, const SettingMap::value_type* rhs) { return lhs->first < rhs->first; });
+
+  for (const auto& setting : settings)
   {
-    if (setting.second.setting->GetType() == SettingType::Action)
+    if (setting->second.setting->GetType() == SettingType::Action)
       continue;
 
     TiXmlElement settingElement(SETTING_XML_ELM_SETTING);
-    settingElement.SetAttribute(SETTING_XML_ATTR_ID, setting.second.setting->GetId());
+    settingElement.SetAttribute(SETTING_XML_ATTR_ID, setting->second.setting->GetId());
 
     // add the default attribute
-    if (setting.second.setting->IsDefault())
+    if (setting->second.setting->IsDefault())
       settingElement.SetAttribute(SETTING_XML_ELM_DEFAULT, "true");
 
     // add the value
-    TiXmlText value(setting.second.setting->ToString());
+    TiXmlText value(setting->second.setting->ToString());
     settingElement.InsertEndChild(value);
 
     if (parent->InsertEndChild(settingElement) == nullptr)
     {
-      CLog::Log(LOGWARNING, "CSetting: unable to write <" SETTING_XML_ELM_SETTING " id=\"%s\"> tag", setting.second.setting->GetId().c_str());
+      CLog::Log(LOGWARNING, "CSetting: unable to write <" SETTING_XML_ELM_SETTING " id=\"%s\"> tag", setting->second.setting->GetId().c_str());
       continue;
     }
   }
@@ -1328,16 +1331,30 @@ void CSettingsManager::ResolveSettingDependencies(const Setting& setting)
   }
 }
 
-CSettingsManager::SettingMap::const_iterator CSettingsManager::FindSetting(std::string settingId) const
+static bool IsLowerCase(const std::string &str)
 {
-  StringUtils::ToLower(settingId);
-  return m_settings.find(settingId);
+  return std::none_of(str.begin(), str.end(), [](char c) { return c >= 'A' && c <= 'Z'; });
 }
 
-CSettingsManager::SettingMap::iterator CSettingsManager::FindSetting(std::string settingId)
+CSettingsManager::SettingMap::const_iterator CSettingsManager::FindSetting(const std::string &settingId) const
 {
-  StringUtils::ToLower(settingId);
-  return m_settings.find(settingId);
+  // identifiers are almost always looked up in lower case already
+  if (IsLowerCase(settingId))
+    return m_settings.find(settingId);
+
+  std::string lowerId(settingId);
+  StringUtils::ToLower(lowerId);
+  return m_settings.find(lowerId);
+}
+
+CSettingsManager::SettingMap::iterator CSettingsManager::FindSetting(const std::string &settingId)
+{
+  if (IsLowerCase(settingId))
+    return m_settings.find(settingId);
+
+  std::string lowerId(settingId);
+  StringUtils::ToLower(lowerId);
+  return m_settings.find(lowerId);
 }
 
 std::pair<CSettingsManager::SettingMap::iterator, bool> CSettingsManager::InsertSetting(std::string settingId, const Setting& setting)
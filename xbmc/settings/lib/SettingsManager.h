@@ -21,6 +21,7 @@
 
 #include <map>
 #include <set>
+#include <unordered_map>
 #include <vector>
 
 #include "ISettingCallback.h"
@@ -29,6 +30,7 @@
 #include "ISettingsHandler.h"
 #include "ISubSettings.h"
 #include "Setting.h"
+#include "SettingHandle.h"
 #include "SettingConditions.h"
 #include "SettingDefinitions.h"
 #include "SettingDependency.h"
@@ -331,6 +333,25 @@ public:
    */
   SettingDependencyMap GetDependencies(std::shared_ptr<const CSetting> setting) const;
 
+  /*!
+   \brief Gets a handle to the setting with the given identifier.
+
+   Intended for settings read often, the handle is looked up once and reading
+   it doesn't involve the settings manager anymore.
+
+   \param id Setting identifier
+   \return Handle to the setting or an invalid handle if the identifier is unknown or the setting isn't of type TValue
+   */
+  template<typename TValue>
+  CSettingHandle<TValue> GetHandle(const std::string &id) const
+  {
+    SettingPtr setting = GetSetting(id);
+    if (setting == nullptr || setting->GetType() != SettingHandleTraits<TValue>::Type)
+      return CSettingHandle<TValue>();
+
+    return CSettingHandle<TValue>(std::static_pointer_cast<typename CSettingHandle<TValue>::Setting>(setting));
+  }
+
   /*!
    \brief Gets the boolean value of the setting with the given identifier.
 
@@ -502,13 +523,13 @@ private:
     CallbackSet callbacks;
   };
 
-  using SettingMap = std::map<std::string, Setting>;
+  using SettingMap = std::unordered_map<std::string, Setting>;
 
   void ResolveSettingDependencies(std::shared_ptr<CSetting> setting);
   void ResolveSettingDependencies(const Setting& setting);
 
-  SettingMap::const_iterator FindSetting(std::string settingId) const;
-  SettingMap::iterator FindSetting(std::string settingId);
+  SettingMap::const_iterator FindSetting(const std::string &settingId) const;
+  SettingMap::iterator FindSetting(const std::string &settingId);
   std::pair<SettingMap::iterator, bool> InsertSetting(std::string settingId, const Setting& setting);
 
   bool m_initialized = false;
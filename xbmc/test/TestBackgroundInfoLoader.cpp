@@ -0,0 +1,172 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "BackgroundInfoLoader.h"
+#include "FileItem.h"
+#include "threads/Event.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+#include "utils/StringUtils.h"
+#include "utils/Variant.h"
+
+#include "gtest/gtest.h"
+
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+// records the order items are loaded in, the first item waits to be released
+class CRecordingLoader : public CBackgroundInfoLoader
+{
+public:
+  explicit CRecordingLoader(unsigned int workers) : CBackgroundInfoLoader(workers) {}
+
+  bool LoadItemCached(CFileItem* pItem) override { return Record(pItem, false); }
+  bool LoadItemLookup(CFileItem* pItem) override { return Record(pItem, true); }
+
+  void WaitUntilLoaded()
+  {
+    while (IsLoading())
+      XbmcThreads::ThreadSleep(1);
+  }
+
+  CEvent m_started;
+  CEvent m_release;
+  CCriticalSection m_section;
+  std::vector<std::pair<int, bool>> m_loaded; // item and whether it was a lookup
+
+private:
+  bool Record(CFileItem* pItem, bool lookup)
+  {
+    bool first;
+    {
+      CSingleLock lock(m_section);
+      first = m_loaded.empty();
+      m_loaded.push_back(std::make_pair(static_cast<int>(pItem->GetProperty("index").asInteger()), lookup));
+    }
+    if (first)
+    {
+      m_started.Set();
+      m_release.Wait();
+    }
+    return false;
+  }
+};
+
+void FillItems(CFileItemList& items, int count)
+{
+  for (int i = 0; i < count; i++)
+  {
+    CFileItemPtr item(new CFileItem(StringUtils::Format("%i", i)));
+    item->SetProperty("index", i);
+    items.Add(item);
+  }
+}
+
+}
+
+TEST(TestBackgroundInfoLoader, VisibleItemsFirst)
+{
+  CFileItemList items;
+  FillItems(items, 100);
+
+  CRecordingLoader loader(1);
+  loader.Load(items);
+  ASSERT_TRUE(loader.m_started.WaitMSec(5000));
+
+  std::vector<CGUIListItemPtr> visible;
+  for (int i = 50; i < 60; i++)
+    visible.push_back(items[i]);
+  loader.SetVisibleItems(visible);
+  loader.m_release.Set();
+  loader.WaitUntilLoaded();
+
+  const std::vector<std::pair<int, bool>>& loaded = loader.m_loaded;
+  ASSERT_EQ(200U, loaded.size());
+  EXPECT_EQ(std::make_pair(0, false), loaded[0]);
+
+  // the visible items first, then everything within a page of them
+  for (int i = 0; i < 10; i++)
+    EXPECT_EQ(std::make_pair(50 + i, false), loaded[1 + i]);
+  for (int i = 11; i < 31; i++)
+  {
+    EXPECT_FALSE(loaded[i].second);
+    EXPECT_LE(40, loaded[i].first);
+    EXPECT_GE(69, loaded[i].first);
+  }
+  for (int i = 0; i < 10; i++)
+    EXPECT_EQ(std::make_pair(50 + i, true), loaded[31 + i]);
+  for (int i = 41; i < 61; i++)
+  {
+    EXPECT_TRUE(loaded[i].second);
+    EXPECT_LE(40, loaded[i].first);
+    EXPECT_GE(69, loaded[i].first);
+  }
+
+  // everything else is cached before it's looked up
+  std::set<int> cached;
+  std::set<int> lookedUp;
+  for (size_t i = 0; i < loaded.size(); i++)
+  {
+    if (loaded[i].second)
+    {
+      EXPECT_TRUE(cached.count(loaded[i].first) == 1);
+      EXPECT_TRUE(lookedUp.insert(loaded[i].first).second);
+    }
+    else
+      EXPECT_TRUE(cached.insert(loaded[i].first).second);
+  }
+  EXPECT_EQ(100U, cached.size());
+  EXPECT_EQ(100U, lookedUp.size());
+}
+
+TEST(TestBackgroundInfoLoader, Workers)
+{
+  CFileItemList items;
+  FillItems(items, 500);
+
+  CRecordingLoader loader(4);
+  loader.m_release.Set();
+  loader.Load(items);
+  loader.WaitUntilLoaded();
+
+  std::set<int> cached;
+  std::set<int> lookedUp;
+  for (const auto& loaded : loader.m_loaded)
+  {
+    if (loaded.second)
+    {
+      EXPECT_TRUE(cached.count(loaded.first) == 1);
+      EXPECT_TRUE(lookedUp.insert(loaded.first).second);
+    }
+    else
+      EXPECT_TRUE(cached.insert(loaded.first).second);
+  }
+  EXPECT_EQ(500U, cached.size());
+  EXPECT_EQ(500U, lookedUp.size());
+
+  // loads again after stopping halfway
+  loader.Load(items);
+  loader.StopThread();
+  EXPECT_FALSE(loader.IsLoading());
+}
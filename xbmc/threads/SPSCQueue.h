@@ -0,0 +1,138 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace XbmcThreads
+{
+  /**
+   * Bounded queue for exactly one producing and one consuming thread.
+   *
+   * Neither side ever locks or waits, Push fails when the queue is full and
+   * Pop fails when it is empty. Each side caches the other side's position
+   * so the shared counters are only touched when the cached one runs out.
+   *
+   * Several producers (or consumers) have to be serialized by the caller.
+   * Calls that look at the whole queue (ForEach) need both sides to be idle.
+   */
+  template<typename T>
+  class CSPSCQueue
+  {
+  public:
+    explicit CSPSCQueue(size_t capacity) : m_items(RoundUp(capacity)), m_mask(m_items.size() - 1)
+    {
+    }
+
+    CSPSCQueue(const CSPSCQueue&) = delete;
+    CSPSCQueue& operator=(const CSPSCQueue&) = delete;
+
+    /**
+     * Producer only. Returns false if the queue is full.
+     */
+    bool Push(const T& item)
+    {
+      size_t write = m_write.load(std::memory_order_relaxed);
+      if (write - m_readCache == m_items.size())
+      {
+        m_readCache = m_read.load(std::memory_order_acquire);
+        if (write - m_readCache == m_items.size())
+          return false;
+      }
+
+      m_items[write & m_mask] = item;
+      m_write.store(write + 1, std::memory_order_release);
+      return true;
+    }
+
+    /**
+     * Consumer only. Returns false if the queue is empty.
+     */
+    bool Pop(T& item)
+    {
+      size_t read = m_read.load(std::memory_order_relaxed);
+      if (read == m_writeCache)
+      {
+        m_writeCache = m_write.load(std::memory_order_acquire);
+        if (read == m_writeCache)
+          return false;
+      }
+
+      item = m_items[read & m_mask];
+      m_read.store(read + 1, std::memory_order_release);
+      return true;
+    }
+
+    /**
+     * Consumer only. The oldest item or NULL if the queue is empty.
+     */
+    const T* Front()
+    {
+      size_t read = m_read.load(std::memory_order_relaxed);
+      if (read == m_writeCache)
+      {
+        m_writeCache = m_write.load(std::memory_order_acquire);
+        if (read == m_writeCache)
+          return nullptr;
+      }
+      return &m_items[read & m_mask];
+    }
+
+    template<typename F>
+    void ForEach(F f) const
+    {
+      size_t write = m_write.load(std::memory_order_acquire);
+      for (size_t read = m_read.load(std::memory_order_acquire); read != write; read++)
+        f(m_items[read & m_mask]);
+    }
+
+    bool Empty() const { return Size() == 0; }
+    size_t Size() const
+    {
+      size_t read = m_read.load(std::memory_order_acquire);
+      return m_write.load(std::memory_order_acquire) - read;
+    }
+    size_t Capacity() const { return m_items.size(); }
+
+  private:
+    static size_t RoundUp(size_t capacity)
+    {
+      size_t size = 2;
+      while (size < capacity)
+        size <<= 1;
+      return size;
+    }
+
+    std::vector<T> m_items;
+    const size_t m_mask;
+
+    // keep what each side writes on its own cache line
+    char m_pad0[64];
+    std::atomic<size_t> m_write{0};
+    size_t m_readCache = 0;
+    char m_pad1[64];
+    std::atomic<size_t> m_read{0};
+    size_t m_writeCache = 0;
+    char m_pad2[64];
+  };
+}
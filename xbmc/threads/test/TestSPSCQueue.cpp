@@ -0,0 +1,214 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "threads/SPSCQueue.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+#include "utils/TimeUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <list>
+#include <vector>
+
+using namespace XbmcThreads;
+
+namespace
+{
+
+// the queue the stream players used before, one locked list node per message
+class CLockedQueue
+{
+public:
+  explicit CLockedQueue(size_t capacity) : m_capacity(capacity) {}
+
+  bool Push(int64_t item)
+  {
+    CSingleLock lock(m_section);
+    if (m_items.size() == m_capacity)
+      return false;
+    m_items.push_front(item);
+    return true;
+  }
+
+  bool Pop(int64_t& item)
+  {
+    CSingleLock lock(m_section);
+    if (m_items.empty())
+      return false;
+    item = m_items.back();
+    m_items.pop_back();
+    return true;
+  }
+
+private:
+  size_t m_capacity;
+  std::list<int64_t> m_items;
+  CCriticalSection m_section;
+};
+
+template<typename Q>
+class CProducer : public IRunnable
+{
+public:
+  CProducer(Q& queue, int count) : m_queue(queue), m_count(count) {}
+
+  void Run() override
+  {
+    for (int i = 0; i < m_count; i++)
+    {
+      while (!m_queue.Push(CurrentHostCounter()))
+        ThreadSleep(0);
+    }
+  }
+
+private:
+  Q& m_queue;
+  int m_count;
+};
+
+// microseconds each stamped item spends in the queue, sorted so percentiles can be read off directly
+template<typename Q>
+void MeasureLatency(Q& queue, int count, std::vector<float>& latencies, float& elapsed)
+{
+  CProducer<Q> producer(queue, count);
+  CThread thread(&producer, "SPSCQueueTest");
+
+  const float frequency = static_cast<float>(CurrentHostFrequency());
+  const int64_t start = CurrentHostCounter();
+  latencies.clear();
+  latencies.reserve(count);
+  thread.Create();
+
+  int64_t stamp;
+  while (latencies.size() < static_cast<size_t>(count))
+  {
+    if (queue.Pop(stamp))
+      latencies.push_back((CurrentHostCounter() - stamp) * 1000000.0f / frequency);
+    else
+      ThreadSleep(0);
+  }
+
+  elapsed = (CurrentHostCounter() - start) * 1000.0f / frequency;
+  thread.StopThread(true);
+  std::sort(latencies.begin(), latencies.end());
+}
+
+}
+
+TEST(TestSPSCQueue, PushPop)
+{
+  CSPSCQueue<int> queue(3);
+  EXPECT_EQ(4U, queue.Capacity());
+  EXPECT_TRUE(queue.Empty());
+  EXPECT_EQ(nullptr, queue.Front());
+
+  for (int i = 0; i < 4; i++)
+    EXPECT_TRUE(queue.Push(i));
+  EXPECT_FALSE(queue.Push(4));
+  EXPECT_EQ(4U, queue.Size());
+
+  int item;
+  ASSERT_TRUE(queue.Pop(item));
+  EXPECT_EQ(0, item);
+  ASSERT_NE(nullptr, queue.Front());
+  EXPECT_EQ(1, *queue.Front());
+
+  // wraps around
+  EXPECT_TRUE(queue.Push(4));
+  std::vector<int> items;
+  queue.ForEach([&items](int i){ items.push_back(i); });
+  EXPECT_EQ(std::vector<int>({ 1, 2, 3, 4 }), items);
+
+  for (int i = 1; i < 5; i++)
+  {
+    ASSERT_TRUE(queue.Pop(item));
+    EXPECT_EQ(i, item);
+  }
+  EXPECT_FALSE(queue.Pop(item));
+  EXPECT_TRUE(queue.Empty());
+}
+
+TEST(TestSPSCQueue, Threaded)
+{
+  static const int count = 200000;
+  CSPSCQueue<int64_t> queue(64);
+
+  class CCounter : public IRunnable
+  {
+  public:
+    explicit CCounter(CSPSCQueue<int64_t>& queue) : m_queue(queue) {}
+    void Run() override
+    {
+      for (int64_t i = 0; i < count; i++)
+      {
+        while (!m_queue.Push(i))
+          ThreadSleep(0);
+      }
+    }
+    CSPSCQueue<int64_t>& m_queue;
+  } counter(queue);
+
+  CThread thread(&counter, "SPSCQueueTest");
+  thread.Create();
+
+  // everything arrives once and in order
+  bool ordered = true;
+  int64_t expected = 0;
+  int64_t item;
+  while (expected < count)
+  {
+    if (queue.Pop(item))
+    {
+      ordered = ordered && item == expected;
+      expected++;
+    }
+    else
+      ThreadSleep(0);
+  }
+  thread.StopThread(true);
+  EXPECT_TRUE(ordered);
+  EXPECT_TRUE(queue.Empty());
+}
+
+TEST(TestSPSCQueue, LatencyBenchmark)
+{
+  static const int count = 200000;
+  std::vector<float> latencies;
+  float elapsed;
+
+  CSPSCQueue<int64_t> ring(1024);
+  MeasureLatency(ring, count, latencies, elapsed);
+  ASSERT_EQ(static_cast<size_t>(count), latencies.size());
+  RecordProperty("ring_items_per_ms", static_cast<int>(count / std::max(elapsed, 1.0f)));
+  RecordProperty("ring_p50_us", static_cast<int>(latencies[count / 2]));
+  RecordProperty("ring_p99_us", static_cast<int>(latencies[count * 99 / 100]));
+  RecordProperty("ring_max_us", static_cast<int>(latencies.back()));
+
+  CLockedQueue list(1024);
+  MeasureLatency(list, count, latencies, elapsed);
+  ASSERT_EQ(static_cast<size_t>(count), latencies.size());
+  RecordProperty("list_items_per_ms", static_cast<int>(count / std::max(elapsed, 1.0f)));
+  RecordProperty("list_p50_us", static_cast<int>(latencies[count / 2]));
+  RecordProperty("list_p99_us", static_cast<int>(latencies[count * 99 / 100]));
+  RecordProperty("list_max_us", static_cast<int>(latencies.back()));
+}
@@ -21,6 +21,7 @@
 #include "CharsetConverter.h"
 
 #include <algorithm>
+#include <atomic>
 
 #include <iconv.h>
 #include <fribidi/fribidi.h>
@@ -79,8 +80,17 @@
   #endif
 #endif
 
+#if defined(WCHAR_IS_UCS_4) || defined(WCHAR_IS_UTF16) || \
+    (defined(__STDC_ISO_10646__) && defined(__SIZEOF_WCHAR__) && __SIZEOF_WCHAR__ == 4)
+  #define WCHAR_IS_UNICODE 1 /* wchar_t holds code points or UTF-16 in native byte order */
+#endif
+
 #define NO_ICONV ((iconv_t)-1)
 
+#if defined(HAVE_SSE2) && defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 enum SpecialCharset
 {
   NotSpecialCharset = 0,
@@ -89,6 +99,23 @@ enum SpecialCharset
   SubtitleCharset /* subtitles.charset */,
 };
 
+/* iconv handle of one thread for one conversion type */
+struct SThreadConverter
+{
+  SThreadConverter() : handle(NO_ICONV), generation(0), targetSingleCharMaxLen(1) {}
+  ~SThreadConverter()
+  {
+    if (handle != NO_ICONV)
+      iconv_close(handle);
+  }
+
+  iconv_t      handle;
+  unsigned int generation;
+  unsigned int targetSingleCharMaxLen;
+};
+
+/* Charsets of a conversion. Every thread opens its own iconv handle from them,
+   so conversions only lock when a thread opens a handle or the charsets change. */
 class CConverterType : public CCriticalSection
 {
 public:
@@ -97,15 +124,14 @@ public:
   CConverterType(const std::string&  sourceCharset,        enum SpecialCharset targetSpecialCharset, unsigned int targetSingleCharMaxLen = 1);
   CConverterType(enum SpecialCharset sourceSpecialCharset, enum SpecialCharset targetSpecialCharset, unsigned int targetSingleCharMaxLen = 1);
   CConverterType(const CConverterType& other);
-  ~CConverterType();
 
-  iconv_t GetConverter(CSingleLock& converterLock);
+  /* returns the handle of the calling thread, reopened if the charsets changed since it was opened */
+  iconv_t GetConverter(SThreadConverter& converter);
 
   void Reset(void);
   void ReinitTo(const std::string& sourceCharset, const std::string& targetCharset, unsigned int targetSingleCharMaxLen = 1);
   std::string GetSourceCharset(void) const  { return m_sourceCharset; }
   std::string GetTargetCharset(void) const  { return m_targetCharset; }
-  unsigned int GetTargetSingleCharMaxLen(void) const  { return m_targetSingleCharMaxLen; }
 
 private:
   static std::string ResolveSpecialCharset(enum SpecialCharset charset);
@@ -114,8 +140,8 @@ private:
   std::string         m_sourceCharset;
   enum SpecialCharset m_targetSpecialCharset;
   std::string         m_targetCharset;
-  iconv_t             m_iconv;
   unsigned int        m_targetSingleCharMaxLen;
+  std::atomic<unsigned int> m_generation; // bumped whenever the charsets change
 };
 
 CConverterType::CConverterType(const std::string& sourceCharset, const std::string& targetCharset, unsigned int targetSingleCharMaxLen /*= 1*/) : CCriticalSection(),
@@ -123,8 +149,8 @@ CConverterType::CConverterType(const std::string& sourceCharset, const std::stri
   m_sourceCharset(sourceCharset),
   m_targetSpecialCharset(NotSpecialCharset),
   m_targetCharset(targetCharset),
-  m_iconv(NO_ICONV),
-  m_targetSingleCharMaxLen(targetSingleCharMaxLen)
+  m_targetSingleCharMaxLen(targetSingleCharMaxLen),
+  m_generation(1)
 {
 }
 
@@ -133,8 +159,8 @@ CConverterType::CConverterType(enum SpecialCharset sourceSpecialCharset, const s
   m_sourceCharset(),
   m_targetSpecialCharset(NotSpecialCharset),
   m_targetCharset(targetCharset),
-  m_iconv(NO_ICONV),
-  m_targetSingleCharMaxLen(targetSingleCharMaxLen)
+  m_targetSingleCharMaxLen(targetSingleCharMaxLen),
+  m_generation(1)
 {
 }
 
@@ -143,8 +169,8 @@ CConverterType::CConverterType(const std::string& sourceCharset, enum SpecialCha
   m_sourceCharset(sourceCharset),
   m_targetSpecialCharset(targetSpecialCharset),
   m_targetCharset(),
-  m_iconv(NO_ICONV),
-  m_targetSingleCharMaxLen(targetSingleCharMaxLen)
+  m_targetSingleCharMaxLen(targetSingleCharMaxLen),
+  m_generation(1)
 {
 }
 
@@ -153,8 +179,8 @@ CConverterType::CConverterType(enum SpecialCharset sourceSpecialCharset, enum Sp
   m_sourceCharset(),
   m_targetSpecialCharset(targetSpecialCharset),
   m_targetCharset(),
-  m_iconv(NO_ICONV),
-  m_targetSingleCharMaxLen(targetSingleCharMaxLen)
+  m_targetSingleCharMaxLen(targetSingleCharMaxLen),
+  m_generation(1)
 {
 }
 
@@ -163,56 +189,49 @@ CConverterType::CConverterType(const CConverterType& other) : CCriticalSection()
   m_sourceCharset(other.m_sourceCharset),
   m_targetSpecialCharset(other.m_targetSpecialCharset),
   m_targetCharset(other.m_targetCharset),
-  m_iconv(NO_ICONV),
-  m_targetSingleCharMaxLen(other.m_targetSingleCharMaxLen)
-{
-}
-
-CConverterType::~CConverterType()
+  m_targetSingleCharMaxLen(other.m_targetSingleCharMaxLen),
+  m_generation(1)
 {
-  CSingleLock lock(*this);
-  if (m_iconv != NO_ICONV)
-    iconv_close(m_iconv);
-  lock.Leave(); // ensure unlocking before final destruction
 }
 
-iconv_t CConverterType::GetConverter(CSingleLock& converterLock)
+iconv_t CConverterType::GetConverter(SThreadConverter& converter)
 {
-  // ensure that this unique instance is locked externally
-  if (&converterLock.get_underlying() != this)
-    return NO_ICONV;
+  if (converter.handle != NO_ICONV && converter.generation == m_generation.load(std::memory_order_acquire))
+    return converter.handle;
 
-  if (m_iconv == NO_ICONV)
+  if (converter.handle != NO_ICONV)
   {
-    if (m_sourceSpecialCharset)
-      m_sourceCharset = ResolveSpecialCharset(m_sourceSpecialCharset);
-    if (m_targetSpecialCharset)
-      m_targetCharset = ResolveSpecialCharset(m_targetSpecialCharset);
-
-    m_iconv = iconv_open(m_targetCharset.c_str(), m_sourceCharset.c_str());
-    
-    if (m_iconv == NO_ICONV)
-      CLog::Log(LOGERROR, "%s: iconv_open() for \"%s\" -> \"%s\" failed, errno = %d (%s)",
-                __FUNCTION__, m_sourceCharset.c_str(), m_targetCharset.c_str(), errno, strerror(errno));
+    iconv_close(converter.handle);
+    converter.handle = NO_ICONV;
   }
 
-  return m_iconv;
+  CSingleLock lock(*this);
+  if (m_sourceSpecialCharset && m_sourceCharset.empty())
+    m_sourceCharset = ResolveSpecialCharset(m_sourceSpecialCharset);
+  if (m_targetSpecialCharset && m_targetCharset.empty())
+    m_targetCharset = ResolveSpecialCharset(m_targetSpecialCharset);
+
+  converter.handle = iconv_open(m_targetCharset.c_str(), m_sourceCharset.c_str());
+  converter.generation = m_generation.load(std::memory_order_relaxed);
+  converter.targetSingleCharMaxLen = m_targetSingleCharMaxLen;
+
+  if (converter.handle == NO_ICONV)
+    CLog::Log(LOGERROR, "%s: iconv_open() for \"%s\" -> \"%s\" failed, errno = %d (%s)",
+              __FUNCTION__, m_sourceCharset.c_str(), m_targetCharset.c_str(), errno, strerror(errno));
+
+  return converter.handle;
 }
 
 void CConverterType::Reset(void)
 {
   CSingleLock lock(*this);
-  if (m_iconv != NO_ICONV)
-  {
-    iconv_close(m_iconv);
-    m_iconv = NO_ICONV;
-  }
-
   if (m_sourceSpecialCharset)
     m_sourceCharset.clear();
   if (m_targetSpecialCharset)
     m_targetCharset.clear();
 
+  // threads reopen their handles on their next conversion
+  m_generation++;
 }
 
 void CConverterType::ReinitTo(const std::string& sourceCharset, const std::string& targetCharset, unsigned int targetSingleCharMaxLen /*= 1*/)
@@ -220,17 +239,12 @@ void CConverterType::ReinitTo(const std::string& sourceCharset, const std::strin
   CSingleLock lock(*this);
   if (sourceCharset != m_sourceCharset || targetCharset != m_targetCharset)
   {
-    if (m_iconv != NO_ICONV)
-    {
-      iconv_close(m_iconv);
-      m_iconv = NO_ICONV;
-    }
-
     m_sourceSpecialCharset = NotSpecialCharset;
     m_sourceCharset = sourceCharset;
     m_targetSpecialCharset = NotSpecialCharset;
     m_targetCharset = targetCharset;
     m_targetSingleCharMaxLen = targetSingleCharMaxLen;
+    m_generation++;
   }
 }
 
@@ -272,6 +286,253 @@ enum StdConversionType /* Keep it in sync with CCharsetConverter::CInnerConverte
   NumberOfStdConversionTypes /* Dummy sentinel entry */
 };
 
+/* Conversions between UTF-8, UTF-32 and wchar_t of valid text don't need iconv.
+   Runs of ASCII are converted 16 characters at a time, anything that is not
+   valid Unicode makes the fast path give up and iconv handle the string, so
+   invalid characters are skipped or fail just like before. */
+namespace
+{
+
+template<typename CHAR>
+size_t WidenAscii(const unsigned char* in, size_t len, CHAR* out)
+{
+  size_t pos = 0;
+#if defined(HAVE_SSE2) && defined(__SSE2__)
+  const __m128i zero = _mm_setzero_si128();
+  for (; pos + 16 <= len; pos += 16)
+  {
+    const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + pos));
+    if (_mm_movemask_epi8(chunk) != 0)
+      break;
+
+    const __m128i low = _mm_unpacklo_epi8(chunk, zero);
+    const __m128i high = _mm_unpackhi_epi8(chunk, zero);
+    __m128i* dst = reinterpret_cast<__m128i*>(out + pos);
+    if (sizeof(CHAR) == 2)
+    {
+      _mm_storeu_si128(dst, low);
+      _mm_storeu_si128(dst + 1, high);
+    }
+    else
+    {
+      _mm_storeu_si128(dst, _mm_unpacklo_epi16(low, zero));
+      _mm_storeu_si128(dst + 1, _mm_unpackhi_epi16(low, zero));
+      _mm_storeu_si128(dst + 2, _mm_unpacklo_epi16(high, zero));
+      _mm_storeu_si128(dst + 3, _mm_unpackhi_epi16(high, zero));
+    }
+  }
+#endif
+  for (; pos < len && in[pos] < 0x80; pos++)
+    out[pos] = static_cast<CHAR>(in[pos]);
+  return pos;
+}
+
+template<typename CHAR>
+size_t NarrowAscii(const CHAR* in, size_t len, unsigned char* out)
+{
+  size_t pos = 0;
+#if defined(HAVE_SSE2) && defined(__SSE2__)
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i* src = reinterpret_cast<const __m128i*>(in);
+  for (; pos + 16 <= len; pos += 16, src += sizeof(CHAR))
+  {
+    __m128i packed;
+    if (sizeof(CHAR) == 2)
+    {
+      const __m128i a = _mm_loadu_si128(src);
+      const __m128i b = _mm_loadu_si128(src + 1);
+      const __m128i nonAscii = _mm_and_si128(_mm_or_si128(a, b), _mm_set1_epi16(~0x7F));
+      if (_mm_movemask_epi8(_mm_cmpeq_epi16(nonAscii, zero)) != 0xFFFF)
+        break;
+      packed = _mm_packus_epi16(a, b);
+    }
+    else
+    {
+      const __m128i a = _mm_loadu_si128(src);
+      const __m128i b = _mm_loadu_si128(src + 1);
+      const __m128i c = _mm_loadu_si128(src + 2);
+      const __m128i d = _mm_loadu_si128(src + 3);
+      const __m128i nonAscii = _mm_and_si128(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d)), _mm_set1_epi32(~0x7F));
+      if (_mm_movemask_epi8(_mm_cmpeq_epi32(nonAscii, zero)) != 0xFFFF)
+        break;
+      packed = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + pos), packed);
+  }
+#endif
+  for (; pos < len && static_cast<uint32_t>(in[pos]) < 0x80; pos++)
+    out[pos] = static_cast<unsigned char>(in[pos]);
+  return pos;
+}
+
+template<typename CHAR>
+bool DecodeUtf8(const std::string& strSource, std::basic_string<CHAR>& strDest)
+{
+  const unsigned char* in = reinterpret_cast<const unsigned char*>(strSource.c_str());
+  const size_t len = strSource.length();
+
+  // no more characters than bytes, even with surrogate pairs
+  strDest.resize(len);
+  CHAR* out = &strDest[0];
+  size_t pos = 0;
+  size_t outPos = 0;
+
+  while (true)
+  {
+    const size_t ascii = WidenAscii(in + pos, len - pos, out + outPos);
+    pos += ascii;
+    outPos += ascii;
+    if (pos == len)
+      break;
+
+#if defined(TARGET_DARWIN)
+    // UTF-8-MAC composes characters, leave that to iconv
+    return false;
+#else
+    uint32_t chr = in[pos];
+    size_t follow;
+    uint32_t minimum;
+    if (chr >= 0xC2 && chr <= 0xDF)
+    {
+      follow = 1;
+      chr &= 0x1F;
+      minimum = 0x80;
+    }
+    else if ((chr & 0xF0) == 0xE0)
+    {
+      follow = 2;
+      chr &= 0x0F;
+      minimum = 0x800;
+    }
+    else if (chr >= 0xF0 && chr <= 0xF4)
+    {
+      follow = 3;
+      chr &= 0x07;
+      minimum = 0x10000;
+    }
+    else
+      return false;
+
+    if (pos + follow >= len)
+      return false;
+    for (size_t i = 1; i <= follow; i++)
+    {
+      const unsigned char byte = in[pos + i];
+      if ((byte & 0xC0) != 0x80)
+        return false;
+      chr = (chr << 6) | (byte & 0x3F);
+    }
+    if (chr < minimum || chr > 0x10FFFF || (chr >= 0xD800 && chr <= 0xDFFF))
+      return false;
+    pos += follow + 1;
+
+    if (sizeof(CHAR) == 2 && chr > 0xFFFF)
+    {
+      chr -= 0x10000;
+      out[outPos++] = static_cast<CHAR>(0xD800 | (chr >> 10));
+      out[outPos++] = static_cast<CHAR>(0xDC00 | (chr & 0x3FF));
+    }
+    else
+      out[outPos++] = static_cast<CHAR>(chr);
+#endif
+  }
+
+  strDest.resize(outPos);
+  return true;
+}
+
+template<typename CHAR>
+bool EncodeUtf8(const std::basic_string<CHAR>& strSource, std::string& strDest)
+{
+  const CHAR* in = strSource.c_str();
+  const size_t len = strSource.length();
+
+  strDest.resize(len * (sizeof(CHAR) == 2 ? 3 : 4));
+  unsigned char* out = reinterpret_cast<unsigned char*>(&strDest[0]);
+  size_t pos = 0;
+  size_t outPos = 0;
+
+  while (true)
+  {
+    const size_t ascii = NarrowAscii(in + pos, len - pos, out + outPos);
+    pos += ascii;
+    outPos += ascii;
+    if (pos == len)
+      break;
+
+    uint32_t chr = static_cast<uint32_t>(in[pos++]);
+    if (sizeof(CHAR) == 2)
+      chr &= 0xFFFF;
+    if (sizeof(CHAR) == 2 && chr >= 0xD800 && chr <= 0xDBFF && pos < len)
+    {
+      const uint32_t low = static_cast<uint32_t>(in[pos]) & 0xFFFF;
+      if (low >= 0xDC00 && low <= 0xDFFF)
+      {
+        chr = 0x10000 + ((chr - 0xD800) << 10) + (low - 0xDC00);
+        pos++;
+      }
+    }
+    if (chr > 0x10FFFF || (chr >= 0xD800 && chr <= 0xDFFF))
+      return false;
+
+    if (chr < 0x800)
+    {
+      out[outPos++] = static_cast<unsigned char>(0xC0 | (chr >> 6));
+    }
+    else if (chr < 0x10000)
+    {
+      out[outPos++] = static_cast<unsigned char>(0xE0 | (chr >> 12));
+      out[outPos++] = static_cast<unsigned char>(0x80 | ((chr >> 6) & 0x3F));
+    }
+    else
+    {
+      out[outPos++] = static_cast<unsigned char>(0xF0 | (chr >> 18));
+      out[outPos++] = static_cast<unsigned char>(0x80 | ((chr >> 12) & 0x3F));
+      out[outPos++] = static_cast<unsigned char>(0x80 | ((chr >> 6) & 0x3F));
+    }
+    out[outPos++] = static_cast<unsigned char>(0x80 | (chr & 0x3F));
+  }
+
+  strDest.resize(outPos);
+  return true;
+}
+
+template<class INPUT, class OUTPUT>
+bool FastConvert(StdConversionType convertType, const INPUT& strSource, OUTPUT& strDest)
+{
+  return false;
+}
+
+bool FastConvert(StdConversionType convertType, const std::string& strSource, std::u32string& strDest)
+{
+  return convertType == Utf8ToUtf32 && DecodeUtf8(strSource, strDest);
+}
+
+bool FastConvert(StdConversionType convertType, const std::u32string& strSource, std::string& strDest)
+{
+  return convertType == Utf32ToUtf8 && EncodeUtf8(strSource, strDest);
+}
+
+bool FastConvert(StdConversionType convertType, const std::string& strSource, std::wstring& strDest)
+{
+#ifdef WCHAR_IS_UNICODE
+  return convertType == Utf8toW && DecodeUtf8(strSource, strDest);
+#else
+  return false;
+#endif
+}
+
+bool FastConvert(StdConversionType convertType, const std::wstring& strSource, std::string& strDest)
+{
+#ifdef WCHAR_IS_UNICODE
+  return convertType == WtoUtf8 && EncodeUtf8(strSource, strDest);
+#else
+  return false;
+#endif
+}
+
+}
+
 /* We don't want to pollute header file with many additional includes and definitions, so put 
    here all staff that require usage of types defined in this file or in additional headers */
 class CCharsetConverter::CInnerConverter
@@ -327,10 +588,14 @@ bool CCharsetConverter::CInnerConverter::stdConvert(StdConversionType convertTyp
   if (convertType < 0 || convertType >= NumberOfStdConversionTypes)
     return false;
 
-  CConverterType& convType = m_stdConversion[convertType];
-  CSingleLock converterLock(convType);
+  if (FastConvert(convertType, strSource, strDest))
+    return true;
+
+  static thread_local SThreadConverter threadConverters[NumberOfStdConversionTypes];
+  SThreadConverter& converter = threadConverters[convertType];
+  iconv_t handle = m_stdConversion[convertType].GetConverter(converter);
 
-  return convert(convType.GetConverter(converterLock), convType.GetTargetSingleCharMaxLen(), strSource, strDest, failOnInvalidChar);
+  return convert(handle, converter.targetSingleCharMaxLen, strSource, strDest, failOnInvalidChar);
 }
 
 template<class INPUT,class OUTPUT>
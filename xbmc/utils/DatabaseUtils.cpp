@@ -21,9 +21,11 @@
 #include <sstream>
 
 #include "DatabaseUtils.h"
+#include "LangInfo.h"
 #include "dbwrappers/dataset.h"
 #include "music/MusicDatabase.h"
 #include "utils/log.h"
+#include "utils/SortUtils.h"
 #include "utils/Variant.h"
 #include "utils/StringUtils.h"
 #include "video/VideoDatabase.h"
@@ -408,7 +410,7 @@ bool DatabaseUtils::GetDatabaseResults(const MediaType &mediaType, const FieldLi
         CLog::Log(LOGWARNING, "GetDatabaseResults: unable to retrieve value of field %s", resultSet.record_header[fieldIndex].name.c_str());
 
       if (value.first == FieldYear &&
-         (mediaType == MediaTypeTvShow || mediaType == MediaTypeEpisode))
+         (mediaType == MediaTypeMovie || mediaType == MediaTypeTvShow || mediaType == MediaTypeEpisode))
       {
         CDateTime dateTime;
         dateTime.SetFromDBDate(value.second.asString());
@@ -474,6 +476,156 @@ std::string DatabaseUtils::BuildLimitClause(int end, int start /* = 0 */)
   return sql.str();
 }
 
+static std::string RemoveArticlesSQL(const std::string &value)
+{
+  // mirrors SortUtils::RemoveArticles(): strip the first matching sort token
+  // as long as there's something left of the value
+  std::string cases;
+  for (const auto& token : g_langInfo.GetSortTokens())
+  {
+    std::string pattern;
+    for (const auto& c : token)
+    {
+      if (c == '\'')
+        pattern += "''";
+      else
+      {
+        if (c == '%' || c == '_' || c == '\\')
+          pattern += '\\';
+        pattern += c;
+      }
+    }
+
+    cases += StringUtils::Format(" WHEN %s LIKE '%s_%%' ESCAPE '\\' THEN SUBSTR(%s, %u)",
+                                 value.c_str(), pattern.c_str(), value.c_str(),
+                                 static_cast<unsigned int>(StringUtils::utf8_strlen(token.c_str()) + 1));
+  }
+
+  if (cases.empty())
+    return value;
+
+  return "CASE" + cases + " ELSE " + value + " END";
+}
+
+static bool GetLabelOrderBy(const MediaType &mediaType, bool ignoreArticle, const std::string &collation, std::vector<std::string> &terms)
+{
+  // the label is built the same way as in GetDatabaseResults()
+  if (mediaType == MediaTypeMovie || mediaType == MediaTypeTvShow || mediaType == MediaTypeMusicVideo)
+  {
+    std::string title = DatabaseUtils::GetField(FieldTitle, mediaType, DatabaseQueryPartSelect);
+    terms.push_back((ignoreArticle ? RemoveArticlesSQL(title) : title) + " COLLATE " + collation);
+  }
+  else if (mediaType == MediaTypeEpisode)
+  {
+    terms.push_back("CAST(" + DatabaseUtils::GetField(FieldSeason, mediaType, DatabaseQueryPartSelect) + " AS INTEGER) * 100 + " +
+                    "CAST(" + DatabaseUtils::GetField(FieldEpisodeNumber, mediaType, DatabaseQueryPartSelect) + " AS INTEGER)");
+    terms.push_back(DatabaseUtils::GetField(FieldTitle, mediaType, DatabaseQueryPartSelect) + " COLLATE " + collation);
+  }
+  else if (mediaType == MediaTypeSong)
+  {
+    terms.push_back(DatabaseUtils::GetField(FieldTrackNumber, mediaType, DatabaseQueryPartSelect));
+    terms.push_back(DatabaseUtils::GetField(FieldTitle, mediaType, DatabaseQueryPartSelect) + " COLLATE " + collation);
+  }
+  else if (mediaType == MediaTypeAlbum || mediaType == MediaTypeArtist)
+  {
+    std::string label = DatabaseUtils::GetField(mediaType == MediaTypeAlbum ? FieldAlbum : FieldArtist, mediaType, DatabaseQueryPartSelect);
+    terms.push_back((ignoreArticle ? RemoveArticlesSQL(label) : label) + " COLLATE " + collation);
+  }
+  else
+    return false;
+
+  return true;
+}
+
+bool DatabaseUtils::BuildOrderByClause(const SortDescription &sortDescription, const MediaType &mediaType, const std::string &collation, std::string &orderBy)
+{
+  bool ignoreArticle = (sortDescription.sortAttributes & SortAttributeIgnoreArticle) == SortAttributeIgnoreArticle;
+  std::vector<std::string> terms;
+
+  // only the sort methods whose SortUtils preparator can be reproduced
+  // exactly are supported, everything else is left to SortUtils::Sort()
+  switch (sortDescription.sortBy)
+  {
+    case SortByTitle:
+    {
+      std::string title = GetField(FieldTitle, mediaType, DatabaseQueryPartSelect);
+      if (title.empty())
+        return false;
+      terms.push_back((ignoreArticle ? RemoveArticlesSQL(title) : title) + " COLLATE " + collation);
+      break;
+    }
+
+    case SortBySortTitle:
+    {
+      // for views with a sort title the ORDER BY variant of FieldTitle
+      // already falls back to the title if the sort title is empty
+      if (GetField(FieldSortTitle, mediaType, DatabaseQueryPartSelect).empty())
+        return false;
+      std::string title = GetField(FieldTitle, mediaType, DatabaseQueryPartOrderBy);
+      terms.push_back((ignoreArticle ? RemoveArticlesSQL(title) : title) + " COLLATE " + collation);
+      break;
+    }
+
+    case SortByYear:
+      if (mediaType != MediaTypeMovie && mediaType != MediaTypeTvShow)
+        return false;
+      terms.push_back("CAST(" + GetField(FieldYear, mediaType, DatabaseQueryPartSelect) + " AS INTEGER)");
+      if (!GetLabelOrderBy(mediaType, ignoreArticle, collation, terms))
+        return false;
+      break;
+
+    case SortByDateAdded:
+    {
+      std::string dateAdded = GetField(FieldDateAdded, mediaType, DatabaseQueryPartSelect);
+      if (dateAdded.empty())
+        return false;
+      terms.push_back("COALESCE(" + dateAdded + ", '') COLLATE " + collation);
+      terms.push_back(GetField(FieldId, mediaType, DatabaseQueryPartSelect));
+      break;
+    }
+
+    case SortByRating:
+    case SortByPlaycount:
+    case SortByLastPlayed:
+    {
+      Field field = sortDescription.sortBy == SortByRating ? FieldRating :
+                    sortDescription.sortBy == SortByPlaycount ? FieldPlaycount : FieldLastPlayed;
+      std::string value = GetField(field, mediaType, DatabaseQueryPartSelect);
+      if (value.empty())
+        return false;
+      if (field == FieldLastPlayed)
+        terms.push_back("COALESCE(" + value + ", '') COLLATE " + collation);
+      else
+        terms.push_back("COALESCE(" + value + ", 0)");
+      if (!GetLabelOrderBy(mediaType, ignoreArticle, collation, terms))
+        return false;
+      break;
+    }
+
+    default:
+      return false;
+  }
+
+  std::string id = GetField(FieldId, mediaType, DatabaseQueryPartSelect);
+  if (id.empty())
+    return false;
+
+  orderBy = " ORDER BY ";
+  for (size_t i = 0; i < terms.size(); i++)
+  {
+    if (i > 0)
+      orderBy += ", ";
+    orderBy += terms[i];
+    if (sortDescription.sortOrder == SortOrderDescending)
+      orderBy += " DESC";
+  }
+  // SortUtils uses a stable sort so equal items keep their order
+  if (terms.back() != id)
+    orderBy += ", " + id;
+
+  return true;
+}
+
 int DatabaseUtils::GetField(Field field, const MediaType &mediaType, bool asIndex)
 {
   if (field == FieldNone || mediaType == MediaTypeNone)
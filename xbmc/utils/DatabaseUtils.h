@@ -28,6 +28,7 @@
 #include "media/MediaType.h"
 
 class CVariant;
+struct SortDescription;
 
 namespace dbiplus
 {
@@ -168,6 +169,16 @@ public:
 
   static std::string BuildLimitClause(int end, int start = 0);
 
+  /*! \brief Build an ORDER BY clause which sorts the rows of a media type's view
+   the same way SortUtils::Sort() would sort the matching DatabaseResults.
+   \param sortDescription the sort method, order and attributes to translate
+   \param mediaType the media type of the queried view
+   \param collation the collation to use for text comparisons (must behave like StringUtils::AlphaNumericCompare)
+   \param orderBy the resulting clause (including the leading " ORDER BY")
+   \return true if the sorting can be expressed in SQL, false if SortUtils has to do it
+   */
+  static bool BuildOrderByClause(const SortDescription &sortDescription, const MediaType &mediaType, const std::string &collation, std::string &orderBy);
+
 private:
   static int GetField(Field field, const MediaType &mediaType, bool asIndex);
 };
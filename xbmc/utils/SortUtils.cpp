@@ -432,130 +432,138 @@ std::string ByLastUsed(SortAttribute attributes, const SortItem &values)
   return values.at(FieldLastUsed).asString();
 }
 
-bool preliminarySort(const SortItem &left, const SortItem &right, bool handleFolder, bool &result, std::wstring &labelLeft, std::wstring &labelRight)
+/*!
+ \brief Precomputed sorting information of a single item.
+
+ The sort label is converted to a wide string only once per item and the
+ special sorting and folder flags are looked up only once instead of on every
+ comparison, which keeps the comparisons cheap and cache friendly.
+ */
+struct SortKey
 {
-  // make sure both items have the necessary data to do the sorting
-  SortItem::const_iterator itLeftSort, itRightSort;
-  if ((itLeftSort = left.find(FieldSort)) == left.end())
-  {
-    result = false;
-    return true;
-  }
-  if ((itRightSort = right.find(FieldSort)) == right.end())
-  {
-    result = true;
-    return true;
-  }
+  std::wstring label;
+  SortSpecial special;
+  int folder; // -1 if unknown, otherwise 0 or 1
+  size_t index;
+};
 
-  // look at special sorting behaviour
-  SortItem::const_iterator itLeft, itRight;
-  SortSpecial leftSortSpecial = SortSpecialNone;
-  SortSpecial rightSortSpecial = SortSpecialNone;
-  if ((itLeft = left.find(FieldSortSpecial)) != left.end() && itLeft->second.asInteger() <= (int64_t)SortSpecialOnBottom)
-    leftSortSpecial = (SortSpecial)itLeft->second.asInteger();
-  if ((itRight = right.find(FieldSortSpecial)) != right.end() && itRight->second.asInteger() <= (int64_t)SortSpecialOnBottom)
-    rightSortSpecial = (SortSpecial)itRight->second.asInteger();
-  
-  // one has a special sort
-  if (leftSortSpecial != rightSortSpecial)
+class SortKeyCompare
+{
+public:
+  SortKeyCompare(bool ascending, bool handleFolder)
+    : m_ascending(ascending),
+      m_handleFolder(handleFolder)
+  { }
+
+  bool operator()(const SortKey &left, const SortKey &right) const
   {
-    // left should be sorted on top
-    // or right should be sorted on bottom
-    // => left is sorted above right
-    if (leftSortSpecial == SortSpecialOnTop ||
-        rightSortSpecial == SortSpecialOnBottom)
+    // one has a special sort
+    if (left.special != right.special)
     {
-      result = true;
-      return true;
+      // left should be sorted on top
+      // or right should be sorted on bottom
+      // => left is sorted above right
+      return left.special == SortSpecialOnTop ||
+             right.special == SortSpecialOnBottom;
     }
-    
-    // otherwise right is sorted above left
-    result = false;
-    return true;
-  }
-  // both have either sort on top or sort on bottom -> leave as-is
-  else if (leftSortSpecial != SortSpecialNone && leftSortSpecial == rightSortSpecial)
-  {
-    result = false;
-    return true;
-  }
 
-  if (handleFolder)
-  {
-    itLeft = left.find(FieldFolder);
-    itRight = right.find(FieldFolder);
-    if (itLeft != left.end() && itRight != right.end() &&
-        itLeft->second.asBoolean() != itRight->second.asBoolean())
+    // both have either sort on top or sort on bottom -> leave as-is
+    if (left.special == SortSpecialNone)
     {
-      result = itLeft->second.asBoolean();
-      return true;
-    }
-  }
+      if (m_handleFolder && left.folder >= 0 && right.folder >= 0 &&
+          left.folder != right.folder)
+        return left.folder > right.folder;
 
-  labelLeft = itLeftSort->second.asWideString();
-  labelRight = itRightSort->second.asWideString();
+      int64_t result = StringUtils::AlphaNumericCompare(left.label.c_str(), right.label.c_str());
+      if (result != 0)
+        return m_ascending ? result < 0 : result > 0;
+    }
 
-  return false;
-}
+    // keep the original order of equal items (like std::stable_sort)
+    return left.index < right.index;
+  }
 
-bool SorterAscending(const SortItem &left, const SortItem &right)
-{
-  bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, true, result, labelLeft, labelRight))
-    return result;
+private:
+  bool m_ascending;
+  bool m_handleFolder;
+};
 
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) < 0;
-}
+inline SortItem& GetSortItem(DatabaseResult &item) { return item; }
+inline SortItem& GetSortItem(SortItemPtr &item) { return *item; }
 
-bool SorterDescending(const SortItem &left, const SortItem &right)
-{
-  bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, true, result, labelLeft, labelRight))
-    return result;
+/*!
+ \brief Sorts the given items and only keeps the items in [limitStart, limitEnd).
 
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) > 0;
-}
+ Instead of sorting the whole list and throwing away everything outside of the
+ requested range only the part up to limitEnd is fully ordered (using a
+ partial sort). FieldSort is only stored for the items being returned and only
+ if storeSortLabel is set.
+ */
+template<class TItems>
+void SortItemsWithLimits(SortUtils::SortPreparator preparator, const Fields &sortingFields,
+                         SortOrder sortOrder, SortAttribute attributes,
+                         TItems &items, int limitEnd, int limitStart, bool storeSortLabel)
+{
+  size_t start = 0;
+  size_t end = items.size();
+  if (limitStart > 0 && (size_t)limitStart < end)
+    start = limitStart;
+  if (limitEnd > 0 && (size_t)limitEnd > start && (size_t)limitEnd < end)
+    end = limitEnd;
+
+  if (preparator == NULL)
+  {
+    items.erase(items.begin() + end, items.end());
+    items.erase(items.begin(), items.begin() + start);
+    return;
+  }
 
-bool SorterIgnoreFoldersAscending(const SortItem &left, const SortItem &right)
-{
-  bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, false, result, labelLeft, labelRight))
-    return result;
+  // Prepare the keys used for sorting
+  std::vector<SortKey> keys(items.size());
+  for (size_t index = 0; index < items.size(); ++index)
+  {
+    SortItem &item = GetSortItem(items[index]);
 
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) < 0;
-}
+    // add all fields to the item that are required for sorting if they are currently missing
+    for (Fields::const_iterator field = sortingFields.begin(); field != sortingFields.end(); ++field)
+    {
+      if (item.find(*field) == item.end())
+        item.insert(std::pair<Field, CVariant>(*field, CVariant::ConstNullVariant));
+    }
 
-bool SorterIgnoreFoldersDescending(const SortItem &left, const SortItem &right)
-{
-  bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, false, result, labelLeft, labelRight))
-    return result;
+    SortKey &key = keys[index];
+    key.index = index;
+    g_charsetConverter.utf8ToW(preparator(attributes, item), key.label, false);
 
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) > 0;
-}
+    key.special = SortSpecialNone;
+    SortItem::const_iterator it = item.find(FieldSortSpecial);
+    if (it != item.end() && it->second.asInteger() <= (int64_t)SortSpecialOnBottom)
+      key.special = (SortSpecial)it->second.asInteger();
 
-bool SorterIndirectAscending(const SortItemPtr &left, const SortItemPtr &right)
-{
-  return SorterAscending(*left, *right);
-}
+    key.folder = -1;
+    if ((it = item.find(FieldFolder)) != item.end())
+      key.folder = it->second.asBoolean() ? 1 : 0;
+  }
 
-bool SorterIndirectDescending(const SortItemPtr &left, const SortItemPtr &right)
-{
-  return SorterDescending(*left, *right);
-}
+  // Do the sorting but only as far as necessary
+  SortKeyCompare compare(sortOrder != SortOrderDescending, (attributes & SortAttributeIgnoreFolders) == 0);
+  if (end < keys.size())
+    std::partial_sort(keys.begin(), keys.begin() + end, keys.end(), compare);
+  else
+    std::sort(keys.begin(), keys.end(), compare);
 
-bool SorterIndirectIgnoreFoldersAscending(const SortItemPtr &left, const SortItemPtr &right)
-{
-  return SorterIgnoreFoldersAscending(*left, *right);
-}
+  // Move the requested items into their new order
+  TItems sortedItems;
+  sortedItems.reserve(end - start);
+  for (size_t index = start; index < end; ++index)
+  {
+    SortKey &key = keys[index];
+    sortedItems.push_back(std::move(items[key.index]));
+    if (storeSortLabel)
+      GetSortItem(sortedItems.back())[FieldSort] = CVariant(std::move(key.label));
+  }
 
-bool SorterIndirectIgnoreFoldersDescending(const SortItemPtr &left, const SortItemPtr &right)
-{
-  return SorterIgnoreFoldersDescending(*left, *right);
+  items.swap(sortedItems);
 }
 
 std::map<SortBy, SortUtils::SortPreparator> fillPreparators()
@@ -710,80 +718,14 @@ std::map<SortBy, Fields> SortUtils::m_sortingFields = fillSortingFields();
 
 void SortUtils::Sort(SortBy sortBy, SortOrder sortOrder, SortAttribute attributes, DatabaseResults& items, int limitEnd /* = -1 */, int limitStart /* = 0 */)
 {
-  if (sortBy != SortByNone)
-  {
-    // get the matching SortPreparator
-    SortPreparator preparator = getPreparator(sortBy);
-    if (preparator != NULL)
-    {
-      Fields sortingFields = GetFieldsForSorting(sortBy);
-
-      // Prepare the string used for sorting and store it under FieldSort
-      for (DatabaseResults::iterator item = items.begin(); item != items.end(); ++item)
-      {
-        // add all fields to the item that are required for sorting if they are currently missing
-        for (Fields::const_iterator field = sortingFields.begin(); field != sortingFields.end(); ++field)
-        {
-          if (item->find(*field) == item->end())
-            item->insert(std::pair<Field, CVariant>(*field, CVariant::ConstNullVariant));
-        }
-
-        std::wstring sortLabel;
-        g_charsetConverter.utf8ToW(preparator(attributes, *item), sortLabel, false);
-        item->insert(std::pair<Field, CVariant>(FieldSort, CVariant(sortLabel)));
-      }
-
-      // Do the sorting
-      std::stable_sort(items.begin(), items.end(), getSorter(sortOrder, attributes));
-    }
-  }
-
-  if (limitStart > 0 && (size_t)limitStart < items.size())
-  {
-    items.erase(items.begin(), items.begin() + limitStart);
-    limitEnd -= limitStart;
-  }
-  if (limitEnd > 0 && (size_t)limitEnd < items.size())
-    items.erase(items.begin() + limitEnd, items.end());
+  SortPreparator preparator = sortBy != SortByNone ? getPreparator(sortBy) : NULL;
+  SortItemsWithLimits(preparator, GetFieldsForSorting(sortBy), sortOrder, attributes, items, limitEnd, limitStart, false);
 }
 
 void SortUtils::Sort(SortBy sortBy, SortOrder sortOrder, SortAttribute attributes, SortItems& items, int limitEnd /* = -1 */, int limitStart /* = 0 */)
 {
-  if (sortBy != SortByNone)
-  {
-    // get the matching SortPreparator
-    SortPreparator preparator = getPreparator(sortBy);
-    if (preparator != NULL)
-    {
-      Fields sortingFields = GetFieldsForSorting(sortBy);
-
-      // Prepare the string used for sorting and store it under FieldSort
-      for (SortItems::iterator item = items.begin(); item != items.end(); ++item)
-      {
-        // add all fields to the item that are required for sorting if they are currently missing
-        for (Fields::const_iterator field = sortingFields.begin(); field != sortingFields.end(); ++field)
-        {
-          if ((*item)->find(*field) == (*item)->end())
-            (*item)->insert(std::pair<Field, CVariant>(*field, CVariant::ConstNullVariant));
-        }
-
-        std::wstring sortLabel;
-        g_charsetConverter.utf8ToW(preparator(attributes, **item), sortLabel, false);
-        (*item)->insert(std::pair<Field, CVariant>(FieldSort, CVariant(sortLabel)));
-      }
-
-      // Do the sorting
-      std::stable_sort(items.begin(), items.end(), getSorterIndirect(sortOrder, attributes));
-    }
-  }
-
-  if (limitStart > 0 && (size_t)limitStart < items.size())
-  {
-    items.erase(items.begin(), items.begin() + limitStart);
-    limitEnd -= limitStart;
-  }
-  if (limitEnd > 0 && (size_t)limitEnd < items.size())
-    items.erase(items.begin() + limitEnd, items.end());
+  SortPreparator preparator = sortBy != SortByNone ? getPreparator(sortBy) : NULL;
+  SortItemsWithLimits(preparator, GetFieldsForSorting(sortBy), sortOrder, attributes, items, limitEnd, limitStart, true);
 }
 
 void SortUtils::Sort(const SortDescription &sortDescription, DatabaseResults& items)
@@ -826,22 +768,6 @@ const SortUtils::SortPreparator& SortUtils::getPreparator(SortBy sortBy)
   return m_preparators[SortByNone];
 }
 
-SortUtils::Sorter SortUtils::getSorter(SortOrder sortOrder, SortAttribute attributes)
-{
-  if (attributes & SortAttributeIgnoreFolders)
-    return sortOrder == SortOrderDescending ? SorterIgnoreFoldersDescending : SorterIgnoreFoldersAscending;
-
-  return sortOrder == SortOrderDescending ? SorterDescending : SorterAscending;
-}
-
-SortUtils::SorterIndirect SortUtils::getSorterIndirect(SortOrder sortOrder, SortAttribute attributes)
-{
-  if (attributes & SortAttributeIgnoreFolders)
-    return sortOrder == SortOrderDescending ? SorterIndirectIgnoreFoldersDescending : SorterIndirectIgnoreFoldersAscending;
-
-  return sortOrder == SortOrderDescending ? SorterIndirectDescending : SorterIndirectAscending;
-}
-
 const Fields& SortUtils::GetFieldsForSorting(SortBy sortBy)
 {
   std::map<SortBy, Fields>::const_iterator it = m_sortingFields.find(sortBy);
@@ -20,6 +20,8 @@
 
 #include "Utf8Utils.h"
 
+#include <stdint.h>
+
 
 CUtf8Utils::utf8CheckResult CUtf8Utils::checkStrForUtf8(const std::string& str)
 {
@@ -158,3 +160,48 @@ inline size_t CUtf8Utils::SizeOfUtf8Char(const char* const str)
 
   return 0; // invalid UTF-8 char sequence
 }
+
+bool CUtf8Utils::Utf8ToW(const std::string& str, std::wstring& wide)
+{
+  const unsigned char* s = reinterpret_cast<const unsigned char*>(str.c_str());
+  const size_t len = str.length();
+
+  wide.clear();
+  wide.reserve(len);
+
+  size_t pos = 0;
+  while (pos < len)
+  {
+    // runs of ASCII are by far the most common
+    if (s[pos] < 0x80)
+    {
+      wide.push_back(static_cast<wchar_t>(s[pos++]));
+      continue;
+    }
+
+    // SizeOfUtf8Char rejects overlong forms, surrogates and anything beyond U+10FFFF
+    const size_t chrLen = SizeOfUtf8Char(reinterpret_cast<const char*>(s + pos));
+    if (chrLen == 0 || pos + chrLen > len)
+      return false;
+
+    uint32_t chr;
+    if (chrLen == 2)
+      chr = ((s[pos] & 0x1F) << 6) | (s[pos + 1] & 0x3F);
+    else if (chrLen == 3)
+      chr = ((s[pos] & 0x0F) << 12) | ((s[pos + 1] & 0x3F) << 6) | (s[pos + 2] & 0x3F);
+    else
+      chr = ((s[pos] & 0x07) << 18) | ((s[pos + 1] & 0x3F) << 12) | ((s[pos + 2] & 0x3F) << 6) | (s[pos + 3] & 0x3F);
+    pos += chrLen;
+
+    if (sizeof(wchar_t) == 2 && chr > 0xFFFF)
+    {
+      chr -= 0x10000;
+      wide.push_back(static_cast<wchar_t>(0xD800 | (chr >> 10)));
+      wide.push_back(static_cast<wchar_t>(0xDC00 | (chr & 0x3FF)));
+    }
+    else
+      wide.push_back(static_cast<wchar_t>(chr));
+  }
+
+  return true;
+}
@@ -50,6 +50,14 @@ public:
   static size_t RFindValidUtf8Char(const std::string& str, const size_t startPos);
   
   static size_t SizeOfUtf8Char(const std::string& str, const size_t charStart = 0);
+
+  /**
+   * Decode UTF-8 to wide characters without going through iconv
+   * @param str string to decode
+   * @param wide receives the characters, UTF-16 if wchar_t is 16 bits wide
+   * @return false if str is not valid UTF-8, wide is undefined then
+   */
+  static bool Utf8ToW(const std::string& str, std::wstring& wide);
 private:
   static size_t SizeOfUtf8Char(const char* const str);
 };
@@ -20,11 +20,15 @@
 
 #include "log.h"
 #include "system.h"
+#include "threads/Event.h"
 #include "threads/SingleLock.h"
 #include "threads/Thread.h"
 #include "utils/StringUtils.h"
 #include "CompileInfo.h"
 
+#include <thread>
+#include <vector>
+
 static const char* const levelNames[] =
 {"DEBUG", "INFO", "NOTICE", "WARNING", "ERROR", "SEVERE", "FATAL", "NONE"};
 
@@ -32,20 +36,295 @@ static const char* const levelNames[] =
 static const char* const logLevelNames[] =
 { "LOG_LEVEL_NONE" /*-1*/, "LOG_LEVEL_NORMAL" /*0*/, "LOG_LEVEL_DEBUG" /*1*/, "LOG_LEVEL_DEBUG_FREEMEM" /*2*/ };
 
+// number of lines that can be pending for the writer thread, must be a power of 2
+#define LOG_QUEUE_SIZE        4096
+// maximum time a queued line waits before the writer thread picks it up
+#define LOG_FLUSH_INTERVAL_MS 100
+
 // s_globals is used as static global with CLog global variables
 #define s_globals XBMC_GLOBAL_USE(CLog).m_globalInstance
 
+struct CLog::LogEntry
+{
+  int level;
+  uint64_t threadId;
+  int hour;
+  int minute;
+  int second;
+  int millisecond;
+  std::string message;
+};
+
+/*!
+ \brief Bounded multi-producer, single-consumer ring of log entries.
+
+ Producers claim a slot with a single compare-and-swap on the tail and never block.
+ Each slot carries a sequence number that tells whether it is free for the producer
+ at a given position or holds a published entry for the consumer at that position.
+ Consumers are serialized by the caller (CLogGlobals::critSec).
+ */
+class CLog::CLogQueue
+{
+public:
+  CLogQueue() : m_cells(LOG_QUEUE_SIZE), m_tail(0), m_head(0), m_dropped(0)
+  {
+    for (size_t i = 0; i < m_cells.size(); i++)
+      m_cells[i].sequence.store(i, std::memory_order_relaxed);
+  }
+
+  bool Push(LogEntry& entry)
+  {
+    const int level = entry.level;
+    size_t pos = m_tail.load(std::memory_order_relaxed);
+    Cell *cell;
+    for (;;)
+    {
+      cell = &m_cells[pos & (LOG_QUEUE_SIZE - 1)];
+      const size_t seq = cell->sequence.load(std::memory_order_acquire);
+      const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+      if (diff == 0)
+      {
+        if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+          break;
+      }
+      else if (diff < 0)
+        return false; // full
+      else
+        pos = m_tail.load(std::memory_order_relaxed);
+    }
+
+    cell->entry = std::move(entry);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+
+    // errors go out promptly, everything else is batched unless the queue is filling up
+    if (level >= LOGERROR || pos - m_head.load(std::memory_order_relaxed) == LOG_QUEUE_SIZE / 4)
+      m_wake.Set();
+    return true;
+  }
+
+  bool Pop(LogEntry& entry)
+  {
+    const size_t pos = m_head.load(std::memory_order_relaxed);
+    Cell &cell = m_cells[pos & (LOG_QUEUE_SIZE - 1)];
+    if (cell.sequence.load(std::memory_order_acquire) != pos + 1)
+      return false;
+
+    entry = std::move(cell.entry);
+    cell.sequence.store(pos + LOG_QUEUE_SIZE, std::memory_order_release);
+    m_head.store(pos + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  bool IsEmpty() const
+  {
+    return m_tail.load(std::memory_order_relaxed) == m_head.load(std::memory_order_relaxed);
+  }
+
+  void Drop() { m_dropped.fetch_add(1, std::memory_order_relaxed); }
+  uint64_t GetDropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+  void Wake() { m_wake.Set(); }
+  void WaitForEntries(unsigned int milliSeconds) { m_wake.WaitMSec(milliSeconds); }
+
+private:
+  struct Cell
+  {
+    std::atomic<size_t> sequence;
+    LogEntry entry;
+  };
+  std::vector<Cell> m_cells;
+  std::atomic<size_t> m_tail;
+  std::atomic<size_t> m_head;
+  std::atomic<uint64_t> m_dropped;
+  CEvent m_wake;
+};
+
+class CLog::CLogWriter : public CThread
+{
+public:
+  explicit CLogWriter(CLogGlobals& globals) : CThread("LogWriter"), m_globals(globals) {}
+
+  void Stop()
+  {
+    m_bStop = true;
+    m_globals.m_queue->Wake();
+    StopThread(true);
+  }
+
+protected:
+  void Process() override
+  {
+    while (!m_bStop)
+    {
+      {
+        CSingleLock lock(m_globals.critSec);
+        m_globals.WriteQueuedEntries(NULL);
+      }
+      if (m_globals.m_queue->IsEmpty())
+        m_globals.m_queue->WaitForEntries(LOG_FLUSH_INTERVAL_MS);
+    }
+  }
+
+private:
+  CLogGlobals& m_globals;
+};
+
+CLog::CLogGlobals::CLogGlobals(void)
+  : m_repeatCount(0),
+    m_repeatLogLevel(-1),
+    m_logLevel(LOG_LEVEL_DEBUG),
+    m_extraLogLevels(0),
+    m_asyncWrite(false),
+    m_asyncProducers(0),
+    m_queue(new CLogQueue()),
+    m_droppedReported(0)
+{ }
+
+CLog::CLogGlobals::~CLogGlobals()
+{
+  StopWriter();
+  CSingleLock waitLock(critSec);
+  WriteQueuedEntries(NULL);
+}
+
+void CLog::CLogGlobals::StartWriter()
+{
+  CSingleLock lock(writerSection);
+  if (!m_writer)
+  {
+    m_writer.reset(new CLogWriter(*this));
+    m_writer->Create();
+  }
+  m_asyncWrite = true;
+}
+
+void CLog::CLogGlobals::StopWriter()
+{
+  CSingleLock lock(writerSection);
+  m_asyncWrite = false;
+  // a push never blocks, so producers that saw the flag still set leave quickly
+  while (m_asyncProducers > 0)
+    std::this_thread::yield();
+  if (m_writer)
+  {
+    m_writer->Stop();
+    m_writer.reset();
+  }
+}
+
+size_t CLog::CLogGlobals::WriteQueuedEntries(LogEntry *entry)
+{
+  m_writeBuffer.clear();
+
+  const uint64_t dropped = m_queue->GetDropped();
+  if (dropped != m_droppedReported)
+  {
+    LogEntry notice;
+    notice.level = LOGWARNING;
+    notice.threadId = (uint64_t)CThread::GetCurrentThreadId();
+    double millisecond;
+    PlatformInterfaceForCLog::GetCurrentLocalTime(notice.hour, notice.minute, notice.second, millisecond);
+    notice.millisecond = static_cast<int>(millisecond);
+    notice.message = StringUtils::Format("Log queue full, dropped %" PRIu64" lines.", dropped - m_droppedReported);
+    m_droppedReported = dropped;
+    AppendEntry(notice);
+  }
+
+  // take at most one queue worth of lines so busy producers can't keep us here forever
+  size_t count = 0;
+  LogEntry queued;
+  while (count < LOG_QUEUE_SIZE && m_queue->Pop(queued))
+  {
+    AppendEntry(queued);
+    count++;
+  }
+
+  if (entry)
+    AppendEntry(*entry);
+
+  if (!m_writeBuffer.empty())
+    m_platform.WriteStringToLog(m_writeBuffer);
+
+  return count;
+}
+
+void CLog::CLogGlobals::AppendEntry(LogEntry& entry)
+{
+  if (m_repeatLogLevel == entry.level && m_repeatLine == entry.message)
+  {
+    m_repeatCount++;
+    return;
+  }
+  else if (m_repeatCount)
+  {
+    std::string strData = StringUtils::Format("Previous line repeats %d times.", m_repeatCount);
+#if defined(_DEBUG) || defined(PROFILE)
+    m_platform.PrintDebugString(strData);
+#endif // defined(_DEBUG) || defined(PROFILE)
+    AppendLine(entry, m_repeatLogLevel, strData);
+    m_repeatCount = 0;
+  }
+
+#if defined(_DEBUG) || defined(PROFILE)
+  m_platform.PrintDebugString(entry.message);
+#endif // defined(_DEBUG) || defined(PROFILE)
+  AppendLine(entry, entry.level, entry.message);
+
+  m_repeatLogLevel = entry.level;
+  m_repeatLine.swap(entry.message);
+}
+
+void CLog::CLogGlobals::AppendLine(const LogEntry& entry, int logLevel, const std::string& line)
+{
+  static const char* prefixFormat = "%02d:%02d:%02d.%03d T:%" PRIu64" %7s: ";
+
+  if (!m_writeBuffer.empty())
+    m_writeBuffer += '\n';
+
+  m_writeBuffer += StringUtils::Format(prefixFormat,
+                                       entry.hour,
+                                       entry.minute,
+                                       entry.second,
+                                       entry.millisecond,
+                                       entry.threadId,
+                                       levelNames[logLevel]);
+
+  if (line.find('\n') == std::string::npos)
+    m_writeBuffer += line;
+  else
+  {
+    /* fixup newline alignment, number of spaces should equal prefix length */
+    std::string strData(line);
+    StringUtils::Replace(strData, "\n", "\n                                            ");
+    m_writeBuffer += strData;
+  }
+}
+
 CLog::CLog() = default;
 
 CLog::~CLog() = default;
 
 void CLog::Close()
 {
+  s_globals.StopWriter();
+
   CSingleLock waitLock(s_globals.critSec);
+  s_globals.WriteQueuedEntries(NULL);
   s_globals.m_platform.CloseLogFile();
   s_globals.m_repeatLine.clear();
 }
 
+void CLog::Flush()
+{
+  CSingleLock waitLock(s_globals.critSec);
+  s_globals.WriteQueuedEntries(NULL);
+}
+
+uint64_t CLog::GetDroppedLines()
+{
+  return s_globals.m_queue->GetDropped();
+}
+
 void CLog::Log(int loglevel, const char *format, ...)
 {
   if (IsLogLevelLogged(loglevel))
@@ -73,32 +352,42 @@ void CLog::LogFunction(int loglevel, const char* functionName, const char* forma
 
 void CLog::LogString(int logLevel, const std::string& logString)
 {
-  CSingleLock waitLock(s_globals.critSec);
-  std::string strData(logString);
-  StringUtils::TrimRight(strData);
-  if (!strData.empty())
+  LogEntry entry;
+  entry.message = logString;
+  StringUtils::TrimRight(entry.message);
+  if (entry.message.empty())
+    return;
+
+  entry.level = logLevel & LOGMASK;
+  entry.threadId = (uint64_t)CThread::GetCurrentThreadId();
+  double millisecond;
+  PlatformInterfaceForCLog::GetCurrentLocalTime(entry.hour, entry.minute, entry.second, millisecond);
+  entry.millisecond = static_cast<int>(millisecond);
+
+  // severe and fatal lines usually precede a crash, so they are always written out
+  // before returning. when the queue is full, lines below error level are dropped
+  // and errors fall back to a synchronous write.
+  if (entry.level < LOGSEVERE)
   {
-    if (s_globals.m_repeatLogLevel == logLevel && s_globals.m_repeatLine == strData)
-    {
-      s_globals.m_repeatCount++;
-      return;
-    }
-    else if (s_globals.m_repeatCount)
+    bool handled = false;
+    s_globals.m_asyncProducers++;
+    if (s_globals.m_asyncWrite)
     {
-      std::string strData2 = StringUtils::Format("Previous line repeats %d times.",
-                                                s_globals.m_repeatCount);
-      PrintDebugString(strData2);
-      WriteLogString(s_globals.m_repeatLogLevel, strData2);
-      s_globals.m_repeatCount = 0;
+      if (s_globals.m_queue->Push(entry))
+        handled = true;
+      else if (entry.level < LOGERROR)
+      {
+        s_globals.m_queue->Drop();
+        handled = true;
+      }
     }
-
-    s_globals.m_repeatLine = strData;
-    s_globals.m_repeatLogLevel = logLevel;
-
-    PrintDebugString(strData);
-
-    WriteLogString(logLevel, strData);
+    s_globals.m_asyncProducers--;
+    if (handled)
+      return;
   }
+
+  CSingleLock waitLock(s_globals.critSec);
+  s_globals.WriteQueuedEntries(&entry);
 }
 
 bool CLog::Init(const std::string& path)
@@ -110,7 +399,12 @@ bool CLog::Init(const std::string& path)
 
   std::string appName = CCompileInfo::GetAppName();
   StringUtils::ToLower(appName);
-  return s_globals.m_platform.OpenLogFile(path + appName + ".log", path + appName + ".old.log");
+  if (!s_globals.m_platform.OpenLogFile(path + appName + ".log", path + appName + ".old.log"))
+    return false;
+
+  waitLock.Leave();
+  s_globals.StartWriter();
+  return true;
 }
 
 void CLog::MemDump(char *pData, int length)
@@ -189,26 +483,3 @@ void CLog::PrintDebugString(const std::string& line)
   s_globals.m_platform.PrintDebugString(line);
 #endif // defined(_DEBUG) || defined(PROFILE)
 }
-
-bool CLog::WriteLogString(int logLevel, const std::string& logString)
-{
-  static const char* prefixFormat = "%02d:%02d:%02d.%03d T:%" PRIu64" %7s: ";
-
-  std::string strData(logString);
-  /* fixup newline alignment, number of spaces should equal prefix length */
-  StringUtils::Replace(strData, "\n", "\n                                            ");
-
-  int hour, minute, second;
-  double millisecond;
-  s_globals.m_platform.GetCurrentLocalTime(hour, minute, second, millisecond);
-
-  strData = StringUtils::Format(prefixFormat,
-                                  hour,
-                                  minute,
-                                  second,
-                                  static_cast<int>(millisecond),
-                                  (uint64_t)CThread::GetCurrentThreadId(),
-                                  levelNames[logLevel]) + strData;
-
-  return s_globals.m_platform.WriteStringToLog(strData);
-}
@@ -20,6 +20,8 @@
  *
  */
 
+#include <atomic>
+#include <memory>
 #include <string>
 
 #if defined(TARGET_POSIX)
@@ -47,6 +49,12 @@ public:
 #define LogF(loglevel,format,...) LogFunction((loglevel),__FUNCTION__,(format),##__VA_ARGS__)
   static void MemDump(char *pData, int length);
   static bool Init(const std::string& path);
+  /*! \brief Write out all log lines still queued for the background writer.
+   Safe to call from crash handlers that are about to terminate the process.
+   */
+  static void Flush();
+  /*! \brief Number of log lines discarded because the log queue was full. */
+  static uint64_t GetDroppedLines();
   static void PrintDebugString(const std::string& line); // universal interface for printing debug strings
   static void SetLogLevel(int level);
   static int  GetLogLevel();
@@ -54,11 +62,15 @@ public:
   static bool IsLogLevelLogged(int loglevel);
 
 protected:
+  struct LogEntry;
+  class CLogQueue;
+  class CLogWriter;
+
   class CLogGlobals
   {
   public:
-    CLogGlobals(void) : m_repeatCount(0), m_repeatLogLevel(-1), m_logLevel(LOG_LEVEL_DEBUG), m_extraLogLevels(0) {}
-    ~CLogGlobals() = default;
+    CLogGlobals(void);
+    ~CLogGlobals();
     PlatformInterfaceForCLog m_platform;
     int         m_repeatCount;
     int         m_repeatLogLevel;
@@ -66,10 +78,36 @@ protected:
     int         m_logLevel;
     int         m_extraLogLevels;
     CCriticalSection critSec;
+
+    /*! \brief Lines are handed to the writer thread through m_queue while m_asyncWrite is set,
+     otherwise they are written synchronously under critSec.
+     */
+    std::atomic<bool> m_asyncWrite;
+    /*! \brief Number of threads between checking m_asyncWrite and queueing their line.
+     StopWriter() waits for it to reach zero so no line is queued after the final drain.
+     */
+    std::atomic<int> m_asyncProducers;
+    std::unique_ptr<CLogQueue> m_queue;
+    std::unique_ptr<CLogWriter> m_writer;
+    CCriticalSection writerSection;
+    uint64_t    m_droppedReported;
+    std::string m_writeBuffer;
+
+    void StartWriter();
+    void StopWriter();
+    /*! \brief Drain the queue and write it, followed by the given entry, in a single write.
+     Callers must hold critSec.
+     \param entry optional entry to write after the queued ones, may be NULL.
+     \return the number of entries taken from the queue.
+     */
+    size_t WriteQueuedEntries(LogEntry *entry);
+
+  private:
+    void AppendEntry(LogEntry& entry);
+    void AppendLine(const LogEntry& entry, int logLevel, const std::string& line);
   };
   class CLogGlobals m_globalInstance; // used as static global variable
   static void LogString(int logLevel, const std::string& logString);
-  static bool WriteLogString(int logLevel, const std::string& logString);
 };
 
 
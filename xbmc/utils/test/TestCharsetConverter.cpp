@@ -20,12 +20,18 @@
 
 #include "ServiceBroker.h"
 #include "settings/Settings.h"
+#include "threads/Thread.h"
 #include "utils/CharsetConverter.h"
+#include "utils/TimeUtils.h"
 #include "utils/Utf8Utils.h"
 #include "system.h"
 
 #include "gtest/gtest.h"
 
+#include <algorithm>
+#include <memory>
+#include <vector>
+
 #if 0
 static const uint16_t refutf16LE1[] = { 0xff54, 0xff45, 0xff53, 0xff54,
                                         0xff3f, 0xff55, 0xff54, 0xff46,
@@ -412,3 +418,106 @@ TEST_F(TestCharsetConverter, fromW)
   g_charsetConverter.fromW(refstrw1, varstra1, "UTF-16LE");
   EXPECT_STREQ(refstra1.c_str(), varstra1.c_str());
 }
+
+TEST_F(TestCharsetConverter, utf8ToUtf32_RoundTrip)
+{
+  // ascii runs longer than a vector register, two, three and four byte characters
+  refstra1 = "plain ascii text that is long enough, caf\xC3\xA9 \xE2\x82\xAC \xD7\xA9\xD7\x9C\xD7\x95\xD7\x9D "
+             "\xE4\xB8\xAD\xE6\x96\x87 \xF0\x9F\x90\xAD and more ascii at the end";
+  std::u32string utf32;
+  EXPECT_TRUE(g_charsetConverter.utf8ToUtf32(refstra1, utf32));
+  ASSERT_FALSE(utf32.empty());
+  EXPECT_EQ(U'p', utf32[0]);
+  EXPECT_NE(std::u32string::npos, utf32.find(U'\x20AC'));
+#ifndef TARGET_DARWIN
+  EXPECT_NE(std::u32string::npos, utf32.find(U'\x1F42D'));
+#endif
+
+  varstra1.clear();
+  EXPECT_TRUE(g_charsetConverter.utf32ToUtf8(utf32, varstra1));
+  EXPECT_EQ(refstra1, varstra1);
+
+  std::wstring wide;
+  EXPECT_TRUE(g_charsetConverter.utf8ToW(refstra1, wide, false));
+  varstra1.clear();
+  EXPECT_TRUE(g_charsetConverter.wToUTF8(wide, varstra1));
+  EXPECT_EQ(refstra1, varstra1);
+}
+
+TEST_F(TestCharsetConverter, utf8ToW_Invalid)
+{
+  // invalid bytes are still skipped
+  std::wstring wide;
+  EXPECT_TRUE(g_charsetConverter.utf8ToW("ab\xFF" "cd", wide, false));
+  EXPECT_EQ(L"abcd", wide);
+
+  std::u32string utf32;
+  EXPECT_FALSE(g_charsetConverter.utf8ToUtf32("ab\xFF" "cd", utf32, true));
+}
+
+namespace
+{
+
+class CConversionRunner : public IRunnable
+{
+public:
+  CConversionRunner(const std::string& utf8, const std::u16string& utf16, int count)
+    : m_utf8(utf8), m_utf16(utf16), m_count(count) {}
+
+  void Run() override
+  {
+    std::u32string utf32;
+    std::string utf8;
+    for (int i = 0; i < m_count; i++)
+    {
+      if (!m_utf8.empty())
+        CCharsetConverter::utf8ToUtf32(m_utf8, utf32);
+      else
+        CCharsetConverter::utf16LEtoUTF8(m_utf16, utf8);
+    }
+  }
+
+private:
+  std::string m_utf8;
+  std::u16string m_utf16;
+  int m_count;
+};
+
+// conversions per millisecond of all threads together
+int MeasureThroughput(int threads, const std::string& utf8, const std::u16string& utf16, int count)
+{
+  std::vector<std::unique_ptr<CConversionRunner>> runners;
+  std::vector<std::unique_ptr<CThread>> workers;
+  const int64_t start = CurrentHostCounter();
+  for (int i = 0; i < threads; i++)
+  {
+    runners.emplace_back(new CConversionRunner(utf8, utf16, count));
+    workers.emplace_back(new CThread(runners.back().get(), "CharsetConverterTest"));
+    workers.back()->Create();
+  }
+  for (auto& worker : workers)
+    worker->StopThread(true);
+
+  const float elapsed = (CurrentHostCounter() - start) * 1000.0f / CurrentHostFrequency();
+  return static_cast<int>(threads * count / std::max(elapsed, 1.0f));
+}
+
+}
+
+// conversions per millisecond with one and with several threads, to see whether the converters contend
+TEST_F(TestCharsetConverter, ThreadedBenchmark)
+{
+  static const int count = 20000;
+  const std::string ascii = "The quick brown fox jumps over the lazy dog, 0123456789";
+  const std::string mixed = "Fran\xC3\xA7ois Truffaut \xE2\x80\x93 Les Quatre Cents Coups \xE4\xB8\xAD\xE6\x96\x87";
+  const std::u16string utf16(u"Fran\u00E7ois Truffaut \u2013 Les Quatre Cents Coups \u4E2D\u6587");
+
+  for (int threads : { 1, 4 })
+  {
+    const std::string suffix = "_" + std::to_string(threads) + "_threads_per_ms";
+    RecordProperty("ascii" + suffix, MeasureThroughput(threads, ascii, std::u16string(), count));
+    RecordProperty("utf8" + suffix, MeasureThroughput(threads, mixed, std::u16string(), count));
+    // no fast path, every call goes through iconv
+    RecordProperty("iconv" + suffix, MeasureThroughput(threads, std::string(), utf16, count));
+  }
+}
@@ -19,6 +19,7 @@
  */
 
 #include "utils/DatabaseUtils.h"
+#include "utils/SortUtils.h"
 #include "video/VideoDatabase.h"
 #include "music/MusicDatabase.h"
 #include "dbwrappers/qry_dat.h"
@@ -1361,6 +1362,34 @@ TEST(TestDatabaseUtils, BuildLimitClause)
   EXPECT_STREQ(" LIMIT 100", a.c_str());
 }
 
+TEST(TestDatabaseUtils, BuildOrderByClause)
+{
+  std::string refstr, varstr;
+  SortDescription sorting;
+
+  sorting.sortBy = SortByNone;
+  EXPECT_FALSE(DatabaseUtils::BuildOrderByClause(sorting, MediaTypeMovie, "ALPHANUM", varstr));
+
+  sorting.sortBy = SortByVotes;
+  EXPECT_FALSE(DatabaseUtils::BuildOrderByClause(sorting, MediaTypeMovie, "ALPHANUM", varstr));
+
+  sorting.sortBy = SortBySortTitle;
+  EXPECT_FALSE(DatabaseUtils::BuildOrderByClause(sorting, MediaTypeSong, "ALPHANUM", varstr));
+
+  sorting.sortBy = SortByPlaycount;
+  refstr = StringUtils::Format(" ORDER BY COALESCE(movie_view.playCount, 0), "
+                               "movie_view.c%02d COLLATE ALPHANUM, movie_view.idMovie", VIDEODB_ID_TITLE);
+  EXPECT_TRUE(DatabaseUtils::BuildOrderByClause(sorting, MediaTypeMovie, "ALPHANUM", varstr));
+  EXPECT_STREQ(refstr.c_str(), varstr.c_str());
+
+  sorting.sortBy = SortByDateAdded;
+  sorting.sortOrder = SortOrderDescending;
+  refstr = " ORDER BY COALESCE(songview.dateAdded, '') COLLATE ALPHANUM DESC, "
+           "songview.idSong DESC";
+  EXPECT_TRUE(DatabaseUtils::BuildOrderByClause(sorting, MediaTypeSong, "ALPHANUM", varstr));
+  EXPECT_STREQ(refstr.c_str(), varstr.c_str());
+}
+
 // class DatabaseUtils
 // {
 // public:
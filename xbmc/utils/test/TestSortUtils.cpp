@@ -19,6 +19,8 @@
  */
 
 #include "utils/SortUtils.h"
+#include "utils/Stopwatch.h"
+#include "utils/StringUtils.h"
 #include "utils/Variant.h"
 
 #include "gtest/gtest.h"
@@ -133,3 +135,64 @@ TEST(TestSortUtils, GetFieldsForSorting)
   EXPECT_EQ(FieldTrackNumber, *it);
   EXPECT_EQ((unsigned int)5, fields.size());
 }
+
+static SortItems CreateTitleItems(size_t count)
+{
+  SortItems items;
+  items.reserve(count);
+  for (size_t i = 0; i < count; i++)
+  {
+    SortItemPtr item(new SortItem());
+    // produce plenty of duplicate titles to check that equal items keep their order
+    (*item)[FieldTitle] = StringUtils::Format("Title %u", (unsigned int)((i * 7919) % (count / 4 + 1)));
+    (*item)[FieldId] = (int)i;
+    items.push_back(item);
+  }
+  return items;
+}
+
+TEST(TestSortUtils, Sort_Limits)
+{
+  SortItems items;
+  const char* titles[] = { "E", "C", "A", "D", "B", "Top", "C" };
+  for (size_t i = 0; i < sizeof(titles) / sizeof(titles[0]); i++)
+  {
+    SortItemPtr item(new SortItem());
+    (*item)[FieldTitle] = titles[i];
+    (*item)[FieldId] = (int)i;
+    items.push_back(item);
+  }
+  (*items.at(5))[FieldSortSpecial] = SortSpecialOnTop;
+
+  SortUtils::Sort(SortByTitle, SortOrderAscending, SortAttributeNone, items, 4, 1);
+
+  ASSERT_EQ(3U, items.size());
+  EXPECT_STREQ("A", (*items.at(0))[FieldTitle].asString().c_str());
+  EXPECT_STREQ("B", (*items.at(1))[FieldTitle].asString().c_str());
+  EXPECT_EQ(1, (*items.at(2))[FieldId].asInteger());
+  EXPECT_FALSE((*items.at(0))[FieldSort].isNull());
+}
+
+TEST(TestSortUtils, Sort_LimitsMatchFullSort)
+{
+  const size_t count = 20000;
+  const int limitStart = 100;
+  const int limitEnd = 150;
+
+  SortItems fullItems = CreateTitleItems(count);
+  SortItems pagedItems = CreateTitleItems(count);
+
+  CStopWatch watch;
+  watch.StartZero();
+  SortUtils::Sort(SortByTitle, SortOrderDescending, SortAttributeNone, fullItems);
+  RecordProperty("FullSortMs", (int)(watch.GetElapsedMilliseconds()));
+
+  watch.StartZero();
+  SortUtils::Sort(SortByTitle, SortOrderDescending, SortAttributeNone, pagedItems, limitEnd, limitStart);
+  RecordProperty("PagedSortMs", (int)(watch.GetElapsedMilliseconds()));
+
+  ASSERT_EQ(count, fullItems.size());
+  ASSERT_EQ((size_t)(limitEnd - limitStart), pagedItems.size());
+  for (size_t i = 0; i < pagedItems.size(); i++)
+    EXPECT_EQ((*fullItems.at(limitStart + i))[FieldId].asInteger(), (*pagedItems.at(i))[FieldId].asInteger());
+}
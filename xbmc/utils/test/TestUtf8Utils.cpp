@@ -0,0 +1,63 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/Utf8Utils.h"
+
+#include "gtest/gtest.h"
+
+TEST(TestUtf8Utils, Utf8ToW_Ascii)
+{
+  std::wstring wide;
+  EXPECT_TRUE(CUtf8Utils::Utf8ToW("", wide));
+  EXPECT_TRUE(wide.empty());
+  EXPECT_TRUE(CUtf8Utils::Utf8ToW("Kodi [B]label[/B]", wide));
+  EXPECT_EQ(L"Kodi [B]label[/B]", wide);
+}
+
+TEST(TestUtf8Utils, Utf8ToW_MultiByte)
+{
+  std::wstring wide;
+  // e acute, hebrew alef, euro sign, CJK
+  EXPECT_TRUE(CUtf8Utils::Utf8ToW("\xC3\xA9\xD7\x90\xE2\x82\xAC\xE4\xB8\xAD", wide));
+  EXPECT_EQ(std::wstring(L"éא€中"), wide);
+
+  // U+1F600 takes a surrogate pair if wchar_t is 16 bits wide
+  EXPECT_TRUE(CUtf8Utils::Utf8ToW("a\xF0\x9F\x98\x80", wide));
+  if (sizeof(wchar_t) == 2)
+  {
+    ASSERT_EQ(3U, wide.size());
+    EXPECT_EQ(0xD83D, static_cast<int>(wide[1]));
+    EXPECT_EQ(0xDE00, static_cast<int>(wide[2]));
+  }
+  else
+  {
+    ASSERT_EQ(2U, wide.size());
+    EXPECT_EQ(0x1F600, static_cast<int>(wide[1]));
+  }
+}
+
+TEST(TestUtf8Utils, Utf8ToW_Invalid)
+{
+  std::wstring wide;
+  EXPECT_FALSE(CUtf8Utils::Utf8ToW("\xE9t\xE9", wide));       // latin-1
+  EXPECT_FALSE(CUtf8Utils::Utf8ToW("\xC0\xAF", wide));         // overlong
+  EXPECT_FALSE(CUtf8Utils::Utf8ToW("\xED\xA0\x80", wide));     // surrogate
+  EXPECT_FALSE(CUtf8Utils::Utf8ToW(std::string("\xE2\x82", 2), wide)); // truncated
+}
@@ -19,10 +19,15 @@
  */
 
 #include <stdlib.h>
+#include <algorithm>
+#include <memory>
+#include <vector>
 #include "utils/log.h"
 #include "utils/RegExp.h"
 #include "filesystem/File.h"
 #include "filesystem/SpecialProtocol.h"
+#include "threads/Thread.h"
+#include "utils/Stopwatch.h"
 #include "utils/StringUtils.h"
 #include "CompileInfo.h"
 
@@ -40,6 +45,73 @@ protected:
   }
 };
 
+namespace
+{
+class LogWriterRunnable : public IRunnable
+{
+public:
+  LogWriterRunnable(int id, int lines) : m_id(id), m_lines(lines) {}
+
+  void Run() override
+  {
+    m_latencies.reserve(m_lines);
+    CStopWatch watch;
+    for (int i = 0; i < m_lines; i++)
+    {
+      watch.StartZero();
+      CLog::Log(LOGDEBUG, "contention test thread %d line %d", m_id, i);
+      m_latencies.push_back(watch.GetElapsedMilliseconds());
+    }
+  }
+
+  std::vector<float> m_latencies;
+
+private:
+  int m_id;
+  int m_lines;
+};
+
+void LogFromThreads(int threadCount, int lines, std::vector<float>& latencies, float& elapsed)
+{
+  std::vector<std::unique_ptr<LogWriterRunnable>> runnables;
+  std::vector<std::unique_ptr<CThread>> threads;
+  for (int i = 0; i < threadCount; i++)
+  {
+    runnables.emplace_back(new LogWriterRunnable(i, lines));
+    threads.emplace_back(new CThread(runnables.back().get(), "LogTest"));
+  }
+
+  CStopWatch watch;
+  watch.StartZero();
+  for (auto& thread : threads)
+    thread->Create();
+  for (auto& thread : threads)
+    thread->StopThread(true);
+  CLog::Flush();
+  elapsed = watch.GetElapsedMilliseconds();
+
+  latencies.clear();
+  for (const auto& runnable : runnables)
+    latencies.insert(latencies.end(), runnable->m_latencies.begin(), runnable->m_latencies.end());
+  std::sort(latencies.begin(), latencies.end());
+}
+
+std::string ReadLogFile(const std::string& logfile)
+{
+  std::string logstring;
+  char buf[4096];
+  unsigned int bytesread;
+  XFILE::CFile file;
+  if (file.Open(logfile))
+  {
+    while ((bytesread = file.Read(buf, sizeof(buf))) > 0)
+      logstring.append(buf, bytesread);
+    file.Close();
+  }
+  return logstring;
+}
+}
+
 TEST_F(Testlog, Log)
 {
   std::string logfile, logstring;
@@ -151,3 +223,72 @@ TEST_F(Testlog, SetLogLevel)
   CLog::Close();
   EXPECT_TRUE(XFILE::CFile::Delete(logfile));
 }
+
+TEST_F(Testlog, Flush)
+{
+  std::string logfile;
+
+  std::string appName = CCompileInfo::GetAppName();
+  StringUtils::ToLower(appName);
+  logfile = CSpecialProtocol::TranslatePath("special://temp/") + appName + ".log";
+  EXPECT_TRUE(CLog::Init(CSpecialProtocol::TranslatePath("special://temp/").c_str()));
+
+  // lines must reach the file on Flush() without closing the log
+  CLog::Log(LOGDEBUG, "queued log message");
+  CLog::Flush();
+  EXPECT_NE(std::string::npos, ReadLogFile(logfile).find("DEBUG: queued log message"));
+
+  // repeated lines are still collapsed when written from the queue
+  CLog::Log(LOGINFO, "repeated log message");
+  CLog::Log(LOGINFO, "repeated log message");
+  CLog::Log(LOGINFO, "repeated log message");
+  CLog::Log(LOGINFO, "final log message");
+  CLog::Close();
+
+  std::string logstring = ReadLogFile(logfile);
+  EXPECT_NE(std::string::npos, logstring.find("Previous line repeats 2 times."));
+  EXPECT_LT(logstring.find("Previous line repeats 2 times."), logstring.find("final log message"));
+
+  EXPECT_TRUE(XFILE::CFile::Delete(logfile));
+}
+
+TEST_F(Testlog, Contention)
+{
+  static const int lines = 20000;
+  std::string logfile;
+
+  std::string appName = CCompileInfo::GetAppName();
+  StringUtils::ToLower(appName);
+  logfile = CSpecialProtocol::TranslatePath("special://temp/") + appName + ".log";
+  EXPECT_TRUE(CLog::Init(CSpecialProtocol::TranslatePath("special://temp/").c_str()));
+  const uint64_t droppedStart = CLog::GetDroppedLines();
+
+  // the same lines from an increasing number of threads, to see how the queue scales
+  const int threadCounts[] = { 1, 4, 8 };
+  for (int threadCount : threadCounts)
+  {
+    const uint64_t droppedBefore = CLog::GetDroppedLines();
+    std::vector<float> latencies;
+    float elapsed;
+    LogFromThreads(threadCount, lines, latencies, elapsed);
+    ASSERT_EQ(static_cast<size_t>(threadCount * lines), latencies.size());
+
+    const std::string prefix = StringUtils::Format("threads%d_", threadCount);
+    RecordProperty(prefix + "lines_per_ms", static_cast<int>(latencies.size() / std::max(elapsed, 1.0f)));
+    RecordProperty(prefix + "p50_us", static_cast<int>(latencies[latencies.size() / 2] * 1000));
+    RecordProperty(prefix + "p99_us", static_cast<int>(latencies[latencies.size() * 99 / 100] * 1000));
+    RecordProperty(prefix + "max_us", static_cast<int>(latencies.back() * 1000));
+    RecordProperty(prefix + "dropped", static_cast<int>(CLog::GetDroppedLines() - droppedBefore));
+  }
+  CLog::Close();
+
+  // every line is either in the file or accounted for as dropped
+  std::string logstring = ReadLogFile(logfile);
+  EXPECT_NE(std::string::npos, logstring.find("contention test thread 0 line 0"));
+  size_t written = 0;
+  for (size_t pos = logstring.find("contention test"); pos != std::string::npos; pos = logstring.find("contention test", pos + 1))
+    written++;
+  EXPECT_EQ(static_cast<uint64_t>((1 + 4 + 8) * lines), written + CLog::GetDroppedLines() - droppedStart);
+
+  EXPECT_TRUE(XFILE::CFile::Delete(logfile));
+}
@@ -23,6 +23,7 @@
 #include <algorithm>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -527,8 +528,8 @@ int CVideoDatabase::GetPathId(const std::string& strPath)
 
     URIUtils::AddSlashAtEnd(strPath1);
 
-    strSQL=PrepareSQL("select idPath from path where strPath='%s'",strPath1.c_str());
-    m_pDS->query(strSQL);
+    strSQL = "select idPath from path where strPath=?";
+    m_pDS->query(strSQL, { strPath1 });
     if (!m_pDS->eof())
       idPath = m_pDS->fv("path.idPath").get_asInt();
 
@@ -1059,9 +1060,7 @@ int CVideoDatabase::GetFileId(const std::string& strFilenameAndPath)
     int idPath = GetPathId(strPath);
     if (idPath >= 0)
     {
-      std::string strSQL;
-      strSQL=PrepareSQL("select idFile from files where strFileName='%s' and idPath=%i", strFileName.c_str(),idPath);
-      m_pDS->query(strSQL);
+      m_pDS->query("select idFile from files where strFileName=? and idPath=?", { strFileName, idPath });
       if (m_pDS->num_rows() > 0)
       {
         int idFile = m_pDS->fv("files.idFile").get_asInt();
@@ -3021,8 +3020,7 @@ void CVideoDatabase::GetBookMarksForFile(const std::string& strFilenameAndPath,
       if (NULL == m_pDB.get()) return ;
       if (NULL == m_pDS.get()) return ;
 
-      std::string strSQL=PrepareSQL("select * from bookmark where idFile=%i and type=%i order by timeInSeconds", idFile, (int)type);
-      m_pDS->query( strSQL );
+      m_pDS->query("select * from bookmark where idFile=? and type=? order by timeInSeconds", { idFile, (int)type });
       while (!m_pDS->eof())
       {
         CBookmark bookmark;
@@ -3666,6 +3664,49 @@ CVideoInfoTag CVideoDatabase::GetDetailsByTypeAndId(VIDEODB_CONTENT_TYPE type, i
   return details;
 }
 
+/// \brief Add the stream described by the current row of a "SELECT * FROM streamdetails" query
+/// \return true if the row contained a known stream type, false otherwise
+static bool AddStreamDetailFromDataset(const std::unique_ptr<Dataset> &pDS, CStreamDetails &details)
+{
+  CStreamDetail::StreamType e = (CStreamDetail::StreamType)pDS->fv(1).get_asInt();
+  switch (e)
+  {
+  case CStreamDetail::VIDEO:
+    {
+      CStreamDetailVideo *p = new CStreamDetailVideo();
+      p->m_strCodec = pDS->fv(2).get_asString();
+      p->m_fAspect = pDS->fv(3).get_asFloat();
+      p->m_iWidth = pDS->fv(4).get_asInt();
+      p->m_iHeight = pDS->fv(5).get_asInt();
+      p->m_iDuration = pDS->fv(10).get_asInt();
+      p->m_strStereoMode = pDS->fv(11).get_asString();
+      p->m_strLanguage = pDS->fv(12).get_asString();
+      details.AddStream(p);
+      return true;
+    }
+  case CStreamDetail::AUDIO:
+    {
+      CStreamDetailAudio *p = new CStreamDetailAudio();
+      p->m_strCodec = pDS->fv(6).get_asString();
+      if (pDS->fv(7).get_isNull())
+        p->m_iChannels = -1;
+      else
+        p->m_iChannels = pDS->fv(7).get_asInt();
+      p->m_strLanguage = pDS->fv(8).get_asString();
+      details.AddStream(p);
+      return true;
+    }
+  case CStreamDetail::SUBTITLE:
+    {
+      CStreamDetailSubtitle *p = new CStreamDetailSubtitle();
+      p->m_strLanguage = pDS->fv(9).get_asString();
+      details.AddStream(p);
+      return true;
+    }
+  }
+  return false;
+}
+
 bool CVideoDatabase::GetStreamDetails(CFileItem& item)
 {
   // Note that this function (possibly) creates VideoInfoTags for items that don't have one yet!
@@ -3698,50 +3739,12 @@ bool CVideoDatabase::GetStreamDetails(CVideoInfoTag& tag) const
   std::unique_ptr<Dataset> pDS(m_pDB->CreateDataset());
   try
   {
-    std::string strSQL = PrepareSQL("SELECT * FROM streamdetails WHERE idFile = %i", tag.m_iFileId);
-    pDS->query(strSQL);
+    pDS->query("SELECT * FROM streamdetails WHERE idFile = ?", { tag.m_iFileId });
 
     while (!pDS->eof())
     {
-      CStreamDetail::StreamType e = (CStreamDetail::StreamType)pDS->fv(1).get_asInt();
-      switch (e)
-      {
-      case CStreamDetail::VIDEO:
-        {
-          CStreamDetailVideo *p = new CStreamDetailVideo();
-          p->m_strCodec = pDS->fv(2).get_asString();
-          p->m_fAspect = pDS->fv(3).get_asFloat();
-          p->m_iWidth = pDS->fv(4).get_asInt();
-          p->m_iHeight = pDS->fv(5).get_asInt();
-          p->m_iDuration = pDS->fv(10).get_asInt();
-          p->m_strStereoMode = pDS->fv(11).get_asString();
-          p->m_strLanguage = pDS->fv(12).get_asString();
-          details.AddStream(p);
-          retVal = true;
-          break;
-        }
-      case CStreamDetail::AUDIO:
-        {
-          CStreamDetailAudio *p = new CStreamDetailAudio();
-          p->m_strCodec = pDS->fv(6).get_asString();
-          if (pDS->fv(7).get_isNull())
-            p->m_iChannels = -1;
-          else
-            p->m_iChannels = pDS->fv(7).get_asInt();
-          p->m_strLanguage = pDS->fv(8).get_asString();
-          details.AddStream(p);
-          retVal = true;
-          break;
-        }
-      case CStreamDetail::SUBTITLE:
-        {
-          CStreamDetailSubtitle *p = new CStreamDetailSubtitle();
-          p->m_strLanguage = pDS->fv(9).get_asString();
-          details.AddStream(p);
-          retVal = true;
-          break;
-        }
-      }
+      if (AddStreamDetailFromDataset(pDS, details))
+        retVal = true;
 
       pDS->next();
     }
@@ -3813,7 +3816,7 @@ CVideoInfoTag CVideoDatabase::GetDetailsForMovie(std::unique_ptr<Dataset> &pDS,
   return GetDetailsForMovie(pDS->get_sql_record(), getDetails);
 }
 
-CVideoInfoTag CVideoDatabase::GetDetailsForMovie(const dbiplus::sql_record* const record, int getDetails /* = VideoDbDetailsNone */)
+CVideoInfoTag CVideoDatabase::GetDetailsForMovie(const dbiplus::sql_record* const record, int getDetails /* = VideoDbDetailsNone */, const DetailsBatch *batch /* = NULL */)
 {
   CVideoInfoTag details;
 
@@ -3855,20 +3858,28 @@ CVideoInfoTag CVideoDatabase::GetDetailsForMovie(const dbiplus::sql_record* cons
 
   if (getDetails)
   {
-    if (getDetails & VideoDbDetailsCast)
+    if (batch != NULL)
+      ApplyDetailsBatch(*batch, getDetails, details);
+    else
     {
-      GetCast(details.m_iDbId, MediaTypeMovie, details.m_cast);
-      castTime += XbmcThreads::SystemClockMillis() - time; time = XbmcThreads::SystemClockMillis();
-    }
+      if (getDetails & VideoDbDetailsCast)
+      {
+        GetCast(details.m_iDbId, MediaTypeMovie, details.m_cast);
+        castTime += XbmcThreads::SystemClockMillis() - time; time = XbmcThreads::SystemClockMillis();
+      }
 
-    if (getDetails & VideoDbDetailsTag)
-      GetTags(details.m_iDbId, MediaTypeMovie, details.m_tags);
+      if (getDetails & VideoDbDetailsTag)
+        GetTags(details.m_iDbId, MediaTypeMovie, details.m_tags);
 
-    if (getDetails & VideoDbDetailsRating)
-      GetRatings(details.m_iDbId, MediaTypeMovie, details.m_ratings);
+      if (getDetails & VideoDbDetailsRating)
+        GetRatings(details.m_iDbId, MediaTypeMovie, details.m_ratings);
 
-    if (getDetails & VideoDbDetailsUniqueID)
-     GetUniqueIDs(details.m_iDbId, MediaTypeMovie, details);
+      if (getDetails & VideoDbDetailsUniqueID)
+        GetUniqueIDs(details.m_iDbId, MediaTypeMovie, details);
+
+      if (getDetails & VideoDbDetailsStream)
+        GetStreamDetails(details);
+    }
 
     details.m_strPictureURL.Parse();
 
@@ -3888,9 +3899,6 @@ CVideoInfoTag CVideoDatabase::GetDetailsForMovie(const dbiplus::sql_record* cons
       m_pDS2->close();
     }
 
-    if (getDetails & VideoDbDetailsStream)
-      GetStreamDetails(details);
-
     details.m_parsedDetails = getDetails;
   }
   return details;
@@ -3974,7 +3982,7 @@ CVideoInfoTag CVideoDatabase::GetDetailsForEpisode(std::unique_ptr<Dataset> &pDS
   return GetDetailsForEpisode(pDS->get_sql_record(), getDetails);
 }
 
-CVideoInfoTag CVideoDatabase::GetDetailsForEpisode(const dbiplus::sql_record* const record, int getDetails /* = VideoDbDetailsNone */)
+CVideoInfoTag CVideoDatabase::GetDetailsForEpisode(const dbiplus::sql_record* const record, int getDetails /* = VideoDbDetailsNone */, const DetailsBatch *batch /* = NULL */)
 {
   CVideoInfoTag details;
 
@@ -4013,26 +4021,31 @@ CVideoInfoTag CVideoDatabase::GetDetailsForEpisode(const dbiplus::sql_record* co
 
   if (getDetails)
   {
-    if (getDetails & VideoDbDetailsCast)
+    if (batch != NULL)
+      ApplyDetailsBatch(*batch, getDetails & ~VideoDbDetailsTag, details);
+    else
     {
-      GetCast(details.m_iDbId, MediaTypeEpisode, details.m_cast);
-      GetCast(details.m_iIdShow, MediaTypeTvShow, details.m_cast);
-      castTime += XbmcThreads::SystemClockMillis() - time; time = XbmcThreads::SystemClockMillis();
-    }
+      if (getDetails & VideoDbDetailsCast)
+      {
+        GetCast(details.m_iDbId, MediaTypeEpisode, details.m_cast);
+        GetCast(details.m_iIdShow, MediaTypeTvShow, details.m_cast);
+        castTime += XbmcThreads::SystemClockMillis() - time; time = XbmcThreads::SystemClockMillis();
+      }
 
-    if (getDetails & VideoDbDetailsRating)
-      GetRatings(details.m_iDbId, MediaTypeEpisode, details.m_ratings);
+      if (getDetails & VideoDbDetailsRating)
+        GetRatings(details.m_iDbId, MediaTypeEpisode, details.m_ratings);
 
-    if (getDetails & VideoDbDetailsUniqueID)
-      GetUniqueIDs(details.m_iDbId, MediaTypeEpisode, details);
+      if (getDetails & VideoDbDetailsUniqueID)
+        GetUniqueIDs(details.m_iDbId, MediaTypeEpisode, details);
+
+      if (getDetails & VideoDbDetailsStream)
+        GetStreamDetails(details);
+    }
 
     details.m_strPictureURL.Parse();
     
     if (getDetails &  VideoDbDetailsBookmark)
       GetBookMarkForEpisode(details, details.m_EpBookmark);
-    
-    if (getDetails & VideoDbDetailsStream)
-      GetStreamDetails(details);
 
     details.m_parsedDetails = getDetails;
   }
@@ -4089,6 +4102,258 @@ CVideoInfoTag CVideoDatabase::GetDetailsForMusicVideo(const dbiplus::sql_record*
   return details;
 }
 
+/// \brief Append the actors to the cast, skipping any actor already in it (like GetCast)
+static void AppendCast(const std::vector<SActorInfo> &actors, std::vector<SActorInfo> &cast)
+{
+  for (const auto &actor : actors)
+  {
+    bool found = false;
+    for (const auto &i : cast)
+    {
+      if (i.strName == actor.strName)
+      {
+        found = true;
+        break;
+      }
+    }
+    if (!found)
+      cast.push_back(actor);
+  }
+}
+
+void CVideoDatabase::GetDetailsBatch(const MediaType &mediaType, const std::vector<const dbiplus::sql_record*> &records, int getDetails, DetailsBatch &batch)
+{
+  if (!m_pDB.get() || !m_pDS2.get())
+    return;
+
+  std::set<int> mediaIds, fileIds, showIds, seasonIds;
+  for (const auto &record : records)
+  {
+    mediaIds.insert(record->at(0).get_asInt());
+    fileIds.insert(record->at(VIDEODB_DETAILS_FILEID).get_asInt());
+    if (mediaType == MediaTypeEpisode)
+    {
+      showIds.insert(record->at(VIDEODB_DETAILS_EPISODE_TVSHOW_ID).get_asInt());
+      seasonIds.insert(record->at(VIDEODB_DETAILS_EPISODE_SEASON_ID).get_asInt());
+    }
+  }
+
+  try
+  {
+    if (getDetails & VideoDbDetailsCast)
+    {
+      std::vector<std::pair<MediaType, const std::set<int>*> > castQueries;
+      castQueries.push_back(std::make_pair(mediaType, &mediaIds));
+      if (mediaType == MediaTypeEpisode)
+        castQueries.push_back(std::make_pair(MediaTypeTvShow, &showIds));
+
+      for (const auto &castQuery : castQueries)
+      {
+        std::map<int, std::vector<SActorInfo> > &cast = castQuery.first == mediaType ? batch.cast : batch.showCast;
+        for (const auto &ids : GetIdLists(*castQuery.second))
+        {
+          std::string sql = PrepareSQL("SELECT actor_link.media_id,"
+                                       "  actor.name,"
+                                       "  actor_link.role,"
+                                       "  actor_link.cast_order,"
+                                       "  actor.art_urls,"
+                                       "  art.url "
+                                       "FROM actor_link"
+                                       "  JOIN actor ON"
+                                       "    actor_link.actor_id=actor.actor_id"
+                                       "  LEFT JOIN art ON"
+                                       "    art.media_id=actor.actor_id AND art.media_type='actor' AND art.type='thumb' "
+                                       "WHERE actor_link.media_id IN (%s) AND actor_link.media_type='%s'"
+                                       "ORDER BY actor_link.media_id, actor_link.cast_order", ids.c_str(), castQuery.first.c_str());
+          m_pDS2->query(sql);
+          while (!m_pDS2->eof())
+          {
+            std::vector<SActorInfo> actors(1);
+            SActorInfo &info = actors.front();
+            info.strName = m_pDS2->fv(1).get_asString();
+            info.strRole = m_pDS2->fv(2).get_asString();
+            info.order = m_pDS2->fv(3).get_asInt();
+            info.thumbUrl.ParseString(m_pDS2->fv(4).get_asString());
+            info.thumb = m_pDS2->fv(5).get_asString();
+            AppendCast(actors, cast[m_pDS2->fv(0).get_asInt()]);
+            m_pDS2->next();
+          }
+          m_pDS2->close();
+        }
+      }
+    }
+
+    for (const auto &ids : GetIdLists(mediaIds))
+    {
+      if (getDetails & VideoDbDetailsTag)
+      {
+        std::string sql = PrepareSQL("SELECT tag_link.media_id, tag.name FROM tag INNER JOIN tag_link ON tag_link.tag_id = tag.tag_id WHERE tag_link.media_id IN (%s) AND tag_link.media_type = '%s' ORDER BY tag_link.media_id, tag.tag_id", ids.c_str(), mediaType.c_str());
+        m_pDS2->query(sql);
+        while (!m_pDS2->eof())
+        {
+          batch.tags[m_pDS2->fv(0).get_asInt()].emplace_back(m_pDS2->fv(1).get_asString());
+          m_pDS2->next();
+        }
+        m_pDS2->close();
+      }
+
+      if (getDetails & VideoDbDetailsRating)
+      {
+        std::string sql = PrepareSQL("SELECT rating.media_id, rating.rating_type, rating.rating, rating.votes FROM rating WHERE rating.media_id IN (%s) AND rating.media_type = '%s'", ids.c_str(), mediaType.c_str());
+        m_pDS2->query(sql);
+        while (!m_pDS2->eof())
+        {
+          batch.ratings[m_pDS2->fv(0).get_asInt()][m_pDS2->fv(1).get_asString()] = CRating(m_pDS2->fv(2).get_asFloat(), m_pDS2->fv(3).get_asInt());
+          m_pDS2->next();
+        }
+        m_pDS2->close();
+      }
+
+      if (getDetails & VideoDbDetailsUniqueID)
+      {
+        std::string sql = PrepareSQL("SELECT media_id, type, value FROM uniqueid WHERE media_id IN (%s) AND media_type = '%s'", ids.c_str(), mediaType.c_str());
+        m_pDS2->query(sql);
+        while (!m_pDS2->eof())
+        {
+          batch.uniqueIDs[m_pDS2->fv(0).get_asInt()].push_back(std::make_pair(m_pDS2->fv(1).get_asString(), m_pDS2->fv(2).get_asString()));
+          m_pDS2->next();
+        }
+        m_pDS2->close();
+      }
+    }
+
+    if (getDetails & VideoDbDetailsStream)
+    {
+      for (const auto &ids : GetIdLists(fileIds))
+      {
+        m_pDS2->query(PrepareSQL("SELECT * FROM streamdetails WHERE idFile IN (%s)", ids.c_str()));
+        while (!m_pDS2->eof())
+        {
+          AddStreamDetailFromDataset(m_pDS2, batch.streamDetails[m_pDS2->fv(0).get_asInt()]);
+          m_pDS2->next();
+        }
+        m_pDS2->close();
+      }
+    }
+
+    if (getDetails & VideoDbDetailsArt)
+    {
+      GetArtBatch(mediaType, mediaIds, batch.art);
+      if (mediaType == MediaTypeEpisode)
+      {
+        GetArtBatch(MediaTypeTvShow, showIds, batch.showArt);
+        GetArtBatch(MediaTypeSeason, seasonIds, batch.seasonArt);
+      }
+    }
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s(%s) failed", __FUNCTION__, mediaType.c_str());
+  }
+}
+
+void CVideoDatabase::GetArtBatch(const MediaType &mediaType, const std::set<int> &mediaIds, std::map<int, std::map<std::string, std::string> > &art)
+{
+  for (const auto &ids : GetIdLists(mediaIds))
+  {
+    m_pDS2->query(PrepareSQL("SELECT media_id, type, url FROM art WHERE media_id IN (%s) AND media_type='%s'", ids.c_str(), mediaType.c_str()));
+    while (!m_pDS2->eof())
+    {
+      art[m_pDS2->fv(0).get_asInt()].insert(std::make_pair(m_pDS2->fv(1).get_asString(), m_pDS2->fv(2).get_asString()));
+      m_pDS2->next();
+    }
+    m_pDS2->close();
+  }
+}
+
+void CVideoDatabase::ApplyArtBatch(const DetailsBatch &batch, CFileItem &item)
+{
+  const CVideoInfoTag &tag = *item.GetVideoInfoTag();
+
+  std::map<int, std::map<std::string, std::string> >::const_iterator art = batch.art.find(tag.m_iDbId);
+  if (art != batch.art.end())
+  {
+    item.SetArt(art->second);
+    if (art->second.find("thumb") == art->second.end())
+    { // set fallback for "thumb"
+      if (art->second.find("poster") != art->second.end())
+        item.SetArtFallback("thumb", "poster");
+      else if (art->second.find("banner") != art->second.end())
+        item.SetArtFallback("thumb", "banner");
+    }
+  }
+
+  if (tag.m_type == MediaTypeEpisode)
+  {
+    // episodes fall back to the art of their show and season
+    if (!item.HasArt("tvshow.fanart") && tag.m_iIdShow >= 0)
+    {
+      if ((art = batch.showArt.find(tag.m_iIdShow)) != batch.showArt.end())
+        item.AppendArt(art->second, "tvshow");
+      item.SetArtFallback("fanart", "tvshow.fanart");
+      item.SetArtFallback("tvshow.thumb", "tvshow.poster");
+    }
+
+    if (!item.HasArt("season.poster") && tag.m_iSeason > -1 &&
+        (art = batch.seasonArt.find(tag.m_iIdSeason)) != batch.seasonArt.end())
+      item.AppendArt(art->second, MediaTypeSeason);
+  }
+
+  item.SetProperty("libraryartfilled", true);
+}
+
+void CVideoDatabase::ApplyDetailsBatch(const DetailsBatch &batch, int getDetails, CVideoInfoTag &details)
+{
+  if (getDetails & VideoDbDetailsCast)
+  {
+    std::map<int, std::vector<SActorInfo> >::const_iterator cast = batch.cast.find(details.m_iDbId);
+    if (cast != batch.cast.end())
+      AppendCast(cast->second, details.m_cast);
+    if (details.m_type == MediaTypeEpisode && (cast = batch.showCast.find(details.m_iIdShow)) != batch.showCast.end())
+      AppendCast(cast->second, details.m_cast);
+  }
+
+  if (getDetails & VideoDbDetailsTag)
+  {
+    std::map<int, std::vector<std::string> >::const_iterator tags = batch.tags.find(details.m_iDbId);
+    if (tags != batch.tags.end())
+      details.m_tags.insert(details.m_tags.end(), tags->second.begin(), tags->second.end());
+  }
+
+  if (getDetails & VideoDbDetailsRating)
+  {
+    std::map<int, RatingMap>::const_iterator ratings = batch.ratings.find(details.m_iDbId);
+    if (ratings != batch.ratings.end())
+    {
+      for (const auto &rating : ratings->second)
+        details.m_ratings[rating.first] = rating.second;
+    }
+  }
+
+  if (getDetails & VideoDbDetailsUniqueID)
+  {
+    std::map<int, std::vector<std::pair<std::string, std::string> > >::const_iterator uniqueIDs = batch.uniqueIDs.find(details.m_iDbId);
+    if (uniqueIDs != batch.uniqueIDs.end())
+    {
+      for (const auto &uniqueID : uniqueIDs->second)
+        details.SetUniqueID(uniqueID.second, uniqueID.first);
+    }
+  }
+
+  if (getDetails & VideoDbDetailsStream)
+  {
+    std::map<int, CStreamDetails>::const_iterator streamDetails = batch.streamDetails.find(details.m_iFileId);
+    if (streamDetails != batch.streamDetails.end())
+      details.m_streamDetails = streamDetails->second;
+    else
+      details.m_streamDetails.Reset();
+    details.m_streamDetails.DetermineBestStreams();
+
+    if (details.m_streamDetails.GetVideoDuration() > 0)
+      details.SetDuration(details.m_streamDetails.GetVideoDuration());
+  }
+}
+
 void CVideoDatabase::GetCast(int media_id, const std::string &media_type, std::vector<SActorInfo> &cast)
 {
   try
@@ -6694,14 +6959,22 @@ bool CVideoDatabase::GetMoviesByWhere(const std::string& strBaseDir, const Filte
     if (!CDatabase::BuildSQL(strSQLExtra, extFilter, strSQLExtra))
       return false;
 
+    // Let the database do the sorting if possible
+    std::string strSortSQL;
+    if (extFilter.order.empty() && extFilter.limit.empty() &&
+        BuildSortSQL(sorting, MediaTypeMovie, strSortSQL))
+      sorting.sortBy = SortByNone;
+
     // Apply the limiting directly here if there's no special sorting but limiting
     if (extFilter.limit.empty() &&
         sorting.sortBy == SortByNone &&
        (sorting.limitStart > 0 || sorting.limitEnd > 0))
     {
       total = (int)strtol(GetSingleValue(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, m_pDS).c_str(), NULL, 10);
-      strSQLExtra += DatabaseUtils::BuildLimitClause(sorting.limitEnd, sorting.limitStart);
+      strSQLExtra += strSortSQL + DatabaseUtils::BuildLimitClause(sorting.limitEnd, sorting.limitStart);
     }
+    else
+      strSQLExtra += strSortSQL;
 
     strSQL = PrepareSQL(strSQL, !extFilter.fields.empty() ? extFilter.fields.c_str() : "*") + strSQLExtra;
 
@@ -6717,23 +6990,32 @@ bool CVideoDatabase::GetMoviesByWhere(const std::string& strBaseDir, const Filte
     DatabaseResults results;
     results.reserve(iRowsFound);
 
-    if (!SortUtils::SortFromDataset(sortDescription, MediaTypeMovie, m_pDS, results))
+    if (!SortUtils::SortFromDataset(sorting, MediaTypeMovie, m_pDS, results))
       return false;
 
     // get data from returned rows
     items.Reserve(results.size());
     const query_data &data = m_pDS->get_result_set().records;
+    std::vector<const dbiplus::sql_record*> records;
+    records.reserve(results.size());
     for (const auto &i : results)
-    {
-      unsigned int targetRow = (unsigned int)i.at(FieldRow).asInteger();
-      const dbiplus::sql_record* const record = data.at(targetRow);
+      records.push_back(data.at((unsigned int)i.at(FieldRow).asInteger()));
 
-      CVideoInfoTag movie = GetDetailsForMovie(record, getDetails);
+    // load the requested details of all movies at once
+    DetailsBatch batch;
+    if (getDetails)
+      GetDetailsBatch(MediaTypeMovie, records, getDetails, batch);
+
+    for (const auto &record : records)
+    {
+      CVideoInfoTag movie = GetDetailsForMovie(record, getDetails, &batch);
       if (CProfilesManager::GetInstance().GetMasterProfile().getLockMode() == LOCK_MODE_EVERYONE ||
           g_passwordManager.bMasterUser                                   ||
           g_passwordManager.IsDatabasePathUnlocked(movie.m_strPath, *CMediaSourceSettings::GetInstance().GetSources("video")))
       {
         CFileItemPtr pItem(new CFileItem(movie));
+        if (getDetails & VideoDbDetailsArt)
+          ApplyArtBatch(batch, *pItem);
 
         CVideoDbUrl itemUrl = videoUrl;
         std::string path = StringUtils::Format("%i", movie.m_iDbId);
@@ -6802,14 +7084,22 @@ bool CVideoDatabase::GetTvShowsByWhere(const std::string& strBaseDir, const Filt
     if (!BuildSQL(strBaseDir, strSQLExtra, extFilter, strSQLExtra, videoUrl, sorting))
       return false;
 
+    // Let the database do the sorting if possible
+    std::string strSortSQL;
+    if (extFilter.order.empty() && extFilter.limit.empty() &&
+        BuildSortSQL(sorting, MediaTypeTvShow, strSortSQL))
+      sorting.sortBy = SortByNone;
+
     // Apply the limiting directly here if there's no special sorting but limiting
     if (extFilter.limit.empty() &&
         sorting.sortBy == SortByNone &&
         (sorting.limitStart > 0 || sorting.limitEnd > 0))
     {
       total = (int)strtol(GetSingleValue(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, m_pDS).c_str(), NULL, 10);
-      strSQLExtra += DatabaseUtils::BuildLimitClause(sorting.limitEnd, sorting.limitStart);
+      strSQLExtra += strSortSQL + DatabaseUtils::BuildLimitClause(sorting.limitEnd, sorting.limitStart);
     }
+    else
+      strSQLExtra += strSortSQL;
 
     strSQL = PrepareSQL(strSQL, !extFilter.fields.empty() ? extFilter.fields.c_str() : "*") + strSQLExtra;
 
@@ -6928,14 +7218,22 @@ bool CVideoDatabase::GetEpisodesByWhere(const std::string& strBaseDir, const Fil
     if (!BuildSQL(strBaseDir, strSQLExtra, extFilter, strSQLExtra, videoUrl, sorting))
       return false;
 
+    // Let the database do the sorting if possible
+    std::string strSortSQL;
+    if (extFilter.order.empty() && extFilter.limit.empty() &&
+        BuildSortSQL(sorting, MediaTypeEpisode, strSortSQL))
+      sorting.sortBy = SortByNone;
+
     // Apply the limiting directly here if there's no special sorting but limiting
     if (extFilter.limit.empty() &&
       sorting.sortBy == SortByNone &&
       (sorting.limitStart > 0 || sorting.limitEnd > 0))
     {
       total = (int)strtol(GetSingleValue(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, m_pDS).c_str(), NULL, 10);
-      strSQLExtra += DatabaseUtils::BuildLimitClause(sorting.limitEnd, sorting.limitStart);
+      strSQLExtra += strSortSQL + DatabaseUtils::BuildLimitClause(sorting.limitEnd, sorting.limitStart);
     }
+    else
+      strSQLExtra += strSortSQL;
 
     strSQL = PrepareSQL(strSQL, !extFilter.fields.empty() ? extFilter.fields.c_str() : "*") + strSQLExtra;
 
@@ -6958,17 +7256,26 @@ bool CVideoDatabase::GetEpisodesByWhere(const std::string& strBaseDir, const Fil
     CLabelFormatter formatter("%H. %T", "");
 
     const query_data &data = m_pDS->get_result_set().records;
+    std::vector<const dbiplus::sql_record*> records;
+    records.reserve(results.size());
     for (const auto &i : results)
-    {
-      unsigned int targetRow = (unsigned int)i.at(FieldRow).asInteger();
-      const dbiplus::sql_record* const record = data.at(targetRow);
+      records.push_back(data.at((unsigned int)i.at(FieldRow).asInteger()));
+
+    // load the requested details of all episodes at once
+    DetailsBatch batch;
+    if (getDetails)
+      GetDetailsBatch(MediaTypeEpisode, records, getDetails & ~VideoDbDetailsTag, batch);
 
-      CVideoInfoTag movie = GetDetailsForEpisode(record, getDetails);
+    for (const auto &record : records)
+    {
+      CVideoInfoTag movie = GetDetailsForEpisode(record, getDetails, &batch);
       if (CProfilesManager::GetInstance().GetMasterProfile().getLockMode() == LOCK_MODE_EVERYONE ||
           g_passwordManager.bMasterUser                                     ||
           g_passwordManager.IsDatabasePathUnlocked(movie.m_strPath, *CMediaSourceSettings::GetInstance().GetSources("video")))
       {
         CFileItemPtr pItem(new CFileItem(movie));
+        if (getDetails & VideoDbDetailsArt)
+          ApplyArtBatch(batch, *pItem);
         formatter.FormatLabel(pItem.get());
       
         int idEpisode = record->at(0).get_asInt();
@@ -7769,14 +8076,22 @@ bool CVideoDatabase::GetMusicVideosByWhere(const std::string &baseDir, const Fil
     if (!BuildSQL(baseDir, strSQLExtra, extFilter, strSQLExtra, videoUrl, sorting))
       return false;
 
+    // Let the database do the sorting if possible
+    std::string strSortSQL;
+    if (extFilter.order.empty() && extFilter.limit.empty() &&
+        BuildSortSQL(sorting, MediaTypeMusicVideo, strSortSQL))
+      sorting.sortBy = SortByNone;
+
     // Apply the limiting directly here if there's no special sorting but limiting
     if (extFilter.limit.empty() &&
       sorting.sortBy == SortByNone &&
       (sorting.limitStart > 0 || sorting.limitEnd > 0))
     {
       total = (int)strtol(GetSingleValue(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, m_pDS).c_str(), NULL, 10);
-      strSQLExtra += DatabaseUtils::BuildLimitClause(sorting.limitEnd, sorting.limitStart);
+      strSQLExtra += strSortSQL + DatabaseUtils::BuildLimitClause(sorting.limitEnd, sorting.limitStart);
     }
+    else
+      strSQLExtra += strSortSQL;
 
     strSQL = PrepareSQL(strSQL, !extFilter.fields.empty() ? extFilter.fields.c_str() : "*") + strSQLExtra;
 
@@ -19,6 +19,7 @@
  *
  */
 
+#include <map>
 #include <memory>
 #include <set>
 #include <utility>
@@ -78,6 +79,7 @@ enum VideoDbDetails
   VideoDbDetailsCast     = 0x10,
   VideoDbDetailsBookmark = 0x20,
   VideoDbDetailsUniqueID = 0x40,
+  VideoDbDetailsArt      = 0x80,
   VideoDbDetailsAll      = 0xFF
 } ;
 
@@ -908,12 +910,57 @@ protected:
   void AddCast(int mediaId, const char *mediaType, const std::vector<SActorInfo> &cast);
 
   void DeleteStreamDetails(int idFile);
+
+  /*! \brief Cast, tags, ratings, unique ids, stream details and art of a whole
+   list of items, loaded with one query per kind instead of one per item.
+   Items are mapped by their media id (and stream details by file id).
+   \sa GetDetailsBatch
+   */
+  struct DetailsBatch
+  {
+    std::map<int, std::vector<SActorInfo> > cast;
+    std::map<int, std::vector<SActorInfo> > showCast;
+    std::map<int, std::vector<std::string> > tags;
+    std::map<int, RatingMap> ratings;
+    std::map<int, std::vector<std::pair<std::string, std::string> > > uniqueIDs;
+    std::map<int, CStreamDetails> streamDetails;
+    std::map<int, std::map<std::string, std::string> > art;
+    std::map<int, std::map<std::string, std::string> > showArt;
+    std::map<int, std::map<std::string, std::string> > seasonArt;
+  };
+
+  /*! \brief Load the details requested by getDetails for all the given rows
+   of a movie or episode query at once.
+   \param mediaType the media type of the rows
+   \param records the rows to load the details for
+   \param getDetails the VideoDbDetails to load
+   \param batch the loaded details
+   */
+  void GetDetailsBatch(const MediaType &mediaType, const std::vector<const dbiplus::sql_record*> &records, int getDetails, DetailsBatch &batch);
+
+  /*! \brief Fill the details requested by getDetails from a batch loaded with GetDetailsBatch.
+   */
+  static void ApplyDetailsBatch(const DetailsBatch &batch, int getDetails, CVideoInfoTag &details);
+
+  /*! \brief Set the art of an item from a batch loaded with VideoDbDetailsArt, the way
+   CVideoThumbLoader::FillLibraryArt does. The item is marked with the "libraryartfilled"
+   property so the art isn't looked up again.
+   */
+  static void ApplyArtBatch(const DetailsBatch &batch, CFileItem &item);
+
+  /*! \brief Load the art of many items of one media type at once.
+   \param mediaType the media type of the items
+   \param mediaIds the ids of the items
+   \param art the art of each item by media id
+   */
+  void GetArtBatch(const MediaType &mediaType, const std::set<int> &mediaIds, std::map<int, std::map<std::string, std::string> > &art);
+
   CVideoInfoTag GetDetailsForMovie(std::unique_ptr<dbiplus::Dataset> &pDS, int getDetails = VideoDbDetailsNone);
-  CVideoInfoTag GetDetailsForMovie(const dbiplus::sql_record* const record, int getDetails = VideoDbDetailsNone);
+  CVideoInfoTag GetDetailsForMovie(const dbiplus::sql_record* const record, int getDetails = VideoDbDetailsNone, const DetailsBatch *batch = NULL);
   CVideoInfoTag GetDetailsForTvShow(std::unique_ptr<dbiplus::Dataset> &pDS, int getDetails = VideoDbDetailsNone, CFileItem* item = NULL);
   CVideoInfoTag GetDetailsForTvShow(const dbiplus::sql_record* const record, int getDetails = VideoDbDetailsNone, CFileItem* item = NULL);
   CVideoInfoTag GetDetailsForEpisode(std::unique_ptr<dbiplus::Dataset> &pDS, int getDetails = VideoDbDetailsNone);
-  CVideoInfoTag GetDetailsForEpisode(const dbiplus::sql_record* const record, int getDetails = VideoDbDetailsNone);
+  CVideoInfoTag GetDetailsForEpisode(const dbiplus::sql_record* const record, int getDetails = VideoDbDetailsNone, const DetailsBatch *batch = NULL);
   CVideoInfoTag GetDetailsForMusicVideo(std::unique_ptr<dbiplus::Dataset> &pDS, int getDetails = VideoDbDetailsNone);
   CVideoInfoTag GetDetailsForMusicVideo(const dbiplus::sql_record* const record, int getDetails = VideoDbDetailsNone);
   bool GetPeopleNav(const std::string& strBaseDir, CFileItemList& items, const char *type, int idContent = -1, const Filter &filter = Filter(), bool countOnly = false);
@@ -39,6 +39,7 @@
 #include "settings/Settings.h"
 #include "settings/VideoSettings.h"
 #include "TextureCache.h"
+#include "threads/SingleLock.h"
 #include "URL.h"
 #include "utils/log.h"
 #include "utils/StringUtils.h"
@@ -183,7 +184,7 @@ bool CThumbExtractor::DoWork()
 }
 
 CVideoThumbLoader::CVideoThumbLoader() :
-  CThumbLoader(), CJobQueue(true, 1, CJob::PRIORITY_LOW_PAUSABLE)
+  CThumbLoader(THUMB_LOADER_WORKERS), CJobQueue(true, 1, CJob::PRIORITY_LOW_PAUSABLE)
 {
   m_videoDatabase = new CVideoDatabase();
 }
@@ -342,8 +343,6 @@ bool CVideoThumbLoader::LoadItemLookup(CFileItem* pItem)
 
   DetectAndAddMissingItemData(*pItem);
 
-  m_videoDatabase->Open();
-
   std::map<std::string, std::string> artwork = pItem->GetArt();
   std::vector<std::string> artTypes = GetArtTypes(pItem->HasVideoInfoTag() ? pItem->GetVideoInfoTag()->m_type : "");
   if (find(artTypes.begin(), artTypes.end(), "thumb") == artTypes.end())
@@ -406,7 +405,12 @@ bool CVideoThumbLoader::LoadItemLookup(CFileItem* pItem)
           // Item has cached autogen image but no art entry. Save it to db.
           CVideoInfoTag* info = pItem->GetVideoInfoTag();
           if (info->m_iDbId > 0 && !info->m_type.empty())
+          {
+            CSingleLock lock(m_cachedSection);
+            m_videoDatabase->Open();
             m_videoDatabase->SetArtForItem(info->m_iDbId, info->m_type, "thumb", thumbURL);
+            m_videoDatabase->Close();
+          }
         }
       }
       else if (CServiceBroker::GetSettings().GetBool(CSettings::SETTING_MYVIDEOS_EXTRACTTHUMB) &&
@@ -419,8 +423,6 @@ bool CVideoThumbLoader::LoadItemLookup(CFileItem* pItem)
 
         CThumbExtractor* extract = new CThumbExtractor(item, path, true, thumbURL);
         AddJob(extract);
-
-        m_videoDatabase->Close();
         return true;
       }
     }
@@ -439,7 +441,6 @@ bool CVideoThumbLoader::LoadItemLookup(CFileItem* pItem)
     }
   }
 
-  m_videoDatabase->Close();
   return true;
 }
 
@@ -637,10 +638,13 @@ void CVideoThumbLoader::DetectAndAddMissingItemData(CFileItem &item)
 
     // check for custom stereomode setting in video settings
     CVideoSettings itemVideoSettings;
-    m_videoDatabase->Open();
-    if (m_videoDatabase->GetVideoSettings(item, itemVideoSettings) && itemVideoSettings.m_StereoMode != RENDER_STEREO_MODE_OFF)
-      stereoMode = CStereoscopicsManager::GetInstance().ConvertGuiStereoModeToString( (RENDER_STEREO_MODE) itemVideoSettings.m_StereoMode );
-    m_videoDatabase->Close();
+    {
+      CSingleLock lock(m_cachedSection);
+      m_videoDatabase->Open();
+      if (m_videoDatabase->GetVideoSettings(item, itemVideoSettings) && itemVideoSettings.m_StereoMode != RENDER_STEREO_MODE_OFF)
+        stereoMode = CStereoscopicsManager::GetInstance().ConvertGuiStereoModeToString( (RENDER_STEREO_MODE) itemVideoSettings.m_StereoMode );
+      m_videoDatabase->Close();
+    }
 
     // still empty, try grabbing from filename
     //! @todo in case of too many false positives due to using the full path, extract the filename only using string utils
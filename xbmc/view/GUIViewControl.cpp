@@ -257,6 +257,17 @@ int CGUIViewControl::GetCurrentControl() const
   return m_visibleViews[m_currentView]->GetID();
 }
 
+void CGUIViewControl::GetVisibleItems(std::vector<CGUIListItemPtr> &items) const
+{
+  if (m_currentView < 0 || m_currentView >= (int)m_visibleViews.size())
+  {
+    items.clear();
+    return;
+  }
+
+  ((IGUIContainer *)m_visibleViews[m_currentView])->GetVisibleItems(items);
+}
+
 // returns the number-th view's viewmode (type and id)
 int CGUIViewControl::GetViewModeNumber(int number) const
 {
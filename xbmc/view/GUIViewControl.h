@@ -20,11 +20,13 @@
  *
  */
 
+#include <memory>
 #include <string>
 #include <vector>
 #include "guilib/GraphicContext.h" // for VIEW_TYPE
 
 class CGUIControl;
+class CGUIListItem; typedef std::shared_ptr<CGUIListItem> CGUIListItemPtr;
 class CFileItemList;
 
 class CGUIViewControl
@@ -57,6 +59,11 @@ public:
 
   int GetCurrentControl() const;
 
+  /*! \brief Get the items the current view shows on screen
+   \param items [out] the visible items
+   */
+  void GetVisibleItems(std::vector<CGUIListItemPtr> &items) const;
+
   void Clear();
 
 protected:
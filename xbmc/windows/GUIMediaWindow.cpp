@@ -20,6 +20,7 @@
 
 #include "GUIMediaWindow.h"
 #include "Application.h"
+#include "BackgroundInfoLoader.h"
 #include "ServiceBroker.h"
 #include "messaging/ApplicationMessenger.h"
 #include "ContextMenuManager.h"
@@ -144,6 +145,18 @@ void CGUIMediaWindow::OnWindowUnload()
   m_viewControl.Reset();
 }
 
+void CGUIMediaWindow::FrameMove()
+{
+  CBackgroundInfoLoader* loader = GetBackgroundLoader();
+  if (loader && loader->IsLoading())
+  {
+    std::vector<CGUIListItemPtr> items;
+    m_viewControl.GetVisibleItems(items);
+    loader->SetVisibleItems(items);
+  }
+  CGUIWindow::FrameMove();
+}
+
 CFileItemPtr CGUIMediaWindow::GetCurrentListItem(int offset)
 {
   int item = m_viewControl.GetSelectedItem();
@@ -27,6 +27,7 @@
 #include "playlists/SmartPlayList.h"
 #include "view/GUIViewControl.h"
 
+class CBackgroundInfoLoader;
 class CFileItemList;
 class CGUIViewState;
 
@@ -46,6 +47,7 @@ public:
   void OnWindowLoaded() override;
   void OnWindowUnload() override;
   void OnInitWindow() override;
+  void FrameMove() override;
   bool IsMediaWindow() const  override { return true; }
   int GetViewContainerID() const  override { return m_viewControl.GetCurrentControl(); }
   int GetViewCount() const  override { return m_viewControl.GetViewModeCount(); };
@@ -90,6 +92,11 @@ protected:
   void SaveControlStates() override;
   void RestoreControlStates() override;
 
+  /*! \brief The loader filling in details of the listed items, if any
+   It is told every frame which items are on screen, so those get loaded first.
+   */
+  virtual CBackgroundInfoLoader* GetBackgroundLoader() { return NULL; }
+
   virtual bool GetDirectory(const std::string &strDirectory, CFileItemList &items);
   /*! \brief Retrieves the items from the given path and updates the list
    \param strDirectory The path to the directory to get the items from